@@ -1,7 +1,9 @@
 #ifndef CONFIG_H
 #define CONFIG_H
 
+#ifdef ARDUINO
 #include <Arduino.h>
+#endif
 
 // ============================================================================
 // WiFi Configuration
@@ -36,16 +38,57 @@
 #define MOTOR2_DIR_PIN 12
 #define MOTOR2_ENABLE_PIN 13
 
+// Homing switches (closing to GND, internal pull-up)
+#define LIMIT1_PIN 32
+#define LIMIT2_PIN 33
+#define LIMIT_ACTIVE_LOW true
+
 // Stepper motor parameters
 #define STEPS_PER_REVOLUTION 200  // 1.8° per step
 #define MICROSTEPS 16             // Microstepping factor
 #define STEPS_PER_DEGREE ((STEPS_PER_REVOLUTION * MICROSTEPS) / 360.0f)
 
+// Stand-alone stepper moves (moveToAngle) ramp up to their speed with
+// this acceleration instead of starting at full rate (0 disables ramps)
+#define STEPPER_MAX_SPEED 3200.0f      // steps/s (1 rev/s at 16 microsteps)
+#define STEPPER_ACCELERATION 6400.0f   // steps/s²
+
+// Minimum STEP high time required by the driver (A4988: 1 us, DRV8825: 1.9 us)
+#define STEP_PULSE_WIDTH_US 2
+
+// Step timer: the step generators run from a hardware timer interrupt at
+// this period (a step takes at least two ticks, high then low: 20 kHz)
+#define STEP_TICK_US 25
+#define STEP_TICKER_TIMER 0         // Hardware timer (0-3)
+#define STEP_TICKER_MAX_MOTORS 2    // Motors driven by the timer
+
+// Step segment buffer (planned motion is pre-chopped into short slices
+// with a precomputed step count and interval per slice)
+#define STEP_SEGMENT_SLICE_US 2000    // Target slice length (microseconds)
+#define STEP_SEGMENT_BUFFER_SIZE 32   // Slices buffered per motor
+
+// Pulse trains (step schedules compiled to RMT-style duration/level items)
+#define PULSE_TICKS_PER_US 1          // RMT tick rate (80 MHz APB / clk_div 80)
+#define PULSE_BUFFER_ITEMS 64         // Items per buffer (one RMT memory block)
+
+// Simulated stepper (SimMotor, for host benchmarking): NEMA 17 driving the arm
+#define SIM_HOLDING_TORQUE 0.40f   // N·m
+#define SIM_INERTIA 5.0e-5f        // kg·m² (rotor + reflected arm)
+#define SIM_NO_LOAD_SPEED 7200.0f  // deg/s at which the torque falls to zero
+#define SIM_DAMPING 2.0e-4f        // N·m·s/rad
+#define SIM_FRICTION 0.01f         // N·m
+#define SIM_SUBSTEP_US 20          // Integration step (microseconds)
+
 // Servo motor parameters (if using servos instead)
 #define SERVO1_PIN 20
 #define SERVO2_PIN 21
 #define SERVO_MIN_PULSE 500   // microseconds
 #define SERVO_MAX_PULSE 2500  // microseconds
+#define SERVO_RANGE_DEG 180.0f         // Angle at SERVO_MAX_PULSE
+#define SERVO_ACCELERATION 720.0f      // deg/s² for moveToAngle (0 = no ramp)
+// The commanded angle leads the trajectory by velocity * this time to make
+// up for the servo's own position loop lag (0 disables feed-forward)
+#define SERVO_VELOCITY_FEEDFORWARD 0.02f  // seconds
 
 // ============================================================================
 // Motion Control Parameters
@@ -59,6 +102,27 @@
 #define INTERPOLATION_INTERVAL_MS 10  // Time between interpolated points
 #define MIN_SEGMENT_LENGTH 0.1f       // Minimum segment length in mm
 
+// G-code front end
+#define GCODE_LINE_MAX 96             // Longest accepted line (characters)
+#define ARC_SEGMENT_LENGTH 0.5f       // Chord length arcs are split into (mm)
+#define ARC_TOLERANCE 0.1f            // Allowed start/end radius mismatch (mm)
+
+// Send position-velocity-time segments to the motors (cubic Hermite)
+// instead of a new target angle on every control loop
+#define MOTION_USE_PVT true
+
+// Homing: fast seek to the switch, back off, slow latch
+#define HOMING_DIR1 -1                 // Direction towards switch 1 (-1 or +1)
+#define HOMING_DIR2 -1                 // Direction towards switch 2
+#define HOMING_ANGLE1 0.0f             // Joint 1 angle at its switch (degrees)
+#define HOMING_ANGLE2 0.0f             // Joint 2 angle at its switch (degrees)
+#define HOMING_FAST_SPEED 1600.0f      // steps/s
+#define HOMING_SLOW_SPEED 200.0f       // steps/s
+#define HOMING_BACKOFF_DEG 5.0f        // Back-off after the fast seek
+#define HOMING_SEEK_RANGE_DEG 350.0f   // Longest travel searched (< 360)
+#define HOMING_TIMEOUT_MS 30000
+#define HOMING_CONCURRENT true         // Home both joints at the same time
+
 // ============================================================================
 // FreeRTOS Task Configuration
 // ============================================================================
@@ -66,19 +130,61 @@
 #define TASK_WEB_HANDLER_STACK_SIZE 8192      // 32 KB
 #define TASK_PLANNER_STACK_SIZE 4096          // 16 KB
 #define TASK_MOTION_CONTROL_STACK_SIZE 4096   // 16 KB
+#define TASK_SERIAL_GCODE_STACK_SIZE 4096     // 16 KB
+#define TASK_TELEMETRY_STACK_SIZE 4096        // 16 KB
 
 // Task priorities (higher number = higher priority)
 #define TASK_WEB_HANDLER_PRIORITY 1
 #define TASK_PLANNER_PRIORITY 2
 #define TASK_MOTION_CONTROL_PRIORITY 3
+#define TASK_SERIAL_GCODE_PRIORITY 1
+#define TASK_TELEMETRY_PRIORITY 1
 
 // Queue sizes
 #define COMMAND_QUEUE_SIZE 10
 #define MOTION_QUEUE_SIZE 50
+#define PATH_BUFFER_SIZE 2048  // Uploaded path vertices (12 bytes each)
 
 // Motion control loop frequency (Hz)
 #define MOTION_CONTROL_FREQUENCY 100  // 100 Hz = 10ms loop
 
+// ============================================================================
+// WebSocket Protocol
+// ============================================================================
+#define WS_MAX_CLIENTS 8               // Matches AsyncWebSocket's own limit
+#define BINARY_PROTOCOL_VERSION 3      // Bump on any frame layout change
+#define WS_REASSEMBLY_SLOTS 4          // Messages arriving in pieces at the same time
+#define WS_MESSAGE_MAX 2048            // Largest reassembled message (bytes, PATH excepted)
+
+// Status telemetry: sent on change, at most once per client interval
+#define TELEMETRY_DEFAULT_INTERVAL_MS 100   // Until the client asks otherwise
+#define TELEMETRY_MIN_INTERVAL_MS 20
+#define TELEMETRY_MAX_INTERVAL_MS 2000      // Slowest rate for a backlogged client
+#define TELEMETRY_HEARTBEAT_MS 5000         // Full status even when idle
+#define TELEMETRY_MAX_QUEUED 1              // Client send queue length that means "slow"
+#define TELEMETRY_POSITION_DEADBAND 0.01f   // mm
+#define TELEMETRY_ANGLE_DEADBAND 0.01f      // degrees
+#define TELEMETRY_TASK_PERIOD_MS 10         // How often the telemetry task looks
+
+// ============================================================================
+// Web UI Assets
+// ============================================================================
+// Gzipped at build time (tools/compress_assets.py), served from LittleFS
+// or, failing that, from the copy built into the firmware. "no-cache"
+// makes browsers revalidate on every load, answered with a 304 while
+// the asset's ETag is unchanged.
+#define WEB_ASSET_CACHE_CONTROL "no-cache"
+
+// ============================================================================
+// Metrics (/metrics, Prometheus text format)
+// ============================================================================
+#define METRICS_MAX_TASKS 8            // Tasks whose stack high-water mark is exported
+#define METRICS_BUFFER_SIZE 6144       // Text of one scrape
+#define LOOP_REPORT_SIZE 1024          // Motion loop timing report ($LOOP, /loop)
+// CPU utilization per core, from the FreeRTOS run-time stats of the idle
+// tasks (configGENERATE_RUN_TIME_STATS; left out with a warning without it)
+#define METRICS_CPU_LOAD true
+
 // ============================================================================
 // Debug Configuration
 // ============================================================================
@@ -86,6 +192,21 @@
 #define DEBUG_KINEMATICS false
 #define DEBUG_PLANNER false
 #define DEBUG_MOTOR false
+#define DEBUG_LOOP_TIMING false        // Print the motion loop timing every 10 s
+
+// PROFILE_SCOPE timing of hot functions, dumped with $PROF or /profile
+// (compiled out when false)
+#define PROFILING_ENABLED false
+#define PROFILE_MAX_SCOPES 16
+#define PROFILE_REPORT_SIZE 1536
+
+// Ring buffer of step pulses and planner samples, downloaded from /trace
+// and analysed with tools/steptrace.cpp (compiled out when false)
+#define STEP_TRACE_ENABLED true
+// One event per step: 2048 hold about 0.3 s with both joints at
+// STEPPER_MAX_SPEED, longer at lower speeds; each doubling costs 16 KB of RAM
+#define STEP_TRACE_EVENTS 2048         // 8 bytes each
+#define STEP_TRACE_KEYFRAME_US 100000  // Joint positions recorded every 100 ms
 
 // ============================================================================
 // Test Mode Configuration
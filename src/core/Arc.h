@@ -0,0 +1,85 @@
+#ifndef ARC_H
+#define ARC_H
+
+#include "Types.h"
+#include "../Config.h"
+#include <math.h>
+
+/**
+ * @file Arc.h
+ * @brief Splits a circular arc into straight chords
+ *
+ * Used by the planner for G2/G3: each chord end point is then planned
+ * like a linear move. The radius is taken from the start point, and the
+ * last point is the exact target, so a small radius mismatch between
+ * start and end (see ARC_TOLERANCE) does not leave a gap.
+ */
+
+class ArcInterpolator {
+private:
+    Point2D center;
+    Point2D end;
+    float radius;
+    float startAngle;
+    float sweep;        // Signed angle covered (radians, negative = clockwise)
+    int segments;
+    int index;
+
+public:
+    ArcInterpolator() : radius(0.0f), startAngle(0.0f), sweep(0.0f), segments(0), index(0) {}
+
+    /**
+     * @brief Start a new arc
+     * A target equal to the start point makes a full circle.
+     * @param start Start point (current position)
+     * @param target End point
+     * @param arcCenter Centre of the arc
+     * @param clockwise true for G2, false for G3
+     * @param segmentLength Longest chord (mm)
+     * @return Number of points next() will produce
+     */
+    int begin(const Point2D& start, const Point2D& target, const Point2D& arcCenter,
+              bool clockwise, float segmentLength = ARC_SEGMENT_LENGTH) {
+        center = arcCenter;
+        end = target;
+        radius = hypotf(start.x - center.x, start.y - center.y);
+        startAngle = atan2f(start.y - center.y, start.x - center.x);
+        float endAngle = atan2f(target.y - center.y, target.x - center.x);
+
+        const float twoPi = 2.0f * (float)M_PI;
+        sweep = endAngle - startAngle;
+        if (clockwise) {
+            if (sweep >= -1e-6f) sweep -= twoPi;
+        } else {
+            if (sweep <= 1e-6f) sweep += twoPi;
+        }
+
+        float length = fabsf(sweep) * radius;
+        segments = (int)ceilf(length / segmentLength);
+        if (segments < 1) {
+            segments = 1;
+        }
+        index = 0;
+        return segments;
+    }
+
+    /**
+     * @brief Next chord end point
+     * @return false once the target has been returned
+     */
+    bool next(Point2D& point) {
+        if (index >= segments) {
+            return false;
+        }
+        index++;
+        if (index == segments) {
+            point = end;
+        } else {
+            float angle = startAngle + sweep * index / segments;
+            point = Point2D(center.x + radius * cosf(angle), center.y + radius * sinf(angle));
+        }
+        return true;
+    }
+};
+
+#endif // ARC_H
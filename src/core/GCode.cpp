@@ -0,0 +1,200 @@
+#include "GCode.h"
+#include <math.h>
+
+// Parse a decimal number ("-12.5", "+3", ".5") without strtod, which
+// may allocate and is much slower than needed for G-code words.
+static bool parseNumber(const char*& p, float& value) {
+    while (*p == ' ' || *p == '\t') p++;
+
+    bool negative = false;
+    if (*p == '-' || *p == '+') {
+        negative = (*p == '-');
+        p++;
+    }
+
+    bool digits = false;
+    float result = 0.0f;
+    while (*p >= '0' && *p <= '9') {
+        result = result * 10.0f + (*p - '0');
+        digits = true;
+        p++;
+    }
+    if (*p == '.') {
+        p++;
+        float scale = 0.1f;
+        while (*p >= '0' && *p <= '9') {
+            result += (*p - '0') * scale;
+            scale *= 0.1f;
+            digits = true;
+            p++;
+        }
+    }
+
+    value = negative ? -result : result;
+    return digits;
+}
+
+GCodeInterpreter::GCodeInterpreter() : error("") {
+}
+
+void GCodeInterpreter::reset() {
+    Point2D position = state.position;
+    state = State();
+    state.position = position;
+    next = state;
+}
+
+void GCodeInterpreter::setPosition(const Point2D& position) {
+    state.position = position;
+    next.position = position;
+}
+
+void GCodeInterpreter::commit() {
+    state = next;
+}
+
+GCodeInterpreter::Result GCodeInterpreter::fail(const char* message) {
+    error = message;
+    return RESULT_ERROR;
+}
+
+GCodeInterpreter::Result GCodeInterpreter::execute(const char* line, Command& cmd) {
+    next = state;
+
+    // Words found on the line
+    int command = -1;          // Non-modal or motion G-code given (0-4, 28)
+    bool hasX = false, hasY = false, hasI = false, hasJ = false;
+    bool hasP = false, hasS = false;
+    float x = 0.0f, y = 0.0f, i = 0.0f, j = 0.0f, p = 0.0f, s = 0.0f;
+
+    const char* c = line;
+    while (*c) {
+        char letter = *c++;
+        if (letter >= 'a' && letter <= 'z') {
+            letter -= 'a' - 'A';
+        }
+
+        if (letter == ' ' || letter == '\t') {
+            continue;
+        }
+        if (letter == ';' || letter == '*') {
+            break;  // Comment or checksum: rest of the line is ignored
+        }
+        if (letter == '(') {
+            while (*c && *c != ')') c++;
+            if (*c == ')') c++;
+            continue;
+        }
+
+        float value;
+        if (!parseNumber(c, value)) {
+            return fail("Bad number");
+        }
+
+        switch (letter) {
+            case 'G': {
+                int code = (int)value;
+                if (value != (float)code) {
+                    return fail("Unsupported command");
+                }
+                if (code == 90 || code == 91) {
+                    next.absolute = (code == 90);
+                } else if (code <= 4 || code == 28) {
+                    if (command >= 0) {
+                        return fail("More than one command");
+                    }
+                    command = code;
+                    if (code <= 3) {
+                        next.motionMode = code;
+                    }
+                } else {
+                    return fail("Unsupported command");
+                }
+                break;
+            }
+            case 'X': x = value; hasX = true; break;
+            case 'Y': y = value; hasY = true; break;
+            case 'I': i = value; hasI = true; break;
+            case 'J': j = value; hasJ = true; break;
+            case 'P': p = value; hasP = true; break;
+            case 'S': s = value; hasS = true; break;
+            case 'F':
+                if (value <= 0.0f) {
+                    return fail("Bad feed rate");
+                }
+                next.feedRate = value / 60.0f;  // mm/min -> mm/s
+                break;
+            case 'N':
+            case 'Z':  // Two-axis arm: pen lifts and the like are ignored
+                break;
+            default:
+                return fail("Unsupported command");
+        }
+    }
+
+    if (command == 4) {
+        if (!hasP && !hasS) {
+            return fail("Missing dwell time");
+        }
+        cmd = Command(Command::DWELL, next.position);
+        cmd.duration = hasP ? p / 1000.0f : s;
+        if (cmd.duration < 0.0f) {
+            return fail("Bad dwell time");
+        }
+        return RESULT_COMMAND;
+    }
+
+    if (command == 28) {
+        cmd = Command(Command::HOME, homePosition);
+        next.position = homePosition;
+        return RESULT_COMMAND;
+    }
+
+    // Motion: an explicit G0-G3, or axis words in the current motion mode
+    if (!hasX && !hasY && !hasI && !hasJ) {
+        return RESULT_NONE;  // Modal changes only (G90, F, bare G1...)
+    }
+
+    // The programmed position can differ from where the planner is (after
+    // a STOP, a skipped move, or moves sent some other way), so relative
+    // and missing axes go out as offsets for the planner to resolve
+    const Point2D& start = next.position;
+    Point2D target = start;
+    Point2D commanded;
+    uint8_t relativeAxes = 0;
+    if (next.absolute) {
+        if (hasX) target.x = commanded.x = x; else relativeAxes |= Command::AXIS_X;
+        if (hasY) target.y = commanded.y = y; else relativeAxes |= Command::AXIS_Y;
+    } else {
+        target.x += x;
+        target.y += y;
+        commanded = Point2D(x, y);
+        relativeAxes = Command::AXIS_X | Command::AXIS_Y;
+    }
+
+    float speed = (next.motionMode == 0) ? MAX_SPEED : next.feedRate;
+
+    if (next.motionMode <= 1) {
+        cmd = Command(Command::MOVE_TO, commanded, speed);
+    } else {
+        if (!hasI && !hasJ) {
+            return fail("Arc needs I or J");
+        }
+
+        // I and J are always relative to the start point
+        Point2D center(start.x + i, start.y + j);
+        float r0 = hypotf(start.x - center.x, start.y - center.y);
+        float r1 = hypotf(target.x - center.x, target.y - center.y);
+        if (r0 < ARC_TOLERANCE || fabsf(r0 - r1) > ARC_TOLERANCE) {
+            return fail("Invalid arc");
+        }
+
+        cmd = Command(next.motionMode == 2 ? Command::ARC_CW : Command::ARC_CCW,
+                      commanded, speed);
+        cmd.center = Point2D(i, j);
+    }
+    cmd.relativeAxes = relativeAxes;
+
+    next.position = target;
+    return RESULT_COMMAND;
+}
@@ -0,0 +1,157 @@
+#ifndef GCODE_H
+#define GCODE_H
+
+#include "Types.h"
+#include "../Config.h"
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @file GCode.h
+ * @brief Streaming G-code front end
+ *
+ * Supported: G0, G1 (lines), G2, G3 (arcs with I/J centre offsets),
+ * G4 (dwell, P in ms or S in s), G28 (home), G90/G91 (absolute/relative)
+ * and F (feed rate in mm/min). Comments (';' and '(...)'), line numbers
+ * (N) and checksums ('*') are accepted and ignored.
+ *
+ * Text is consumed one character at a time by GCodeLineBuffer and every
+ * complete line is turned into at most one Command by GCodeInterpreter.
+ * Nothing allocates, so both can run on any task.
+ *
+ * The interpreter tracks the programmed position to resolve relative
+ * moves, arcs and missing axes. execute() does not change the modal
+ * state; the caller calls commit() once the command has been queued,
+ * so a line that could not be queued can be retried unchanged.
+ *
+ * The programmed position is only used to check arcs. Relative moves,
+ * missing axes and arc centres leave as offsets (Command::relativeAxes,
+ * Command::center), resolved by the planner from where the arm is.
+ */
+
+/**
+ * Assembles characters into lines in a fixed buffer.
+ * Lines longer than GCODE_LINE_MAX - 1 characters are flagged as
+ * overflowed rather than split.
+ */
+class GCodeLineBuffer {
+private:
+    char buffer[GCODE_LINE_MAX];
+    size_t length;
+    bool overflow;
+    bool complete;
+
+public:
+    GCodeLineBuffer() : length(0), overflow(false), complete(false) {
+        buffer[0] = '\0';
+    }
+
+    /**
+     * @brief Add one received character
+     * @return true when a line is complete (read it with line())
+     */
+    bool feed(char c) {
+        if (complete) {
+            // Previous line was handed out; start a new one
+            length = 0;
+            overflow = false;
+            complete = false;
+        }
+
+        if (c == '\n' || c == '\r') {
+            if (length == 0 && !overflow) {
+                return false;  // Second half of CRLF, or an empty line
+            }
+            buffer[length] = '\0';
+            complete = true;
+            return true;
+        }
+
+        if (length < GCODE_LINE_MAX - 1) {
+            buffer[length++] = c;
+        } else {
+            overflow = true;
+        }
+        return false;
+    }
+
+    const char* line() const { return buffer; }
+
+    // true if the last line was truncated (should be rejected)
+    bool overflowed() const { return overflow; }
+
+    void clear() {
+        length = 0;
+        overflow = false;
+        complete = false;
+        buffer[0] = '\0';
+    }
+};
+
+class GCodeInterpreter {
+public:
+    enum Result {
+        RESULT_NONE,      // Nothing to queue (blank line, G90, F...): acknowledge
+        RESULT_COMMAND,   // cmd was filled in: queue it, then acknowledge
+        RESULT_ERROR      // Line rejected, see getError()
+    };
+
+    GCodeInterpreter();
+
+    /**
+     * @brief Interpret one line
+     * The modal state is left unchanged until commit().
+     * @param line Null-terminated line, without the line ending
+     * @param cmd Output command (for RESULT_COMMAND)
+     * @return What the caller has to do with the line
+     */
+    Result execute(const char* line, Command& cmd);
+
+    /**
+     * @brief Apply the modal state of the last successful execute()
+     */
+    void commit();
+
+    /**
+     * @brief Back to power-on modal state (G0, G90, default feed)
+     */
+    void reset();
+
+    /**
+     * @brief Set the programmed position (e.g. after a STOP)
+     */
+    void setPosition(const Point2D& position);
+
+    /**
+     * @brief Set the Cartesian position the arm is at after G28
+     */
+    void setHomePosition(const Point2D& position) { homePosition = position; }
+
+    const Point2D& getPosition() const { return state.position; }
+    bool isAbsolute() const { return state.absolute; }
+    float getFeedRate() const { return state.feedRate; }
+
+    /**
+     * @brief Reason for the last RESULT_ERROR
+     */
+    const char* getError() const { return error; }
+
+private:
+    struct State {
+        Point2D position;  // Programmed position (mm)
+        bool absolute;     // G90 (true) or G91
+        int motionMode;    // 0, 1, 2 or 3 (G0..G3)
+        float feedRate;    // mm/s (F is given in mm/min)
+
+        State() : absolute(true), motionMode(0), feedRate(DEFAULT_SPEED) {}
+    };
+
+    State state;     // Committed modal state
+    State next;      // State after the last executed line
+    Point2D homePosition;
+    const char* error;
+
+    Result fail(const char* message);
+};
+
+#endif // GCODE_H
@@ -0,0 +1,68 @@
+#ifndef HERMITE_H
+#define HERMITE_H
+
+/**
+ * @file Hermite.h
+ * @brief Cubic Hermite segment for position-velocity-time (PVT) motion
+ *
+ * Interpolates between two (position, velocity) pairs over a duration.
+ * Position and velocity are continuous across consecutive segments, so
+ * a motor following a chain of PVT points has no velocity jumps at the
+ * segment boundaries. Units are whatever the caller uses (degrees and
+ * degrees/s for joints).
+ */
+
+struct HermiteSegment {
+    float p0;        // Start position
+    float v0;        // Start velocity (units/s)
+    float p1;        // End position
+    float v1;        // End velocity (units/s)
+    float duration;  // Segment duration in seconds
+
+    HermiteSegment() : p0(0.0f), v0(0.0f), p1(0.0f), v1(0.0f), duration(0.0f) {}
+    HermiteSegment(float p0, float v0, float p1, float v1, float duration)
+        : p0(p0), v0(v0), p1(p1), v1(v1), duration(duration) {}
+
+    /**
+     * @brief Position at time t (clamped to the segment)
+     * @param t Time from the start of the segment in seconds
+     */
+    float position(float t) const {
+        if (duration <= 0.0f || t >= duration) return p1;
+        if (t <= 0.0f) return p0;
+
+        float s = t / duration;
+        float s2 = s * s;
+        float s3 = s2 * s;
+
+        // Hermite basis functions
+        float h00 = 2.0f * s3 - 3.0f * s2 + 1.0f;
+        float h10 = s3 - 2.0f * s2 + s;
+        float h01 = -2.0f * s3 + 3.0f * s2;
+        float h11 = s3 - s2;
+
+        return h00 * p0 + h10 * duration * v0 + h01 * p1 + h11 * duration * v1;
+    }
+
+    /**
+     * @brief Velocity at time t (clamped to the segment)
+     * @param t Time from the start of the segment in seconds
+     */
+    float velocity(float t) const {
+        if (duration <= 0.0f || t >= duration) return v1;
+        if (t <= 0.0f) return v0;
+
+        float s = t / duration;
+        float s2 = s * s;
+
+        // Derivatives of the basis functions with respect to s
+        float d00 = 6.0f * s2 - 6.0f * s;
+        float d10 = 3.0f * s2 - 4.0f * s + 1.0f;
+        float d01 = -6.0f * s2 + 6.0f * s;
+        float d11 = 3.0f * s2 - 2.0f * s;
+
+        return (d00 * p0 + d01 * p1) / duration + d10 * v0 + d11 * v1;
+    }
+};
+
+#endif // HERMITE_H
@@ -0,0 +1,176 @@
+#include "Homing.h"
+
+HomingAxis::HomingAxis(IMotor& motor, ILimitSwitch& limitSwitch, const HomingAxisConfig& config)
+    : motor(motor), limitSwitch(limitSwitch), config(config), state(IDLE),
+      remaining(0.0f) {
+}
+
+// Longest single motor move: moveToAngle() takes the shortest way round,
+// so anything near 180 degrees could go the wrong way
+static const float HOMING_MAX_MOVE_DEG = 90.0f;
+
+void HomingAxis::moveBy(float distance) {
+    remaining = distance;
+    motor.stop();
+    continueMove();
+}
+
+bool HomingAxis::continueMove() {
+    if (motor.isMoving()) {
+        return true;
+    }
+    if (remaining == 0.0f) {
+        return false;
+    }
+    
+    float move = remaining;
+    if (move > HOMING_MAX_MOVE_DEG) move = HOMING_MAX_MOVE_DEG;
+    if (move < -HOMING_MAX_MOVE_DEG) move = -HOMING_MAX_MOVE_DEG;
+    remaining -= move;
+    
+    // Redefine the current position as 0: the reference is lost anyway
+    // until the switch is found
+    motor.setCurrentAngle(0.0f);
+    motor.moveToAngle(move);
+    return true;
+}
+
+void HomingAxis::begin() {
+    motor.setSpeed(config.fastSpeed);
+    
+    if (limitSwitch.isTriggered()) {
+        // Already on the switch: skip the fast seek
+        startBackOff();
+        return;
+    }
+    
+    moveBy(config.direction * config.seekRange);
+    state = SEEK_FAST;
+}
+
+void HomingAxis::startBackOff() {
+    motor.setSpeed(config.fastSpeed);
+    moveBy(-config.direction * config.backoff);
+    state = BACK_OFF;
+}
+
+void HomingAxis::fail() {
+    remaining = 0.0f;
+    motor.stop();
+    motor.setSpeed(config.runSpeed);
+    state = FAILED;
+}
+
+void HomingAxis::abort() {
+    if (isActive()) {
+        fail();
+    }
+}
+
+void HomingAxis::update() {
+    switch (state) {
+        case SEEK_FAST:
+            if (limitSwitch.isTriggered()) {
+                motor.stop();
+                startBackOff();
+            } else if (!continueMove()) {
+                fail();  // Whole range searched, no switch
+            }
+            break;
+            
+        case BACK_OFF:
+            if (!continueMove()) {
+                if (limitSwitch.isTriggered()) {
+                    fail();  // Switch stuck or back-off too short
+                } else {
+                    // The switch is within twice the back-off distance
+                    motor.setSpeed(config.slowSpeed);
+                    moveBy(config.direction * 2.0f * config.backoff);
+                    state = SEEK_SLOW;
+                }
+            }
+            break;
+            
+        case SEEK_SLOW:
+            if (limitSwitch.isTriggered()) {
+                remaining = 0.0f;
+                motor.stop();
+                motor.setCurrentAngle(config.homeAngle);
+                motor.setSpeed(config.runSpeed);
+                state = DONE;
+            } else if (!continueMove()) {
+                fail();
+            }
+            break;
+            
+        default:
+            break;
+    }
+}
+
+HomingEngine::HomingEngine(HomingAxis& axis1, HomingAxis& axis2, bool concurrent,
+                           uint32_t timeoutMs)
+    : axis1(axis1), axis2(axis2), concurrent(concurrent),
+      timeoutMs(timeoutMs), startMs(0), active(false) {
+}
+
+void HomingEngine::begin(uint32_t nowMs) {
+    startMs = nowMs;
+    active = true;
+    
+    axis1.reset();
+    axis2.reset();
+    axis1.begin();
+    if (concurrent) {
+        axis2.begin();
+    }
+}
+
+void HomingEngine::update(uint32_t nowMs) {
+    if (!active) {
+        return;
+    }
+    
+    if (nowMs - startMs > timeoutMs) {
+        abort();
+        return;
+    }
+    
+    axis1.update();
+    axis2.update();
+    
+    // One at a time: joint 2 starts once joint 1 is referenced
+    if (!concurrent && axis1.getState() == HomingAxis::DONE &&
+        axis2.getState() == HomingAxis::IDLE) {
+        axis2.begin();
+    }
+    
+    if (axis1.getState() == HomingAxis::FAILED || axis2.getState() == HomingAxis::FAILED) {
+        abort();
+        return;
+    }
+    
+    if (axis1.getState() == HomingAxis::DONE && axis2.getState() == HomingAxis::DONE) {
+        active = false;
+    }
+}
+
+void HomingEngine::abort() {
+    axis1.abort();
+    axis2.abort();
+    active = false;
+}
+
+bool HomingEngine::isActive() const {
+    return active;
+}
+
+bool HomingEngine::isDone() const {
+    return !active && axis1.getState() == HomingAxis::DONE &&
+           axis2.getState() == HomingAxis::DONE;
+}
+
+bool HomingEngine::hasFailed() const {
+    return !active && !isDone() && (axis1.getState() != HomingAxis::IDLE ||
+                                    axis2.getState() != HomingAxis::IDLE);
+}
@@ -0,0 +1,112 @@
+#ifndef HOMING_H
+#define HOMING_H
+
+#include "../hardware/IMotor.h"
+#include "../hardware/ILimitSwitch.h"
+#include "../Config.h"
+#include <stdint.h>
+
+/**
+ * @file Homing.h
+ * @brief Two-stage homing against limit switches
+ *
+ * Each joint seeks its switch quickly, backs off until the switch opens,
+ * then approaches again slowly and takes the position where the switch
+ * closes as its reference. The slow approach makes the reference
+ * repeatable; the fast seek keeps homing short.
+ *
+ * No hardware dependencies beyond IMotor / ILimitSwitch: the caller
+ * passes the time and keeps calling the motors' update().
+ */
+
+struct HomingAxisConfig {
+    int8_t direction;   // Direction towards the switch (-1 or +1)
+    float homeAngle;    // Joint angle at the switch (degrees)
+    float fastSpeed;    // Seek speed (motor units, steps/s for steppers)
+    float slowSpeed;    // Latch speed
+    float runSpeed;     // Speed restored after homing
+    float backoff;      // Back-off distance (degrees)
+    float seekRange;    // Longest travel searched (degrees, < 360)
+
+    HomingAxisConfig(int8_t direction = -1, float homeAngle = 0.0f)
+        : direction(direction), homeAngle(homeAngle),
+          fastSpeed(HOMING_FAST_SPEED), slowSpeed(HOMING_SLOW_SPEED),
+          runSpeed(STEPPER_MAX_SPEED), backoff(HOMING_BACKOFF_DEG),
+          seekRange(HOMING_SEEK_RANGE_DEG) {}
+};
+
+class HomingAxis {
+public:
+    enum State {
+        IDLE,
+        SEEK_FAST,   // Moving towards the switch at fastSpeed
+        BACK_OFF,    // Moving away until the switch opens
+        SEEK_SLOW,   // Approaching again at slowSpeed
+        DONE,
+        FAILED
+    };
+
+    HomingAxis(IMotor& motor, ILimitSwitch& limitSwitch, const HomingAxisConfig& config);
+
+    void begin();
+    void update();
+    void abort();
+    void reset() { state = IDLE; }
+
+    State getState() const { return state; }
+    bool isActive() const { return state != IDLE && state != DONE && state != FAILED; }
+
+private:
+    IMotor& motor;
+    ILimitSwitch& limitSwitch;
+    HomingAxisConfig config;
+    State state;
+    float remaining;    // Travel of the current moveBy() not yet commanded (degrees)
+
+    // Move by 'distance' degrees from here, whatever the current angle
+    void moveBy(float distance);
+
+    // Command the next part of the moveBy() travel once the motor stops
+    // @return false once the whole travel is done
+    bool continueMove();
+
+    void startBackOff();
+    void fail();
+};
+
+class HomingEngine {
+public:
+    HomingEngine(HomingAxis& axis1, HomingAxis& axis2, bool concurrent = HOMING_CONCURRENT,
+                 uint32_t timeoutMs = HOMING_TIMEOUT_MS);
+
+    /**
+     * @brief Start homing
+     * @param nowMs Current time (milliseconds)
+     */
+    void begin(uint32_t nowMs);
+
+    /**
+     * @brief Advance the sequence (call every control tick)
+     * @param nowMs Current time (milliseconds)
+     */
+    void update(uint32_t nowMs);
+
+    /**
+     * @brief Stop both joints and give up (e.g. on STOP)
+     */
+    void abort();
+
+    bool isActive() const;
+    bool isDone() const;
+    bool hasFailed() const;
+
+private:
+    HomingAxis& axis1;
+    HomingAxis& axis2;
+    bool concurrent;
+    uint32_t timeoutMs;
+    uint32_t startMs;
+    bool active;
+};
+
+#endif // HOMING_H
@@ -1,6 +1,10 @@
 #include "Kinematics.h"
+#include "Profiler.h"
 #include <math.h>
-#include <Arduino.h>
+
+#ifdef ARDUINO
+#include <Arduino.h>  // Serial, for the debug output
+#endif
 
 Kinematics::Kinematics(float l1, float l2) : L1(l1), L2(l2) {
 }
@@ -11,6 +15,7 @@ void Kinematics::setArmLengths(float l1, float l2) {
 }
 
 bool Kinematics::inverse(const Point2D& target, JointAngles& angles) {
+    PROFILE_SCOPE("Kinematics::inverse");
     float x = target.x;
     float y = target.y;
     
@@ -18,7 +23,7 @@ bool Kinematics::inverse(const Point2D& target, JointAngles& angles) {
     float r = sqrt(x * x + y * y);
     
     // Check if point is reachable
-    if (r > (L1 + L2) || r < abs(L1 - L2)) {
+    if (r > (L1 + L2) || r < fabsf(L1 - L2)) {
         #if DEBUG_KINEMATICS
         Serial.printf("Kinematics: Point (%.2f, %.2f) out of reach (r=%.2f)\n", 
                       x, y, r);
@@ -94,7 +99,7 @@ void Kinematics::forward(const JointAngles& angles, Point2D& position) {
 
 bool Kinematics::isReachable(const Point2D& point) {
     float r = sqrt(point.x * point.x + point.y * point.y);
-    return (r <= (L1 + L2) && r >= abs(L1 - L2));
+    return (r <= (L1 + L2) && r >= fabsf(L1 - L2));
 }
 
 float Kinematics::getMaxReach() {
@@ -102,5 +107,5 @@ float Kinematics::getMaxReach() {
 }
 
 float Kinematics::getMinReach() {
-    return abs(L1 - L2);
+    return fabsf(L1 - L2);
 }
@@ -0,0 +1,165 @@
+#include "LoopTiming.h"
+#include <stdarg.h>
+#include <stdio.h>
+
+// Bucket upper bounds in microseconds; the last bucket is open-ended
+static const uint32_t BUCKET_BOUNDS_US[TimingHistogram::BUCKETS - 1] = {
+    5, 10, 20, 50, 100, 200, 500, 1000, 2000, 5000, 10000
+};
+
+uint32_t TimingHistogram::upperBound(int bucket) {
+    if (bucket >= BUCKETS - 1) {
+        return UINT32_MAX;
+    }
+    return BUCKET_BOUNDS_US[bucket];
+}
+
+void TimingHistogram::record(uint32_t us) {
+    int bucket = 0;
+    while (bucket < BUCKETS - 1 && us > BUCKET_BOUNDS_US[bucket]) {
+        bucket++;
+    }
+    add(counts[bucket], 1);
+    add(total, 1);
+    add(sum, us);
+    if (us > maxUs()) {
+        max.store(us, std::memory_order_relaxed);
+    }
+}
+
+void TimingHistogram::clear() {
+    for (int i = 0; i < BUCKETS; i++) {
+        counts[i].store(0, std::memory_order_relaxed);
+    }
+    total.store(0, std::memory_order_relaxed);
+    sum.store(0, std::memory_order_relaxed);
+    max.store(0, std::memory_order_relaxed);
+}
+
+uint32_t TimingHistogram::percentileUs(float fraction) const {
+    uint32_t n = count();
+    if (n == 0) {
+        return 0;
+    }
+
+    uint32_t target = (uint32_t)(fraction * n + 0.999f);
+    if (target < 1) target = 1;
+
+    uint32_t cumulative = 0;
+    for (int i = 0; i < BUCKETS; i++) {
+        cumulative += bucketCount(i);
+        if (cumulative >= target) {
+            return upperBound(i);
+        }
+    }
+    return UINT32_MAX;
+}
+
+LoopTimer::LoopTimer(uint32_t periodUs, uint32_t cyclesPerUs)
+    : periodUs(periodUs), cyclesPerUs(1), periodCycles(periodUs),
+      missed(0), resetRequested(false),
+      started(false), startCycles(0), dueCycles(0) {
+    setClockRate(cyclesPerUs);
+}
+
+void LoopTimer::setClockRate(uint32_t rate) {
+    cyclesPerUs = rate > 0 ? rate : 1;
+    periodCycles = periodUs * cyclesPerUs;
+}
+
+void LoopTimer::begin(uint32_t nowCycles) {
+    if (resetRequested.exchange(false)) {
+        jitterUs.clear();
+        executionUs.clear();
+        missed.store(0, std::memory_order_relaxed);
+    }
+
+    if (!started) {
+        // The first iteration sets the timeline
+        started = true;
+        dueCycles = nowCycles;
+    } else {
+        uint32_t period = (nowCycles - startCycles) / cyclesPerUs;
+        jitterUs.record(period > periodUs ? period - periodUs : periodUs - period);
+
+        dueCycles += periodCycles;
+        if ((int32_t)(nowCycles - dueCycles) < 0) {
+            dueCycles = nowCycles;  // Early (clock drift): follow the loop
+        }
+    }
+    startCycles = nowCycles;
+}
+
+void LoopTimer::end(uint32_t nowCycles) {
+    executionUs.record((nowCycles - startCycles) / cyclesPerUs);
+
+    // Finished after the next iteration was due
+    if ((int32_t)(nowCycles - (dueCycles + periodCycles)) > 0) {
+        missed.store(missedDeadlines() + 1, std::memory_order_relaxed);
+    }
+}
+
+void LoopTimer::requestReset() {
+    resetRequested = true;
+}
+
+// Append to a report, stopping at the end of the buffer
+static void append(char* out, size_t size, size_t& used, const char* format, ...) {
+    if (used + 1 >= size) {
+        return;
+    }
+    va_list args;
+    va_start(args, format);
+    int n = vsnprintf(out + used, size - used, format, args);
+    va_end(args);
+    if (n > 0) {
+        used += (size_t)n;
+    }
+    if (used >= size) {
+        used = size - 1;
+    }
+}
+
+// "<= 50 us", or "> 10000 us" for the open bucket
+static void formatBound(char* out, size_t size, uint32_t us) {
+    if (us == UINT32_MAX) {
+        uint32_t last = TimingHistogram::upperBound(TimingHistogram::BUCKETS - 2);
+        snprintf(out, size, "> %u us", (unsigned)last);
+    } else {
+        snprintf(out, size, "<= %u us", (unsigned)us);
+    }
+}
+
+size_t LoopTimer::report(char* out, size_t size) const {
+    if (size == 0) {
+        return 0;
+    }
+
+    size_t used = 0;
+    char p50[16], p99[16];
+    out[0] = '\0';
+
+    append(out, size, used, "Loop timing: period %u us, %u iterations, %u missed deadlines\n",
+           (unsigned)periodUs, (unsigned)executionUs.count(),
+           (unsigned)missedDeadlines());
+
+    formatBound(p50, sizeof(p50), jitterUs.percentileUs(0.5f));
+    formatBound(p99, sizeof(p99), jitterUs.percentileUs(0.99f));
+    append(out, size, used, "Jitter:    p50 %s, p99 %s, max %u us\n",
+           p50, p99, (unsigned)jitterUs.maxUs());
+
+    formatBound(p50, sizeof(p50), executionUs.percentileUs(0.5f));
+    formatBound(p99, sizeof(p99), executionUs.percentileUs(0.99f));
+    append(out, size, used, "Execution: p50 %s, p99 %s, max %u us\n",
+           p50, p99, (unsigned)executionUs.maxUs());
+
+    append(out, size, used, "Bucket        jitter  execution\n");
+    for (int i = 0; i < TimingHistogram::BUCKETS; i++) {
+        char bound[16];
+        formatBound(bound, sizeof(bound), TimingHistogram::upperBound(i));
+        append(out, size, used, "%-12s %7u %10u\n", bound,
+               (unsigned)jitterUs.bucketCount(i), (unsigned)executionUs.bucketCount(i));
+    }
+
+    return used;
+}
@@ -0,0 +1,123 @@
+#ifndef LOOP_TIMING_H
+#define LOOP_TIMING_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+
+/**
+ * @file LoopTiming.h
+ * @brief Timing of a periodic loop: jitter, execution time, missed deadlines
+ *
+ * LoopTimer is told when each iteration starts and ends, as raw clock
+ * cycles (ESP.getCycleCount() on the target, any counter in tests), and
+ * records into fixed-bucket histograms:
+ * - jitter: |start-to-start period - nominal period|
+ * - execution: time from begin() to end()
+ *
+ * An iteration misses its deadline when it ends after the next one was
+ * due. Due times follow the ideal timeline (one period apart from the
+ * first iteration), which is how vTaskDelayUntil schedules the loop, so
+ * a late wake-up counts against the iteration as well as a long body.
+ *
+ * The loop task is the only writer. Other tasks read the histograms at
+ * any time (relaxed atomics, one value at a time) and ask for a reset
+ * with requestReset(), which the loop applies at its next begin().
+ */
+
+class TimingHistogram {
+public:
+    static const int BUCKETS = 12;
+
+    TimingHistogram() { clear(); }
+
+    /**
+     * @brief Largest value counted in a bucket (microseconds)
+     * @return UINT32_MAX for the last bucket (+Inf)
+     */
+    static uint32_t upperBound(int bucket);
+
+    void record(uint32_t us);
+    void clear();
+
+    uint32_t bucketCount(int bucket) const { return counts[bucket].load(std::memory_order_relaxed); }
+    uint32_t count() const { return total.load(std::memory_order_relaxed); }
+    uint32_t sumUs() const { return sum.load(std::memory_order_relaxed); }
+    uint32_t maxUs() const { return max.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Upper bound of the bucket holding the given fraction of samples
+     * @param fraction 0.5 for the median, 0.99 for the 99th percentile
+     * @return Bound in microseconds (UINT32_MAX: above the last bound),
+     *         0 if nothing was recorded
+     */
+    uint32_t percentileUs(float fraction) const;
+
+private:
+    std::atomic<uint32_t> counts[BUCKETS];
+    std::atomic<uint32_t> total;
+    std::atomic<uint32_t> sum;   // Wraps, like a Prometheus counter
+    std::atomic<uint32_t> max;
+
+    // Single writer: no read-modify-write needed
+    static void add(std::atomic<uint32_t>& value, uint32_t n) {
+        value.store(value.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+};
+
+class LoopTimer {
+public:
+    /**
+     * @param periodUs Nominal loop period (microseconds)
+     * @param cyclesPerUs Clock rate of the cycle counter (CPU MHz)
+     */
+    LoopTimer(uint32_t periodUs, uint32_t cyclesPerUs = 1);
+
+    /**
+     * @brief Set the clock rate once it is known (before the loop starts)
+     */
+    void setClockRate(uint32_t cyclesPerUs);
+
+    /**
+     * @brief Mark the start of an iteration (loop task only)
+     */
+    void begin(uint32_t nowCycles);
+
+    /**
+     * @brief Mark the end of the iteration (loop task only)
+     */
+    void end(uint32_t nowCycles);
+
+    /**
+     * @brief Clear the statistics at the loop's next iteration (any task)
+     */
+    void requestReset();
+
+    const TimingHistogram& jitter() const { return jitterUs; }
+    const TimingHistogram& execution() const { return executionUs; }
+    uint32_t missedDeadlines() const { return missed.load(std::memory_order_relaxed); }
+    uint32_t getPeriodUs() const { return periodUs; }
+
+    /**
+     * @brief Write a human-readable summary (serial console, /loop)
+     * @return Length written (truncated to size - 1)
+     */
+    size_t report(char* out, size_t size) const;
+
+private:
+    uint32_t periodUs;
+    uint32_t cyclesPerUs;
+    uint32_t periodCycles;
+
+    TimingHistogram jitterUs;
+    TimingHistogram executionUs;
+    std::atomic<uint32_t> missed;
+    std::atomic<bool> resetRequested;
+
+    // Loop task only
+    bool started;
+    uint32_t startCycles;      // Start of the current iteration
+    uint32_t dueCycles;        // When the current iteration was due
+};
+
+#endif // LOOP_TIMING_H
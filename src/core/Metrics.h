@@ -0,0 +1,123 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include "../Config.h"
+#include <stdint.h>
+#include <atomic>
+
+/**
+ * @file Metrics.h
+ * @brief Lock-free counters updated by the tasks, exported on /metrics
+ *
+ * Every value is a relaxed 32-bit atomic: an update is a single atomic
+ * add or store, never a lock, so the motion task can update its own
+ * metrics on every loop. Counters only grow (and wrap at 2^32, which
+ * Prometheus treats as a restart); gauges are overwritten by the one
+ * task that owns them.
+ *
+ * The values are only snapshots for monitoring: they are not read
+ * together atomically and nothing in the firmware depends on them.
+ */
+
+/**
+ * @brief Busy fraction of one core, from its idle task's run time
+ *
+ * FreeRTOS run-time stats count how long each task has run. Whatever
+ * the core's idle task did not get went to other tasks, however short
+ * each burst was. Interrupts are charged to the task they interrupt, so
+ * ISR time (the step timer) shows up under whichever task was running.
+ * utilization() is only called by the metrics exporter.
+ */
+class IdleMeter {
+public:
+    IdleMeter() : started(false), lastTotal(0), lastIdle(0) {}
+
+    /**
+     * @brief Fraction of time the core was busy since the previous call
+     * @param totalRunTime Run-time clock now (wraps)
+     * @param idleRunTime The idle task's run-time counter, same clock (wraps)
+     * @return 0.0 (idle) to 1.0 (fully loaded); 0 on the first call
+     */
+    float utilization(uint32_t totalRunTime, uint32_t idleRunTime) {
+        uint32_t elapsed = totalRunTime - lastTotal;
+        uint32_t idleDelta = idleRunTime - lastIdle;
+        bool first = !started;
+        started = true;
+        lastTotal = totalRunTime;
+        lastIdle = idleRunTime;
+
+        if (first || elapsed == 0) {
+            return 0.0f;
+        }
+        if (idleDelta >= elapsed) {
+            return 0.0f;
+        }
+        return 1.0f - (float)idleDelta / (float)elapsed;
+    }
+
+private:
+    bool started;
+    uint32_t lastTotal;
+    uint32_t lastIdle;
+};
+
+struct Metrics {
+    static const int JOINTS = 2;
+    static const int CORES = 2;
+
+    // Command sources (web server, serial G-code)
+    std::atomic<uint32_t> commandsReceived;   // Command messages and G-code lines
+    std::atomic<uint32_t> commandsParsed;     // Of those, understood
+    std::atomic<uint32_t> commandsRejected;   // Refused: no credits left
+
+    // Planner task
+    std::atomic<uint32_t> plannerBlocks;      // Straight moves planned
+    std::atomic<uint32_t> plannerSamples;     // Trajectory samples queued
+    std::atomic<uint32_t> ikFailures;         // Targets or points out of reach
+
+    // Motion task
+    std::atomic<uint32_t> motionQueueDepth;   // Gauge: samples waiting
+    std::atomic<uint32_t> motionUnderruns;    // Moves starved of samples
+    std::atomic<uint32_t> stepsIssued[JOINTS];
+
+    // Busy fraction of each core between scrapes
+    IdleMeter cpuIdle[CORES];
+
+    Metrics() {
+        reset();
+    }
+
+    /**
+     * @brief Zero every counter (tests)
+     */
+    void reset() {
+        commandsReceived.store(0);
+        commandsParsed.store(0);
+        commandsRejected.store(0);
+        plannerBlocks.store(0);
+        plannerSamples.store(0);
+        ikFailures.store(0);
+        motionQueueDepth.store(0);
+        motionUnderruns.store(0);
+        for (int i = 0; i < JOINTS; i++) {
+            stepsIssued[i].store(0);
+        }
+    }
+
+    static void increment(std::atomic<uint32_t>& counter, uint32_t n = 1) {
+        counter.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    static void set(std::atomic<uint32_t>& gauge, uint32_t value) {
+        gauge.store(value, std::memory_order_relaxed);
+    }
+
+    static uint32_t get(const std::atomic<uint32_t>& value) {
+        return value.load(std::memory_order_relaxed);
+    }
+};
+
+// Shared by all tasks (defined in Metrics.cpp)
+extern Metrics metrics;
+
+#endif // METRICS_H
@@ -0,0 +1,145 @@
+#ifndef PATH_BUFFER_H
+#define PATH_BUFFER_H
+
+#include "Types.h"
+#include "../Config.h"
+#include <stdint.h>
+#include <atomic>
+
+/**
+ * @file PathBuffer.h
+ * @brief Shared ring of uploaded path vertices
+ *
+ * A bulk path upload writes its vertices straight into this ring while
+ * the message is still arriving, and queues a single Command::PATH once
+ * it is complete. The planner then pops the vertices from here, so a
+ * drawing with thousands of points costs one command instead of one per
+ * point.
+ *
+ * Every vertex is tagged with the id of its upload. An upload whose
+ * command is never queued (aborted, or refused for lack of credits) is
+ * taken back by the producer with retract(). Commands flushed from the
+ * queue by a STOP leave their vertices behind: the producer marks them
+ * with abandonBefore() and the planner drops them when it handles the
+ * STOP. Either way no vertex holds space that no command will free.
+ */
+
+struct PathVertex {
+    Point2D point;    // Target position (mm)
+    uint16_t pathId;  // Upload the vertex belongs to
+
+    PathVertex() : pathId(0) {}
+};
+
+/**
+ * Fixed-size single-producer / single-consumer ring of path vertices.
+ * The web server produces, the planner consumes.
+ */
+class PathBuffer {
+private:
+    PathVertex vertices[PATH_BUFFER_SIZE];
+    std::atomic<uint16_t> head;  // Next slot to write (producer)
+    std::atomic<uint16_t> tail;  // Next slot to read (consumer)
+    std::atomic<int32_t> liveFrom;  // First id still wanted after a STOP (-1: none)
+
+    // true if id a was issued before id b (ids wrap around)
+    static bool isOlder(uint16_t a, uint16_t b) {
+        return (int16_t)(a - b) < 0;
+    }
+
+public:
+    PathBuffer() : head(0), tail(0), liveFrom(-1) {}
+
+    bool push(const Point2D& point, uint16_t pathId) {
+        uint16_t h = head.load(std::memory_order_relaxed);
+        uint16_t next = (h + 1) % PATH_BUFFER_SIZE;
+        if (next == tail.load(std::memory_order_acquire)) {
+            return false;  // Full
+        }
+        vertices[h].point = point;
+        vertices[h].pathId = pathId;
+        head.store(next, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Pop the next vertex of a path
+     * Vertices of older, abandoned uploads are dropped on the way.
+     * @param pathId Path being consumed
+     * @param point Output vertex
+     * @return false if no vertex of this path is available
+     */
+    bool pop(uint16_t pathId, Point2D& point) {
+        uint16_t t = tail.load(std::memory_order_relaxed);
+        while (t != head.load(std::memory_order_acquire)) {
+            const PathVertex& vertex = vertices[t];
+            if (vertex.pathId != pathId && !isOlder(vertex.pathId, pathId)) {
+                break;  // Next path's vertices: this one is exhausted
+            }
+
+            uint16_t next = (t + 1) % PATH_BUFFER_SIZE;
+            bool match = (vertex.pathId == pathId);
+            if (match) {
+                point = vertex.point;
+            }
+            tail.store(next, std::memory_order_release);
+            t = next;
+            if (match) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Drop the remaining vertices of a path (e.g. after a STOP)
+     */
+    void discard(uint16_t pathId) {
+        Point2D unused;
+        while (pop(pathId, unused)) {
+        }
+    }
+
+    /**
+     * @brief Take back the last vertices pushed (producer only)
+     * For an upload whose command was never queued. The consumer never
+     * reads them: it stops at the first vertex newer than its path.
+     * @param count Vertices to take back
+     */
+    void retract(uint16_t count) {
+        uint16_t h = head.load(std::memory_order_relaxed);
+        head.store((uint16_t)((h + PATH_BUFFER_SIZE - count) % PATH_BUFFER_SIZE),
+                   std::memory_order_release);
+    }
+
+    /**
+     * @brief Mark uploads older than pathId as abandoned (producer, on STOP)
+     * They are dropped by the consumer's next dropAbandoned().
+     */
+    void abandonBefore(uint16_t pathId) {
+        liveFrom.store(pathId);
+    }
+
+    /**
+     * @brief Drop the vertices marked by abandonBefore() (consumer)
+     */
+    void dropAbandoned() {
+        int32_t first = liveFrom.exchange(-1);
+        if (first >= 0) {
+            discard((uint16_t)(first - 1));
+        }
+    }
+
+    bool isEmpty() const {
+        return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+    }
+
+    int available() const {
+        int used = (int)head.load(std::memory_order_acquire) -
+                   (int)tail.load(std::memory_order_acquire);
+        if (used < 0) used += PATH_BUFFER_SIZE;
+        return PATH_BUFFER_SIZE - 1 - used;
+    }
+};
+
+#endif // PATH_BUFFER_H
@@ -1,11 +1,16 @@
 #include "Planner.h"
+#include "Profiler.h"
 #include <math.h>
-#include <Arduino.h>
+
+#ifdef ARDUINO
+#include <Arduino.h>  // Serial, for the debug output
+#endif
 
 Planner::Planner(float speed, float acceleration)
     : speed(speed), acceleration(acceleration),
       interpolationInterval(INTERPOLATION_INTERVAL_MS / 1000.0f),
-      useSCurve(false), jerkLimit(JERK_LIMIT) {
+      useSCurve(false), jerkLimit(JERK_LIMIT),
+      pathSegments(0), pathIndex(0), pathPoints(0), pathDuration(0.0f) {
 }
 
 void Planner::setSpeed(float speed) {
@@ -24,13 +29,32 @@ void Planner::setAcceleration(float acceleration) {
 
 int Planner::planPath(const Point2D& start, const Point2D& end, 
                       std::queue<Point2D>& motionQueue) {
+    PROFILE_SCOPE("Planner::planPath");
+    int numPoints = beginPath(start, end);
+    
+    Point2D point;
+    while (nextPoint(point)) {
+        motionQueue.push(point);
+    }
+    
+    return numPoints;
+}
+
+int Planner::beginPath(const Point2D& start, const Point2D& end) {
+    PROFILE_SCOPE("Planner::beginPath");
+    pathStart = start;
+    pathEnd = end;
+    pathIndex = 0;
+    
     // Calculate total distance
     float dist = distance(start, end);
     
     if (dist < MIN_SEGMENT_LENGTH) {
         // Too short, just add the end point
-        motionQueue.push(end);
-        return 1;
+        pathSegments = 0;
+        pathPoints = 1;
+        pathDuration = 0.0f;
+        return pathPoints;
     }
     
     // Calculate total time needed
@@ -51,25 +75,49 @@ int Planner::planPath(const Point2D& start, const Point2D& end,
                   dist, totalTime, numPoints);
     #endif
     
-    // Generate interpolated points
-    for (int i = 0; i <= numPoints; i++) {
-        float t = (float)i / (float)numPoints;  // Parameter from 0 to 1
-        
-        // Linear interpolation
-        Point2D point;
-        point.x = start.x + t * (end.x - start.x);
-        point.y = start.y + t * (end.y - start.y);
-        
-        motionQueue.push(point);
-        
-        #if DEBUG_PLANNER
-        if (i % 10 == 0 || i == numPoints) {
-            Serial.printf("Planner: Point %d: (%.2f, %.2f)\n", i, point.x, point.y);
-        }
-        #endif
+    pathSegments = numPoints;
+    pathPoints = numPoints + 1;
+    pathDuration = totalTime;
+    return pathPoints;
+}
+
+bool Planner::nextPoint(Point2D& point) {
+    float t;
+    return nextPoint(point, t);
+}
+
+bool Planner::nextPoint(Point2D& point, float& t) {
+    PROFILE_SCOPE("Planner::nextPoint");
+    if (pathIndex >= pathPoints) {
+        return false;
+    }
+    
+    if (pathSegments == 0) {
+        point = pathEnd;
+        t = 0.0f;
+        pathIndex++;
+        return true;
     }
     
-    return numPoints + 1;
+    float u = (float)pathIndex / (float)pathSegments;  // Parameter from 0 to 1
+    
+    // Linear interpolation
+    point.x = pathStart.x + u * (pathEnd.x - pathStart.x);
+    point.y = pathStart.y + u * (pathEnd.y - pathStart.y);
+    t = u * pathDuration;
+    
+    #if DEBUG_PLANNER
+    if (pathIndex % 10 == 0 || pathIndex == pathSegments) {
+        Serial.printf("Planner: Point %d: (%.2f, %.2f)\n", pathIndex, point.x, point.y);
+    }
+    #endif
+    
+    pathIndex++;
+    return true;
+}
+
+bool Planner::hasNextPoint() const {
+    return pathIndex < pathPoints;
 }
 
 float Planner::distance(const Point2D& p1, const Point2D& p2) {
@@ -24,6 +24,14 @@ private:
     bool useSCurve;
     float jerkLimit;
     
+    // Incremental path state (see beginPath / nextPoint)
+    Point2D pathStart;
+    Point2D pathEnd;
+    int pathSegments;         // Number of interpolation intervals
+    int pathIndex;            // Index of the next point to emit
+    int pathPoints;           // Total number of points in the path
+    float pathDuration;       // Duration of the path in seconds
+    
 public:
     /**
      * @brief Constructor
@@ -57,6 +65,39 @@ public:
     int planPath(const Point2D& start, const Point2D& end, 
                  std::queue<Point2D>& motionQueue);
     
+    /**
+     * @brief Start an incremental path from start to end
+     * Points are then pulled one at a time with nextPoint(), so the caller
+     * can hand each one to the motion task as soon as it exists instead of
+     * waiting for the whole move to be generated.
+     * 
+     * @param start Starting position
+     * @param end Ending position
+     * @return Number of points the path will produce
+     */
+    int beginPath(const Point2D& start, const Point2D& end);
+    
+    /**
+     * @brief Generate the next point of the path started by beginPath()
+     * @param point Output interpolated point
+     * @return true if a point was produced, false once the path is done
+     */
+    bool nextPoint(Point2D& point);
+    
+    /**
+     * @brief Generate the next point of the path with its timestamp
+     * @param point Output interpolated point
+     * @param t Output time of the point from the start of the path (seconds)
+     * @return true if a point was produced, false once the path is done
+     */
+    bool nextPoint(Point2D& point, float& t);
+    
+    /**
+     * @brief Check if the current path still has points to generate
+     * @return true while nextPoint() would produce a point
+     */
+    bool hasNextPoint() const;
+    
     /**
      * @brief Calculate distance between two points
      * @param p1 First point
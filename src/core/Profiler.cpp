@@ -0,0 +1,88 @@
+#include "Profiler.h"
+#include <stdarg.h>
+#include <stdio.h>
+
+#if PROFILING_ENABLED
+ProfileTable profiler;
+#endif
+
+ProfileSlot* ProfileTable::claim(const char* name) {
+    // Sites in different tasks may claim at the same time
+    int index = used.fetch_add(1);
+    if (index >= PROFILE_MAX_SCOPES) {
+        return nullptr;  // Table full: this site is not profiled
+    }
+    slots[index].name = name;
+    return &slots[index];
+}
+
+int ProfileTable::rows() const {
+    int n = used.load();
+    return n < PROFILE_MAX_SCOPES ? n : PROFILE_MAX_SCOPES;
+}
+
+void ProfileTable::reset() {
+    for (int i = 0; i < rows(); i++) {
+        slots[i].reset();
+    }
+}
+
+// Append to a report, stopping at the end of the buffer
+static void append(char* out, size_t size, size_t& used, const char* format, ...) {
+    if (used + 1 >= size) {
+        return;
+    }
+    va_list args;
+    va_start(args, format);
+    int n = vsnprintf(out + used, size - used, format, args);
+    va_end(args);
+    if (n > 0) {
+        used += (size_t)n;
+    }
+    if (used >= size) {
+        used = size - 1;
+    }
+}
+
+size_t ProfileTable::report(char* out, size_t size, uint32_t ticksPerUs) const {
+    if (size == 0) {
+        return 0;
+    }
+
+    size_t length = 0;
+    float perUs = ticksPerUs > 0 ? (float)ticksPerUs : 1.0f;
+    out[0] = '\0';
+
+    append(out, size, length, "%-24s %8s %12s %10s %10s %10s\n",
+           "Scope", "Calls", "Total us", "Avg us", "Min us", "Max us");
+    for (int i = 0; i < rows(); i++) {
+        const ProfileSlot& slot = slots[i];
+        if (!slot.name) {
+            continue;  // Being claimed
+        }
+        float total = (float)slot.total / perUs;
+        float average = slot.count > 0 ? total / slot.count : 0.0f;
+        append(out, size, length, "%-24s %8u %12.1f %10.2f %10.2f %10.2f\n",
+               slot.name, (unsigned)slot.count, (double)total, (double)average,
+               (double)(slot.min / perUs), (double)(slot.max / perUs));
+    }
+    if (used.load() > PROFILE_MAX_SCOPES) {
+        append(out, size, length, "(%d scopes not profiled: raise PROFILE_MAX_SCOPES)\n",
+               used.load() - PROFILE_MAX_SCOPES);
+    }
+    return length;
+}
+
+size_t profileReport(char* out, size_t size) {
+#if PROFILING_ENABLED
+    return profiler.report(out, size, ProfileClock::ticksPerUs());
+#else
+    return (size_t)snprintf(out, size, "Profiling disabled (PROFILING_ENABLED in Config.h)\n");
+#endif
+}
+
+void profileReset() {
+#if PROFILING_ENABLED
+    profiler.reset();
+#endif
+}
@@ -0,0 +1,156 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include "../Config.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+
+#ifndef ARDUINO
+#include <chrono>
+#endif
+
+/**
+ * @file Profiler.h
+ * @brief Scoped timing of named code sections
+ *
+ * PROFILE_SCOPE("name") at the top of a block times the rest of the
+ * block and adds it to that call site's row of a static table: call
+ * count, total, minimum and maximum time. Nothing is allocated; each
+ * site claims its row the first time it runs.
+ *
+ * The clock is the CPU cycle counter on the ESP32 (ESP.getCycleCount())
+ * and std::chrono::steady_clock (nanoseconds) on the host. The cycle
+ * counter is per core, so a scope must not migrate between cores
+ * (tasks here are pinned).
+ *
+ * Rows are updated without locking: a site entered by two tasks at once
+ * may lose an update, which only skews its statistics.
+ *
+ * With PROFILING_ENABLED false (Config.h), PROFILE_SCOPE expands to
+ * nothing and no table exists; profileReport() says so.
+ */
+
+/**
+ * @brief Tick source of the profiler
+ */
+class ProfileClock {
+public:
+#ifdef ARDUINO
+    static inline uint32_t now() { return ESP.getCycleCount(); }
+    static uint32_t ticksPerUs() { return ESP.getCpuFreqMHz(); }
+#else
+    static inline uint32_t now() {
+        return (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+    static uint32_t ticksPerUs() { return 1000; }
+#endif
+};
+
+/**
+ * @brief Statistics of one profiled call site (times in clock ticks)
+ */
+struct ProfileSlot {
+    const char* name;
+    uint32_t count;
+    uint64_t total;
+    uint32_t min;
+    uint32_t max;
+
+    ProfileSlot() : name(nullptr) { reset(); }
+
+    void record(uint32_t ticks) {
+        if (count == 0 || ticks < min) min = ticks;
+        if (ticks > max) max = ticks;
+        total += ticks;
+        count++;
+    }
+
+    void reset() {
+        count = 0;
+        total = 0;
+        min = 0;
+        max = 0;
+    }
+};
+
+/**
+ * @brief Fixed table of profiled call sites
+ */
+class ProfileTable {
+public:
+    ProfileTable() : used(0) {}
+
+    /**
+     * @brief Take a row for a call site
+     * @return The row, or nullptr if all PROFILE_MAX_SCOPES rows are taken
+     */
+    ProfileSlot* claim(const char* name);
+
+    /**
+     * @brief Zero the statistics of every row (the rows stay claimed)
+     */
+    void reset();
+
+    /**
+     * @brief Write a table of the rows (times in microseconds)
+     * @param ticksPerUs Clock ticks per microsecond
+     * @return Length written (truncated to size - 1)
+     */
+    size_t report(char* out, size_t size, uint32_t ticksPerUs) const;
+
+    int rows() const;
+
+private:
+    ProfileSlot slots[PROFILE_MAX_SCOPES];
+    std::atomic<int> used;    // Rows claimed (may exceed the table once full)
+};
+
+/**
+ * @brief Times its own lifetime into a row
+ */
+class ProfileScope {
+public:
+    explicit ProfileScope(ProfileSlot* slot) : slot(slot), start(ProfileClock::now()) {}
+
+    ~ProfileScope() {
+        if (slot) {
+            slot->record(ProfileClock::now() - start);
+        }
+    }
+
+private:
+    ProfileSlot* slot;
+    uint32_t start;
+};
+
+/**
+ * @brief Write the profile of the firmware's scopes (serial console, /profile)
+ */
+size_t profileReport(char* out, size_t size);
+
+/**
+ * @brief Zero the firmware's profile
+ */
+void profileReset();
+
+#if PROFILING_ENABLED
+
+// The firmware's table (Profiler.cpp)
+extern ProfileTable profiler;
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+
+#define PROFILE_SCOPE(name) \
+    static ProfileSlot* const PROFILE_CONCAT(profileSlot_, __LINE__) = profiler.claim(name); \
+    ProfileScope PROFILE_CONCAT(profileScope_, __LINE__)(PROFILE_CONCAT(profileSlot_, __LINE__))
+
+#else
+
+#define PROFILE_SCOPE(name) do {} while (0)
+
+#endif
+
+#endif // PROFILER_H
@@ -0,0 +1,155 @@
+#include "PulseTrain.h"
+
+bool PulseTrainCompiler::fromSegmentBuffer(StepSegment& segment, void* context) {
+    return static_cast<StepSegmentBuffer*>(context)->pop(segment);
+}
+
+PulseTrainCompiler::PulseTrainCompiler(RefillCallback refill, void* context, uint16_t pulseTicks)
+    : refill(refill), context(context), pulseTicks(pulseTicks), active(0),
+      haveSegment(false), stepIndex(0), segmentStartTick(0), emittedTick(0) {
+    if (this->pulseTicks < 1) {
+        this->pulseTicks = 1;
+    }
+}
+
+void PulseTrainCompiler::begin() {
+    haveSegment = false;
+    stepIndex = 0;
+    segmentStartTick = 0;
+    emittedTick = 0;
+    active = 0;
+
+    fill(buffers[0]);
+    fill(buffers[1]);
+}
+
+const PulseBuffer& PulseTrainCompiler::current() const {
+    return buffers[active];
+}
+
+bool PulseTrainCompiler::bufferDone() {
+    // The other buffer was compiled earlier, so it plays next
+    fill(buffers[active]);
+    active ^= 1;
+    return buffers[active].count > 0;
+}
+
+void PulseTrainCompiler::setItem(PulseItem& item, uint32_t d0, bool l0, uint32_t d1, bool l1) {
+    item.duration0 = d0;
+    item.level0 = l0 ? 1 : 0;
+    item.duration1 = d1;
+    item.level1 = l1 ? 1 : 0;
+}
+
+uint32_t PulseTrainCompiler::emitLow(PulseBuffer& buffer, uint32_t ticks) {
+    uint32_t emitted = 0;
+
+    // A zero duration marks the end of the train for the RMT, so both
+    // halves need at least one tick; a single leftover tick is kept
+    while (ticks - emitted >= 2 && buffer.count < PULSE_BUFFER_ITEMS) {
+        uint32_t take = ticks - emitted;
+        if (take > 2 * PULSE_MAX_DURATION) {
+            take = 2 * PULSE_MAX_DURATION;
+            if (ticks - emitted - take == 1) {
+                take--;
+            }
+        }
+        setItem(buffer.items[buffer.count++], (take + 1) / 2, false, take / 2, false);
+        emitted += take;
+    }
+    return emitted;
+}
+
+int PulseTrainCompiler::fill(PulseBuffer& buffer) {
+    buffer.count = 0;
+    buffer.direction = 0;
+
+    while (true) {
+        if (!haveSegment) {
+            if (!refill || !refill(segment, context)) {
+                // Source dry: play out the rest of the last slice as low time
+                int32_t pending = (int32_t)(segmentStartTick - emittedTick);
+                if (pending > 0) {
+                    emittedTick += emitLow(buffer, (uint32_t)pending);
+                }
+                break;
+            }
+            haveSegment = true;
+            stepIndex = 0;
+        }
+
+        if (stepIndex >= segment.steps) {
+            segmentStartTick += segment.durationUs * PULSE_TICKS_PER_US;
+            haveSegment = false;
+            continue;
+        }
+
+        // One direction per buffer
+        if (buffer.direction != 0 && buffer.direction != segment.direction) {
+            break;
+        }
+
+        // Same step times as the segment walker: step k at k * interval
+        uint32_t stepTick = segmentStartTick +
+                            (uint32_t)(stepIndex + 1) * segment.intervalUs * PULSE_TICKS_PER_US;
+        int32_t gap = (int32_t)(stepTick - emittedTick);
+        if (gap < 1) {
+            gap = 1;  // Pulse longer than the step interval: this step slips
+        }
+
+        // Low time that does not fit in the step item goes into fillers
+        uint32_t fillerTicks = 0;
+        if ((uint32_t)gap > PULSE_MAX_DURATION) {
+            fillerTicks = gap - PULSE_MAX_DURATION;
+            if (fillerTicks == 1) {
+                fillerTicks = 2;
+            }
+        }
+
+        int needed = 1;
+        if (fillerTicks > 0) {
+            needed += (fillerTicks + 2 * PULSE_MAX_DURATION - 1) / (2 * PULSE_MAX_DURATION) + 1;
+        }
+        if (buffer.count + needed > PULSE_BUFFER_ITEMS) {
+            if (buffer.count == 0) {
+                // Gap longer than a whole buffer of fillers: play what fits
+                // and carry the rest, or the empty buffer would end the train
+                emittedTick += emitLow(buffer, fillerTicks);
+            }
+            break;  // Continue in the next buffer
+        }
+
+        uint32_t low = gap - emitLow(buffer, fillerTicks);
+        setItem(buffer.items[buffer.count++], low, false, pulseTicks, true);
+
+        emittedTick += gap + pulseTicks;
+        buffer.direction = segment.direction;
+        stepIndex++;
+    }
+
+    return buffer.count;
+}
+
+int PulseTrainCompiler::decode(const PulseBuffer& buffer, uint32_t& clockTicks,
+                               uint32_t* edges, int maxEdges) {
+    int found = 0;
+    bool previous = false;
+
+    for (int i = 0; i < buffer.count; i++) {
+        const PulseItem& item = buffer.items[i];
+        uint32_t durations[2] = { item.duration0, item.duration1 };
+        bool levels[2] = { item.level0 != 0, item.level1 != 0 };
+
+        for (int h = 0; h < 2; h++) {
+            if (durations[h] == 0) {
+                return found;  // End marker
+            }
+            if (levels[h] && !previous && found < maxEdges) {
+                edges[found++] = clockTicks;
+            }
+            clockTicks += durations[h];
+            previous = levels[h];
+        }
+    }
+    return found;
+}
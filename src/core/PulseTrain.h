@@ -0,0 +1,126 @@
+#ifndef PULSE_TRAIN_H
+#define PULSE_TRAIN_H
+
+#include "StepSegment.h"
+#include "../Config.h"
+#include <stdint.h>
+
+/**
+ * @file PulseTrain.h
+ * @brief Compiles step schedules into run-length (duration, level) items
+ *
+ * The items use the layout of the ESP32 RMT peripheral (rmt_item32_t),
+ * so a buffer can be copied to RMT memory as is and the STEP pulses are
+ * then timed by hardware instead of by update() calls. Each step becomes
+ * one item: the low time before the step, then the high pulse. Gaps
+ * longer than one item can hold are split into all-low filler items,
+ * over several buffers if need be.
+ *
+ * Two buffers are used alternately: while the hardware plays one, the
+ * other is compiled. The schedule is pulled through a refill callback,
+ * so any source of StepSegments can feed the compiler.
+ *
+ * Pure logic with no hardware dependencies, testable on the host with
+ * decode().
+ */
+
+#define PULSE_MAX_DURATION 32767  // Largest duration of one item half (15 bits)
+
+// One RMT item: two (duration, level) halves, durations in ticks
+struct PulseItem {
+    uint32_t duration0 : 15;
+    uint32_t level0 : 1;
+    uint32_t duration1 : 15;
+    uint32_t level1 : 1;
+};
+
+// A block of items sharing one DIR level
+struct PulseBuffer {
+    PulseItem items[PULSE_BUFFER_ITEMS];
+    int count;          // Items in use
+    int8_t direction;   // DIR to set before playing (0 if the buffer has no steps)
+
+    PulseBuffer() : count(0), direction(0) {}
+};
+
+class PulseTrainCompiler {
+public:
+    /**
+     * @brief Refill callback: provide the next slice of the step schedule
+     * @return false if no slice is available right now
+     */
+    typedef bool (*RefillCallback)(StepSegment& segment, void* context);
+
+    /**
+     * @brief Refill callback reading from a StepSegmentBuffer (context)
+     */
+    static bool fromSegmentBuffer(StepSegment& segment, void* context);
+
+    /**
+     * @param refill Source of step segments
+     * @param context Passed to refill
+     * @param pulseTicks STEP high time in ticks
+     */
+    PulseTrainCompiler(RefillCallback refill, void* context,
+                       uint16_t pulseTicks = STEP_PULSE_WIDTH_US * PULSE_TICKS_PER_US);
+
+    /**
+     * @brief Start a new train and compile both buffers
+     * The schedule starts at tick 0 of the first buffer.
+     */
+    void begin();
+
+    /**
+     * @brief Buffer to play now
+     */
+    const PulseBuffer& current() const;
+
+    /**
+     * @brief Called when the hardware has finished current()
+     * Refills that buffer with the next part of the schedule and makes the
+     * other one current.
+     * @return false if the train is finished (nothing left to play)
+     */
+    bool bufferDone();
+
+    /**
+     * @brief Compile as much of the schedule as fits into buffer
+     * A buffer ends early when the direction changes, so DIR can be set
+     * between buffers. Once the source runs dry, the time left in its
+     * last slice is emitted as low time.
+     * @return Number of items written
+     */
+    int fill(PulseBuffer& buffer);
+
+    /**
+     * @brief Decode a buffer back into step (rising edge) times
+     * @param buffer Buffer to decode
+     * @param clockTicks Time at the start of the buffer; advanced past it
+     * @param edges Output rising edge times in ticks
+     * @param maxEdges Capacity of edges
+     * @return Number of rising edges found
+     */
+    static int decode(const PulseBuffer& buffer, uint32_t& clockTicks,
+                      uint32_t* edges, int maxEdges);
+
+private:
+    RefillCallback refill;
+    void* context;
+    uint16_t pulseTicks;
+
+    PulseBuffer buffers[2];
+    int active;                 // Index of current()
+
+    StepSegment segment;        // Slice being compiled
+    bool haveSegment;           // segment is valid
+    uint16_t stepIndex;         // Steps of segment already emitted
+    uint32_t segmentStartTick;  // Schedule time at which segment starts
+    uint32_t emittedTick;       // Schedule time covered by emitted items
+
+    static void setItem(PulseItem& item, uint32_t d0, bool l0, uint32_t d1, bool l1);
+
+    // Emit low time of 'ticks' as filler items; returns ticks emitted
+    uint32_t emitLow(PulseBuffer& buffer, uint32_t ticks);
+};
+
+#endif // PULSE_TRAIN_H
@@ -0,0 +1,65 @@
+#ifndef SEQLOCK_H
+#define SEQLOCK_H
+
+#include <stdint.h>
+#include <atomic>
+
+/**
+ * @file Seqlock.h
+ * @brief Single-writer snapshot that readers copy without locking
+ *
+ * The writer bumps a sequence counter to an odd value, updates the data
+ * and bumps it back to even. A reader copies the data between two reads
+ * of the counter and retries if the writer was active meanwhile, so it
+ * always gets a consistent copy. The writer never waits, which makes this
+ * safe to publish from the real-time motion task: readers on the other
+ * core pay the retries, not the writer.
+ *
+ * Only one task may call write(). T must be trivially copyable and small
+ * (a reader retries for as long as it is being overwritten).
+ */
+
+template <typename T>
+class Seqlock {
+private:
+    std::atomic<uint32_t> sequence;
+    T value;
+
+public:
+    Seqlock() : sequence(0), value() {}
+
+    /**
+     * @brief Publish a new value (single writer only)
+     */
+    void write(const T& newValue) {
+        uint32_t seq = sequence.load(std::memory_order_relaxed);
+        sequence.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        value = newValue;
+        sequence.store(seq + 2, std::memory_order_release);
+    }
+
+    /**
+     * @brief Copy the latest complete value
+     */
+    T read() const {
+        T copy;
+        uint32_t before, after;
+        do {
+            before = sequence.load(std::memory_order_acquire);
+            copy = value;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            after = sequence.load(std::memory_order_relaxed);
+        } while ((before & 1) != 0 || before != after);
+        return copy;
+    }
+
+    /**
+     * @brief Number of writes so far (changes whenever the value may have)
+     */
+    uint32_t version() const {
+        return sequence.load(std::memory_order_acquire) >> 1;
+    }
+};
+
+#endif // SEQLOCK_H
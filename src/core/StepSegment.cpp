@@ -0,0 +1,51 @@
+#include "StepSegment.h"
+#include <math.h>
+
+int StepSegmentPreparer::prepare(const HermiteSegment& segment, float stepsPerDegree,
+                                 long startStep, StepSegmentBuffer& buffer) {
+    int room = buffer.available();
+    if (room <= 0) {
+        return 0;
+    }
+
+    uint32_t totalUs = (uint32_t)(segment.duration * 1000000.0f);
+    if (totalUs == 0) {
+        totalUs = 1;
+    }
+
+    // Number of slices: one per STEP_SEGMENT_SLICE_US, capped by free space
+    int sliceCount = (int)((totalUs + STEP_SEGMENT_SLICE_US - 1) / STEP_SEGMENT_SLICE_US);
+    if (sliceCount > room) {
+        sliceCount = room;
+    }
+    if (sliceCount < 1) {
+        sliceCount = 1;
+    }
+
+    long previousStep = startStep;
+    uint32_t previousUs = 0;
+    int pushed = 0;
+
+    for (int i = 1; i <= sliceCount; i++) {
+        uint32_t endUs = (uint32_t)(((uint64_t)totalUs * i) / sliceCount);
+        float t = (i == sliceCount) ? segment.duration : endUs / 1000000.0f;
+        long endStep = lroundf(segment.position(t) * stepsPerDegree);
+
+        long delta = endStep - previousStep;
+        StepSegment slice;
+        slice.durationUs = endUs - previousUs;
+        slice.direction = (delta < 0) ? -1 : 1;
+        slice.steps = (uint16_t)(delta < 0 ? -delta : delta);
+        slice.intervalUs = slice.steps > 0 ? slice.durationUs / slice.steps : 0;
+
+        if (!buffer.push(slice)) {
+            break;
+        }
+        pushed++;
+
+        previousStep = endStep;
+        previousUs = endUs;
+    }
+
+    return pushed;
+}
@@ -0,0 +1,100 @@
+#ifndef STEP_SEGMENT_H
+#define STEP_SEGMENT_H
+
+#include "Hermite.h"
+#include "../Config.h"
+#include <stdint.h>
+#include <atomic>
+
+/**
+ * @file StepSegment.h
+ * @brief Step segment preparation and buffering (GRBL-style)
+ *
+ * A planned joint motion is chopped into short time slices, and for each
+ * slice the step count and step interval are computed once, up front.
+ * The step generator then only walks these integer segments, so no
+ * floating-point math runs on the per-step path.
+ */
+
+// One time slice of a joint motion
+struct StepSegment {
+    uint32_t durationUs;   // Length of the slice in microseconds
+    uint32_t intervalUs;   // Time between steps (0 if no steps)
+    uint16_t steps;        // Number of steps in the slice
+    int8_t direction;      // +1 or -1
+
+    StepSegment() : durationUs(0), intervalUs(0), steps(0), direction(1) {}
+};
+
+/**
+ * Fixed-size single-producer / single-consumer ring of step segments.
+ * The producer (segment preparation) and the consumer (step generator)
+ * may run in different contexts without locking.
+ */
+class StepSegmentBuffer {
+private:
+    StepSegment segments[STEP_SEGMENT_BUFFER_SIZE];
+    std::atomic<uint16_t> head;  // Next slot to write (producer)
+    std::atomic<uint16_t> tail;  // Next slot to read (consumer)
+
+public:
+    StepSegmentBuffer() : head(0), tail(0) {}
+
+    bool push(const StepSegment& segment) {
+        uint16_t h = head.load(std::memory_order_relaxed);
+        uint16_t next = (h + 1) % STEP_SEGMENT_BUFFER_SIZE;
+        if (next == tail.load(std::memory_order_acquire)) {
+            return false;  // Full
+        }
+        segments[h] = segment;
+        head.store(next, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(StepSegment& segment) {
+        uint16_t t = tail.load(std::memory_order_relaxed);
+        if (t == head.load(std::memory_order_acquire)) {
+            return false;  // Empty
+        }
+        segment = segments[t];
+        tail.store((t + 1) % STEP_SEGMENT_BUFFER_SIZE, std::memory_order_release);
+        return true;
+    }
+
+    bool isEmpty() const {
+        return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+    }
+
+    int available() const {
+        int used = (int)head.load(std::memory_order_acquire) -
+                   (int)tail.load(std::memory_order_acquire);
+        if (used < 0) used += STEP_SEGMENT_BUFFER_SIZE;
+        return STEP_SEGMENT_BUFFER_SIZE - 1 - used;
+    }
+
+    // Only safe while the consumer is not running
+    void clear() {
+        tail.store(head.load(std::memory_order_acquire), std::memory_order_release);
+    }
+};
+
+class StepSegmentPreparer {
+public:
+    /**
+     * @brief Chop a joint motion into step segments
+     * Slices are STEP_SEGMENT_SLICE_US long, or longer if the buffer does
+     * not have room for that many. Step counts are taken from the rounded
+     * step position at each slice boundary, so rounding never accumulates
+     * and the last slice always ends exactly on the target step.
+     *
+     * @param segment Joint motion in degrees over segment.duration seconds
+     * @param stepsPerDegree Conversion from degrees to steps
+     * @param startStep Step position at the start of the motion
+     * @param buffer Buffer to append the slices to
+     * @return Number of slices appended
+     */
+    static int prepare(const HermiteSegment& segment, float stepsPerDegree,
+                       long startStep, StepSegmentBuffer& buffer);
+};
+
+#endif // STEP_SEGMENT_H
@@ -0,0 +1,158 @@
+#include "StepTrace.h"
+#include "../hardware/StepTicker.h"
+#include <string.h>
+
+#if STEP_TRACE_ENABLED
+static TraceEvent traceEvents[STEP_TRACE_EVENTS];
+StepTrace stepTrace(traceEvents, STEP_TRACE_EVENTS);
+#endif
+
+StepTrace::StepTrace(TraceEvent* storage, uint32_t capacity)
+    : events(storage), capacity(capacity),
+      head(0), clearedAt(0), frozen(false),
+      dumpFirst(0), dumpCount(0) {
+}
+
+void STEP_ISR_ATTR StepTrace::record(uint32_t timeUs, uint8_t type, uint8_t channel, long value) {
+    if (frozen.load()) {
+        return;
+    }
+    if (value > INT16_MAX) value = INT16_MAX;
+    if (value < INT16_MIN) value = INT16_MIN;
+
+    // One writer at a time: the slot is filled before the index publishes it
+    uint32_t index = head.load(std::memory_order_relaxed);
+    events[index % capacity] = TraceEvent(timeUs, type, channel, (int16_t)value);
+    head.store(index + 1);
+}
+
+void STEP_ISR_ATTR StepTrace::recordStep(uint8_t joint, bool forward, uint32_t timeUs) {
+    record(timeUs, TRACE_STEP, joint, forward ? 1 : -1);
+}
+
+void STEP_ISR_ATTR StepTrace::recordPosition(uint8_t joint, long steps, uint32_t timeUs) {
+    // The step count keeps counting across turns
+    const long turn = STEPS_PER_REVOLUTION * MICROSTEPS;
+    steps %= turn;
+    if (steps < 0) steps += turn;
+    record(timeUs, TRACE_POSITION, joint, steps);
+}
+
+void StepTrace::recordSample(const Point2D& position, bool firstOfMove, uint32_t timeUs) {
+    float x = position.x * 100.0f;
+    float y = position.y * 100.0f;
+    record(timeUs, TRACE_SAMPLE_X, firstOfMove ? 1 : 0, (long)(x < 0 ? x - 0.5f : x + 0.5f));
+    record(timeUs, TRACE_SAMPLE_Y, 0, (long)(y < 0 ? y - 0.5f : y + 0.5f));
+}
+
+bool StepTrace::freeze() {
+    if (frozen.exchange(true)) {
+        return false;
+    }
+
+    // The writer may have checked the flag just before it was set and
+    // still be filling slot head % capacity, which holds the oldest
+    // event: leave that one out
+    uint32_t end = head.load();
+    uint32_t available = end - clearedAt.load();
+    uint32_t limit = capacity > 0 ? capacity - 1 : 0;
+    dumpCount = available < limit ? available : limit;
+    dumpFirst = end - dumpCount;
+    return true;
+}
+
+void StepTrace::resume() {
+    frozen = false;
+}
+
+void StepTrace::clear() {
+    clearedAt = head.load();
+}
+
+size_t StepTrace::dumpSize() const {
+    return TRACE_HEADER_SIZE + (size_t)dumpCount * TRACE_EVENT_SIZE;
+}
+
+static void put16(uint8_t* out, uint16_t value) {
+    out[0] = (uint8_t)value;
+    out[1] = (uint8_t)(value >> 8);
+}
+
+static void put32(uint8_t* out, uint32_t value) {
+    put16(out, (uint16_t)value);
+    put16(out + 2, (uint16_t)(value >> 16));
+}
+
+static uint16_t get16(const uint8_t* in) {
+    return (uint16_t)(in[0] | (in[1] << 8));
+}
+
+static uint32_t get32(const uint8_t* in) {
+    return get16(in) | ((uint32_t)get16(in + 2) << 16);
+}
+
+void StepTrace::writeHeader(uint8_t* out) const {
+    memcpy(out, "STRC", 4);
+    out[4] = TRACE_VERSION;
+    out[5] = (uint8_t)TRACE_EVENT_SIZE;
+    put16(out + 6, (uint16_t)(STEPS_PER_REVOLUTION * MICROSTEPS));
+    put32(out + 8, dumpCount);
+    put16(out + 12, (uint16_t)(ARM_LENGTH_1 * 10.0f + 0.5f));
+    put16(out + 14, (uint16_t)(ARM_LENGTH_2 * 10.0f + 0.5f));
+}
+
+size_t StepTrace::read(uint8_t* out, size_t maxLen, size_t index) const {
+    size_t total = dumpSize();
+    size_t copied = 0;
+
+    // Encode one header or event at a time and copy the requested part
+    while (copied < maxLen && index < total) {
+        uint8_t chunk[TRACE_HEADER_SIZE];
+        size_t chunkStart;
+        size_t chunkLength;
+
+        if (index < TRACE_HEADER_SIZE) {
+            writeHeader(chunk);
+            chunkStart = 0;
+            chunkLength = TRACE_HEADER_SIZE;
+        } else {
+            uint32_t n = (uint32_t)((index - TRACE_HEADER_SIZE) / TRACE_EVENT_SIZE);
+            const TraceEvent& event = events[(dumpFirst + n) % capacity];
+            put32(chunk, event.timeUs);
+            chunk[4] = event.type;
+            chunk[5] = event.channel;
+            put16(chunk + 6, (uint16_t)event.value);
+            chunkStart = TRACE_HEADER_SIZE + (size_t)n * TRACE_EVENT_SIZE;
+            chunkLength = TRACE_EVENT_SIZE;
+        }
+
+        size_t offset = index - chunkStart;
+        size_t length = chunkLength - offset;
+        if (length > maxLen - copied) {
+            length = maxLen - copied;
+        }
+        memcpy(out + copied, chunk + offset, length);
+        copied += length;
+        index += length;
+    }
+    return copied;
+}
+
+bool StepTrace::parseHeader(const uint8_t* in, size_t length, TraceHeader& header) {
+    if (length < TRACE_HEADER_SIZE || memcmp(in, "STRC", 4) != 0) {
+        return false;
+    }
+    if (in[4] != TRACE_VERSION || in[5] != TRACE_EVENT_SIZE) {
+        return false;
+    }
+    header.version = in[4];
+    header.stepsPerRevolution = get16(in + 6);
+    header.eventCount = get32(in + 8);
+    header.armLength1 = get16(in + 12) / 10.0f;
+    header.armLength2 = get16(in + 14) / 10.0f;
+    return true;
+}
+
+TraceEvent StepTrace::decodeEvent(const uint8_t* in) {
+    return TraceEvent(get32(in), in[4], in[5], (int16_t)get16(in + 6));
+}
@@ -0,0 +1,179 @@
+#ifndef STEP_TRACE_H
+#define STEP_TRACE_H
+
+#include "../Config.h"
+#include "Types.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+
+/**
+ * @file StepTrace.h
+ * @brief Ring buffer of step pulses and planner samples for offline analysis
+ *
+ * The motion layer records 8-byte events:
+ * - STEP: one STEP pulse of a joint, with its direction
+ * - POSITION: a joint's step count within one turn, every STEP_TRACE_KEYFRAME_US and
+ *   whenever it is redefined (homing), so a trace can be replayed from
+ *   any point even after the oldest events were overwritten
+ * - SAMPLE_X, SAMPLE_Y: the position of a planner sample, when the
+ *   motion task hands it to the executor
+ *
+ * Recording is two loads and two stores; once the buffer is full the
+ * oldest events are overwritten. The writers the step interrupt calls
+ * sit in IRAM with the rest of the step path. Writers must not overlap:
+ * the step interrupt and the motion task take turns under StepTicker's
+ * lock.
+ *
+ * Each step is one event, so the buffer covers STEP_TRACE_EVENTS /
+ * (steps per second of both joints): about 0.3 s at full speed with the
+ * default size, and proportionally longer at lower speeds.
+ *
+ * A reader freezes the buffer, copies the dump out with read() (the
+ * /trace download) and resumes recording. Events that happen while the
+ * buffer is frozen are not recorded. tools/steptrace.cpp rebuilds the
+ * trajectories from a dump.
+ *
+ * Dump layout, little-endian:
+ *
+ *     offset  size
+ *     0       4     "STRC"
+ *     4       1     version (TRACE_VERSION)
+ *     5       1     event size (8)
+ *     6       2     steps per revolution (microsteps included)
+ *     8       4     number of events
+ *     12      2     arm length 1 (0.1 mm)
+ *     14      2     arm length 2 (0.1 mm)
+ *     16            events, oldest first:
+ *                   time (4, µs), type (1), channel (1), value (2, signed)
+ */
+
+enum TraceEventType {
+    TRACE_STEP = 1,       // channel: joint; value: +1 or -1
+    TRACE_POSITION = 2,   // channel: joint; value: step count within one turn
+    TRACE_SAMPLE_X = 3,   // channel: 1 for the first sample of a move; value: 0.01 mm
+    TRACE_SAMPLE_Y = 4    // value: 0.01 mm
+};
+
+struct TraceEvent {
+    uint32_t timeUs;
+    uint8_t type;
+    uint8_t channel;
+    int16_t value;
+
+    TraceEvent() : timeUs(0), type(0), channel(0), value(0) {}
+    TraceEvent(uint32_t time, uint8_t type, uint8_t channel, int16_t value)
+        : timeUs(time), type(type), channel(channel), value(value) {}
+};
+
+/**
+ * @brief Dump header, as decoded by StepTrace::parseHeader()
+ */
+struct TraceHeader {
+    uint8_t version;
+    uint16_t stepsPerRevolution;
+    uint32_t eventCount;
+    float armLength1;   // mm
+    float armLength2;   // mm
+};
+
+static const uint8_t TRACE_VERSION = 1;
+static const size_t TRACE_HEADER_SIZE = 16;
+static const size_t TRACE_EVENT_SIZE = 8;
+
+class StepTrace {
+public:
+    /**
+     * @param storage Event buffer (must outlive the trace)
+     * @param capacity Events in the buffer
+     */
+    StepTrace(TraceEvent* storage, uint32_t capacity);
+
+    // --- Writers (step interrupt, motion task) ---
+
+    void recordStep(uint8_t joint, bool forward, uint32_t timeUs);
+
+    /**
+     * @brief Record a joint's step count, wrapped to [0, steps per turn)
+     */
+    void recordPosition(uint8_t joint, long steps, uint32_t timeUs);
+
+    /**
+     * @brief Record a planner sample (coordinates clamped to ±327 mm)
+     * @param firstOfMove The sample starts a new move
+     */
+    void recordSample(const Point2D& position, bool firstOfMove, uint32_t timeUs);
+
+    // --- Readers (any task) ---
+
+    /**
+     * @brief Stop recording and fix the events of the dump
+     * @return false if the buffer is already frozen (another download)
+     */
+    bool freeze();
+
+    /**
+     * @brief Resume recording after freeze()
+     */
+    void resume();
+
+    bool isFrozen() const { return frozen.load(); }
+
+    /**
+     * @brief Leave the events recorded so far out of later dumps
+     */
+    void clear();
+
+    /**
+     * @brief Size in bytes of the dump fixed by freeze()
+     */
+    size_t dumpSize() const;
+
+    /**
+     * @brief Copy part of the dump (header, then events oldest first)
+     * @param index Byte offset in the dump
+     * @return Bytes copied, 0 past the end
+     */
+    size_t read(uint8_t* out, size_t maxLen, size_t index) const;
+
+    /**
+     * @brief Events recorded since power-up (wraps)
+     */
+    uint32_t recorded() const { return head.load(); }
+
+    uint32_t getCapacity() const { return capacity; }
+
+    // --- Decoding (offline tool, tests) ---
+
+    /**
+     * @brief Decode a dump header
+     * @return false if the magic, version or event size is wrong
+     */
+    static bool parseHeader(const uint8_t* in, size_t length, TraceHeader& header);
+
+    static TraceEvent decodeEvent(const uint8_t* in);
+
+private:
+    TraceEvent* events;
+    uint32_t capacity;
+
+    std::atomic<uint32_t> head;        // Events recorded (next slot: head % capacity)
+    std::atomic<uint32_t> clearedAt;   // head when clear() was last called
+    std::atomic<bool> frozen;
+
+    // Range of the dump, set by freeze()
+    uint32_t dumpFirst;
+    uint32_t dumpCount;
+
+    void record(uint32_t timeUs, uint8_t type, uint8_t channel, long value);
+    void writeHeader(uint8_t* out) const;
+};
+
+#if STEP_TRACE_ENABLED
+
+// The firmware's trace (StepTrace.cpp)
+extern StepTrace stepTrace;
+
+#endif
+
+#endif // STEP_TRACE_H
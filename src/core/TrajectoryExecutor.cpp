@@ -0,0 +1,115 @@
+#include "TrajectoryExecutor.h"
+
+// Interpolate between two angles in degrees along the shortest arc,
+// keeping the result in the 0-360 range used by the motors.
+static float lerpAngle(float a, float b, float f) {
+    float diff = b - a;
+    if (diff > 180.0f) {
+        diff -= 360.0f;
+    } else if (diff < -180.0f) {
+        diff += 360.0f;
+    }
+
+    float angle = a + f * diff;
+    if (angle < 0.0f) angle += 360.0f;
+    if (angle >= 360.0f) angle -= 360.0f;
+    return angle;
+}
+
+TrajectoryExecutor::TrajectoryExecutor()
+    : hasTarget(false), underrun(false), segmentPending(false), underruns(0),
+      segmentStartUs(0), segmentDurationUs(0) {
+}
+
+void TrajectoryExecutor::reset() {
+    hasTarget = false;
+    underrun = false;
+    segmentPending = false;
+    segmentStartUs = 0;
+    segmentDurationUs = 0;
+}
+
+bool TrajectoryExecutor::needsSample(uint32_t nowUs) const {
+    if (!hasTarget) {
+        return true;
+    }
+    return elapsed(nowUs, segmentStartUs + segmentDurationUs) >= 0;
+}
+
+void TrajectoryExecutor::push(const TrajectorySample& sample, uint32_t nowUs) {
+    if (!hasTarget) {
+        // First sample: nothing to interpolate from, go there directly
+        from = sample;
+        to = sample;
+        segmentStartUs = nowUs;
+        segmentDurationUs = 0;
+        hasTarget = true;
+        underrun = false;
+        segmentPending = true;
+        return;
+    }
+
+    // Chain segments end to end so loop jitter does not accumulate; only
+    // re-anchor at the current time after running out of samples.
+    uint32_t segmentEndUs = segmentStartUs + segmentDurationUs;
+    segmentStartUs = underrun ? nowUs : segmentEndUs;
+
+    float dt = sample.t - to.t;
+    if (dt < 0.0f) {
+        dt = 0.0f;  // New move: its first sample starts where we are
+    } else if (underrun && dt > 0.0f) {
+        underruns++;  // Same move, but the motion stalled waiting for this
+    }
+
+    from = to;
+    to = sample;
+    segmentDurationUs = (uint32_t)(dt * 1000000.0f);
+    underrun = false;
+    segmentPending = true;
+}
+
+bool TrajectoryExecutor::sample(uint32_t nowUs, JointAngles& angles, Point2D& position) {
+    if (!hasTarget) {
+        return false;
+    }
+
+    int32_t sinceStart = elapsed(nowUs, segmentStartUs);
+
+    if (sinceStart >= (int32_t)segmentDurationUs) {
+        // End of the segment and no further sample was pushed: hold here
+        angles = to.angles;
+        position = to.position;
+        underrun = true;
+        return true;
+    }
+
+    if (sinceStart <= 0) {
+        angles = from.angles;
+        position = from.position;
+        return true;
+    }
+
+    float f = (float)sinceStart / (float)segmentDurationUs;
+    angles.theta1 = lerpAngle(from.angles.theta1, to.angles.theta1, f);
+    angles.theta2 = lerpAngle(from.angles.theta2, to.angles.theta2, f);
+    position.x = from.position.x + f * (to.position.x - from.position.x);
+    position.y = from.position.y + f * (to.position.y - from.position.y);
+    return true;
+}
+
+bool TrajectoryExecutor::takeSegment(uint32_t nowUs, TrajectorySample& target,
+                                     float& duration) {
+    if (!segmentPending) {
+        return false;
+    }
+    segmentPending = false;
+
+    int32_t remaining = elapsed(segmentStartUs + segmentDurationUs, nowUs);
+    target = to;
+    duration = remaining > 0 ? remaining / 1000000.0f : 0.0f;
+    return true;
+}
+
+bool TrajectoryExecutor::isActive() const {
+    return hasTarget && !underrun;
+}
@@ -0,0 +1,99 @@
+#ifndef TRAJECTORY_EXECUTOR_H
+#define TRAJECTORY_EXECUTOR_H
+
+#include "Types.h"
+#include <stdint.h>
+
+/**
+ * @file TrajectoryExecutor.h
+ * @brief Executes time-stamped trajectory samples against a clock
+ *
+ * The executor keeps the segment between two TrajectorySamples and
+ * interpolates the joint targets for the current clock value, so the
+ * motion speed no longer depends on the control loop running exactly
+ * once per sample. Missed or late ticks are caught up; samples can be
+ * sent more sparsely than the loop rate.
+ *
+ * Pure logic with no hardware dependencies: the caller passes the time.
+ */
+
+class TrajectoryExecutor {
+private:
+    TrajectorySample from;    // Start of the current segment
+    TrajectorySample to;      // End of the current segment
+    bool hasTarget;           // At least one sample received
+    bool underrun;            // Ran past the last sample without a new one
+    bool segmentPending;      // New segment not yet taken by takeSegment()
+    uint32_t underruns;       // Moves that ran out of samples and resumed late
+
+    uint32_t segmentStartUs;     // Clock time at which 'from' is reached
+    uint32_t segmentDurationUs;  // Time from 'from' to 'to'
+
+    // Signed difference (a - b) that survives micros() wrap-around
+    static int32_t elapsed(uint32_t a, uint32_t b) {
+        return (int32_t)(a - b);
+    }
+
+public:
+    TrajectoryExecutor();
+
+    /**
+     * @brief Forget all samples (e.g. after an emergency stop)
+     */
+    void reset();
+
+    /**
+     * @brief Check if the next sample is needed to continue at nowUs
+     * Feed samples with push() while this returns true.
+     * @param nowUs Current clock value (microseconds)
+     * @return true if the current segment is finished (or none exists)
+     */
+    bool needsSample(uint32_t nowUs) const;
+
+    /**
+     * @brief Append the next trajectory sample
+     * A sample whose time is not after the previous one starts a new move.
+     * After an underrun the timeline is re-anchored at nowUs, so a late
+     * sample slows the motion down instead of making it jump.
+     *
+     * @param sample Next sample of the trajectory
+     * @param nowUs Current clock value (microseconds)
+     */
+    void push(const TrajectorySample& sample, uint32_t nowUs);
+
+    /**
+     * @brief Interpolate the trajectory at nowUs
+     * @param nowUs Current clock value (microseconds)
+     * @param angles Output joint targets (degrees)
+     * @param position Output Cartesian position (mm)
+     * @return true if a target is available, false if no sample was received
+     */
+    bool sample(uint32_t nowUs, JointAngles& angles, Point2D& position);
+
+    /**
+     * @brief Get the segment started by the latest push(), once
+     * Used to hand whole PVT segments to the motors instead of sending
+     * interpolated targets every tick.
+     *
+     * @param nowUs Current clock value (microseconds)
+     * @param target Output sample at the end of the segment
+     * @param duration Output time left until the target is due (seconds)
+     * @return true if a new segment started since the last call
+     */
+    bool takeSegment(uint32_t nowUs, TrajectorySample& target, float& duration);
+
+    /**
+     * @brief Check if the executor is still following a trajectory
+     * @return true until the last received sample has been reached
+     */
+    bool isActive() const;
+    
+    /**
+     * @brief Number of times a move ran out of samples before it ended
+     * Counted when the late sample arrives (a sample starting a new move
+     * after the previous one ended is not an underrun). Kept by reset().
+     */
+    uint32_t getUnderruns() const { return underruns; }
+};
+
+#endif // TRAJECTORY_EXECUTOR_H
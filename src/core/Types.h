@@ -6,6 +6,9 @@
  * @brief Common data structures for the SCARA robot controller
  */
 
+#include <stdint.h>
+#include <math.h>
+
 // 2D Cartesian point
 struct Point2D {
     float x;
@@ -28,12 +31,64 @@ struct JointAngles {
     JointAngles(float t1, float t2) : theta1(t1), theta2(t2) {}
 };
 
+/**
+ * @brief Signed difference between two angles in degrees, along the shortest arc
+ * @return to - from, brought into [-180, 180)
+ */
+inline float angleDelta(float from, float to) {
+    float diff = fmodf(to - from, 360.0f);
+    if (diff >= 180.0f) diff -= 360.0f;
+    if (diff < -180.0f) diff += 360.0f;
+    return diff;
+}
+
+// Time-stamped joint-space trajectory sample
+// Produced by the planner task, executed against the clock by
+// TrajectoryExecutor on the motion task.
+struct TrajectorySample {
+    float t;                // Time from the start of the move (seconds)
+    JointAngles angles;     // Joint targets (degrees)
+    JointAngles velocity;   // Joint velocities (degrees/s), if hasVelocity
+    Point2D position;       // Cartesian position of the sample (for status)
+    bool hasVelocity;       // true if velocity is valid
+    
+    TrajectorySample() : t(0.0f), hasVelocity(false) {}
+    TrajectorySample(float time, const JointAngles& a, const Point2D& p)
+        : t(time), angles(a), position(p), hasVelocity(false) {}
+};
+
+// Running statistics for a latency measured in microseconds
+struct LatencyStats {
+    uint32_t lastUs;    // Most recent sample
+    uint32_t minUs;     // Smallest sample seen
+    uint32_t maxUs;     // Largest sample seen
+    uint32_t count;     // Number of samples
+    uint64_t totalUs;   // Sum of all samples (for the average)
+    
+    LatencyStats() : lastUs(0), minUs(0), maxUs(0), count(0), totalUs(0) {}
+    
+    void record(uint32_t us) {
+        lastUs = us;
+        if (count == 0 || us < minUs) minUs = us;
+        if (us > maxUs) maxUs = us;
+        totalUs += us;
+        count++;
+    }
+    
+    uint32_t averageUs() const {
+        return count > 0 ? (uint32_t)(totalUs / count) : 0;
+    }
+};
+
 // Robot state information
 struct RobotState {
     Point2D currentPosition;    // Current Cartesian position
     JointAngles currentAngles;  // Current joint angles
     bool isMoving;               // Movement status
     bool isHomed;                // Homing status
+    // Planning start -> first sample executed, for moves planned while the
+    // motion queue was empty (time spent in commandQueue is not included)
+    LatencyStats firstStepLatency;
     
     RobotState() : currentPosition(0, 0), currentAngles(0, 0), 
                    isMoving(false), isHomed(false) {}
@@ -46,16 +101,43 @@ struct Command {
         MOVE_RELATIVE,// Move relative to current position
         HOME,         // Home the robot
         SET_SPEED,    // Set movement speed
-        STOP          // Emergency stop
+        STOP,         // Emergency stop
+        PATH,         // Follow vertices uploaded to the shared PathBuffer
+        ARC_CW,       // Clockwise arc to target around center (G2)
+        ARC_CCW,      // Counter-clockwise arc to target around center (G3)
+        DWELL         // Wait for the queued motion to finish, then pause
+    };
+    
+    // Axes of target given as offsets from the start of the move
+    enum Axis {
+        AXIS_X = 1 << 0,
+        AXIS_Y = 1 << 1
     };
     
     Type type;
-    Point2D target;  // Target position (for MOVE_TO, MOVE_RELATIVE)
-    float speed;     // Speed parameter (for SET_SPEED, MOVE_TO)
+    Point2D target;  // Target position (for MOVE_TO, MOVE_RELATIVE, ARC_*)
+    float speed;     // Speed parameter (for SET_SPEED, MOVE_TO, PATH, ARC_*)
+    uint16_t pathId;      // Upload the vertices belong to (for PATH)
+    uint16_t pathLength;  // Number of vertices (for PATH)
+    uint8_t relativeAxes; // Axis bits of target that are offsets (MOVE_TO, ARC_*)
+    Point2D center;       // Arc centre, as an offset from the start (for ARC_*)
+    float duration;       // Pause in seconds (for DWELL)
     
-    Command() : type(MOVE_TO), target(0, 0), speed(0.0f) {}
+    Command() : type(MOVE_TO), target(0, 0), speed(0.0f), pathId(0), pathLength(0),
+                relativeAxes(0), duration(0.0f) {}
     Command(Type t, Point2D pos, float spd = 0.0f) 
-        : type(t), target(pos), speed(spd) {}
+        : type(t), target(pos), speed(spd), pathId(0), pathLength(0), relativeAxes(0),
+          duration(0.0f) {}
+    
+    /**
+     * @brief Target of a move starting at start (the planner's position)
+     */
+    Point2D resolveTarget(const Point2D& start) const {
+        Point2D resolved = target;
+        if (relativeAxes & AXIS_X) resolved.x += start.x;
+        if (relativeAxes & AXIS_Y) resolved.y += start.y;
+        return resolved;
+    }
 };
 
 #endif // TYPES_H
@@ -0,0 +1,13 @@
+#include "GpioLimitSwitch.h"
+
+GpioLimitSwitch::GpioLimitSwitch(uint8_t pin, bool activeLow)
+    : pin(pin), activeLow(activeLow) {
+}
+
+void GpioLimitSwitch::init() {
+    pinMode(pin, activeLow ? INPUT_PULLUP : INPUT);
+}
+
+bool GpioLimitSwitch::isTriggered() {
+    return digitalRead(pin) == (activeLow ? LOW : HIGH);
+}
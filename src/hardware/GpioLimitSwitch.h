@@ -0,0 +1,32 @@
+#ifndef GPIO_LIMIT_SWITCH_H
+#define GPIO_LIMIT_SWITCH_H
+
+#include "ILimitSwitch.h"
+#include <Arduino.h>
+
+/**
+ * @file GpioLimitSwitch.h
+ * @brief Limit switch wired to a GPIO input
+ * 
+ * Active-low switches (closing to GND) use the internal pull-up.
+ */
+
+class GpioLimitSwitch final : public ILimitSwitch {
+private:
+    uint8_t pin;
+    bool activeLow;
+    
+public:
+    /**
+     * @brief Constructor
+     * @param pin GPIO pin of the switch
+     * @param activeLow true if the input reads LOW when pressed
+     */
+    GpioLimitSwitch(uint8_t pin, bool activeLow = true);
+    
+    // ILimitSwitch interface implementation
+    void init() override;
+    bool isTriggered() override;
+};
+
+#endif // GPIO_LIMIT_SWITCH_H
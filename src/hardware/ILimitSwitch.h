@@ -0,0 +1,31 @@
+#ifndef ILIMIT_SWITCH_H
+#define ILIMIT_SWITCH_H
+
+/**
+ * @file ILimitSwitch.h
+ * @brief Abstract base class (interface) for homing / limit switches
+ * 
+ * The homing sequence only sees this interface, so it runs the same
+ * against real GPIO inputs and against simulated switches on the host.
+ */
+
+class ILimitSwitch {
+public:
+    /**
+     * @brief Initialize the switch input
+     */
+    virtual void init() = 0;
+    
+    /**
+     * @brief Check if the switch is pressed
+     * @return true if the joint is on the switch
+     */
+    virtual bool isTriggered() = 0;
+    
+    /**
+     * @brief Virtual destructor for proper cleanup
+     */
+    virtual ~ILimitSwitch() = default;
+};
+
+#endif // ILIMIT_SWITCH_H
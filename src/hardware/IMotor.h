@@ -9,6 +9,8 @@
  * motor types (Stepper, Servo, etc.) through polymorphism.
  */
 
+#include <stdint.h>
+
 class IMotor {
 public:
     /**
@@ -25,10 +27,48 @@ public:
     
     /**
      * @brief Move to an absolute angle
+     * Like all the moves below, it takes the shortest way round: 359° to
+     * 1° is 2° forward across 0°.
      * @param angle Target angle in degrees (0-360)
      */
     virtual void moveToAngle(float angle) = 0;
     
+    /**
+     * @brief Move along a position-velocity-time (PVT) segment
+     * The motor follows a cubic Hermite curve from its current position
+     * and velocity to reach 'angle' with 'velocity' after 'duration'.
+     * Chaining PVT points gives continuous velocity at segment boundaries.
+     * 
+     * @param angle Target angle in degrees (0-360)
+     * @param velocity Joint velocity at the target in degrees/s
+     * @param duration Time to reach the target in seconds
+     */
+    virtual void moveToPVT(float angle, float velocity, float duration) = 0;
+    
+    /**
+     * @brief Move to an absolute angle, arriving after 'duration'
+     * The move comes to rest at the target. Joints started together with
+     * the same duration arrive together (see MotionController::moveJointsTo).
+     * 
+     * @param angle Target angle in degrees (0-360)
+     * @param duration Time to reach the target in seconds
+     */
+    virtual void moveToAngleIn(float angle, float duration) = 0;
+    
+    /**
+     * @brief Shortest duration for moveToAngleIn() within the motor's limits
+     * @param angle Target angle in degrees (0-360)
+     * @return Duration in seconds (0 if already there)
+     */
+    virtual float getMinMoveTime(float angle) = 0;
+    
+    /**
+     * @brief Redefine the current position without moving (e.g. after homing)
+     * Any move in progress is stopped.
+     * @param angle Angle in degrees (0-360) to assign to the current position
+     */
+    virtual void setCurrentAngle(float angle) = 0;
+    
     /**
      * @brief Get the current motor angle
      * @return Current angle in degrees
@@ -69,6 +109,19 @@ public:
      */
     virtual void update() = 0;
     
+    /**
+     * @brief Number of steps issued since power-up (for metrics)
+     * @return Step pulses, wrapping at 2^32; 0 for motors without steps
+     */
+    virtual uint32_t getStepsIssued() { return 0; }
+    
+    /**
+     * @brief Record this motor's steps in the step trace (see StepTrace.h)
+     * @param joint Joint index in the trace, -1 to stop recording
+     * Motors without steps ignore it.
+     */
+    virtual void setTraceJoint(int8_t joint) { (void)joint; }
+    
     /**
      * @brief Virtual destructor for proper cleanup
      */
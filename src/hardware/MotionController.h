@@ -0,0 +1,111 @@
+#ifndef MOTION_CONTROLLER_H
+#define MOTION_CONTROLLER_H
+
+#include "IMotor.h"
+#include "../core/Types.h"
+
+/**
+ * @file MotionController.h
+ * @brief Drives the two arm joints with the motor types bound at compile time
+ *
+ * The motion task calls update(), isMoving() and the move functions of both
+ * motors on every tick. Through IMotor* each of these is a virtual call;
+ * with the concrete (final) motor classes as template arguments the
+ * compiler resolves them statically and can inline them.
+ *
+ * MotionController<IMotor, IMotor> still works for any mix of motors,
+ * e.g. in tests, at the cost of virtual dispatch.
+ */
+
+template <class MotorA, class MotorB>
+class MotionController {
+private:
+    MotorA& motor1;
+    MotorB& motor2;
+
+public:
+    MotionController(MotorA& motor1, MotorB& motor2)
+        : motor1(motor1), motor2(motor2) {}
+
+    MotorA& joint1() { return motor1; }
+    MotorB& joint2() { return motor2; }
+
+    void init() {
+        motor1.init();
+        motor2.init();
+    }
+
+    void enable() {
+        motor1.enable();
+        motor2.enable();
+    }
+
+    void disable() {
+        motor1.disable();
+        motor2.disable();
+    }
+
+    /**
+     * @brief Move both joints to the given angles
+     */
+    void moveToAngles(const JointAngles& angles) {
+        motor1.moveToAngle(angles.theta1);
+        motor2.moveToAngle(angles.theta2);
+    }
+
+    /**
+     * @brief Coordinated move: both joints arrive at the same time
+     * Each joint gets a rest-to-rest move of the same duration, so the
+     * joints move in proportion and neither finishes early.
+     * 
+     * @param angles Joint targets (degrees)
+     * @param duration Move time in seconds; 0 or less to use the shortest
+     *                 time that keeps both joints within their limits
+     * @return Duration actually used (seconds)
+     */
+    float moveJointsTo(const JointAngles& angles, float duration = 0.0f) {
+        if (duration <= 0.0f) {
+            float time1 = motor1.getMinMoveTime(angles.theta1);
+            float time2 = motor2.getMinMoveTime(angles.theta2);
+            duration = time1 > time2 ? time1 : time2;
+        }
+        
+        motor1.moveToAngleIn(angles.theta1, duration);
+        motor2.moveToAngleIn(angles.theta2, duration);
+        return duration;
+    }
+
+    /**
+     * @brief Start a PVT segment on both joints
+     * @param angles Joint targets (degrees)
+     * @param velocity Joint velocities at the targets (degrees/s)
+     * @param duration Time to reach the targets (seconds)
+     */
+    void moveToPVT(const JointAngles& angles, const JointAngles& velocity, float duration) {
+        motor1.moveToPVT(angles.theta1, velocity.theta1, duration);
+        motor2.moveToPVT(angles.theta2, velocity.theta2, duration);
+    }
+
+    JointAngles getCurrentAngles() {
+        return JointAngles(motor1.getCurrentAngle(), motor2.getCurrentAngle());
+    }
+
+    bool isMoving() {
+        return motor1.isMoving() || motor2.isMoving();
+    }
+
+    void stop() {
+        motor1.stop();
+        motor2.stop();
+    }
+
+    /**
+     * @brief Generate steps / PWM for both joints (call every control tick)
+     */
+    void update() {
+        motor1.update();
+        motor2.update();
+    }
+};
+
+#endif // MOTION_CONTROLLER_H
@@ -0,0 +1,89 @@
+#include "PinIO.h"
+
+#ifndef ARDUINO
+
+#include <chrono>
+
+static bool levels[MOCK_PIN_COUNT];
+static uint32_t writes[MOCK_PIN_COUNT];
+static uint32_t rising[MOCK_PIN_COUNT];
+static MockPinIO::Event events[MOCK_PIN_LOG_SIZE];
+static int eventsRecorded = 0;
+static bool manualTime = false;
+static uint32_t manualTimeUs = 0;
+
+void MockPinIO::output(uint8_t pin) {
+    (void)pin;
+}
+
+void MockPinIO::write(uint8_t pin, bool high) {
+    if (pin >= MOCK_PIN_COUNT) {
+        return;
+    }
+
+    writes[pin]++;
+    if (high && !levels[pin]) {
+        rising[pin]++;
+    }
+    levels[pin] = high;
+
+    if (eventsRecorded < MOCK_PIN_LOG_SIZE) {
+        events[eventsRecorded].pin = pin;
+        events[eventsRecorded].level = high;
+        events[eventsRecorded].timeUs = micros();
+        eventsRecorded++;
+    }
+}
+
+uint32_t MockPinIO::micros() {
+    if (manualTime) {
+        return manualTimeUs;
+    }
+    static const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    return (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
+void MockPinIO::setTime(uint32_t us) {
+    manualTime = true;
+    manualTimeUs = us;
+}
+
+void MockPinIO::advance(uint32_t us) {
+    manualTimeUs += us;
+}
+
+void MockPinIO::useRealTime() {
+    manualTime = false;
+}
+
+void MockPinIO::reset() {
+    for (int i = 0; i < MOCK_PIN_COUNT; i++) {
+        levels[i] = false;
+        writes[i] = 0;
+        rising[i] = 0;
+    }
+    eventsRecorded = 0;
+}
+
+bool MockPinIO::level(uint8_t pin) {
+    return pin < MOCK_PIN_COUNT ? levels[pin] : false;
+}
+
+uint32_t MockPinIO::writeCount(uint8_t pin) {
+    return pin < MOCK_PIN_COUNT ? writes[pin] : 0;
+}
+
+uint32_t MockPinIO::risingEdges(uint8_t pin) {
+    return pin < MOCK_PIN_COUNT ? rising[pin] : 0;
+}
+
+int MockPinIO::eventCount() {
+    return eventsRecorded;
+}
+
+const MockPinIO::Event& MockPinIO::event(int index) {
+    return events[index];
+}
+
+#endif // ARDUINO
@@ -0,0 +1,103 @@
+#ifndef PIN_IO_H
+#define PIN_IO_H
+
+#include <stdint.h>
+
+/**
+ * @file PinIO.h
+ * @brief Compile-time pin I/O policy for the step generator
+ *
+ * The step generator only talks to pins and the clock through PinIO.
+ * On the ESP32 this writes the GPIO set/clear registers directly
+ * (one store per edge, no pin lookup as in digitalWrite). On the host it
+ * is MockPinIO, which records every edge and has a settable clock, so
+ * the motor code can be unit-tested and benchmarked on Linux.
+ */
+
+#ifdef ARDUINO
+
+#include <Arduino.h>
+#include "soc/gpio_reg.h"
+
+class Esp32PinIO {
+public:
+    static void output(uint8_t pin) {
+        pinMode(pin, OUTPUT);
+    }
+
+    static inline void set(uint8_t pin) {
+        if (pin < 32) {
+            REG_WRITE(GPIO_OUT_W1TS_REG, 1UL << pin);
+        } else if (pin < 40) {
+            REG_WRITE(GPIO_OUT1_W1TS_REG, 1UL << (pin - 32));
+        }
+    }
+
+    static inline void clear(uint8_t pin) {
+        if (pin < 32) {
+            REG_WRITE(GPIO_OUT_W1TC_REG, 1UL << pin);
+        } else if (pin < 40) {
+            REG_WRITE(GPIO_OUT1_W1TC_REG, 1UL << (pin - 32));
+        }
+    }
+
+    static inline void write(uint8_t pin, bool high) {
+        if (high) {
+            set(pin);
+        } else {
+            clear(pin);
+        }
+    }
+
+    static inline uint32_t micros() {
+        return (uint32_t)::micros();
+    }
+};
+
+typedef Esp32PinIO PinIO;
+
+#else
+
+#define MOCK_PIN_COUNT 128     // Pins tracked by the mock
+#define MOCK_PIN_LOG_SIZE 1024 // Edges kept in the event log
+
+class MockPinIO {
+public:
+    struct Event {
+        uint8_t pin;
+        bool level;
+        uint32_t timeUs;
+    };
+
+    static void output(uint8_t pin);
+    static void set(uint8_t pin) { write(pin, true); }
+    static void clear(uint8_t pin) { write(pin, false); }
+    static void write(uint8_t pin, bool high);
+
+    /**
+     * @brief Current time: the real clock, or the manual one after setTime()
+     */
+    static uint32_t micros();
+    static void setTime(uint32_t us);
+    static void advance(uint32_t us);
+    static void useRealTime();
+
+    /**
+     * @brief Forget all recorded writes and levels
+     */
+    static void reset();
+
+    static bool level(uint8_t pin);
+    static uint32_t writeCount(uint8_t pin);   // All writes, changed or not
+    static uint32_t risingEdges(uint8_t pin);
+
+    // Event log (only the first MOCK_PIN_LOG_SIZE writes are kept)
+    static int eventCount();
+    static const Event& event(int index);
+};
+
+typedef MockPinIO PinIO;
+
+#endif
+
+#endif // PIN_IO_H
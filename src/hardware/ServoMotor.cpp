@@ -1,10 +1,14 @@
 #include "ServoMotor.h"
 #include "../Config.h"
+#include "../core/Profiler.h"
+#include <math.h>
 
 ServoMotor::ServoMotor(uint8_t pwmPin)
     : pwmPin(pwmPin), currentAngle(0.0f), targetAngle(0.0f),
-      speed(90.0f), enabled(false), isMovingFlag(false),
-      lastUpdateTime(0), lastAngle(0.0f) {
+      speed(90.0f), acceleration(SERVO_ACCELERATION), currentVelocity(0.0f),
+      enabled(false), isMovingFlag(false),
+      lastUpdateTime(0),
+      pvtActive(false), pvtStartTime(0) {
 }
 
 void ServoMotor::init() {
@@ -17,19 +21,91 @@ void ServoMotor::setSpeed(float speed) {
     this->speed = speed;  // degrees per second
 }
 
-void ServoMotor::moveToAngle(float angle) {
+void ServoMotor::setAcceleration(float acceleration) {
+    this->acceleration = acceleration > 0.0f ? acceleration : 0.0f;
+}
+
+float ServoMotor::clampAngle(float angle) {
     // Normalize angle to 0-360 range
     while (angle < 0) angle += 360.0f;
     while (angle >= 360.0f) angle -= 360.0f;
     
-    // Clamp to servo range (typically 0-180 degrees)
-    if (angle > 180.0f) angle = 180.0f;
-    if (angle < 0.0f) angle = 0.0f;
+    // Clamp to servo range (typically 0-180 degrees), to the nearer end
+    // so that -1° gives 0° rather than the far end
+    if (angle > SERVO_RANGE_DEG) {
+        angle = (angle - SERVO_RANGE_DEG < 360.0f - angle) ? SERVO_RANGE_DEG : 0.0f;
+    }
+    return angle;
+}
+
+void ServoMotor::moveToAngle(float angle) {
+    targetAngle = clampAngle(angle);
+    
+    // Keep the current velocity: the motion loop retargets every tick
+    if (pvtActive) {
+        currentVelocity = pvtSegment.velocity((micros() - pvtStartTime) / 1000000.0f);
+        pvtActive = false;
+    }
+    if (!isMovingFlag) {
+        lastUpdateTime = micros();
+    }
+    isMovingFlag = fabsf(targetAngle - currentAngle) > 0.05f || currentVelocity != 0.0f;
+}
+
+void ServoMotor::moveToPVT(float angle, float velocity, float duration) {
+    if (duration <= 0.0f) {
+        moveToAngle(angle);
+        return;
+    }
+    
+    angle = clampAngle(angle);
+    unsigned long now = micros();
+    
+    // Continue with the velocity we are moving at
+    float startVelocity = currentVelocity;
+    if (pvtActive) {
+        startVelocity = pvtSegment.velocity((now - pvtStartTime) / 1000000.0f);
+    }
+    
+    // Unwrap the target so the segment takes the shortest way round
+    pvtSegment = HermiteSegment(currentAngle, startVelocity,
+                                currentAngle + angleDelta(currentAngle, angle),
+                                velocity, duration);
+    pvtStartTime = now;
+    pvtActive = true;
     
     targetAngle = angle;
-    isMovingFlag = (abs(targetAngle - currentAngle) > 0.5f);  // 0.5 degree threshold
-    lastUpdateTime = millis();
-    lastAngle = currentAngle;
+    isMovingFlag = true;
+    lastUpdateTime = now;
+}
+
+void ServoMotor::moveToAngleIn(float angle, float duration) {
+    moveToPVT(angle, 0.0f, duration);
+}
+
+float ServoMotor::getMinMoveTime(float angle) {
+    float distance = fabsf(angleDelta(currentAngle, clampAngle(angle)));
+    
+    // A rest-to-rest cubic peaks at 1.5x the average velocity and at
+    // 6 * distance / duration² acceleration
+    float duration = 0.0f;
+    if (speed > 0.0f) {
+        duration = 1.5f * distance / speed;
+    }
+    if (acceleration > 0.0f) {
+        float accelDuration = sqrtf(6.0f * distance / acceleration);
+        if (accelDuration > duration) {
+            duration = accelDuration;
+        }
+    }
+    return duration;
+}
+
+void ServoMotor::setCurrentAngle(float angle) {
+    // Servos are absolute: this only changes what we believe the angle is
+    stop();
+    currentAngle = clampAngle(angle);
+    targetAngle = currentAngle;
 }
 
 float ServoMotor::getCurrentAngle() {
@@ -39,7 +115,7 @@ float ServoMotor::getCurrentAngle() {
 void ServoMotor::enable() {
     enabled = true;
     if (!isMovingFlag) {
-        servo.write(currentAngle);
+        writeAngle(currentAngle);
     }
 }
 
@@ -47,6 +123,7 @@ void ServoMotor::disable() {
     // Note: Some servos don't have a disable, so we just stop updating
     enabled = false;
     isMovingFlag = false;
+    currentVelocity = 0.0f;
 }
 
 bool ServoMotor::isEnabled() {
@@ -60,54 +137,84 @@ bool ServoMotor::isMoving() {
 void ServoMotor::stop() {
     targetAngle = currentAngle;
     isMovingFlag = false;
+    pvtActive = false;
+    currentVelocity = 0.0f;
+    writeAngle(currentAngle);
 }
 
 void ServoMotor::update() {
+    PROFILE_SCOPE("ServoMotor::update");
     if (!enabled || !isMovingFlag) {
         return;
     }
     
-    unsigned long currentTime = millis();
-    float deltaTime = (currentTime - lastUpdateTime) / 1000.0f;  // Convert to seconds
+    unsigned long currentTime = micros();
     
-    if (deltaTime > 0) {
-        // Calculate maximum angle change based on speed
-        float maxAngleChange = speed * deltaTime;
-        float angleDiff = targetAngle - currentAngle;
-        
-        // Normalize angle difference to shortest path
-        if (angleDiff > 180.0f) {
-            angleDiff -= 360.0f;
-        } else if (angleDiff < -180.0f) {
-            angleDiff += 360.0f;
-        }
-        
-        // Move towards target
-        if (abs(angleDiff) <= maxAngleChange) {
-            // Reached target
+    if (pvtActive) {
+        // Servos take position commands, so follow the curve directly
+        float t = (currentTime - pvtStartTime) / 1000000.0f;
+        if (t >= pvtSegment.duration) {
+            pvtActive = false;
             currentAngle = targetAngle;
+            currentVelocity = pvtSegment.v1;
             isMovingFlag = false;
         } else {
-            // Move by maxAngleChange towards target
-            if (angleDiff > 0) {
-                currentAngle += maxAngleChange;
-            } else {
-                currentAngle -= maxAngleChange;
-            }
+            currentAngle = pvtSegment.position(t);
+            currentVelocity = pvtSegment.velocity(t);
+        }
+    } else {
+        float dt = (currentTime - lastUpdateTime) / 1000000.0f;
+        if (dt <= 0.0f) {
+            return;
+        }
+        followProfile(dt);
+    }
+    
+    // Lead the trajectory to cancel the servo's response lag
+    writeAngle(currentAngle + currentVelocity * SERVO_VELOCITY_FEEDFORWARD);
+    lastUpdateTime = currentTime;
+}
+
+void ServoMotor::followProfile(float dt) {
+    float distance = targetAngle - currentAngle;
+    float direction = distance >= 0.0f ? 1.0f : -1.0f;
+    float remaining = fabsf(distance);
+    
+    // Velocity towards the target (negative while still moving away)
+    float v = currentVelocity * direction;
+    
+    if (acceleration <= 0.0f) {
+        v = speed;
+    } else {
+        // Brake when the stopping distance reaches the target, else speed up
+        float stoppingDistance = v > 0.0f ? (v * v) / (2.0f * acceleration) : 0.0f;
+        if (v > 0.0f && stoppingDistance >= remaining) {
+            v -= acceleration * dt;
+            if (v < 0.0f) v = 0.0f;
+        } else {
+            v += acceleration * dt;
+            if (v > speed) v = speed;
         }
-        
-        // Normalize current angle
-        while (currentAngle < 0) currentAngle += 360.0f;
-        while (currentAngle >= 360.0f) currentAngle -= 360.0f;
-        
-        // Clamp to servo range
-        if (currentAngle > 180.0f) currentAngle = 180.0f;
-        if (currentAngle < 0.0f) currentAngle = 0.0f;
-        
-        // Update servo position
-        servo.write((int)currentAngle);
-        
-        lastUpdateTime = currentTime;
-        lastAngle = currentAngle;
     }
+    
+    float stepAngle = v * dt;
+    if (stepAngle >= remaining || (remaining < 0.05f && fabsf(v) <= acceleration * dt)) {
+        // Reached target
+        currentAngle = targetAngle;
+        currentVelocity = 0.0f;
+        isMovingFlag = false;
+        return;
+    }
+    
+    currentAngle += direction * stepAngle;
+    currentVelocity = direction * v;
+}
+
+void ServoMotor::writeAngle(float angle) {
+    if (angle < 0.0f) angle = 0.0f;
+    if (angle > SERVO_RANGE_DEG) angle = SERVO_RANGE_DEG;
+    
+    // Whole microseconds give sub-degree steps (2000 us over 180°)
+    float pulse = SERVO_MIN_PULSE + angle * (SERVO_MAX_PULSE - SERVO_MIN_PULSE) / SERVO_RANGE_DEG;
+    servo.writeMicroseconds((int)lroundf(pulse));
 }
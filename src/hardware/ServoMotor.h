@@ -2,6 +2,8 @@
 #define SERVO_MOTOR_H
 
 #include "IMotor.h"
+#include "../core/Hermite.h"
+#include "../core/Types.h"
 #include <Arduino.h>
 #include <ESP32Servo.h>
 
@@ -11,21 +13,39 @@
  * 
  * This class implements the IMotor interface for servo motors
  * controlled via PWM signals (e.g., SG90, MG996R, or smart servos).
+ * The pulse width is written in microseconds (about 0.1° per step with
+ * the default range) and moves follow a velocity profile with limited
+ * acceleration, plus a velocity feed-forward term.
  */
 
-class ServoMotor : public IMotor {
+class ServoMotor final : public IMotor {
 private:
     uint8_t pwmPin;
     Servo servo;
     
-    float currentAngle;      // Current angle in degrees
+    float currentAngle;      // Current angle in degrees (trajectory)
     float targetAngle;       // Target angle in degrees
     float speed;             // Speed in degrees per second
+    float acceleration;      // Acceleration in degrees/s² (0 = no ramp)
+    float currentVelocity;   // Trajectory velocity in degrees/s
     bool enabled;            // Motor enable state
     bool isMovingFlag;       // Movement status
     
-    unsigned long lastUpdateTime;  // Last update timestamp (milliseconds)
-    float lastAngle;              // Angle at last update
+    unsigned long lastUpdateTime;  // Last update timestamp (microseconds)
+    
+    // PVT (cubic Hermite) motion state
+    HermiteSegment pvtSegment;   // Segment being followed (degrees)
+    bool pvtActive;              // Following pvtSegment
+    unsigned long pvtStartTime;  // Segment start timestamp (microseconds)
+    
+    // Advance the moveToAngle() velocity profile by dt seconds
+    void followProfile(float dt);
+    
+    // Write an angle as a pulse width, clamped to the servo range
+    void writeAngle(float angle);
+    
+    // Normalize to 0-360 and clamp to the servo range
+    static float clampAngle(float angle);
     
 public:
     /**
@@ -38,6 +58,10 @@ public:
     void init() override;
     void setSpeed(float speed) override;
     void moveToAngle(float angle) override;
+    void moveToPVT(float angle, float velocity, float duration) override;
+    void moveToAngleIn(float angle, float duration) override;
+    float getMinMoveTime(float angle) override;
+    void setCurrentAngle(float angle) override;
     float getCurrentAngle() override;
     void enable() override;
     void disable() override;
@@ -45,6 +69,12 @@ public:
     bool isMoving() override;
     void stop() override;
     void update() override;
+    
+    /**
+     * @brief Set the acceleration used by moveToAngle()
+     * @param acceleration Acceleration in degrees/s² (0 moves at full speed at once)
+     */
+    void setAcceleration(float acceleration);
 };
 
 #endif // SERVO_MOTOR_H
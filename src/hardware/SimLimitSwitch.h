@@ -0,0 +1,55 @@
+#ifndef SIM_LIMIT_SWITCH_H
+#define SIM_LIMIT_SWITCH_H
+
+#include "ILimitSwitch.h"
+#include "SimMotor.h"
+
+/**
+ * @file SimLimitSwitch.h
+ * @brief Simulated limit switch actuated by a SimMotor's rotor
+ * 
+ * The switch closes when the rotor reaches triggerAngle from the free
+ * side and only opens again once it has moved 'hysteresis' degrees back,
+ * like a mechanical microswitch.
+ */
+
+class SimLimitSwitch final : public ILimitSwitch {
+private:
+    const SimMotor& motor;
+    float triggerAngle;   // Physical rotor angle at which the switch closes
+    int8_t direction;     // Side of the switch: -1 below triggerAngle, +1 above
+    float hysteresis;     // Travel back needed to open again (degrees)
+    bool triggered;
+    
+public:
+    /**
+     * @brief Constructor
+     * @param motor Motor whose physical angle actuates the switch
+     * @param triggerAngle Physical angle at which the switch closes (degrees)
+     * @param direction Direction of travel that presses the switch (-1 or +1)
+     * @param hysteresis Travel back needed to release it (degrees)
+     */
+    SimLimitSwitch(const SimMotor& motor, float triggerAngle, int8_t direction,
+                   float hysteresis = 0.5f)
+        : motor(motor), triggerAngle(triggerAngle), direction(direction),
+          hysteresis(hysteresis), triggered(false) {}
+    
+    // ILimitSwitch interface implementation
+    void init() override {
+        triggered = false;
+        isTriggered();
+    }
+    
+    bool isTriggered() override {
+        // Distance past the trigger point in the pressing direction
+        float travel = (motor.getPhysicalAngle() - triggerAngle) * direction;
+        if (travel >= 0.0f) {
+            triggered = true;
+        } else if (travel < -hysteresis) {
+            triggered = false;
+        }
+        return triggered;
+    }
+};
+
+#endif // SIM_LIMIT_SWITCH_H
@@ -0,0 +1,283 @@
+#include "SimMotor.h"
+#include <math.h>
+
+// A hybrid stepper has one electrical period per 4 full steps
+#define SIM_POLE_PAIRS (STEPS_PER_REVOLUTION / 4)
+#define SIM_DEG_TO_RAD 0.017453293f
+#define SIM_RAD_TO_DEG 57.29578f
+
+SimMotor::SimMotor(SimClock& clock, const SimMotorParams& params)
+    : clock(clock), params(params),
+      speed(100.0f), acceleration(STEPPER_ACCELERATION),
+      enabled(false), isMovingFlag(false),
+      frameOffset(0.0f),
+      commandAngle(0.0f), commandVelocity(0.0f), targetAngle(0.0f),
+      pvtActive(false), pvtStartTime(0),
+      rotorAngle(0.0f), rotorVelocity(0.0f),
+      stalled(false), maxFollowingError(0.0f),
+      lastUpdateTime(0) {
+}
+
+void SimMotor::init() {
+    frameOffset = 0.0f;
+    commandAngle = 0.0f;
+    commandVelocity = 0.0f;
+    targetAngle = 0.0f;
+    pvtActive = false;
+    rotorAngle = 0.0f;
+    rotorVelocity = 0.0f;
+    stalled = false;
+    maxFollowingError = 0.0f;
+    lastUpdateTime = clock.micros();
+    disable();
+}
+
+void SimMotor::setSpeed(float speed) {
+    this->speed = speed;  // steps per second
+}
+
+void SimMotor::setAcceleration(float acceleration) {
+    this->acceleration = acceleration > 0.0f ? acceleration : 0.0f;
+}
+
+void SimMotor::moveToAngle(float angle) {
+    // Normalize angle to 0-360 range
+    while (angle < 0) angle += 360.0f;
+    while (angle >= 360.0f) angle -= 360.0f;
+
+    if (pvtActive) {
+        commandVelocity = pvtSegment.velocity((clock.micros() - pvtStartTime) / 1000000.0f);
+        pvtActive = false;
+    }
+    // commandAngle is not wrapped: take the shortest way round
+    targetAngle = commandAngle + angleDelta(commandAngle, angle);
+    isMovingFlag = true;
+}
+
+void SimMotor::moveToPVT(float angle, float velocity, float duration) {
+    if (duration <= 0.0f) {
+        moveToAngle(angle);
+        return;
+    }
+
+    // Normalize angle to 0-360 range
+    while (angle < 0) angle += 360.0f;
+    while (angle >= 360.0f) angle -= 360.0f;
+
+    uint32_t now = clock.micros();
+    float startVelocity = commandVelocity;
+    if (pvtActive) {
+        startVelocity = pvtSegment.velocity((now - pvtStartTime) / 1000000.0f);
+    }
+
+    // Unwrap the target so the segment takes the shortest way round
+    angle = commandAngle + angleDelta(commandAngle, angle);
+    pvtSegment = HermiteSegment(commandAngle, startVelocity, angle, velocity, duration);
+    pvtStartTime = now;
+    pvtActive = true;
+    targetAngle = angle;
+    isMovingFlag = true;
+}
+
+void SimMotor::moveToAngleIn(float angle, float duration) {
+    moveToPVT(angle, 0.0f, duration);
+}
+
+float SimMotor::getMinMoveTime(float angle) {
+    while (angle < 0) angle += 360.0f;
+    while (angle >= 360.0f) angle -= 360.0f;
+
+    float steps = fabsf(angleDelta(commandAngle, angle)) * STEPS_PER_DEGREE;
+
+    // Same limits as StepperMotor: rest-to-rest cubic peak velocity and
+    // acceleration
+    float duration = 0.0f;
+    if (speed > 0.0f) {
+        duration = 1.5f * steps / speed;
+    }
+    if (acceleration > 0.0f) {
+        float accelDuration = sqrtf(6.0f * steps / acceleration);
+        if (accelDuration > duration) {
+            duration = accelDuration;
+        }
+    }
+    return duration;
+}
+
+void SimMotor::setCurrentAngle(float angle) {
+    stop();
+    
+    // Normalize angle to 0-360 range
+    while (angle < 0) angle += 360.0f;
+    while (angle >= 360.0f) angle -= 360.0f;
+    
+    frameOffset += angle - commandAngle;
+    commandAngle = angle;
+    targetAngle = angle;
+}
+
+float SimMotor::getCurrentAngle() {
+    return rotorAngle * SIM_RAD_TO_DEG + frameOffset;
+}
+
+float SimMotor::getPhysicalAngle() const {
+    return rotorAngle * SIM_RAD_TO_DEG;
+}
+
+void SimMotor::setPhysicalAngle(float angle) {
+    stop();
+    rotorAngle = angle * SIM_DEG_TO_RAD;
+    rotorVelocity = 0.0f;
+    commandAngle = angle + frameOffset;
+    targetAngle = commandAngle;
+}
+
+float SimMotor::getCommandedAngle() const {
+    return lroundf(commandAngle * STEPS_PER_DEGREE) / STEPS_PER_DEGREE;
+}
+
+float SimMotor::getVelocity() const {
+    return rotorVelocity * SIM_RAD_TO_DEG;
+}
+
+void SimMotor::enable() {
+    enabled = true;
+}
+
+void SimMotor::disable() {
+    enabled = false;
+    isMovingFlag = false;
+}
+
+bool SimMotor::isEnabled() {
+    return enabled;
+}
+
+bool SimMotor::isMoving() {
+    return isMovingFlag && enabled;
+}
+
+void SimMotor::stop() {
+    // Steps stop at once; the rotor may still overshoot and ring
+    targetAngle = commandAngle;
+    commandVelocity = 0.0f;
+    pvtActive = false;
+    isMovingFlag = false;
+}
+
+bool SimMotor::isStalled() const {
+    return stalled;
+}
+
+void SimMotor::clearStall() {
+    stalled = false;
+    maxFollowingError = 0.0f;
+}
+
+float SimMotor::getMaxFollowingError() const {
+    return maxFollowingError;
+}
+
+void SimMotor::update() {
+    uint32_t now = clock.micros();
+
+    // Integrate in fixed substeps up to the current simulated time
+    while ((int32_t)(now - lastUpdateTime) > 0) {
+        uint32_t stepUs = now - lastUpdateTime;
+        if (stepUs > SIM_SUBSTEP_US) {
+            stepUs = SIM_SUBSTEP_US;
+        }
+        lastUpdateTime += stepUs;
+        float dt = stepUs / 1000000.0f;
+
+        if (enabled && isMovingFlag) {
+            advanceCommand(lastUpdateTime, dt);
+        }
+
+        // The driver only moves the field in whole (micro)steps
+        float fieldAngle = lroundf(commandAngle * STEPS_PER_DEGREE) / STEPS_PER_DEGREE;
+        advanceRotor(fieldAngle - frameOffset, dt);
+    }
+}
+
+void SimMotor::advanceCommand(uint32_t nowUs, float dt) {
+    if (pvtActive) {
+        float t = (nowUs - pvtStartTime) / 1000000.0f;
+        if (t >= pvtSegment.duration) {
+            pvtActive = false;
+            commandAngle = pvtSegment.p1;
+            commandVelocity = 0.0f;
+            isMovingFlag = false;
+        } else {
+            commandAngle = pvtSegment.position(t);
+            commandVelocity = pvtSegment.velocity(t);
+        }
+        return;
+    }
+
+    // Trapezoidal profile towards targetAngle, as StepperMotor's ramp
+    float maxSpeed = speed / STEPS_PER_DEGREE;
+    float accel = acceleration / STEPS_PER_DEGREE;
+    float distance = targetAngle - commandAngle;
+    float direction = distance >= 0.0f ? 1.0f : -1.0f;
+    float remaining = fabsf(distance);
+    float v = commandVelocity * direction;
+
+    if (accel <= 0.0f) {
+        v = maxSpeed;
+    } else {
+        float stoppingDistance = v > 0.0f ? (v * v) / (2.0f * accel) : 0.0f;
+        if (v > 0.0f && stoppingDistance >= remaining) {
+            v -= accel * dt;
+            if (v < 0.0f) v = 0.0f;
+        } else {
+            v += accel * dt;
+            if (v > maxSpeed) v = maxSpeed;
+        }
+    }
+
+    float stepAngle = v * dt;
+    if (stepAngle >= remaining || (remaining < 0.5f / STEPS_PER_DEGREE && v <= accel * dt)) {
+        commandAngle = targetAngle;
+        commandVelocity = 0.0f;
+        isMovingFlag = false;
+        return;
+    }
+
+    commandAngle += direction * stepAngle;
+    commandVelocity = direction * v;
+}
+
+void SimMotor::advanceRotor(float fieldAngle, float dt) {
+    float lag = fieldAngle * SIM_DEG_TO_RAD - rotorAngle;
+    float electricalError = SIM_POLE_PAIRS * lag;
+
+    // Torque available at this speed (linear torque-speed curve)
+    float torque = 0.0f;
+    if (enabled) {
+        float noLoadSpeed = params.noLoadSpeed * SIM_DEG_TO_RAD;
+        float available = params.holdingTorque * (1.0f - fabsf(rotorVelocity) / noLoadSpeed);
+        if (available < 0.0f) available = 0.0f;
+        torque = available * sinf(electricalError);
+    }
+
+    torque -= params.damping * rotorVelocity;
+    if (rotorVelocity > 0.0f) {
+        torque -= params.friction;
+    } else if (rotorVelocity < 0.0f) {
+        torque += params.friction;
+    }
+
+    // Semi-implicit Euler
+    rotorVelocity += torque / params.inertia * dt;
+    rotorAngle += rotorVelocity * dt;
+
+    // Past half an electrical period the rotor locks onto the next pole
+    float lagDegrees = fabsf(lag) * SIM_RAD_TO_DEG;
+    if (enabled && lagDegrees > maxFollowingError) {
+        maxFollowingError = lagDegrees;
+    }
+    if (enabled && fabsf(electricalError) > (float)M_PI) {
+        stalled = true;
+    }
+}
@@ -0,0 +1,149 @@
+#ifndef SIM_MOTOR_H
+#define SIM_MOTOR_H
+
+#include "IMotor.h"
+#include "../core/Hermite.h"
+#include "../core/Types.h"
+#include "../Config.h"
+#include <stdint.h>
+
+/**
+ * @file SimMotor.h
+ * @brief Simulated stepper motor with a simple physical model
+ *
+ * The commanded motion is quantized to steps like on a STEP/DIR driver.
+ * The rotor is pulled towards the field angle with a torque that follows
+ * a sin() of the electrical angle error and a linear torque-speed curve,
+ * against inertia, damping and friction. When the rotor lags the field
+ * by more than half an electrical period it slips a pole and the motor
+ * is flagged as stalled, i.e. steps were lost.
+ *
+ * Time comes from a SimClock advanced by the caller, so whole moves run
+ * on the host much faster than real time.
+ */
+
+class SimClock {
+private:
+    uint32_t nowUs;
+
+public:
+    SimClock() : nowUs(0) {}
+
+    uint32_t micros() const { return nowUs; }
+    void advance(uint32_t us) { nowUs += us; }
+};
+
+struct SimMotorParams {
+    float holdingTorque;  // N·m
+    float inertia;        // kg·m²
+    float noLoadSpeed;    // deg/s at which the available torque is zero
+    float damping;        // N·m·s/rad
+    float friction;       // N·m (opposes motion)
+
+    SimMotorParams()
+        : holdingTorque(SIM_HOLDING_TORQUE), inertia(SIM_INERTIA),
+          noLoadSpeed(SIM_NO_LOAD_SPEED), damping(SIM_DAMPING),
+          friction(SIM_FRICTION) {}
+};
+
+class SimMotor final : public IMotor {
+private:
+    SimClock& clock;
+    SimMotorParams params;
+
+    float speed;             // Speed in steps per second
+    float acceleration;      // Acceleration in steps/s² (0 = no ramp)
+    bool enabled;            // Motor enable state
+    bool isMovingFlag;       // Command in progress
+
+    // Commanded motion (degrees, not normalized, in the motor's frame;
+    // the rotor is at frameOffset degrees less in the physical frame)
+    float frameOffset;       // setCurrentAngle() shift
+    float commandAngle;      // Commanded angle
+    float commandVelocity;   // Commanded velocity in degrees/s
+    float targetAngle;       // Target of moveToAngle()
+    bool pvtActive;          // Following pvtSegment
+    HermiteSegment pvtSegment;
+    uint32_t pvtStartTime;   // Segment start (microseconds)
+
+    // Rotor state
+    float rotorAngle;        // Radians
+    float rotorVelocity;     // Radians/s
+    bool stalled;            // A pole slip happened since the last clearStall()
+    float maxFollowingError; // Largest field-to-rotor lag seen (degrees)
+
+    uint32_t lastUpdateTime; // Simulated up to this time (microseconds)
+
+    // Advance the commanded motion by dt seconds
+    void advanceCommand(uint32_t nowUs, float dt);
+
+    // Advance the rotor by dt seconds against the given field angle (degrees)
+    void advanceRotor(float fieldAngle, float dt);
+
+public:
+    /**
+     * @brief Constructor
+     * @param clock Simulated clock shared by all motors of the model
+     * @param params Physical parameters
+     */
+    SimMotor(SimClock& clock, const SimMotorParams& params = SimMotorParams());
+
+    // IMotor interface implementation
+    void init() override;
+    void setSpeed(float speed) override;
+    void moveToAngle(float angle) override;
+    void moveToPVT(float angle, float velocity, float duration) override;
+    void moveToAngleIn(float angle, float duration) override;
+    float getMinMoveTime(float angle) override;
+    void setCurrentAngle(float angle) override;
+    float getCurrentAngle() override;
+    void enable() override;
+    void disable() override;
+    bool isEnabled() override;
+    bool isMoving() override;
+    void stop() override;
+    void update() override;
+
+    /**
+     * @brief Set the acceleration used by moveToAngle()
+     * @param acceleration Acceleration in steps/s² (0 = full speed at once)
+     */
+    void setAcceleration(float acceleration);
+
+    /**
+     * @brief Commanded (step) angle in degrees
+     */
+    float getCommandedAngle() const;
+
+    /**
+     * @brief Rotor angle in the physical frame (not moved by setCurrentAngle())
+     * Used by simulated switches and sensors.
+     */
+    float getPhysicalAngle() const;
+    
+    /**
+     * @brief Put the rotor at a physical angle, at rest (e.g. before a test)
+     */
+    void setPhysicalAngle(float angle);
+
+    /**
+     * @brief Rotor velocity in degrees/s
+     */
+    float getVelocity() const;
+
+    /**
+     * @brief Check if the rotor slipped (steps lost) since the last clearStall()
+     */
+    bool isStalled() const;
+    void clearStall();
+
+    /**
+     * @brief Largest lag of the rotor behind the field since clearStall()
+     * A pole slip happens at 2 full steps; the margin to that is the
+     * step-loss risk of a move.
+     * @return Lag in degrees
+     */
+    float getMaxFollowingError() const;
+};
+
+#endif // SIM_MOTOR_H
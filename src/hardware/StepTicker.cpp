@@ -0,0 +1,81 @@
+#include "StepTicker.h"
+#include "StepperMotor.h"
+
+static StepperMotor* tickerMotors[STEP_TICKER_MAX_MOTORS];
+static uint8_t tickerMotorCount = 0;
+
+#ifdef ARDUINO
+
+static portMUX_TYPE tickerMux = portMUX_INITIALIZER_UNLOCKED;
+static hw_timer_t* tickerTimer = nullptr;
+
+static void IRAM_ATTR onStepTimer() {
+    portENTER_CRITICAL_ISR(&tickerMux);
+    StepTicker::tick();
+    portEXIT_CRITICAL_ISR(&tickerMux);
+}
+
+void StepTicker::begin() {
+    if (tickerTimer != nullptr) {
+        return;
+    }
+    
+    // 80 MHz APB / 80: the timer counts microseconds
+    tickerTimer = timerBegin(STEP_TICKER_TIMER, 80, true);
+    timerAttachInterrupt(tickerTimer, &onStepTimer, true);
+    timerAlarmWrite(tickerTimer, STEP_TICK_US, true);
+    timerAlarmEnable(tickerTimer);
+}
+
+void StepTicker::lock() {
+    portENTER_CRITICAL(&tickerMux);
+}
+
+void StepTicker::unlock() {
+    portEXIT_CRITICAL(&tickerMux);
+}
+
+#else
+
+void StepTicker::begin() {
+}
+
+void StepTicker::lock() {
+}
+
+void StepTicker::unlock() {
+}
+
+#endif
+
+bool StepTicker::attach(StepperMotor& motor) {
+    StepTickerLock lock;
+    for (uint8_t i = 0; i < tickerMotorCount; i++) {
+        if (tickerMotors[i] == &motor) {
+            return true;
+        }
+    }
+    if (tickerMotorCount >= STEP_TICKER_MAX_MOTORS) {
+        return false;
+    }
+    tickerMotors[tickerMotorCount++] = &motor;
+    motor.tickerDriven = true;
+    return true;
+}
+
+void StepTicker::detach(StepperMotor& motor) {
+    StepTickerLock lock;
+    for (uint8_t i = 0; i < tickerMotorCount; i++) {
+        if (tickerMotors[i] == &motor) {
+            tickerMotors[i] = tickerMotors[--tickerMotorCount];
+            motor.tickerDriven = false;
+            return;
+        }
+    }
+}
+
+void STEP_ISR_ATTR StepTicker::tick() {
+    for (uint8_t i = 0; i < tickerMotorCount; i++) {
+        tickerMotors[i]->tick();
+    }
+}
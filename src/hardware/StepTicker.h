@@ -0,0 +1,74 @@
+#ifndef STEP_TICKER_H
+#define STEP_TICKER_H
+
+#include "../Config.h"
+#include <stdint.h>
+
+/**
+ * @file StepTicker.h
+ * @brief Hardware timer that runs the stepper step generators
+ *
+ * The motion loop runs at MOTION_CONTROL_FREQUENCY, far too slowly to
+ * time step pulses: one step per loop would cap a joint at 100 steps/s.
+ * Motors attached here are advanced from a timer interrupt every
+ * STEP_TICK_US instead, and their update() no longer steps. The
+ * interrupt only does integer work (the ramp recurrence and the
+ * prepared step segments); all floating point stays in the motion task.
+ *
+ * Motor state shared with the interrupt is changed between lock() and
+ * unlock(), a critical section on the ESP32. On the host there is no
+ * timer: tests call tick() themselves, and the lock does nothing.
+ */
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#define STEP_ISR_ATTR IRAM_ATTR   // Step path kept in IRAM
+#else
+#define STEP_ISR_ATTR
+#endif
+
+class StepperMotor;
+
+class StepTicker {
+public:
+    /**
+     * @brief Drive a motor from the timer
+     * @return false if STEP_TICKER_MAX_MOTORS are already attached
+     */
+    static bool attach(StepperMotor& motor);
+
+    /**
+     * @brief Give a motor back to its update()
+     */
+    static void detach(StepperMotor& motor);
+
+    /**
+     * @brief Start the timer
+     * The interrupt is allocated on the calling core, so call it from the
+     * motion task to keep it on core 1.
+     */
+    static void begin();
+
+    /**
+     * @brief Advance every attached motor (the interrupt handler's work)
+     */
+    static void tick();
+
+    static void lock();
+    static void unlock();
+};
+
+/**
+ * @brief Holds the StepTicker lock for the enclosing scope
+ */
+class StepTickerLock {
+public:
+    StepTickerLock() { StepTicker::lock(); }
+    ~StepTickerLock() { StepTicker::unlock(); }
+
+private:
+    StepTickerLock(const StepTickerLock&);
+    StepTickerLock& operator=(const StepTickerLock&);
+};
+
+#endif // STEP_TICKER_H
@@ -1,36 +1,77 @@
 #include "StepperMotor.h"
 #include "../Config.h"
+#include "../core/Profiler.h"
+#include "../core/StepTrace.h"
+#include "StepTicker.h"
+#include <math.h>
+
+// Fixed-point ramp intervals: 1/256 us, up to RAMP_MAX_INTERVAL_US
+static const int RAMP_SHIFT = 8;
+static const unsigned long RAMP_MAX_INTERVAL_US = 1000000;
 
 StepperMotor::StepperMotor(uint8_t stepPin, uint8_t dirPin, uint8_t enablePin)
     : stepPin(stepPin), dirPin(dirPin), enablePin(enablePin),
-      currentAngle(0.0f), targetAngle(0.0f), speed(100.0f),
-      enabled(false), isMovingFlag(false),
+      speed(100.0f), enabled(false), isMovingFlag(false),
       currentStep(0), targetStep(0),
-      lastStepTime(0), stepInterval(0) {
+      lastStepTime(0), stepInterval(0),
+      stepPinHigh(false), pulseStartTime(0), dirLevel(-1), stepsIssued(0),
+      traceJoint(-1), traceKeyframeTime(0), tickerDriven(false),
+      pvtActive(false), pvtStartTime(0), pvtVelocity(0.0f),
+      segmentActive(false), segmentChained(false),
+      segmentStartTime(0), segmentStepsScheduled(0),
+      acceleration(0.0f), rampFirstInterval(0), rampMinInterval(0),
+      rampInterval(0), rampRemainder(0), rampStep(0), rampDirection(1) {
+    setSpeed(speed);
+    setAcceleration(STEPPER_ACCELERATION);
 }
 
 void StepperMotor::init() {
-    pinMode(stepPin, OUTPUT);
-    pinMode(dirPin, OUTPUT);
-    pinMode(enablePin, OUTPUT);
+    PinIO::output(stepPin);
+    PinIO::output(dirPin);
+    PinIO::output(enablePin);
     
-    digitalWrite(stepPin, LOW);
-    digitalWrite(dirPin, LOW);
-    disable();  // Start disabled
+    StepTickerLock lock;
+    PinIO::clear(stepPin);
+    PinIO::clear(dirPin);
+    stepPinHigh = false;
+    dirLevel = 0;
     
-    // Calculate initial step interval based on speed
-    if (speed > 0) {
-        stepInterval = (unsigned long)(1000000.0f / speed);  // microseconds per step
-    }
+    // Start disabled
+    PinIO::set(enablePin);
+    enabled = false;
+    isMovingFlag = false;
 }
 
 void StepperMotor::setSpeed(float speed) {
-    this->speed = speed;
+    unsigned long interval = 0;
     if (speed > 0) {
-        stepInterval = (unsigned long)(1000000.0f / speed);  // microseconds per step
-    } else {
-        stepInterval = 0;
+        interval = (unsigned long)(1000000.0f / speed);  // microseconds per step
+    }
+    unsigned long minInterval = interval < RAMP_MAX_INTERVAL_US ? interval : RAMP_MAX_INTERVAL_US;
+    
+    StepTickerLock lock;
+    this->speed = speed;
+    stepInterval = interval;
+    rampMinInterval = (uint32_t)(minInterval << RAMP_SHIFT);
+}
+
+void StepperMotor::setAcceleration(float acceleration) {
+    acceleration = acceleration > 0.0f ? acceleration : 0.0f;
+    
+    // First interval from rest, c0 = 0.676 * sqrt(2 / a) (AVR446). The
+    // 0.676 factor corrects the error of the recurrence for small n. This
+    // is the only square root; the ramp itself uses the recurrence.
+    // Capped so the fixed-point recurrence cannot overflow (a >= ~1 step/s²)
+    uint32_t firstInterval = 0;
+    if (acceleration > 0.0f) {
+        float first = 0.676f * sqrtf(2.0f / acceleration) * 1000000.0f;
+        if (first > (float)RAMP_MAX_INTERVAL_US) first = (float)RAMP_MAX_INTERVAL_US;
+        firstInterval = (uint32_t)(first * (1 << RAMP_SHIFT));
     }
+    
+    StepTickerLock lock;
+    this->acceleration = acceleration;
+    rampFirstInterval = firstInterval;
 }
 
 void StepperMotor::moveToAngle(float angle) {
@@ -38,30 +79,140 @@ void StepperMotor::moveToAngle(float angle) {
     while (angle < 0) angle += 360.0f;
     while (angle >= 360.0f) angle -= 360.0f;
     
-    targetAngle = angle;
-    targetStep = angleToSteps(angle);
+    StepTickerLock lock;
     
-    // Set direction
-    if (targetStep > currentStep) {
-        digitalWrite(dirPin, HIGH);
-    } else {
-        digitalWrite(dirPin, LOW);
+    // The step count is not wrapped: take the shortest way round
+    float position = stepsToAngle(currentStep);
+    targetStep = angleToSteps(position + angleDelta(position, angle));
+    pvtActive = false;
+    pvtVelocity = 0.0f;
+    segments.clear();
+    segmentActive = false;
+    
+    // DIR is set by tick() with the first step. A ramp still under way
+    // keeps going: it has to brake before it can stop.
+    isMovingFlag = (targetStep != currentStep) || rampStep != 0;
+}
+
+void StepperMotor::moveToPVT(float angle, float velocity, float duration) {
+    if (duration <= 0.0f) {
+        moveToAngle(angle);
+        return;
     }
     
-    isMovingFlag = (targetStep != currentStep);
+    // Normalize angle to 0-360 range
+    while (angle < 0) angle += 360.0f;
+    while (angle >= 360.0f) angle -= 360.0f;
+    
+    unsigned long now = PinIO::micros();
+    float startVelocity;
+    long startStep;
+    
+    {
+        // Hold the motor while the new slices are prepared: replace
+        // whatever is left of the previous segment
+        StepTickerLock lock;
+        
+        // Continue from the actual position with the velocity we are
+        // moving at, so consecutive segments join without a velocity step
+        startVelocity = pvtVelocity;
+        if (pvtActive) {
+            startVelocity = pvtSegment.velocity((now - pvtStartTime) / 1000000.0f);
+        }
+        startStep = currentStep;
+        
+        pvtActive = false;
+        isMovingFlag = false;
+        segments.clear();
+        segmentActive = false;
+        segmentChained = false;
+        targetStep = currentStep;
+        rampStep = 0;  // The PVT segment carries its own velocity profile
+    }
+    
+    // Unwrap the target so the segment takes the shortest way round
+    float position = stepsToAngle(startStep);
+    pvtSegment = HermiteSegment(position, startVelocity,
+                                position + angleDelta(position, angle),
+                                velocity, duration);
+    pvtStartTime = now;
+    pvtVelocity = velocity;
+    
+    // All the floating point work happens here, once per PVT point;
+    // tick() only walks the resulting integer slices. The interrupt does
+    // not touch the buffer until the segment is activated below.
+    StepSegmentPreparer::prepare(pvtSegment, STEPS_PER_DEGREE, startStep, segments);
+    
+    StepTickerLock lock;
+    pvtActive = true;
+    isMovingFlag = true;
+}
+
+void StepperMotor::moveToAngleIn(float angle, float duration) {
+    // A rest-to-rest PVT segment: the step timing then follows the clock,
+    // so the move takes exactly 'duration' whatever the distance
+    moveToPVT(angle, 0.0f, duration);
+}
+
+float StepperMotor::getMinMoveTime(float angle) {
+    while (angle < 0) angle += 360.0f;
+    while (angle >= 360.0f) angle -= 360.0f;
+    
+    float steps = fabsf(angleDelta(getCurrentAngle(), angle)) * STEPS_PER_DEGREE;
+    
+    // A rest-to-rest cubic peaks at 1.5x the average velocity and at
+    // 6 * distance / duration² acceleration
+    float duration = 0.0f;
+    if (speed > 0.0f) {
+        duration = 1.5f * steps / speed;
+    }
+    if (acceleration > 0.0f) {
+        float accelDuration = sqrtf(6.0f * steps / acceleration);
+        if (accelDuration > duration) {
+            duration = accelDuration;
+        }
+    }
+    return duration;
+}
+
+void StepperMotor::setCurrentAngle(float angle) {
+    // Normalize angle to 0-360 range
+    while (angle < 0) angle += 360.0f;
+    while (angle >= 360.0f) angle -= 360.0f;
+    long step = angleToSteps(angle);
+    
+    StepTickerLock lock;
+    halt();
+    currentStep = step;
+    targetStep = currentStep;
+    
+    #if STEP_TRACE_ENABLED
+    // The trace replays steps from the last recorded position
+    if (traceJoint >= 0) {
+        traceKeyframeTime = PinIO::micros();
+        stepTrace.recordPosition(traceJoint, currentStep, traceKeyframeTime);
+    }
+    #endif
 }
 
 float StepperMotor::getCurrentAngle() {
-    return currentAngle;
+    long step;
+    {
+        StepTickerLock lock;
+        step = currentStep;
+    }
+    return wrapAngle(stepsToAngle(step));
 }
 
 void StepperMotor::enable() {
-    digitalWrite(enablePin, LOW);  // Active low on most drivers
+    StepTickerLock lock;
+    PinIO::clear(enablePin);  // Active low on most drivers
     enabled = true;
 }
 
 void StepperMotor::disable() {
-    digitalWrite(enablePin, HIGH);
+    StepTickerLock lock;
+    PinIO::set(enablePin);
     enabled = false;
     isMovingFlag = false;
 }
@@ -71,60 +222,266 @@ bool StepperMotor::isEnabled() {
 }
 
 bool StepperMotor::isMoving() {
+    StepTickerLock lock;
     return isMovingFlag && enabled;
 }
 
+uint32_t StepperMotor::getStepsIssued() {
+    return stepsIssued;
+}
+
+void StepperMotor::setTraceJoint(int8_t joint) {
+    StepTickerLock lock;
+    traceJoint = joint;
+    
+    #if STEP_TRACE_ENABLED
+    // Starting point for the steps that follow
+    if (traceJoint >= 0) {
+        traceKeyframeTime = PinIO::micros();
+        stepTrace.recordPosition(traceJoint, currentStep, traceKeyframeTime);
+    }
+    #endif
+}
+
 void StepperMotor::stop() {
+    StepTickerLock lock;
+    halt();
+}
+
+void StepperMotor::halt() {
     targetStep = currentStep;
-    targetAngle = currentAngle;
     isMovingFlag = false;
+    pvtActive = false;
+    pvtVelocity = 0.0f;
+    segments.clear();
+    segmentActive = false;
+    rampStep = 0;
 }
 
 void StepperMotor::update() {
+    PROFILE_SCOPE("StepperMotor::update");
+    
+    // Motors on the step timer are advanced by its interrupt
+    if (!tickerDriven) {
+        tick();
+    }
+}
+
+void STEP_ISR_ATTR StepperMotor::tick() {
+    unsigned long currentTime = PinIO::micros();
+    
+    #if STEP_TRACE_ENABLED
+    if (traceJoint >= 0 && currentTime - traceKeyframeTime >= STEP_TRACE_KEYFRAME_US) {
+        stepTrace.recordPosition(traceJoint, currentStep, currentTime);
+        traceKeyframeTime = currentTime;
+    }
+    #endif
+    
+    // End the step pulse once the driver has seen it, and leave STEP low
+    // until the next call so the driver sees the low time too. Nothing
+    // here busy-waits.
+    if (stepPinHigh) {
+        if (currentTime - pulseStartTime >= STEP_PULSE_WIDTH_US) {
+            PinIO::clear(stepPin);
+            stepPinHigh = false;
+        }
+        return;
+    }
+    
     if (!enabled || !isMovingFlag) {
         return;
     }
     
-    unsigned long currentTime = micros();
+    if (pvtActive) {
+        // The prepared segments are the step schedule
+        walkSegments(currentTime);
+        
+        if (currentStep != targetStep) {
+            // The PVT target may reverse mid-segment
+            step(targetStep > currentStep, currentTime);
+        } else if (!segmentActive && segments.isEmpty()) {
+            // pvtVelocity already holds the velocity the segment ended at
+            pvtActive = false;
+            isMovingFlag = false;
+        }
+        return;
+    }
+    
+    if (rampFirstInterval > 0) {
+        updateRamped(currentTime);
+        return;
+    }
+    
+    if (currentStep == targetStep) {
+        // Reached target
+        isMovingFlag = false;
+        return;
+    }
     
     // Check if it's time for the next step
-    if (currentTime - lastStepTime >= stepInterval) {
-        if (currentStep != targetStep) {
-            // Generate step pulse
-            digitalWrite(stepPin, HIGH);
-            delayMicroseconds(2);  // Minimum pulse width (adjust based on driver)
-            digitalWrite(stepPin, LOW);
-            
-            // Update position
-            if (targetStep > currentStep) {
-                currentStep++;
-            } else {
-                currentStep--;
+    unsigned long elapsed = currentTime - lastStepTime;
+    if (elapsed >= stepInterval) {
+        step(targetStep > currentStep, currentTime);
+        
+        // Steps land on the next call after they are due; advancing by
+        // the interval keeps the average rate exact. After a pause the
+        // schedule restarts from now.
+        lastStepTime = elapsed < 2 * stepInterval ? lastStepTime + stepInterval : currentTime;
+    }
+}
+
+void STEP_ISR_ATTR StepperMotor::updateRamped(unsigned long currentTime) {
+    unsigned long interval = rampInterval >> RAMP_SHIFT;
+    unsigned long elapsed = currentTime - lastStepTime;
+    
+    // Standing still, the first step is taken right away
+    bool fromRest = (rampStep == 0);
+    if (!fromRest && elapsed < interval) {
+        return;
+    }
+    
+    if (!computeRamp()) {
+        // Reached target
+        isMovingFlag = false;
+        return;
+    }
+    
+    step(rampDirection > 0, currentTime);
+    lastStepTime = (!fromRest && elapsed < 2 * interval) ? lastStepTime + interval : currentTime;
+}
+
+bool STEP_ISR_ATTR StepperMotor::computeRamp() {
+    long distance = targetStep - currentStep;
+    long remaining = distance < 0 ? -distance : distance;
+    
+    // After n steps of acceleration from rest it takes n steps to stop,
+    // so the ramp index doubles as the braking distance
+    long stepsToStop = rampStep < 0 ? -rampStep : rampStep;
+    
+    if (distance == 0 && stepsToStop <= 1) {
+        rampStep = 0;
+        return false;
+    }
+    
+    // Direction we would like to go; overshooting counts as wrong way
+    int8_t wanted = distance > 0 ? 1 : (distance < 0 ? -1 : -rampDirection);
+    
+    if (rampStep > 0) {
+        // Accelerating or cruising: brake if the target is too close or
+        // behind us
+        if (stepsToStop >= remaining || wanted != rampDirection) {
+            rampStep = -stepsToStop;
+        }
+    } else if (rampStep < 0) {
+        // Braking: speed up again if the target moved away
+        if (stepsToStop < remaining && wanted == rampDirection) {
+            rampStep = -rampStep;
+        }
+    }
+    
+    if (rampStep == 0) {
+        // Start from rest
+        rampDirection = wanted;
+        rampInterval = rampFirstInterval;
+        rampRemainder = 0;
+        rampStep = 1;
+        return true;
+    }
+    
+    // c_n = c_(n-1) - 2 c_(n-1) / (4n + 1); negative n lengthens the
+    // interval. The remainder carries over so the rounding does not
+    // accumulate (AVR446).
+    long numerator = 2 * (long)rampInterval + rampRemainder;
+    long denominator = 4 * rampStep + 1;
+    long next = (long)rampInterval - numerator / denominator;
+    if (rampStep > 0 && next <= (long)rampMinInterval) {
+        // Full speed: hold n so it keeps matching the braking distance
+        rampInterval = rampMinInterval;
+        rampRemainder = 0;
+    } else {
+        rampInterval = (uint32_t)next;
+        rampRemainder = numerator % denominator;
+        rampStep++;
+    }
+    return true;
+}
+
+void STEP_ISR_ATTR StepperMotor::step(bool forward, unsigned long currentTime) {
+    // DIR only needs a write when the direction changes
+    int8_t level = forward ? 1 : 0;
+    if (level != dirLevel) {
+        PinIO::write(dirPin, forward);
+        dirLevel = level;
+    }
+    
+    // Update position (the angle is derived from it on demand); this also
+    // gives DIR its setup time before the STEP edge
+    currentStep += forward ? 1 : -1;
+    
+    // Rising edge; the next tick() lowers it
+    PinIO::set(stepPin);
+    stepPinHigh = true;
+    pulseStartTime = currentTime;
+    stepsIssued++;
+    
+    #if STEP_TRACE_ENABLED
+    if (traceJoint >= 0) {
+        stepTrace.recordStep(traceJoint, forward, currentTime);
+    }
+    #endif
+}
+
+void STEP_ISR_ATTR StepperMotor::walkSegments(unsigned long currentTime) {
+    while (true) {
+        if (!segmentActive) {
+            if (!segments.pop(activeSegment)) {
+                // Out of slices: the next one starts whenever it arrives
+                segmentChained = false;
+                return;
             }
-            
-            // Update current angle
-            currentAngle = stepsToAngle(currentStep);
-            
-            // Update direction if needed
-            if (targetStep > currentStep) {
-                digitalWrite(dirPin, HIGH);
-            } else {
-                digitalWrite(dirPin, LOW);
+            if (!segmentChained) {
+                segmentStartTime = currentTime;
+            }
+            segmentActive = true;
+            segmentChained = true;
+            segmentStepsScheduled = 0;
+        }
+        
+        // Steps of this slice that are due by now
+        unsigned long elapsed = currentTime - segmentStartTime;
+        uint16_t due = activeSegment.steps;
+        if (elapsed < activeSegment.durationUs) {
+            unsigned long count = activeSegment.intervalUs > 0
+                                ? elapsed / activeSegment.intervalUs : 0;
+            if (count < due) {
+                due = (uint16_t)count;
             }
-            
-            lastStepTime = currentTime;
-        } else {
-            // Reached target
-            isMovingFlag = false;
-            currentAngle = targetAngle;
         }
+        
+        targetStep += activeSegment.direction * (long)(due - segmentStepsScheduled);
+        segmentStepsScheduled = due;
+        
+        if (elapsed < activeSegment.durationUs) {
+            return;
+        }
+        
+        // Slice finished: the next one starts exactly where it ended
+        segmentStartTime += activeSegment.durationUs;
+        segmentActive = false;
     }
 }
 
 long StepperMotor::angleToSteps(float angle) {
-    return (long)(angle * STEPS_PER_DEGREE);
+    // Rounded, to match the step positions used by StepSegmentPreparer
+    return lroundf(angle * STEPS_PER_DEGREE);
 }
 
 float StepperMotor::stepsToAngle(long steps) {
     return (float)steps / STEPS_PER_DEGREE;
 }
+
+float StepperMotor::wrapAngle(float angle) {
+    angle = fmodf(angle, 360.0f);
+    if (angle < 0.0f) angle += 360.0f;
+    return angle >= 360.0f ? 0.0f : angle;
+}
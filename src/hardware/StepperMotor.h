@@ -2,7 +2,10 @@
 #define STEPPER_MOTOR_H
 
 #include "IMotor.h"
-#include <Arduino.h>
+#include "../core/Hermite.h"
+#include "../core/Types.h"
+#include "PinIO.h"
+#include "../core/StepSegment.h"
 
 /**
  * @file StepperMotor.h
@@ -10,16 +13,19 @@
  * 
  * This class implements the IMotor interface for stepper motors
  * controlled via STEP and DIR pins (common with drivers like A4988, DRV8825).
+ * Pins and time go through the PinIO policy (see PinIO.h).
+ *
+ * The step generator is tick(). Once the motor is attached to the step
+ * timer (StepTicker.h) the timer interrupt calls it; otherwise update()
+ * does, and steps can only be as frequent as update() calls.
  */
 
-class StepperMotor : public IMotor {
+class StepperMotor final : public IMotor {
 private:
     uint8_t stepPin;
     uint8_t dirPin;
     uint8_t enablePin;
     
-    float currentAngle;      // Current angle in degrees
-    float targetAngle;       // Target angle in degrees
     float speed;             // Speed in steps per second
     bool enabled;            // Motor enable state
     bool isMovingFlag;       // Movement status
@@ -30,9 +36,57 @@ private:
     unsigned long lastStepTime;  // Last step timestamp (microseconds)
     unsigned long stepInterval;  // Time between steps (microseconds)
     
-    // Calculate steps from angle
+    // Pin state, so update() never busy-waits
+    bool stepPinHigh;            // STEP pulse in progress
+    unsigned long pulseStartTime; // When STEP went high (microseconds)
+    int8_t dirLevel;             // Level last written to DIR (-1 = unknown)
+    uint32_t stepsIssued;        // STEP pulses since power-up (wraps)
+    int8_t traceJoint;           // Joint in the step trace (-1 = not traced)
+    unsigned long traceKeyframeTime; // Last position recorded in the trace
+    bool tickerDriven;           // Stepped by the StepTicker interrupt
+    
+    // PVT (cubic Hermite) motion state
+    HermiteSegment pvtSegment;   // Segment being followed (degrees)
+    bool pvtActive;              // Following pvtSegment
+    unsigned long pvtStartTime;  // Segment start timestamp (microseconds)
+    float pvtVelocity;           // Velocity at the end of pvtSegment
+    
+    // Step segment execution (integer only, see StepSegment.h)
+    StepSegmentBuffer segments;     // Prepared slices waiting to run
+    StepSegment activeSegment;      // Slice being walked
+    bool segmentActive;             // activeSegment is valid
+    bool segmentChained;            // Next slice starts when the last one ended
+    unsigned long segmentStartTime; // Start of activeSegment (microseconds)
+    uint16_t segmentStepsScheduled; // Steps of activeSegment already scheduled
+    
+    // Advance the segment walker to currentTime and update targetStep
+    void walkSegments(unsigned long currentTime);
+    
+    // Acceleration ramp for stand-alone moves (AVR446 / AccelStepper).
+    // Intervals are in 1/256 us so the ramp runs in integer arithmetic.
+    float acceleration;          // Acceleration in steps/s² (0 = no ramp)
+    uint32_t rampFirstInterval;  // Interval of the first step from rest
+    uint32_t rampMinInterval;    // Interval at full speed
+    uint32_t rampInterval;       // Interval until the next step
+    long rampRemainder;          // Remainder of the last recurrence division
+    long rampStep;               // Ramp step index (< 0 while decelerating)
+    int8_t rampDirection;        // Direction of travel while ramping
+    
+    // Compute direction and interval for the next ramped step
+    bool computeRamp();
+    void updateRamped(unsigned long currentTime);
+    
+    // Raise STEP for one step in the given direction (lowered by tick())
+    void step(bool forward, unsigned long currentTime);
+    
+    // stop() without taking the StepTicker lock
+    void halt();
+    
+    // Calculate steps from angle (the step count is not wrapped to one
+    // turn, so moves across 0° keep going the same way)
     long angleToSteps(float angle);
     float stepsToAngle(long steps);
+    static float wrapAngle(float angle);
     
 public:
     /**
@@ -47,6 +101,10 @@ public:
     void init() override;
     void setSpeed(float speed) override;
     void moveToAngle(float angle) override;
+    void moveToPVT(float angle, float velocity, float duration) override;
+    void moveToAngleIn(float angle, float duration) override;
+    float getMinMoveTime(float angle) override;
+    void setCurrentAngle(float angle) override;
     float getCurrentAngle() override;
     void enable() override;
     void disable() override;
@@ -54,6 +112,26 @@ public:
     bool isMoving() override;
     void stop() override;
     void update() override;
+    uint32_t getStepsIssued() override;
+    void setTraceJoint(int8_t joint) override;
+    
+    /**
+     * @brief Set the acceleration used by moveToAngle()
+     * Moves ramp up to the speed set with setSpeed() and back down, so the
+     * top speed is limited by the motor's pull-out rate rather than its
+     * pull-in rate. PVT moves carry their own velocity profile.
+     * @param acceleration Acceleration in steps/s² (0 disables ramping)
+     */
+    void setAcceleration(float acceleration);
+    
+    /**
+     * @brief Advance the step generator to the current time
+     * Integer only, so it can run in the step timer interrupt. Lowers a
+     * finished STEP pulse or raises the next one; never both in one call.
+     */
+    void tick();
+    
+    friend class StepTicker;
 };
 
 #endif // STEPPER_MOTOR_H
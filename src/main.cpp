@@ -6,7 +6,7 @@
  * for the 2-DOF SCARA robotic arm controller.
  * 
  * Core Assignment:
- * - Core 0: Web Server, Trajectory Planner
+ * - Core 0: Web Server, Trajectory Planner, Telemetry
  * - Core 1: Real-Time Motion Control
  */
 
@@ -16,14 +16,27 @@
 #include <freertos/task.h>
 #include <freertos/queue.h>
 
-#include <queue>  // For std::queue in planner task
+#include <atomic>
 #include "Config.h"
 #include "core/Types.h"
 #include "core/Kinematics.h"
 #include "core/Planner.h"
+#include "core/TrajectoryExecutor.h"
+#include "core/PathBuffer.h"
+#include "core/GCode.h"
+#include "core/Arc.h"
+#include "core/Seqlock.h"
+#include "core/Metrics.h"
+#include "core/LoopTiming.h"
+#include "core/Profiler.h"
+#include "core/StepTrace.h"
 #include "hardware/IMotor.h"
 #include "hardware/StepperMotor.h"
+#include "hardware/StepTicker.h"
 #include "hardware/ServoMotor.h"
+#include "hardware/MotionController.h"
+#include "hardware/GpioLimitSwitch.h"
+#include "core/Homing.h"
 #include "web/WebServer.h"
 
 // Test mode includes
@@ -36,11 +49,32 @@
 // ============================================================================
 Kinematics kinematics(ARM_LENGTH_1, ARM_LENGTH_2);
 Planner planner(DEFAULT_SPEED, ACCELERATION);
+// Arm state, owned by the motion task: it is the only task that touches
+// robotState. Everyone else reads the copy it publishes to robotSnapshot
+// once per loop, which never blocks the motion task and is never torn.
 RobotState robotState;
+Seqlock<RobotState> robotSnapshot;
 
-// Motor instances (using StepperMotor by default, can be changed to ServoMotor)
-IMotor* motor1 = nullptr;
-IMotor* motor2 = nullptr;
+// Timing of every motion loop iteration, in CPU cycles (read by the web
+// server and the serial console, written by the motion task only)
+LoopTimer motionLoopTimer(1000000UL / MOTION_CONTROL_FREQUENCY);
+
+// Motor types are bound at compile time so the motion loop calls them
+// directly (to use servos, change these and the constructors in setup())
+typedef StepperMotor Joint1Motor;
+typedef StepperMotor Joint2Motor;
+typedef MotionController<Joint1Motor, Joint2Motor> ArmController;
+
+Joint1Motor* motor1 = nullptr;
+Joint2Motor* motor2 = nullptr;
+ArmController* arm = nullptr;
+
+// Homing switches and sequence (run by the motion task)
+GpioLimitSwitch limit1(LIMIT1_PIN, LIMIT_ACTIVE_LOW);
+GpioLimitSwitch limit2(LIMIT2_PIN, LIMIT_ACTIVE_LOW);
+HomingAxis* homingAxis1 = nullptr;
+HomingAxis* homingAxis2 = nullptr;
+HomingEngine* homing = nullptr;
 
 WebServer webServer;
 
@@ -48,7 +82,25 @@ WebServer webServer;
 // FreeRTOS Queues
 // ============================================================================
 QueueHandle_t commandQueue;   // Commands from web interface
-QueueHandle_t motionQueue;    // Interpolated motion points
+QueueHandle_t motionQueue;    // Time-stamped trajectory samples
+
+// Vertices of bulk PATH uploads (web server -> planner)
+PathBuffer pathBuffer;
+
+// G-code received over Serial (the web server has its own interpreter)
+GCodeInterpreter serialGCode;
+
+// Time (micros) at which the planner accepted the current move; cleared by
+// the motion task when it executes the move's first point.
+std::atomic<uint32_t> moveRequestUs(0);
+
+// Set by the planner to start homing; cleared by the motion task when the
+// sequence ends, or by the planner to abort it
+std::atomic<bool> homingRequested(false);
+
+// Set by the planner on STOP, once motionQueue is empty; cleared by the
+// motion task when the executor and motors have stopped
+std::atomic<bool> stopRequested(false);
 
 // ============================================================================
 // FreeRTOS Task Handles
@@ -56,6 +108,8 @@ QueueHandle_t motionQueue;    // Interpolated motion points
 TaskHandle_t taskWebHandlerHandle = nullptr;
 TaskHandle_t taskPlannerHandle = nullptr;
 TaskHandle_t taskMotionControlHandle = nullptr;
+TaskHandle_t taskSerialGCodeHandle = nullptr;
+TaskHandle_t taskTelemetryHandle = nullptr;
 
 // ============================================================================
 // Task Function Prototypes
@@ -63,6 +117,23 @@ TaskHandle_t taskMotionControlHandle = nullptr;
 void taskWebHandler(void* parameter);
 void taskTrajectoryPlanner(void* parameter);
 void taskMotionControl(void* parameter);
+void taskSerialGCode(void* parameter);
+void taskTelemetry(void* parameter);
+bool stopPending();
+bool pushMotionSample(const TrajectorySample& sample);
+bool waitForMotion();
+bool runHoming();
+bool dwell(float seconds);
+void updateHoming(TrajectoryExecutor& executor);
+void applyStop(TrajectoryExecutor& executor);
+void publishState(bool moving);
+void updateMotionMetrics(const TrajectoryExecutor& executor);
+bool handleSystemCommand(const char* line);
+int streamPath(const Point2D& start, const Point2D& end);
+int followPath(Point2D& currentPos, const Command& cmd);
+int followArc(Point2D& currentPos, const Command& cmd);
+void setJointVelocity(TrajectorySample& sample, const TrajectorySample& before,
+                      const TrajectorySample& after);
 
 // ============================================================================
 // Setup Function
@@ -97,24 +168,53 @@ void setup() {
     Serial.println("Initializing hardware...");
     
     // Create motor instances (StepperMotor implementation)
-    motor1 = new StepperMotor(MOTOR1_STEP_PIN, MOTOR1_DIR_PIN, MOTOR1_ENABLE_PIN);
-    motor2 = new StepperMotor(MOTOR2_STEP_PIN, MOTOR2_DIR_PIN, MOTOR2_ENABLE_PIN);
+    motor1 = new Joint1Motor(MOTOR1_STEP_PIN, MOTOR1_DIR_PIN, MOTOR1_ENABLE_PIN);
+    motor2 = new Joint2Motor(MOTOR2_STEP_PIN, MOTOR2_DIR_PIN, MOTOR2_ENABLE_PIN);
+    arm = new ArmController(*motor1, *motor2);
     
     // Initialize motors
-    motor1->init();
-    motor2->init();
-    motor1->enable();
-    motor2->enable();
+    arm->init();
+    arm->enable();
+    motor1->setSpeed(STEPPER_MAX_SPEED);
+    motor2->setSpeed(STEPPER_MAX_SPEED);
+    
+    // Steps are timed by the step timer, not by the motion loop (the
+    // timer is started by the motion task)
+    StepTicker::attach(*motor1);
+    StepTicker::attach(*motor2);
+    
+    #if STEP_TRACE_ENABLED
+    // Record both joints' steps for /trace
+    motor1->setTraceJoint(0);
+    motor2->setTraceJoint(1);
+    #endif
+    
+    // Initial position from the motors, before any task reads it
+    publishState(false);
+    
+    // Homing switches
+    limit1.init();
+    limit2.init();
+    homingAxis1 = new HomingAxis(*motor1, limit1, HomingAxisConfig(HOMING_DIR1, HOMING_ANGLE1));
+    homingAxis2 = new HomingAxis(*motor2, limit2, HomingAxisConfig(HOMING_DIR2, HOMING_ANGLE2));
+    homing = new HomingEngine(*homingAxis1, *homingAxis2);
     
     Serial.println("Motors initialized");
     
     // Create FreeRTOS queues
     commandQueue = xQueueCreate(COMMAND_QUEUE_SIZE, sizeof(Command));
-    motionQueue = xQueueCreate(MOTION_QUEUE_SIZE, sizeof(Point2D));
+    motionQueue = xQueueCreate(MOTION_QUEUE_SIZE, sizeof(TrajectorySample));
     
     
     Serial.println("Queues created");
     
+    // G28 leaves the arm where the homing switches are
+    Point2D homePosition;
+    kinematics.forward(JointAngles(HOMING_ANGLE1, HOMING_ANGLE2), homePosition);
+    serialGCode.setHomePosition(homePosition);
+    Point2D startPosition = robotSnapshot.read().currentPosition;
+    serialGCode.setPosition(startPosition);
+    
     // Connect to WiFi
     Serial.print("Connecting to WiFi: ");
     Serial.println(WIFI_SSID);
@@ -134,7 +234,8 @@ void setup() {
         Serial.println(WiFi.localIP());
         
         // Initialize web server
-        webServer.init(commandQueue);
+        webServer.init(commandQueue, &pathBuffer);
+        webServer.setGCodeHome(homePosition, startPosition);
         webServer.begin();
     } else {
         Serial.println("\nWiFi connection failed!");
@@ -176,10 +277,42 @@ void setup() {
         1  // Core 1
     );
     
+    // Task 4: Serial G-code (Core 0, Low Priority)
+    xTaskCreatePinnedToCore(
+        taskSerialGCode,
+        "SerialGCode",
+        TASK_SERIAL_GCODE_STACK_SIZE,
+        nullptr,
+        TASK_SERIAL_GCODE_PRIORITY,
+        &taskSerialGCodeHandle,
+        0  // Core 0
+    );
+    
+    // Task 5: Telemetry (Core 0, Low Priority)
+    xTaskCreatePinnedToCore(
+        taskTelemetry,
+        "Telemetry",
+        TASK_TELEMETRY_STACK_SIZE,
+        nullptr,
+        TASK_TELEMETRY_PRIORITY,
+        &taskTelemetryHandle,
+        0  // Core 0
+    );
+    
+    // Stack high-water marks on /metrics
+    webServer.watchTask("WebHandler", taskWebHandlerHandle);
+    webServer.watchTask("Planner", taskPlannerHandle);
+    webServer.watchTask("MotionControl", taskMotionControlHandle);
+    webServer.watchTask("SerialGCode", taskSerialGCodeHandle);
+    webServer.watchTask("Telemetry", taskTelemetryHandle);
+    webServer.setLoopTimer(&motionLoopTimer);
+    
     Serial.println("\nFreeRTOS tasks created:");
     Serial.println("  - WebHandler (Core 0, Priority 1)");
     Serial.println("  - Planner (Core 0, Priority 2)");
     Serial.println("  - MotionControl (Core 1, Priority 3)");
+    Serial.println("  - SerialGCode (Core 0, Priority 1)");
+    Serial.println("  - Telemetry (Core 0, Priority 1)");
     Serial.println("\nSystem ready!\n");
 }
 
@@ -208,14 +341,20 @@ void loop() {
 void taskWebHandler(void* parameter) {
     Serial.println("Task WebHandler started on Core 0");
     
+    int cleanupCounter = 0;
+    
     while (true) {
-        // Web server handles requests asynchronously
-        // This task mainly serves as a placeholder for future synchronous operations
+        // Web server handles requests asynchronously; this task acknowledges
+        // G-code lines that were waiting for room in the command queue
+        webServer.poll();
         
         // Cleanup WebSocket clients periodically
-        webServer.cleanup();
+        if (++cleanupCounter >= 10) {
+            cleanupCounter = 0;
+            webServer.cleanup();
+        }
         
-        vTaskDelay(pdMS_TO_TICKS(100));  // 100ms delay
+        vTaskDelay(pdMS_TO_TICKS(10));  // 10ms delay
     }
 }
 
@@ -225,13 +364,18 @@ void taskWebHandler(void* parameter) {
  * Priority: Medium
  * 
  * Blocks waiting for commands in commandQueue.
- * Calculates linear interpolation and pushes Point2D to motionQueue.
+ * Calculates linear interpolation and inverse kinematics, and pushes
+ * time-stamped TrajectorySamples to motionQueue one at a time, as each
+ * one is generated.
  */
 void taskTrajectoryPlanner(void* parameter) {
     Serial.println("Task Planner started on Core 0");
     
     Command cmd;
-    Point2D currentPos = robotState.currentPosition;
+    
+    // Where the last planned move ends; the measured position (from
+    // robotSnapshot) lags behind it while the queue drains
+    Point2D currentPos = robotSnapshot.read().currentPosition;
     
     while (true) {
         // Wait for command from queue (blocking)
@@ -240,11 +384,13 @@ void taskTrajectoryPlanner(void* parameter) {
             
             switch (cmd.type) {
                 case Command::MOVE_TO: {
-                    // Plan path from current position to target
-                    Point2D target = cmd.target;
+                    // Plan path from current position to target (G-code
+                    // sends relative and missing axes as offsets)
+                    Point2D target = cmd.resolveTarget(currentPos);
                     
                     // Check if target is reachable
                     if (!kinematics.isReachable(target)) {
+                        Metrics::increment(metrics.ikFailures);
                         Serial.printf("Planner: Target (%.2f, %.2f) is unreachable!\n",
                                      target.x, target.y);
                         break;
@@ -255,51 +401,92 @@ void taskTrajectoryPlanner(void* parameter) {
                         planner.setSpeed(cmd.speed);
                     }
                     
-                    // Generate interpolated points
-                    std::queue<Point2D> localQueue;
-                    int numPoints = planner.planPath(currentPos, target, localQueue);
-                    
-                    Serial.printf("Planner: Generated %d points\n", numPoints);
+                    // Stream interpolated points as they are generated, so
+                    // motion starts while the rest of the path is planned
+                    int numPoints = streamPath(currentPos, target);
                     
-                    // Push all points to motion queue
-                    while (!localQueue.empty()) {
-                        Point2D point = localQueue.front();
-                        localQueue.pop();
-                        
-                        if (xQueueSend(motionQueue, &point, pdMS_TO_TICKS(100)) != pdTRUE) {
-                            Serial.println("Planner: WARNING - Motion queue full!");
-                        }
+                    if (numPoints < 0) {
+                        Serial.println("Planner: Move interrupted by STOP");
+                        break;
                     }
                     
+                    Serial.printf("Planner: Generated %d points\n", numPoints);
+                    
                     // Update current position
                     currentPos = target;
-                    robotState.currentPosition = target;
                     break;
                 }
                 
-                case Command::HOME: {
-                    // Home sequence: move to (0, 0) or predefined home position
-                    Point2D homePos(0, 0);
-                    std::queue<Point2D> localQueue;
-                    planner.planPath(currentPos, homePos, localQueue);
+                case Command::PATH: {
+                    if (cmd.speed > 0) {
+                        planner.setSpeed(cmd.speed);
+                    }
                     
-                    while (!localQueue.empty()) {
-                        Point2D point = localQueue.front();
-                        localQueue.pop();
-                        xQueueSend(motionQueue, &point, portMAX_DELAY);
+                    int followed = followPath(currentPos, cmd);
+                    if (followed < 0) {
+                        Serial.println("Planner: Path interrupted by STOP");
+                        break;
                     }
                     
-                    currentPos = homePos;
-                    robotState.currentPosition = homePos;
-                    robotState.isHomed = true;
-                    Serial.println("Planner: Homing sequence completed");
+                    Serial.printf("Planner: Followed %d of %u path vertices\n",
+                                 followed, cmd.pathLength);
+                    break;
+                }
+                
+                case Command::ARC_CW:
+                case Command::ARC_CCW: {
+                    if (cmd.speed > 0) {
+                        planner.setSpeed(cmd.speed);
+                    }
+                    
+                    int chords = followArc(currentPos, cmd);
+                    if (chords < 0) {
+                        Serial.println("Planner: Arc interrupted by STOP");
+                        break;
+                    }
+                    
+                    Serial.printf("Planner: Arc split into %d chords\n", chords);
+                    break;
+                }
+                
+                case Command::DWELL: {
+                    if (!dwell(cmd.duration)) {
+                        Serial.println("Planner: Dwell interrupted by STOP");
+                    }
+                    break;
+                }
+                
+                case Command::HOME: {
+                    // The motion task owns the motors and runs the switch
+                    // sequence; this waits for it like for a queued move
+                    if (!runHoming()) {
+                        Serial.println("Planner: Homing interrupted by STOP");
+                        break;
+                    }
+                    
+                    // Published by the motion task before it ended the sequence
+                    RobotState state = robotSnapshot.read();
+                    currentPos = state.currentPosition;
+                    if (state.isHomed) {
+                        Serial.println("Planner: Homing sequence completed");
+                    } else {
+                        Serial.println("Planner: Homing failed!");
+                    }
                     break;
                 }
                 
                 case Command::STOP: {
-                    // Clear motion queue
+                    // Clear motion queue, then have the motion task drop
+                    // the samples it holds and stop the motors
                     xQueueReset(motionQueue);
-                    robotState.isMoving = false;
+                    pathBuffer.dropAbandoned();
+                    stopRequested = true;
+                    while (stopRequested) {
+                        vTaskDelay(pdMS_TO_TICKS(1));
+                    }
+                    
+                    // Resume planning from where the arm actually stopped
+                    currentPos = robotSnapshot.read().currentPosition;
                     Serial.println("Planner: Emergency stop!");
                     break;
                 }
@@ -318,69 +505,591 @@ void taskTrajectoryPlanner(void* parameter) {
     }
 }
 
+/**
+ * Push one trajectory sample to motionQueue, blocking while it is full.
+ * 
+ * Samples are never dropped: the planner simply stops pulling commands,
+ * commandQueue fills up and the web layer runs out of credits, which
+ * throttles the client. The wait is only abandoned when a STOP command
+ * is waiting (the web layer always puts STOP at the front of the queue).
+ * 
+ * @return true if the sample was queued, false if a STOP is pending
+ */
+bool pushMotionSample(const TrajectorySample& sample) {
+    while (xQueueSend(motionQueue, &sample, pdMS_TO_TICKS(100)) != pdTRUE) {
+        if (stopPending()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Check whether a STOP command is waiting (always at the front of the queue).
+ */
+bool stopPending() {
+    Command pending;
+    return xQueuePeek(commandQueue, &pending, 0) == pdTRUE &&
+           pending.type == Command::STOP;
+}
+
+/**
+ * Wait until every queued trajectory sample has been executed.
+ * 
+ * @return true once the arm is idle, false if a STOP is pending
+ */
+bool waitForMotion() {
+    while (uxQueueMessagesWaiting(motionQueue) > 0) {
+        if (stopPending()) {
+            return false;
+        }
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+    
+    // Only a snapshot written after the queue drained knows about the
+    // last sample: wait for one full write (two version steps) first
+    uint32_t drained = robotSnapshot.version();
+    while (robotSnapshot.version() - drained < 2 || robotSnapshot.read().isMoving) {
+        if (stopPending()) {
+            return false;
+        }
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+    return true;
+}
+
+/**
+ * Pause between moves (G4): let the queued motion finish, then wait.
+ * 
+ * @return true when the pause is over, false if interrupted by a STOP
+ */
+bool dwell(float seconds) {
+    if (!waitForMotion()) {
+        return false;
+    }
+    
+    TickType_t end = xTaskGetTickCount() + pdMS_TO_TICKS((uint32_t)(seconds * 1000.0f));
+    while ((int32_t)(end - xTaskGetTickCount()) > 0) {
+        if (stopPending()) {
+            return false;
+        }
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+    return true;
+}
+
+/**
+ * Run the homing sequence in the motion task and wait for it to end.
+ * 
+ * Queued moves finish first, so HOME keeps its place in the command
+ * order. A pending STOP abandons the wait and aborts the sequence.
+ * 
+ * @return true if the sequence ended (check robotSnapshot's isHomed), false if
+ *         interrupted by a STOP
+ */
+bool runHoming() {
+    if (!waitForMotion()) {
+        return false;
+    }
+    
+    homingRequested = true;
+    while (homingRequested) {
+        if (stopPending()) {
+            homingRequested = false;
+            return false;
+        }
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+    return true;
+}
+
+/**
+ * Follow an uploaded path, vertex by vertex, from pathBuffer.
+ * 
+ * Each vertex is a straight move from the previous one. Unreachable
+ * vertices are skipped. On a STOP the rest of the path is dropped from
+ * the buffer.
+ * 
+ * @param currentPos Start position, updated to the last vertex reached
+ * @param cmd PATH command naming the upload and its vertex count
+ * @return Number of vertices followed, or -1 if interrupted by a STOP
+ */
+int followPath(Point2D& currentPos, const Command& cmd) {
+    int followed = 0;
+    Point2D vertex;
+    
+    for (uint16_t i = 0; i < cmd.pathLength; i++) {
+        if (!pathBuffer.pop(cmd.pathId, vertex)) {
+            Serial.printf("Planner: Path %u ended after %u vertices\n", cmd.pathId, i);
+            break;
+        }
+        
+        if (!kinematics.isReachable(vertex)) {
+            Metrics::increment(metrics.ikFailures);
+            Serial.printf("Planner: Path vertex (%.2f, %.2f) is unreachable!\n",
+                         vertex.x, vertex.y);
+            continue;
+        }
+        
+        if (streamPath(currentPos, vertex) < 0) {
+            pathBuffer.discard(cmd.pathId);
+            return -1;
+        }
+        
+        currentPos = vertex;
+        followed++;
+    }
+    
+    return followed;
+}
+
+/**
+ * Follow a G2/G3 arc as a series of short chords.
+ * 
+ * Stops at the first unreachable chord end, leaving the arm at the last
+ * point reached. An arc whose end is not on the circle through the start
+ * is skipped.
+ * 
+ * @param currentPos Start position, updated to the last point reached
+ * @param cmd ARC_CW or ARC_CCW command
+ * @return Number of chords followed, or -1 if interrupted by a STOP
+ */
+int followArc(Point2D& currentPos, const Command& cmd) {
+    // Centre and relative axes are offsets from where the arc starts
+    Point2D target = cmd.resolveTarget(currentPos);
+    Point2D center(currentPos.x + cmd.center.x, currentPos.y + cmd.center.y);
+    float r0 = hypotf(currentPos.x - center.x, currentPos.y - center.y);
+    float r1 = hypotf(target.x - center.x, target.y - center.y);
+    if (r0 < ARC_TOLERANCE || fabsf(r0 - r1) > ARC_TOLERANCE) {
+        // An absolute end point programmed from elsewhere (e.g. before a STOP)
+        Serial.printf("Planner: Arc end (%.2f, %.2f) is off the circle, skipped\n",
+                     target.x, target.y);
+        return 0;
+    }
+    
+    ArcInterpolator arc;
+    arc.begin(currentPos, target, center, cmd.type == Command::ARC_CW);
+    
+    int chords = 0;
+    Point2D point;
+    while (arc.next(point)) {
+        if (!kinematics.isReachable(point)) {
+            Metrics::increment(metrics.ikFailures);
+            Serial.printf("Planner: Arc point (%.2f, %.2f) is unreachable!\n",
+                         point.x, point.y);
+            break;
+        }
+        
+        if (streamPath(currentPos, point) < 0) {
+            return -1;
+        }
+        
+        currentPos = point;
+        chords++;
+    }
+    
+    return chords;
+}
+
+/**
+ * Plan a path and feed it to motionQueue incrementally.
+ * 
+ * Each sample is pushed as soon as the planner produces it, so the motion
+ * task can start executing the first block while the rest of the move is
+ * still being generated here on core 0.
+ * 
+ * @return Number of points streamed, or -1 if interrupted by a STOP
+ */
+int streamPath(const Point2D& start, const Point2D& end) {
+    // Start the time-to-first-step clock only when the motion queue is
+    // empty; otherwise the next point executed belongs to a previous move.
+    if (uxQueueMessagesWaiting(motionQueue) == 0) {
+        moveRequestUs = micros();
+    }
+    
+    int numPoints = planner.beginPath(start, end);
+    Metrics::increment(metrics.plannerBlocks);
+    
+    // Samples are sent one behind the planner so each joint velocity can
+    // be estimated from its neighbours (central difference) for PVT.
+    Point2D point;
+    float t;
+    TrajectorySample sample;
+    TrajectorySample pending;
+    TrajectorySample previous;
+    bool hasPending = false;
+    bool hasPrevious = false;
+    
+    while (planner.nextPoint(point, t)) {
+        // Inverse kinematics runs here on core 0, not in the RT loop
+        if (!kinematics.inverse(point, sample.angles)) {
+            Metrics::increment(metrics.ikFailures);
+            Serial.printf("Planner: IK failed for (%.2f, %.2f)\n", point.x, point.y);
+            continue;
+        }
+        
+        sample.t = t;
+        sample.position = point;
+        
+        if (hasPending) {
+            // The move starts from rest; interior samples use their neighbours
+            if (hasPrevious) {
+                setJointVelocity(pending, previous, sample);
+            } else {
+                pending.velocity = JointAngles(0.0f, 0.0f);
+                pending.hasVelocity = true;
+            }
+            
+            if (!pushMotionSample(pending)) {
+                return -1;
+            }
+            Metrics::increment(metrics.plannerSamples);
+            previous = pending;
+            hasPrevious = true;
+        }
+        
+        pending = sample;
+        hasPending = true;
+    }
+    
+    // The move ends at rest
+    if (hasPending) {
+        pending.velocity = JointAngles(0.0f, 0.0f);
+        pending.hasVelocity = true;
+        if (!pushMotionSample(pending)) {
+            return -1;
+        }
+        Metrics::increment(metrics.plannerSamples);
+    }
+    
+    return numPoints;
+}
+
+/**
+ * Estimate the joint velocities of a sample from its two neighbours.
+ */
+void setJointVelocity(TrajectorySample& sample, const TrajectorySample& before,
+                      const TrajectorySample& after) {
+    float dt = after.t - before.t;
+    if (dt <= 0.0f) {
+        sample.velocity = JointAngles(0.0f, 0.0f);
+    } else {
+        sample.velocity.theta1 = angleDelta(before.angles.theta1, after.angles.theta1) / dt;
+        sample.velocity.theta2 = angleDelta(before.angles.theta2, after.angles.theta2) / dt;
+    }
+    sample.hasVelocity = true;
+}
+
+/**
+ * Task D: Serial G-code
+ * Core: 0
+ * Priority: Low
+ * 
+ * Reads G-code lines from Serial. Each line is answered with "ok" only
+ * once its command is in commandQueue (blocking while the planner is
+ * behind), so senders that wait for "ok", or count characters against
+ * the receive buffer, stream at the rate the planner consumes.
+ */
+void taskSerialGCode(void* parameter) {
+    Serial.println("Task SerialGCode started on Core 0");
+    
+    GCodeLineBuffer line;
+    Command cmd;
+    
+    while (true) {
+        while (Serial.available() > 0) {
+            if (!line.feed((char)Serial.read())) {
+                continue;
+            }
+            
+            Metrics::increment(metrics.commandsReceived);
+            if (line.overflowed()) {
+                Serial.println("error: Line too long");
+                continue;
+            }
+            
+            if (line.line()[0] == '$') {
+                if (handleSystemCommand(line.line())) {
+                    Serial.println("ok");
+                } else {
+                    Serial.println("error: Unknown $ command");
+                }
+                continue;
+            }
+            
+            GCodeInterpreter::Result result = serialGCode.execute(line.line(), cmd);
+            if (result == GCodeInterpreter::RESULT_ERROR) {
+                Serial.printf("error: %s\n", serialGCode.getError());
+                continue;
+            }
+            Metrics::increment(metrics.commandsParsed);
+            
+            if (result == GCodeInterpreter::RESULT_COMMAND) {
+                xQueueSend(commandQueue, &cmd, portMAX_DELAY);
+            }
+            serialGCode.commit();
+            Serial.println("ok");
+        }
+        
+        vTaskDelay(1);
+    }
+}
+
+/**
+ * Console commands starting with '$' (not G-code):
+ * - $LOOP        print the motion loop timing
+ * - $LOOP RESET  print it, then start measuring afresh
+ * - $PROF        print the PROFILE_SCOPE table
+ * - $PROF RESET  print it, then zero it
+ * 
+ * @return false if the command is unknown
+ */
+bool handleSystemCommand(const char* line) {
+    if (strcmp(line, "$LOOP") == 0 || strcmp(line, "$LOOP RESET") == 0) {
+        char report[LOOP_REPORT_SIZE];
+        motionLoopTimer.report(report, sizeof(report));
+        Serial.print(report);
+        if (line[5] != '\0') {
+            motionLoopTimer.requestReset();
+        }
+        return true;
+    }
+    if (strcmp(line, "$PROF") == 0 || strcmp(line, "$PROF RESET") == 0) {
+        char report[PROFILE_REPORT_SIZE];
+        profileReport(report, sizeof(report));
+        Serial.print(report);
+        if (line[5] != '\0') {
+            profileReset();
+        }
+        return true;
+    }
+    return false;
+}
+
 /**
  * Task C: Motion Control (Critical Loop)
  * Core: 1
  * Priority: High (Real-time)
  * Frequency: 100 Hz (10ms loop)
  * 
- * Pops points from motionQueue, calculates inverse kinematics,
- * and commands motors to move.
+ * Pulls time-stamped samples from motionQueue, interpolates the joint
+ * targets for the current time and commands motors to move (or hands
+ * each segment to the motors as a PVT triple when MOTION_USE_PVT is
+ * set). Because the targets follow the clock rather than the loop
+ * count, jitter or a missed tick does not change the execution speed.
+ * 
+ * Nothing here touches the network: the state is published to
+ * robotSnapshot and taskTelemetry sends it from core 0.
  */
 void taskMotionControl(void* parameter) {
     Serial.println("Task MotionControl started on Core 1");
     
     const TickType_t loopDelay = pdMS_TO_TICKS(1000 / MOTION_CONTROL_FREQUENCY);
-    Point2D targetPoint;
+    TrajectoryExecutor executor;
+    TrajectorySample sample;
+    TrajectorySample segmentEnd;  // End of the current executor segment
+    float segmentDuration;
     JointAngles targetAngles;
+    Point2D targetPoint;
+    
+    // Wake times follow from the first one, so the period does not
+    // stretch by the time spent in the loop body
+    TickType_t lastWakeTime = xTaskGetTickCount();
+    
+    // The cycle counter is per core; this task stays on core 1
+    motionLoopTimer.setClockRate(ESP.getCpuFreqMHz());
+    
+    // The step interrupt goes to the core that starts the timer
+    StepTicker::begin();
     
     while (true) {
-        TickType_t lastWakeTime = xTaskGetTickCount();
+        motionLoopTimer.begin(ESP.getCycleCount());
+        uint32_t nowUs = micros();
+        
+        if (stopRequested) {
+            applyStop(executor);
+            segmentEnd = TrajectorySample();
+        }
         
-        // Check motion queue
-        if (xQueueReceive(motionQueue, &targetPoint, 0) == pdTRUE) {
-            // New target point received
-            robotState.isMoving = true;
+        if (homingRequested || homing->isActive()) {
+            updateHoming(executor);
             
-            // Calculate inverse kinematics
-            if (kinematics.inverse(targetPoint, targetAngles)) {
-                // Command motors to move to target angles
-                motor1->moveToAngle(targetAngles.theta1);
-                motor2->moveToAngle(targetAngles.theta2);
-                
-                robotState.currentAngles = targetAngles;
-                robotState.currentPosition = targetPoint;
-                
-                #if DEBUG_MOTOR
-                Serial.printf("Motion: Target (%.2f, %.2f) -> θ1=%.2f°, θ2=%.2f°\n",
-                             targetPoint.x, targetPoint.y,
-                             targetAngles.theta1, targetAngles.theta2);
-                #endif
-            } else {
-                Serial.printf("Motion: IK failed for (%.2f, %.2f)\n",
-                             targetPoint.x, targetPoint.y);
+            arm->update();
+            publishState(arm->isMoving());
+            updateMotionMetrics(executor);
+            motionLoopTimer.end(ESP.getCycleCount());
+            vTaskDelayUntil(&lastWakeTime, loopDelay);
+            continue;
+        }
+        
+        // Pull every sample needed to reach the current time
+        while (executor.needsSample(nowUs) &&
+               xQueueReceive(motionQueue, &sample, 0) == pdTRUE) {
+            executor.push(sample, nowUs);
+            
+            #if STEP_TRACE_ENABLED
+            // The plan the recorded steps are compared against (the step
+            // interrupt writes the trace too)
+            {
+                StepTickerLock lock;
+                stepTrace.recordSample(sample.position, sample.t <= 0.0f, nowUs);
+            }
+            #endif
+            
+            // First sample of a new move: record time-to-first-step
+            uint32_t requestUs = moveRequestUs.exchange(0);
+            if (requestUs != 0) {
+                robotState.firstStepLatency.record(nowUs - requestUs);
             }
-        } else {
-            // No new target, maintain current position
-            robotState.isMoving = (motor1->isMoving() || motor2->isMoving());
         }
         
-        // Update motors (generate steps for steppers, update PWM for servos)
-        motor1->update();
-        motor2->update();
+        // With PVT the motors interpolate each segment themselves, so they
+        // only hear from us once per sample instead of on every tick
+        bool usePVT = MOTION_USE_PVT && segmentEnd.hasVelocity;
+        if (executor.takeSegment(nowUs, segmentEnd, segmentDuration)) {
+            usePVT = MOTION_USE_PVT && segmentEnd.hasVelocity;
+            if (usePVT) {
+                arm->moveToPVT(segmentEnd.angles, segmentEnd.velocity, segmentDuration);
+            }
+        }
         
-        // Broadcast status periodically (every 10 loops = 1 second at 100Hz)
-        static int statusCounter = 0;
-        if (++statusCounter >= 10) {
-            statusCounter = 0;
-            webServer.broadcastStatus(robotState);
+        if (executor.sample(nowUs, targetAngles, targetPoint)) {
+            if (!usePVT) {
+                // Command motors to move to the interpolated target angles
+                arm->moveToAngles(targetAngles);
+            }
+            
+            #if DEBUG_MOTOR
+            Serial.printf("Motion: Target (%.2f, %.2f) -> θ1=%.2f°, θ2=%.2f°\n",
+                         targetPoint.x, targetPoint.y,
+                         targetAngles.theta1, targetAngles.theta2);
+            #endif
         }
         
+        // Update motors (servo PWM; steppers are stepped by StepTicker)
+        arm->update();
+        
+        // Lock-free hand-off to the planner and the telemetry task
+        publishState(executor.isActive() || arm->isMoving());
+        updateMotionMetrics(executor);
+        motionLoopTimer.end(ESP.getCycleCount());
+        
         // Fixed frequency loop
         vTaskDelayUntil(&lastWakeTime, loopDelay);
     }
 }
 
+/**
+ * Task E: Telemetry
+ * Core: 0
+ * Priority: Low
+ * 
+ * Sends the state published by the motion task to the WebSocket
+ * clients. All JSON/binary encoding and AsyncWebSocket locking happens
+ * here, off the real-time core.
+ */
+void taskTelemetry(void* parameter) {
+    Serial.println("Task Telemetry started on Core 0");
+    
+    TickType_t lastWakeTime = xTaskGetTickCount();
+    #if DEBUG_LOOP_TIMING
+    uint32_t lastReportMs = millis();
+    #endif
+    
+    while (true) {
+        RobotState state = robotSnapshot.read();
+        
+        // Cheap unless a client is due a message
+        webServer.broadcastStatus(state);
+        
+        #if DEBUG_LOOP_TIMING
+        if (millis() - lastReportMs >= 10000) {
+            lastReportMs = millis();
+            char report[LOOP_REPORT_SIZE];
+            motionLoopTimer.report(report, sizeof(report));
+            Serial.print(report);
+        }
+        #endif
+        
+        vTaskDelayUntil(&lastWakeTime, pdMS_TO_TICKS(TELEMETRY_TASK_PERIOD_MS));
+    }
+}
+
+/**
+ * Advance the homing sequence from the motion task.
+ * 
+ * Started when the planner sets homingRequested; aborted when the planner
+ * clears it early (STOP). On completion the joint angles are known again,
+ * so the Cartesian position is taken from forward kinematics.
+ */
+void updateHoming(TrajectoryExecutor& executor) {
+    uint32_t nowMs = millis();
+    
+    if (!homingRequested) {
+        homing->abort();
+        return;
+    }
+    
+    if (!homing->isActive()) {
+        // The trajectory in progress (if any) is meaningless after homing
+        executor.reset();
+        homing->begin(nowMs);
+    }
+    
+    homing->update(nowMs);
+    
+    if (!homing->isActive()) {
+        // Publish before clearing the flag: the planner reads the result
+        // as soon as it sees the flag drop
+        robotState.isHomed = homing->isDone();
+        publishState(arm->isMoving());
+        homingRequested = false;
+    }
+}
+
+/**
+ * Stop where the arm is, from the motion task (STOP).
+ * 
+ * The planner has already emptied motionQueue; the samples the executor
+ * holds and the motors' own targets and segments go too. The planner
+ * resumes from the published position once it sees the flag drop.
+ */
+void applyStop(TrajectoryExecutor& executor) {
+    executor.reset();
+    arm->stop();
+    moveRequestUs = 0;
+    
+    // Publish before clearing the flag, as for homing
+    publishState(arm->isMoving());
+    stopRequested = false;
+}
+
+/**
+ * Publish the arm state to robotSnapshot (motion task, or setup before
+ * the tasks start).
+ * 
+ * The angles are read back from the motors (step counts for steppers)
+ * and the position computed from them by forward kinematics, so readers
+ * see where the arm is, not where it was last told to go.
+ */
+void publishState(bool moving) {
+    robotState.currentAngles = arm->getCurrentAngles();
+    kinematics.forward(robotState.currentAngles, robotState.currentPosition);
+    robotState.isMoving = moving;
+    robotSnapshot.write(robotState);
+}
+
+/**
+ * Copy the motion task's counters to the shared metrics (relaxed stores,
+ * no locking: cheap enough for every loop).
+ */
+void updateMotionMetrics(const TrajectoryExecutor& executor) {
+    Metrics::set(metrics.motionQueueDepth, (uint32_t)uxQueueMessagesWaiting(motionQueue));
+    Metrics::set(metrics.motionUnderruns, executor.getUnderruns());
+    Metrics::set(metrics.stepsIssued[0], motor1->getStepsIssued());
+    Metrics::set(metrics.stepsIssued[1], motor2->getStepsIssued());
+}
+
 // ============================================================================
 // Notes on Stack Size Tuning
 // ============================================================================
@@ -388,7 +1097,8 @@ void taskMotionControl(void* parameter) {
  * Stack Size Tuning Guidelines:
  * 
  * 1. Start with the default values in Config.h
- * 2. Monitor stack usage using FreeRTOS functions:
+ * 2. Monitor stack usage: /metrics reports scara_task_stack_free_bytes
+ *    for every task, or use the FreeRTOS functions directly:
  *    - uxTaskGetStackHighWaterMark() - returns minimum free stack
  *    - Add this to each task to monitor:
  *      UBaseType_t stack = uxTaskGetStackHighWaterMark(nullptr);
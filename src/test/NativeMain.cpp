@@ -0,0 +1,19 @@
+/**
+ * @file NativeMain.cpp
+ * @brief Entry point of the host unit test build
+ *
+ * Built by the native environment only (the ESP32 build runs the tests
+ * from setup() when RUN_UNIT_TESTS is set):
+ *
+ *   pio run -e native -t exec
+ */
+
+#ifndef ARDUINO
+
+#include "RunTests.h"
+
+int main() {
+    return runAllUnitTests() ? 0 : 1;
+}
+
+#endif
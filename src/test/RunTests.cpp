@@ -1,12 +1,12 @@
 #include "RunTests.h"
 #include "../hardware/StepperMotor.h"
 
-void runAllUnitTests() {
-    Serial.println("\n\n");
-    Serial.println("╔══════════════════════════════════════════════════════════╗");
-    Serial.println("║         ESP32 SCARA ROBOT - UNIT TESTS                   ║");
-    Serial.println("╚══════════════════════════════════════════════════════════╝");
-    Serial.println();
+bool runAllUnitTests() {
+    testPrintf("\n\n\n");
+    testPrintf("╔══════════════════════════════════════════════════════════╗\n");
+    testPrintf("║         ESP32 SCARA ROBOT - UNIT TESTS                   ║\n");
+    testPrintf("╚══════════════════════════════════════════════════════════╝\n");
+    testPrintf("\n");
     
     TestRunner runner(true);
     
@@ -15,14 +15,33 @@ void runAllUnitTests() {
     TestKinematics::runAllTests(runner);
     TestPlanner::runAllTests(runner);
     TestStepperMotor::runAllTests(runner);
+    TestTrajectoryExecutor::runAllTests(runner);
+    TestHermite::runAllTests(runner);
+    TestStepSegment::runAllTests(runner);
+    TestPulseTrain::runAllTests(runner);
+    TestMotionController::runAllTests(runner);
+    TestSimMotor::runAllTests(runner);
+    TestHoming::runAllTests(runner);
+    TestBinaryProtocol::runAllTests(runner);
+    TestGCode::runAllTests(runner);
+    TestTelemetry::runAllTests(runner);
+    TestHttpCache::runAllTests(runner);
+    TestMetrics::runAllTests(runner);
+    TestLoopTiming::runAllTests(runner);
+    TestProfiler::runAllTests(runner);
+    TestStepTrace::runAllTests(runner);
     
     // Print final results
     runner.printResults();
     
-    Serial.println("\nTests completed. Check results above.");
-    Serial.println("Press RESET to run tests again.\n");
+    testPrintf("\nTests completed. Check results above.\n");
+#ifdef ARDUINO
+    testPrintf("Press RESET to run tests again.\n\n");
+#endif
+    return runner.getStats().failed == 0;
 }
 
+#ifdef ARDUINO
 void runVisualTestsOnly() {
     Serial.println("\n\n");
     Serial.println("╔══════════════════════════════════════════════════════════╗");
@@ -45,6 +64,10 @@ void runInteractiveTest() {
     StepperMotor* motor1 = new StepperMotor(MOTOR1_STEP_PIN, MOTOR1_DIR_PIN, MOTOR1_ENABLE_PIN);
     StepperMotor* motor2 = new StepperMotor(MOTOR2_STEP_PIN, MOTOR2_DIR_PIN, MOTOR2_ENABLE_PIN);
     
+    // Ramped moves can run well above the pull-in rate
+    motor1->setSpeed(STEPPER_MAX_SPEED);
+    motor2->setSpeed(STEPPER_MAX_SPEED);
+    
     // Run interactive test
     TestInteractive::run(motor1, motor2);
     
@@ -52,3 +75,4 @@ void runInteractiveTest() {
     delete motor1;
     delete motor2;
 }
+#endif
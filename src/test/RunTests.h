@@ -6,16 +6,44 @@
 #include "TestPlanner.h"
 #include "TestTypes.h"
 #include "TestStepperMotor.h"
+#include "TestTrajectoryExecutor.h"
+#include "TestHermite.h"
+#include "TestStepSegment.h"
+#include "TestPulseTrain.h"
+#include "TestMotionController.h"
+#include "TestSimMotor.h"
+#include "TestHoming.h"
+#include "TestBinaryProtocol.h"
+#include "TestGCode.h"
+#include "TestTelemetry.h"
+#include "TestHttpCache.h"
+#include "TestMetrics.h"
+#include "TestLoopTiming.h"
+#include "TestProfiler.h"
+#include "TestStepTrace.h"
+#ifdef ARDUINO
 #include "TestVisual.h"
 #include "TestInteractive.h"
+#endif
 
 /**
  * @file RunTests.h
  * @brief Main test runner that executes all test suites
+ *
+ * The unit tests also build for the host ([env:native] in platformio.ini,
+ * entry point NativeMain.cpp); the visual and interactive tests need the
+ * hardware and are ESP32 only.
  */
 
-void runAllUnitTests();
+/**
+ * @brief Run every unit test suite
+ * @return true if all tests passed
+ */
+bool runAllUnitTests();
+
+#ifdef ARDUINO
 void runVisualTestsOnly();
 void runInteractiveTest();
+#endif
 
 #endif // RUN_TESTS_H
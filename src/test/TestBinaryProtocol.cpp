@@ -0,0 +1,449 @@
+#include "TestBinaryProtocol.h"
+
+void TestBinaryProtocol::runAllTests(TestRunner& runner) {
+    runner.printHeader("BINARY PROTOCOL");
+    
+    runner.runTest("MOVE_TO round trip", testMoveToRoundTrip);
+    runner.runTest("Little-endian wire layout", testWireLayout);
+    runner.runTest("STATUS round trip", testStatusRoundTrip);
+    runner.runTest("Rejects bad frames", testRejectsBadFrames);
+    runner.runTest("Client sessions", testClientSessions);
+    runner.runTest("Session telemetry requests", testTelemetryRequests);
+    runner.runTest("Binary switch starts with a full status", testBinarySwitchFull);
+    runner.runTest("PATH decoded in pieces", testPathInPieces);
+    runner.runTest("PATH larger than free space", testPathNoRoom);
+    runner.runTest("PATH buffer skips abandoned uploads", testPathBufferSkipsStale);
+    runner.runTest("Rejected full-size PATH taken back", testRejectedPathTakenBack);
+    runner.runTest("PATHs flushed by STOP dropped", testFlushedPathsDropped);
+    runner.runTest("Whole message passed in place", testWholeMessageNotCopied);
+    runner.runTest("Message reassembled from pieces", testMessageInPieces);
+    runner.runTest("Oversized message dropped", testMessageDropped);
+}
+
+// Encode a PATH message with vertices (i, 2i) into frame
+static size_t encodeTestPath(uint16_t count, float speed, uint8_t* frame, size_t capacity) {
+    size_t len = BinaryProtocol::encodePathStart(speed, count, frame, capacity);
+    for (uint16_t i = 0; i < count; i++) {
+        len += BinaryProtocol::encodeVertex(Point2D(i, 2.0f * i), frame + len, capacity - len);
+    }
+    return len;
+}
+
+bool TestBinaryProtocol::testMoveToRoundTrip() {
+    TestRunner runner(false);
+    
+    uint8_t frame[32];
+    Command sent(Command::MOVE_TO, Point2D(123.5f, -42.25f), 75.0f);
+    size_t len = BinaryProtocol::encodeCommand(sent, frame, sizeof(frame));
+    
+    Command received;
+    BinaryProtocol::Result result = BinaryProtocol::decodeCommand(frame, len, received);
+    
+    return runner.assertEqual((int)(BinaryProtocol::HEADER_SIZE + BinaryProtocol::MOVE_TO_PAYLOAD), (int)len) &&
+           runner.assertEqual((int)BinaryProtocol::OK, (int)result) &&
+           runner.assertEqual((int)Command::MOVE_TO, (int)received.type) &&
+           runner.assertEqual(123.5f, received.target.x, 0.0001f) &&
+           runner.assertEqual(-42.25f, received.target.y, 0.0001f) &&
+           runner.assertEqual(75.0f, received.speed, 0.0001f);
+}
+
+bool TestBinaryProtocol::testWireLayout() {
+    TestRunner runner(false);
+    
+    // 1.0f is 0x3F800000, so its little-endian bytes are 00 00 80 3F
+    uint8_t frame[32];
+    Command cmd(Command::MOVE_TO, Point2D(1.0f, 0.0f), 0.0f);
+    BinaryProtocol::encodeCommand(cmd, frame, sizeof(frame));
+    
+    if (!runner.assertEqual(BINARY_PROTOCOL_VERSION, (int)frame[0])) return false;
+    if (!runner.assertEqual((int)BinaryProtocol::MSG_MOVE_TO, (int)frame[1])) return false;
+    if (!runner.assertEqual(12, (int)frame[2])) return false;
+    if (!runner.assertEqual(0, (int)frame[3])) return false;
+    if (!runner.assertEqual(0x00, (int)frame[4])) return false;
+    if (!runner.assertEqual(0x00, (int)frame[5])) return false;
+    if (!runner.assertEqual(0x80, (int)frame[6])) return false;
+    if (!runner.assertEqual(0x3F, (int)frame[7])) return false;
+    
+    // Credits: 0x0102 -> 02 01, path space: 0x0304 -> 04 03
+    size_t len = BinaryProtocol::encodeCredits(BinaryProtocol::MSG_ACK, 0x0102, 0x0304,
+                                               frame, sizeof(frame));
+    return runner.assertEqual(8, (int)len) &&
+           runner.assertEqual((int)BinaryProtocol::MSG_ACK, (int)frame[1]) &&
+           runner.assertEqual(0x02, (int)frame[4]) &&
+           runner.assertEqual(0x01, (int)frame[5]) &&
+           runner.assertEqual(0x04, (int)frame[6]) &&
+           runner.assertEqual(0x03, (int)frame[7]);
+}
+
+bool TestBinaryProtocol::testStatusRoundTrip() {
+    TestRunner runner(false);
+    
+    StatusFrame sent;
+    sent.position = Point2D(10.5f, 200.25f);
+    sent.angles = JointAngles(45.0f, 300.5f);
+    sent.isMoving = true;
+    sent.isHomed = false;
+    sent.credits = 7;
+    sent.ttfsUs = 12345;
+    sent.ttfsMaxUs = 70000;
+    sent.pathSpace = 1500;
+    
+    uint8_t frame[BinaryProtocol::MAX_FRAME_SIZE];
+    size_t len = BinaryProtocol::encodeStatus(sent, frame, sizeof(frame));
+    
+    StatusFrame received;
+    BinaryProtocol::Result result = BinaryProtocol::decodeStatus(frame, len, received);
+    
+    return runner.assertEqual((int)(BinaryProtocol::HEADER_SIZE + BinaryProtocol::STATUS_PAYLOAD), (int)len) &&
+           runner.assertEqual((int)BinaryProtocol::OK, (int)result) &&
+           runner.assertEqual(10.5f, received.position.x, 0.0001f) &&
+           runner.assertEqual(200.25f, received.position.y, 0.0001f) &&
+           runner.assertEqual(45.0f, received.angles.theta1, 0.0001f) &&
+           runner.assertEqual(300.5f, received.angles.theta2, 0.0001f) &&
+           runner.assertTrue(received.isMoving) &&
+           runner.assertFalse(received.isHomed) &&
+           runner.assertEqual(7, (int)received.credits) &&
+           runner.assertEqual(12345, (int)received.ttfsUs) &&
+           runner.assertEqual(70000, (int)received.ttfsMaxUs) &&
+           runner.assertEqual(1500, (int)received.pathSpace);
+}
+
+bool TestBinaryProtocol::testRejectsBadFrames() {
+    TestRunner runner(false);
+    
+    uint8_t frame[32];
+    Command cmd;
+    size_t len = BinaryProtocol::encodeCommand(Command(Command::MOVE_TO, Point2D(1, 2), 3),
+                                               frame, sizeof(frame));
+    
+    // Cut short
+    if (!runner.assertEqual((int)BinaryProtocol::ERROR_TRUNCATED,
+                            (int)BinaryProtocol::decodeCommand(frame, len - 1, cmd))) return false;
+    if (!runner.assertEqual((int)BinaryProtocol::ERROR_TRUNCATED,
+                            (int)BinaryProtocol::decodeCommand(frame, 2, cmd))) return false;
+    
+    // Wrong payload length for the type
+    frame[2] = 8;
+    if (!runner.assertEqual((int)BinaryProtocol::ERROR_BAD_LENGTH,
+                            (int)BinaryProtocol::decodeCommand(frame, len, cmd))) return false;
+    frame[2] = 12;
+    
+    // Server-to-client type
+    frame[1] = BinaryProtocol::MSG_STATUS;
+    if (!runner.assertEqual((int)BinaryProtocol::ERROR_UNKNOWN_TYPE,
+                            (int)BinaryProtocol::decodeCommand(frame, len, cmd))) return false;
+    frame[1] = BinaryProtocol::MSG_MOVE_TO;
+    
+    // Other protocol version
+    frame[0] = BINARY_PROTOCOL_VERSION + 1;
+    FrameHeader header;
+    return runner.assertEqual((int)BinaryProtocol::ERROR_BAD_VERSION,
+                              (int)BinaryProtocol::decodeCommand(frame, len, cmd)) &&
+           runner.assertEqual((int)BinaryProtocol::ERROR_BAD_VERSION,
+                              (int)BinaryProtocol::readHeader(frame, len, header)) &&
+           runner.assertEqual(BINARY_PROTOCOL_VERSION + 1, (int)header.version);
+}
+
+bool TestBinaryProtocol::testClientSessions() {
+    TestRunner runner(false);
+    
+    ClientSessionTable table;
+    
+    // Fill every slot; one more is refused
+    for (int i = 0; i < WS_MAX_CLIENTS; i++) {
+        if (!runner.assertTrue(table.open(100 + i) != nullptr)) return false;
+    }
+    if (!runner.assertTrue(table.open(999) == nullptr)) return false;
+    if (!runner.assertEqual(WS_MAX_CLIENTS, table.count(ClientSession::FORMAT_JSON))) return false;
+    
+    // Negotiate binary for one client (applied by the telemetry task)
+    table.find(101)->requestBinaryFormat();
+    table.find(101)->applyTelemetryRequests();
+    if (!runner.assertEqual(1, table.count(ClientSession::FORMAT_BINARY))) return false;
+    
+    // A freed slot is reused and starts on JSON again
+    table.close(101);
+    if (!runner.assertTrue(table.find(101) == nullptr)) return false;
+    ClientSession* session = table.open(999);
+    if (!runner.assertTrue(session != nullptr)) return false;
+    session->applyTelemetryRequests();
+    return runner.assertEqual((int)ClientSession::FORMAT_JSON, (int)session->format) &&
+           runner.assertEqual(0, table.count(ClientSession::FORMAT_BINARY));
+}
+
+bool TestBinaryProtocol::testTelemetryRequests() {
+    TestRunner runner(false);
+    
+    ClientSessionTable table;
+    ClientSession* session = table.open(7);
+    session->applyTelemetryRequests();
+    
+    // The channel has a baseline and stays unchanged until the requests
+    // are applied (by the telemetry task)
+    StatusFrame status;
+    uint16_t mask;
+    session->telemetry.sent(status, BinaryProtocol::FIELD_ALL, 1000);
+    session->requestTelemetryInterval(250);
+    session->requestBinaryFormat();
+    if (!runner.assertEqual(TELEMETRY_DEFAULT_INTERVAL_MS, (int)session->telemetry.getInterval())) return false;
+    if (!runner.assertEqual((int)ClientSession::FORMAT_JSON, (int)session->format)) return false;
+    if (!runner.assertEqual((int)TelemetryChannel::SEND_NONE,
+                            (int)session->telemetry.poll(status, 1001, false, mask))) return false;
+    
+    // All apply: the next status is a full binary one, at the new interval
+    session->applyTelemetryRequests();
+    if (!runner.assertEqual((int)ClientSession::FORMAT_BINARY, (int)session->format)) return false;
+    if (!runner.assertEqual(250, (int)session->telemetry.getInterval())) return false;
+    if (!runner.assertEqual((int)TelemetryChannel::SEND_FULL,
+                            (int)session->telemetry.poll(status, 1002, false, mask))) return false;
+    
+    // Applied once only
+    session->telemetry.sent(status, BinaryProtocol::FIELD_ALL, 1002);
+    session->applyTelemetryRequests();
+    return runner.assertEqual((int)TelemetryChannel::SEND_NONE,
+                              (int)session->telemetry.poll(status, 1003, false, mask));
+}
+
+bool TestBinaryProtocol::testBinarySwitchFull() {
+    TestRunner runner(false);
+    
+    ClientSessionTable table;
+    ClientSession* session = table.open(7);
+    session->applyTelemetryRequests();
+    StatusFrame status;
+    uint16_t mask;
+    
+    // The telemetry task sends a full JSON status
+    if (!runner.assertEqual((int)TelemetryChannel::SEND_FULL,
+                            (int)session->telemetry.poll(status, 1000, false, mask))) return false;
+    
+    // HELLO arrives while that status goes out: the pass still sees JSON
+    session->requestBinaryFormat();
+    if (!runner.assertEqual((int)ClientSession::FORMAT_JSON, (int)session->format)) return false;
+    session->telemetry.sent(status, BinaryProtocol::FIELD_ALL, 1000);
+    
+    // Next pass: binary, and a full status before any delta
+    status.credits = 3;
+    session->applyTelemetryRequests();
+    return runner.assertEqual((int)ClientSession::FORMAT_BINARY, (int)session->format) &&
+           runner.assertEqual((int)TelemetryChannel::SEND_FULL,
+                              (int)session->telemetry.poll(status, 1000 + TELEMETRY_DEFAULT_INTERVAL_MS,
+                                                           false, mask));
+}
+
+bool TestBinaryProtocol::testPathInPieces() {
+    TestRunner runner(false);
+    
+    const uint16_t count = 300;
+    static uint8_t frame[BinaryProtocol::HEADER_SIZE + 4 + count * BinaryProtocol::PATH_VERTEX_SIZE];
+    size_t len = encodeTestPath(count, 40.0f, frame, sizeof(frame));
+    if (!runner.assertEqual((int)sizeof(frame), (int)len)) return false;
+    
+    // Odd piece sizes split the header and many vertices across pieces
+    static PathBuffer buffer;
+    PathStreamDecoder decoder;
+    decoder.begin(&buffer, 7);
+    
+    size_t sent = 0;
+    size_t piece = 3;
+    while (sent < len) {
+        size_t n = (len - sent < piece) ? len - sent : piece;
+        if (!runner.assertEqual((int)BinaryProtocol::OK, (int)decoder.feed(frame + sent, n))) return false;
+        sent += n;
+        piece = (piece * 7) % 61 + 1;
+    }
+    
+    if (!runner.assertTrue(decoder.isComplete())) return false;
+    if (!runner.assertEqual((int)count, (int)decoder.getVertexCount())) return false;
+    if (!runner.assertEqual(40.0f, decoder.getSpeed(), 0.0001f)) return false;
+    
+    Point2D point;
+    for (int i = 0; i < count; i++) {
+        if (!runner.assertTrue(buffer.pop(7, point))) return false;
+        if (!runner.assertEqual((float)i, point.x, 0.0001f)) return false;
+        if (!runner.assertEqual(2.0f * i, point.y, 0.0001f)) return false;
+    }
+    return runner.assertFalse(buffer.pop(7, point));
+}
+
+bool TestBinaryProtocol::testPathNoRoom() {
+    TestRunner runner(false);
+    
+    // Leave room for 10 vertices only
+    static PathBuffer buffer;
+    for (int i = 0; i < PATH_BUFFER_SIZE - 11; i++) {
+        buffer.push(Point2D(0, 0), 1);
+    }
+    if (!runner.assertEqual(10, buffer.available())) return false;
+    
+    uint8_t frame[BinaryProtocol::HEADER_SIZE + 4 + 11 * BinaryProtocol::PATH_VERTEX_SIZE];
+    size_t len = encodeTestPath(11, 0.0f, frame, sizeof(frame));
+    
+    PathStreamDecoder decoder;
+    decoder.begin(&buffer, 2);
+    
+    // Rejected on the header, before any vertex is written
+    return runner.assertEqual((int)BinaryProtocol::ERROR_NO_ROOM, (int)decoder.feed(frame, len)) &&
+           runner.assertEqual((int)PathStreamDecoder::FAILED, (int)decoder.getState()) &&
+           runner.assertEqual(10, buffer.available());
+}
+
+bool TestBinaryProtocol::testPathBufferSkipsStale() {
+    TestRunner runner(false);
+    
+    static PathBuffer buffer;
+    
+    // Upload 3 was abandoned, upload 4 is complete, upload 5 is arriving
+    buffer.push(Point2D(3, 0), 3);
+    buffer.push(Point2D(3, 1), 3);
+    buffer.push(Point2D(4, 0), 4);
+    buffer.push(Point2D(4, 1), 4);
+    buffer.push(Point2D(5, 0), 5);
+    
+    Point2D point;
+    if (!runner.assertTrue(buffer.pop(4, point))) return false;
+    if (!runner.assertEqual(4.0f, point.x, 0.0001f)) return false;
+    if (!runner.assertEqual(0.0f, point.y, 0.0001f)) return false;
+    if (!runner.assertTrue(buffer.pop(4, point))) return false;
+    if (!runner.assertEqual(1.0f, point.y, 0.0001f)) return false;
+    
+    // Path 4 is exhausted; path 5's vertex must not be consumed
+    if (!runner.assertFalse(buffer.pop(4, point))) return false;
+    
+    // Ids wrap around: 65535 is older than 1
+    PathBuffer wrapped;
+    wrapped.push(Point2D(9, 9), 65535);
+    wrapped.push(Point2D(1, 1), 1);
+    return runner.assertTrue(buffer.pop(5, point)) &&
+           runner.assertEqual(5.0f, point.x, 0.0001f) &&
+           runner.assertTrue(wrapped.pop(1, point)) &&
+           runner.assertEqual(1.0f, point.x, 0.0001f);
+}
+
+bool TestBinaryProtocol::testRejectedPathTakenBack() {
+    TestRunner runner(false);
+    
+    static PathBuffer buffer;
+    static uint8_t frame[BinaryProtocol::HEADER_SIZE + 4 +
+                         (PATH_BUFFER_SIZE - 1) * BinaryProtocol::PATH_VERTEX_SIZE];
+    size_t len = encodeTestPath(PATH_BUFFER_SIZE - 1, 0.0f, frame, sizeof(frame));
+    
+    // A full-size upload completes, but its command finds the queue full
+    PathStreamDecoder decoder;
+    decoder.begin(&buffer, 1);
+    if (!runner.assertEqual((int)BinaryProtocol::OK, (int)decoder.feed(frame, len))) return false;
+    if (!runner.assertTrue(decoder.isComplete())) return false;
+    if (!runner.assertEqual(0, buffer.available())) return false;
+    decoder.abort();
+    if (!runner.assertEqual(PATH_BUFFER_SIZE - 1, buffer.available())) return false;
+    
+    // The next upload fits, and the planner only sees its vertices
+    decoder.begin(&buffer, 2);
+    if (!runner.assertEqual((int)BinaryProtocol::OK, (int)decoder.feed(frame, len))) return false;
+    Point2D point;
+    return runner.assertTrue(decoder.isComplete()) &&
+           runner.assertFalse(buffer.pop(1, point)) &&
+           runner.assertTrue(buffer.pop(2, point)) &&
+           runner.assertEqual(0.0f, point.x, 0.0001f);
+}
+
+bool TestBinaryProtocol::testFlushedPathsDropped() {
+    TestRunner runner(false);
+    
+    static PathBuffer buffer;
+    
+    // Paths 3 and 4 were queued, then flushed by a STOP; 5 is arriving
+    buffer.push(Point2D(3, 0), 3);
+    buffer.push(Point2D(4, 0), 4);
+    buffer.push(Point2D(4, 1), 4);
+    buffer.push(Point2D(5, 0), 5);
+    
+    // Nothing happens before the mark, and the mark is used once
+    buffer.dropAbandoned();
+    if (!runner.assertEqual(PATH_BUFFER_SIZE - 5, buffer.available())) return false;
+    buffer.abandonBefore(5);
+    buffer.dropAbandoned();
+    if (!runner.assertEqual(PATH_BUFFER_SIZE - 2, buffer.available())) return false;
+    buffer.dropAbandoned();
+    
+    Point2D point;
+    return runner.assertEqual(PATH_BUFFER_SIZE - 2, buffer.available()) &&
+           runner.assertTrue(buffer.pop(5, point)) &&
+           runner.assertEqual(5.0f, point.x, 0.0001f);
+}
+
+bool TestBinaryProtocol::testWholeMessageNotCopied() {
+    TestRunner runner(false);
+    
+    static MessageAssembler assembler;  // Too large for the test task's stack
+    assembler.clear();
+    uint8_t data[] = "{\"type\":\"HOME\"}";
+    uint8_t* message = nullptr;
+    size_t length = 0;
+    
+    MessageAssembler::Result result =
+        assembler.feed(1, data, sizeof(data) - 1, true, true, message, length);
+    
+    return runner.assertEqual((int)MessageAssembler::MESSAGE_COMPLETE, (int)result) &&
+           runner.assertTrue(message == data) &&
+           runner.assertEqual((int)sizeof(data) - 1, (int)length) &&
+           runner.assertEqual(WS_REASSEMBLY_SLOTS, assembler.freeSlots());
+}
+
+bool TestBinaryProtocol::testMessageInPieces() {
+    TestRunner runner(false);
+    
+    static MessageAssembler assembler;  // Too large for the test task's stack
+    assembler.clear();
+    uint8_t a1[] = {'G', '1', ' '};
+    uint8_t a2[] = {'X', '5'};
+    uint8_t b1[] = {'G', '2', '8'};
+    uint8_t* message = nullptr;
+    size_t length = 0;
+    
+    // Two clients interleaving their pieces
+    if (!runner.assertEqual((int)MessageAssembler::MESSAGE_PENDING,
+                            (int)assembler.feed(1, a1, sizeof(a1), true, false, message, length))) return false;
+    if (!runner.assertEqual((int)MessageAssembler::MESSAGE_PENDING,
+                            (int)assembler.feed(2, b1, sizeof(b1), true, false, message, length))) return false;
+    if (!runner.assertEqual((int)MessageAssembler::MESSAGE_COMPLETE,
+                            (int)assembler.feed(1, a2, sizeof(a2), false, true, message, length))) return false;
+    if (!runner.assertEqual(5, (int)length)) return false;
+    if (!runner.assertTrue(memcmp(message, "G1 X5", 5) == 0 && message[5] == '\0')) return false;
+    
+    // Releasing returns the slot; client 2 still holds one
+    assembler.release(1);
+    if (!runner.assertEqual(WS_REASSEMBLY_SLOTS - 1, assembler.freeSlots())) return false;
+    
+    // A disconnect frees the slot of an unfinished message
+    assembler.release(2);
+    return runner.assertEqual(WS_REASSEMBLY_SLOTS, assembler.freeSlots());
+}
+
+bool TestBinaryProtocol::testMessageDropped() {
+    TestRunner runner(false);
+    
+    static MessageAssembler assembler;  // Too large for the test task's stack
+    assembler.clear();
+    static uint8_t piece[WS_MESSAGE_MAX / 2 + 1];
+    memset(piece, 'x', sizeof(piece));
+    uint8_t* message = nullptr;
+    size_t length = 0;
+    
+    // Two pieces together exceed WS_MESSAGE_MAX: reported once, at the end
+    if (!runner.assertEqual((int)MessageAssembler::MESSAGE_PENDING,
+                            (int)assembler.feed(1, piece, sizeof(piece), true, false, message, length))) return false;
+    if (!runner.assertEqual((int)MessageAssembler::MESSAGE_DROPPED,
+                            (int)assembler.feed(1, piece, sizeof(piece), false, true, message, length))) return false;
+    if (!runner.assertEqual(WS_REASSEMBLY_SLOTS, assembler.freeSlots())) return false;
+    
+    // Pool exhausted: the next multi-piece message is dropped up front
+    // and its remaining pieces are ignored
+    for (int i = 0; i < WS_REASSEMBLY_SLOTS; i++) {
+        assembler.feed(10 + i, piece, 1, true, false, message, length);
+    }
+    if (!runner.assertEqual((int)MessageAssembler::MESSAGE_DROPPED,
+                            (int)assembler.feed(99, piece, 1, true, false, message, length))) return false;
+    return runner.assertEqual((int)MessageAssembler::MESSAGE_PENDING,
+                              (int)assembler.feed(99, piece, 1, false, true, message, length));
+}
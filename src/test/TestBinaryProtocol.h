@@ -0,0 +1,37 @@
+#ifndef TEST_BINARY_PROTOCOL_H
+#define TEST_BINARY_PROTOCOL_H
+
+#include "TestRunner.h"
+#include "../web/BinaryProtocol.h"
+#include "../web/ClientSession.h"
+#include "../web/MessageAssembler.h"
+
+/**
+ * @file TestBinaryProtocol.h
+ * @brief Unit tests for the binary WebSocket protocol, client sessions,
+ * message reassembly and bulk path uploads
+ */
+
+class TestBinaryProtocol {
+public:
+    static void runAllTests(TestRunner& runner);
+    
+private:
+    static bool testMoveToRoundTrip();
+    static bool testWireLayout();
+    static bool testStatusRoundTrip();
+    static bool testRejectsBadFrames();
+    static bool testClientSessions();
+    static bool testTelemetryRequests();
+    static bool testBinarySwitchFull();
+    static bool testPathInPieces();
+    static bool testPathNoRoom();
+    static bool testPathBufferSkipsStale();
+    static bool testRejectedPathTakenBack();
+    static bool testFlushedPathsDropped();
+    static bool testWholeMessageNotCopied();
+    static bool testMessageInPieces();
+    static bool testMessageDropped();
+};
+
+#endif // TEST_BINARY_PROTOCOL_H
@@ -0,0 +1,282 @@
+#include "TestGCode.h"
+#include <math.h>
+#include <string.h>
+
+void TestGCode::runAllTests(TestRunner& runner) {
+    runner.printHeader("GCODE");
+    
+    runner.runTest("Line buffer (CRLF, overflow)", testLineBuffer);
+    runner.runTest("G0/G1 linear moves", testLinearMoves);
+    runner.runTest("Modal motion mode and feed", testModalState);
+    runner.runTest("G91 relative moves", testRelativeMoves);
+    runner.runTest("G2/G3 arcs", testArcs);
+    runner.runTest("Offsets resolved from the planner", testOffsetsFromPlanner);
+    runner.runTest("G4 dwell and G28 home", testDwellAndHome);
+    runner.runTest("Comments and errors", testCommentsAndErrors);
+    runner.runTest("Uncommitted line leaves state", testUncommittedLine);
+    runner.runTest("Arc interpolator", testArcInterpolator);
+}
+
+// Execute a line and commit it, as a sender would after "ok"
+static GCodeInterpreter::Result run(GCodeInterpreter& gcode, const char* line, Command& cmd) {
+    GCodeInterpreter::Result result = gcode.execute(line, cmd);
+    if (result != GCodeInterpreter::RESULT_ERROR) {
+        gcode.commit();
+    }
+    return result;
+}
+
+bool TestGCode::testLineBuffer() {
+    TestRunner runner(false);
+    
+    GCodeLineBuffer buffer;
+    const char* text = "G1 X1\r\nG1 X2\n\nG1 X3";
+    int lines = 0;
+    for (const char* c = text; *c; c++) {
+        if (buffer.feed(*c)) {
+            lines++;
+            if (lines == 2 && !runner.assertTrue(strcmp(buffer.line(), "G1 X2") == 0)) return false;
+        }
+    }
+    if (!runner.assertEqual(2, lines)) return false;
+    
+    // The last line only ends with its newline
+    if (!runner.assertTrue(buffer.feed('\n'))) return false;
+    if (!runner.assertTrue(strcmp(buffer.line(), "G1 X3") == 0)) return false;
+    
+    // Too long: flagged, not split into two lines
+    for (int i = 0; i < GCODE_LINE_MAX + 10; i++) {
+        if (!runner.assertFalse(buffer.feed('X'))) return false;
+    }
+    if (!runner.assertTrue(buffer.feed('\n'))) return false;
+    if (!runner.assertTrue(buffer.overflowed())) return false;
+    
+    // Next line is fine again
+    buffer.feed('G');
+    buffer.feed('0');
+    return runner.assertTrue(buffer.feed('\n')) &&
+           runner.assertFalse(buffer.overflowed()) &&
+           runner.assertTrue(strcmp(buffer.line(), "G0") == 0);
+}
+
+bool TestGCode::testLinearMoves() {
+    TestRunner runner(false);
+    
+    GCodeInterpreter gcode;
+    gcode.setPosition(Point2D(100, 100));
+    Command cmd;
+    
+    if (!runner.assertEqual((int)GCodeInterpreter::RESULT_COMMAND, (int)run(gcode, "G1 X150 Y120 F600", cmd))) return false;
+    if (!runner.assertEqual((int)Command::MOVE_TO, (int)cmd.type)) return false;
+    if (!runner.assertEqual(150.0f, cmd.target.x)) return false;
+    if (!runner.assertEqual(120.0f, cmd.target.y)) return false;
+    if (!runner.assertEqual(10.0f, cmd.speed)) return false;  // 600 mm/min
+    
+    // Missing axis keeps the position the move starts from; G0 runs at MAX_SPEED
+    if (!runner.assertEqual((int)GCodeInterpreter::RESULT_COMMAND, (int)run(gcode, "G0 Y200", cmd))) return false;
+    Point2D target = cmd.resolveTarget(Point2D(150, 120));
+    return runner.assertEqual(150.0f, target.x) &&
+           runner.assertEqual(200.0f, target.y) &&
+           runner.assertEqual(MAX_SPEED, cmd.speed);
+}
+
+bool TestGCode::testModalState() {
+    TestRunner runner(false);
+    
+    GCodeInterpreter gcode;
+    Command cmd;
+    
+    // Feed and motion mode without a move: nothing to queue
+    if (!runner.assertEqual((int)GCodeInterpreter::RESULT_NONE, (int)run(gcode, "G1 F1200", cmd))) return false;
+    if (!runner.assertEqual(20.0f, gcode.getFeedRate())) return false;
+    
+    // Bare coordinates reuse G1 and F
+    if (!runner.assertEqual((int)GCodeInterpreter::RESULT_COMMAND, (int)run(gcode, "X10 Y60", cmd))) return false;
+    if (!runner.assertEqual((int)Command::MOVE_TO, (int)cmd.type)) return false;
+    if (!runner.assertEqual(20.0f, cmd.speed)) return false;
+    
+    // Leading zeros and lower case
+    if (!runner.assertEqual((int)GCodeInterpreter::RESULT_COMMAND, (int)run(gcode, "g01 x-12.5 y.5", cmd))) return false;
+    return runner.assertEqual(-12.5f, cmd.target.x, 0.0001f) &&
+           runner.assertEqual(0.5f, cmd.target.y, 0.0001f);
+}
+
+bool TestGCode::testRelativeMoves() {
+    TestRunner runner(false);
+    
+    GCodeInterpreter gcode;
+    gcode.setPosition(Point2D(100, 100));
+    Command cmd;
+    
+    run(gcode, "G91", cmd);
+    if (!runner.assertFalse(gcode.isAbsolute())) return false;
+    
+    run(gcode, "G1 X10", cmd);
+    Point2D target = cmd.resolveTarget(Point2D(100, 100));
+    if (!runner.assertEqual(110.0f, target.x)) return false;
+    if (!runner.assertEqual(100.0f, target.y)) return false;
+    
+    run(gcode, "G1 X-5 Y20", cmd);
+    target = cmd.resolveTarget(target);
+    if (!runner.assertEqual(105.0f, target.x)) return false;
+    if (!runner.assertEqual(120.0f, target.y)) return false;
+    if (!runner.assertEqual(105.0f, gcode.getPosition().x)) return false;
+    
+    // Back to absolute on the same line as a move
+    run(gcode, "G90 G1 X0 Y150", cmd);
+    return runner.assertTrue(gcode.isAbsolute()) &&
+           runner.assertEqual(0.0f, cmd.target.x) &&
+           runner.assertEqual(150.0f, cmd.target.y);
+}
+
+bool TestGCode::testArcs() {
+    TestRunner runner(false);
+    
+    GCodeInterpreter gcode;
+    gcode.setPosition(Point2D(110, 100));
+    Command cmd;
+    
+    // Quarter circle around (100, 100), radius 10
+    if (!runner.assertEqual((int)GCodeInterpreter::RESULT_COMMAND, (int)run(gcode, "G3 X100 Y110 I-10 J0", cmd))) return false;
+    if (!runner.assertEqual((int)Command::ARC_CCW, (int)cmd.type)) return false;
+    if (!runner.assertEqual(-10.0f, cmd.center.x)) return false;   // Offset from the start
+    if (!runner.assertEqual(0.0f, cmd.center.y)) return false;
+    if (!runner.assertEqual(110.0f, cmd.target.y)) return false;
+    
+    if (!runner.assertEqual((int)GCodeInterpreter::RESULT_COMMAND, (int)run(gcode, "G2 X110 Y100 J-10", cmd))) return false;
+    if (!runner.assertEqual((int)Command::ARC_CW, (int)cmd.type)) return false;
+    
+    // End point not on the circle, and an arc without a centre
+    return runner.assertEqual((int)GCodeInterpreter::RESULT_ERROR, (int)run(gcode, "G2 X130 Y100 I-10", cmd)) &&
+           runner.assertEqual((int)GCodeInterpreter::RESULT_ERROR, (int)run(gcode, "G2 X100 Y110", cmd)) &&
+           runner.assertEqual(110.0f, gcode.getPosition().x);
+}
+
+bool TestGCode::testOffsetsFromPlanner() {
+    TestRunner runner(false);
+    
+    // The interpreter thinks the arm is at (100, 100); it stopped at (80, 90)
+    GCodeInterpreter gcode;
+    gcode.setPosition(Point2D(100, 100));
+    Point2D arm(80, 90);
+    Command cmd;
+    
+    // Absolute axes stay absolute, a missing one is where the arm is
+    run(gcode, "G1 X120", cmd);
+    Point2D target = cmd.resolveTarget(arm);
+    if (!runner.assertEqual(120.0f, target.x)) return false;
+    if (!runner.assertEqual(90.0f, target.y)) return false;
+    
+    // Relative moves start from the arm
+    run(gcode, "G91 G1 X10 Y-10", cmd);
+    target = cmd.resolveTarget(arm);
+    if (!runner.assertEqual(90.0f, target.x)) return false;
+    if (!runner.assertEqual(80.0f, target.y)) return false;
+    
+    // A relative arc keeps its radius around a centre taken from the arm
+    run(gcode, "G3 X-10 Y10 I-10", cmd);
+    target = cmd.resolveTarget(arm);
+    Point2D center(arm.x + cmd.center.x, arm.y + cmd.center.y);
+    return runner.assertEqual((int)Command::ARC_CCW, (int)cmd.type) &&
+           runner.assertEqual(70.0f, center.x) &&
+           runner.assertEqual(90.0f, center.y) &&
+           runner.assertEqual(10.0f, hypotf(target.x - center.x, target.y - center.y), 0.0001f);
+}
+
+bool TestGCode::testDwellAndHome() {
+    TestRunner runner(false);
+    
+    GCodeInterpreter gcode;
+    gcode.setHomePosition(Point2D(300, 0));
+    Command cmd;
+    
+    if (!runner.assertEqual((int)GCodeInterpreter::RESULT_COMMAND, (int)run(gcode, "G4 P250", cmd))) return false;
+    if (!runner.assertEqual((int)Command::DWELL, (int)cmd.type)) return false;
+    if (!runner.assertEqual(0.25f, cmd.duration, 0.0001f)) return false;
+    
+    run(gcode, "G4 S2", cmd);
+    if (!runner.assertEqual(2.0f, cmd.duration, 0.0001f)) return false;
+    if (!runner.assertEqual((int)GCodeInterpreter::RESULT_ERROR, (int)run(gcode, "G4", cmd))) return false;
+    
+    if (!runner.assertEqual((int)GCodeInterpreter::RESULT_COMMAND, (int)run(gcode, "G28", cmd))) return false;
+    if (!runner.assertEqual((int)Command::HOME, (int)cmd.type)) return false;
+    
+    // Relative moves continue from the home position
+    run(gcode, "G91 G1 X-10", cmd);
+    Point2D target = cmd.resolveTarget(Point2D(300, 0));
+    return runner.assertEqual(290.0f, target.x) &&
+           runner.assertEqual(0.0f, target.y) &&
+           runner.assertEqual(290.0f, gcode.getPosition().x);
+}
+
+bool TestGCode::testCommentsAndErrors() {
+    TestRunner runner(false);
+    
+    GCodeInterpreter gcode;
+    Command cmd;
+    
+    if (!runner.assertEqual((int)GCodeInterpreter::RESULT_NONE, (int)run(gcode, "; whole line comment", cmd))) return false;
+    if (!runner.assertEqual((int)GCodeInterpreter::RESULT_NONE, (int)run(gcode, "", cmd))) return false;
+    if (!runner.assertEqual((int)GCodeInterpreter::RESULT_COMMAND,
+                            (int)run(gcode, "N12 G1 (pen down) X5 Z-1 Y60 ; go*71", cmd))) return false;
+    if (!runner.assertEqual(5.0f, cmd.target.x)) return false;
+    if (!runner.assertEqual(60.0f, cmd.target.y)) return false;
+    
+    return runner.assertEqual((int)GCodeInterpreter::RESULT_ERROR, (int)run(gcode, "G17", cmd)) &&
+           runner.assertEqual((int)GCodeInterpreter::RESULT_ERROR, (int)run(gcode, "M3 S1000", cmd)) &&
+           runner.assertEqual((int)GCodeInterpreter::RESULT_ERROR, (int)run(gcode, "G1 X", cmd)) &&
+           runner.assertEqual((int)GCodeInterpreter::RESULT_ERROR, (int)run(gcode, "G1 F0", cmd)) &&
+           runner.assertEqual((int)GCodeInterpreter::RESULT_ERROR, (int)run(gcode, "G0 G28", cmd)) &&
+           runner.assertTrue(strlen(gcode.getError()) > 0);
+}
+
+bool TestGCode::testUncommittedLine() {
+    TestRunner runner(false);
+    
+    GCodeInterpreter gcode;
+    gcode.setPosition(Point2D(100, 100));
+    Command cmd;
+    
+    // Queue full: the line is not committed and is retried unchanged
+    gcode.execute("G91 G1 X10 F300", cmd);
+    if (!runner.assertEqual(100.0f, gcode.getPosition().x)) return false;
+    if (!runner.assertTrue(gcode.isAbsolute())) return false;
+    
+    gcode.execute("G91 G1 X10 F300", cmd);
+    gcode.commit();
+    return runner.assertEqual(10.0f, cmd.target.x) &&
+           runner.assertEqual(110.0f, gcode.getPosition().x) &&
+           runner.assertFalse(gcode.isAbsolute()) &&
+           runner.assertEqual(5.0f, gcode.getFeedRate());
+}
+
+bool TestGCode::testArcInterpolator() {
+    TestRunner runner(false);
+    
+    // Counter-clockwise quarter circle, radius 10: length ~15.7 mm
+    ArcInterpolator arc;
+    int count = arc.begin(Point2D(110, 100), Point2D(100, 110), Point2D(100, 100), false, 1.0f);
+    if (!runner.assertEqual(16, count)) return false;
+    
+    Point2D point;
+    Point2D last(110, 100);
+    int produced = 0;
+    while (arc.next(point)) {
+        produced++;
+        float r = hypotf(point.x - 100.0f, point.y - 100.0f);
+        if (!runner.assertEqual(10.0f, r, 0.001f)) return false;
+        // Counter-clockwise from (110, 100): x falls, y rises
+        if (!runner.assertTrue(point.x <= last.x + 0.0001f && point.y >= last.y - 0.0001f)) return false;
+        if (!runner.assertTrue(hypotf(point.x - last.x, point.y - last.y) <= 1.0f)) return false;
+        last = point;
+    }
+    if (!runner.assertEqual(count, produced)) return false;
+    if (!runner.assertEqual(100.0f, last.x, 0.0001f)) return false;
+    if (!runner.assertEqual(110.0f, last.y, 0.0001f)) return false;
+    
+    // Clockwise the same way round is three quarters; start == end is a full circle
+    int clockwise = arc.begin(Point2D(110, 100), Point2D(100, 110), Point2D(100, 100), true, 1.0f);
+    int full = arc.begin(Point2D(110, 100), Point2D(110, 100), Point2D(100, 100), true, 1.0f);
+    return runner.assertEqual(48, clockwise) &&
+           runner.assertEqual(63, full);
+}
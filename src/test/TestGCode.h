@@ -0,0 +1,30 @@
+#ifndef TEST_GCODE_H
+#define TEST_GCODE_H
+
+#include "TestRunner.h"
+#include "../core/GCode.h"
+#include "../core/Arc.h"
+
+/**
+ * @file TestGCode.h
+ * @brief Unit tests for the G-code line buffer, interpreter and arc chords
+ */
+
+class TestGCode {
+public:
+    static void runAllTests(TestRunner& runner);
+    
+private:
+    static bool testLineBuffer();
+    static bool testLinearMoves();
+    static bool testModalState();
+    static bool testRelativeMoves();
+    static bool testArcs();
+    static bool testOffsetsFromPlanner();
+    static bool testDwellAndHome();
+    static bool testCommentsAndErrors();
+    static bool testUncommittedLine();
+    static bool testArcInterpolator();
+};
+
+#endif // TEST_GCODE_H
@@ -0,0 +1,66 @@
+#include "TestHermite.h"
+
+void TestHermite::runAllTests(TestRunner& runner) {
+    runner.printHeader("HERMITE (PVT)");
+    
+    runner.runTest("Hermite: Endpoints", testEndpoints);
+    runner.runTest("Hermite: End velocities", testEndVelocities);
+    runner.runTest("Hermite: Constant velocity is linear", testConstantVelocity_IsLinear);
+    runner.runTest("Hermite: Rest to rest symmetric", testRestToRest_Symmetric);
+    runner.runTest("Hermite: Zero duration", testZeroDuration);
+}
+
+bool TestHermite::testEndpoints() {
+    HermiteSegment seg(10.0f, 5.0f, 30.0f, -2.0f, 0.5f);
+    TestRunner runner(false);
+    
+    return runner.assertNear(10.0f, seg.position(0.0f), 0.001f) &&
+           runner.assertNear(30.0f, seg.position(0.5f), 0.001f) &&
+           runner.assertNear(30.0f, seg.position(1.0f), 0.001f);  // Clamped
+}
+
+bool TestHermite::testEndVelocities() {
+    HermiteSegment seg(10.0f, 5.0f, 30.0f, -2.0f, 0.5f);
+    TestRunner runner(false);
+    
+    // Derivative just inside the segment must match the requested velocities
+    float h = 0.0001f;
+    float vStart = (seg.position(h) - seg.position(0.0f)) / h;
+    float vEnd = (seg.position(0.5f) - seg.position(0.5f - h)) / h;
+    
+    return runner.assertNear(5.0f, vStart, 0.2f) &&
+           runner.assertNear(-2.0f, vEnd, 0.2f) &&
+           runner.assertNear(5.0f, seg.velocity(0.0f), 0.001f) &&
+           runner.assertNear(-2.0f, seg.velocity(0.5f), 0.001f);
+}
+
+bool TestHermite::testConstantVelocity_IsLinear() {
+    // 100 deg/s over 0.1 s covers exactly 10 degrees
+    HermiteSegment seg(0.0f, 100.0f, 10.0f, 100.0f, 0.1f);
+    TestRunner runner(false);
+    
+    for (int i = 0; i <= 10; i++) {
+        float t = i * 0.01f;
+        if (!runner.assertNear(100.0f * t, seg.position(t), 0.001f)) return false;
+        if (!runner.assertNear(100.0f, seg.velocity(t), 0.01f)) return false;
+    }
+    return true;
+}
+
+bool TestHermite::testRestToRest_Symmetric() {
+    HermiteSegment seg(0.0f, 0.0f, 20.0f, 0.0f, 1.0f);
+    TestRunner runner(false);
+    
+    // Halfway in time is halfway in position, with peak velocity 1.5x average
+    return runner.assertNear(10.0f, seg.position(0.5f), 0.001f) &&
+           runner.assertNear(30.0f, seg.velocity(0.5f), 0.01f) &&
+           runner.assertNear(seg.position(0.25f), 20.0f - seg.position(0.75f), 0.001f);
+}
+
+bool TestHermite::testZeroDuration() {
+    HermiteSegment seg(5.0f, 1.0f, 7.0f, 2.0f, 0.0f);
+    TestRunner runner(false);
+    
+    return runner.assertNear(7.0f, seg.position(0.0f), 0.001f) &&
+           runner.assertNear(2.0f, seg.velocity(0.0f), 0.001f);
+}
@@ -0,0 +1,24 @@
+#ifndef TEST_HERMITE_H
+#define TEST_HERMITE_H
+
+#include "TestRunner.h"
+#include "../core/Hermite.h"
+
+/**
+ * @file TestHermite.h
+ * @brief Unit tests for the cubic Hermite (PVT) segment
+ */
+
+class TestHermite {
+public:
+    static void runAllTests(TestRunner& runner);
+    
+private:
+    static bool testEndpoints();
+    static bool testEndVelocities();
+    static bool testConstantVelocity_IsLinear();
+    static bool testRestToRest_Symmetric();
+    static bool testZeroDuration();
+};
+
+#endif // TEST_HERMITE_H
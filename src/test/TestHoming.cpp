@@ -0,0 +1,278 @@
+#include "TestHoming.h"
+#include "../hardware/SimMotor.h"
+#include "../hardware/SimLimitSwitch.h"
+#include "../hardware/StepperMotor.h"
+#include "../hardware/StepTicker.h"
+#include <math.h>
+
+// Run homing in 1 ms ticks; returns the simulated duration in ms
+// and whether both joints were ever homing at the same time
+static uint32_t runHoming(SimClock& clock, HomingEngine& homing,
+                          SimMotor& motor1, SimMotor& motor2,
+                          const HomingAxis& axis1, const HomingAxis& axis2,
+                          bool& concurrent) {
+    uint32_t start = clock.micros() / 1000;
+    homing.begin(start);
+    concurrent = false;
+    
+    for (int i = 0; i < 60000 && homing.isActive(); i++) {
+        clock.advance(1000);
+        motor1.update();
+        motor2.update();
+        homing.update(clock.micros() / 1000);
+        
+        if (axis1.isActive() && axis2.isActive()) {
+            concurrent = true;
+        }
+    }
+    return clock.micros() / 1000 - start;
+}
+
+void TestHoming::runAllTests(TestRunner& runner) {
+    runner.printHeader("HOMING");
+    
+    runner.runTest("Homes both joints", testHomesBothJoints);
+    runner.runTest("Start on the switch", testStartOnSwitch);
+    runner.runTest("Switch not found", testSwitchNotFound);
+    runner.runTest("Sequential homing", testSequential);
+#ifndef ARDUINO
+    runner.runTest("Steppers at production rate", testStepperProductionRate);
+#endif
+}
+
+bool TestHoming::testHomesBothJoints() {
+    SimClock clock;
+    SimMotor motor1(clock);
+    SimMotor motor2(clock);
+    motor1.init();
+    motor2.init();
+    motor1.enable();
+    motor2.enable();
+    
+    // Switches 40 and 60 degrees below the power-on positions
+    SimLimitSwitch switch1(motor1, -40.0f, -1);
+    SimLimitSwitch switch2(motor2, -60.0f, -1);
+    switch1.init();
+    switch2.init();
+    
+    HomingAxis axis1(motor1, switch1, HomingAxisConfig(-1, 10.0f));
+    HomingAxis axis2(motor2, switch2, HomingAxisConfig(-1, 20.0f));
+    HomingEngine homing(axis1, axis2, true);
+    
+    TestRunner runner(false);
+    
+    bool concurrent;
+    uint32_t durationMs = runHoming(clock, homing, motor1, motor2, axis1, axis2, concurrent);
+    
+    // The reference is taken at the switch, at slow speed (22 deg/s at
+    // 200 steps/s), so it lands within a fraction of a degree
+    bool ok = runner.assertTrue(homing.isDone()) &&
+              runner.assertFalse(homing.hasFailed()) &&
+              runner.assertTrue(concurrent) &&
+              runner.assertNear(-40.0f, motor1.getPhysicalAngle(), 0.1f) &&
+              runner.assertNear(-60.0f, motor2.getPhysicalAngle(), 0.1f) &&
+              runner.assertNear(10.0f, motor1.getCurrentAngle(), 0.1f) &&
+              runner.assertNear(20.0f, motor2.getCurrentAngle(), 0.1f) &&
+              runner.assertFalse(motor1.isStalled()) &&
+              runner.assertFalse(motor2.isStalled());
+    
+    // Fast seek of 60 degrees plus back-off and a 5-10 degree latch
+    // take well under the 3 s a slow-only seek would need
+    return ok && runner.assertTrue(durationMs < 2000);
+}
+
+bool TestHoming::testStartOnSwitch() {
+    SimClock clock;
+    SimMotor motor1(clock);
+    SimMotor motor2(clock);
+    motor1.init();
+    motor2.init();
+    motor1.enable();
+    motor2.enable();
+    
+    // Joint 1 powers up pressing its switch
+    SimLimitSwitch switch1(motor1, 1.0f, -1);
+    SimLimitSwitch switch2(motor2, -10.0f, -1);
+    switch1.init();
+    switch2.init();
+    
+    HomingAxis axis1(motor1, switch1, HomingAxisConfig(-1, 0.0f));
+    HomingAxis axis2(motor2, switch2, HomingAxisConfig(-1, 0.0f));
+    HomingEngine homing(axis1, axis2, true);
+    
+    TestRunner runner(false);
+    
+    bool concurrent;
+    runHoming(clock, homing, motor1, motor2, axis1, axis2, concurrent);
+    
+    return runner.assertTrue(homing.isDone()) &&
+           runner.assertNear(1.0f, motor1.getPhysicalAngle(), 0.1f) &&
+           runner.assertNear(0.0f, motor1.getCurrentAngle(), 0.1f);
+}
+
+bool TestHoming::testSwitchNotFound() {
+    SimClock clock;
+    SimMotor motor1(clock);
+    SimMotor motor2(clock);
+    motor1.init();
+    motor2.init();
+    motor1.enable();
+    motor2.enable();
+    
+    // Switch 1 is on the wrong side: the seek never reaches it
+    SimLimitSwitch switch1(motor1, 10.0f, 1);
+    SimLimitSwitch switch2(motor2, -10.0f, -1);
+    switch1.init();
+    switch2.init();
+    
+    HomingAxisConfig config1(-1, 0.0f);
+    config1.seekRange = 30.0f;
+    HomingAxis axis1(motor1, switch1, config1);
+    HomingAxis axis2(motor2, switch2, HomingAxisConfig(-1, 0.0f));
+    HomingEngine homing(axis1, axis2, true);
+    
+    TestRunner runner(false);
+    
+    bool concurrent;
+    runHoming(clock, homing, motor1, motor2, axis1, axis2, concurrent);
+    
+    return runner.assertFalse(homing.isActive()) &&
+           runner.assertTrue(homing.hasFailed()) &&
+           runner.assertFalse(homing.isDone()) &&
+           runner.assertFalse(motor1.isMoving()) &&
+           runner.assertFalse(motor2.isMoving());
+}
+
+bool TestHoming::testSequential() {
+    SimClock clock;
+    SimMotor motor1(clock);
+    SimMotor motor2(clock);
+    motor1.init();
+    motor2.init();
+    motor1.enable();
+    motor2.enable();
+    
+    SimLimitSwitch switch1(motor1, -20.0f, -1);
+    SimLimitSwitch switch2(motor2, 20.0f, 1);
+    switch1.init();
+    switch2.init();
+    
+    HomingAxis axis1(motor1, switch1, HomingAxisConfig(-1, 0.0f));
+    HomingAxis axis2(motor2, switch2, HomingAxisConfig(1, 180.0f));
+    HomingEngine homing(axis1, axis2, false);
+    
+    TestRunner runner(false);
+    
+    bool concurrent;
+    runHoming(clock, homing, motor1, motor2, axis1, axis2, concurrent);
+    
+    return runner.assertTrue(homing.isDone()) &&
+           runner.assertFalse(concurrent) &&
+           runner.assertNear(20.0f, motor2.getPhysicalAngle(), 0.1f) &&
+           runner.assertNear(180.0f, motor2.getCurrentAngle(), 0.1f);
+}
+
+#ifndef ARDUINO
+/**
+ * Limit switch actuated by a StepperMotor on the mock pins: the physical
+ * position is counted from the STEP edges, so it does not move when the
+ * homing sequence redefines the motor's angle. poll() must run after
+ * every tick (tick() issues at most one step).
+ */
+class StepLimitSwitch final : public ILimitSwitch {
+private:
+    uint8_t stepPin;
+    uint8_t dirPin;
+    long triggerStep;      // Physical position at which the switch closes
+    uint32_t edgesSeen;
+    long position;         // Physical position in steps
+    
+public:
+    StepLimitSwitch(uint8_t stepPin, uint8_t dirPin, float triggerAngle)
+        : stepPin(stepPin), dirPin(dirPin),
+          triggerStep(lroundf(triggerAngle * STEPS_PER_DEGREE)),
+          edgesSeen(0), position(0) {}
+    
+    void init() override {
+        edgesSeen = MockPinIO::risingEdges(stepPin);
+    }
+    
+    void poll() {
+        uint32_t edges = MockPinIO::risingEdges(stepPin);
+        if (edges != edgesSeen) {
+            position += MockPinIO::level(dirPin) ? 1 : -1;
+            edgesSeen = edges;
+        }
+    }
+    
+    bool isTriggered() override {
+        return position <= triggerStep;
+    }
+    
+    float getPhysicalAngle() const {
+        return position / STEPS_PER_DEGREE;
+    }
+};
+
+bool TestHoming::testStepperProductionRate() {
+    MockPinIO::reset();
+    MockPinIO::setTime(0);
+    
+    StepperMotor motor1(99, 98, 97);
+    StepperMotor motor2(96, 95, 94);
+    motor1.init();
+    motor2.init();
+    motor1.enable();
+    motor2.enable();
+    StepTicker::attach(motor1);
+    StepTicker::attach(motor2);
+    
+    // Joint 2 has to search 300 degrees for its switch
+    StepLimitSwitch switch1(99, 98, -40.0f);
+    StepLimitSwitch switch2(96, 95, -300.0f);
+    switch1.init();
+    switch2.init();
+    
+    HomingAxis axis1(motor1, switch1, HomingAxisConfig(-1, 10.0f));
+    HomingAxis axis2(motor2, switch2, HomingAxisConfig(-1, 20.0f));
+    HomingEngine homing(axis1, axis2, true);
+    
+    TestRunner runner(false);
+    
+    // Production rates: the step timer every STEP_TICK_US, the motion
+    // loop (motor updates and homing) every 10 ms
+    const uint32_t loopUs = 1000000UL / MOTION_CONTROL_FREQUENCY;
+    homing.begin(0);
+    uint32_t t = 0;
+    while (homing.isActive() && t < 20000000) {
+        if (t % loopUs == 0) {
+            motor1.update();
+            motor2.update();
+            homing.update(t / 1000);
+        }
+        StepTicker::tick();
+        switch1.poll();
+        switch2.poll();
+        MockPinIO::advance(STEP_TICK_US);
+        t += STEP_TICK_US;
+    }
+    
+    // The switch is read once per loop: at the slow speed (200 steps/s)
+    // the reference lands within 2 steps (0.25 degree) of it
+    bool ok = runner.assertTrue(homing.isDone()) &&
+              runner.assertNear(-40.0f, switch1.getPhysicalAngle(), 0.25f) &&
+              runner.assertNear(-300.0f, switch2.getPhysicalAngle(), 0.25f) &&
+              runner.assertNear(10.0f, motor1.getCurrentAngle(), 0.25f) &&
+              runner.assertNear(20.0f, motor2.getCurrentAngle(), 0.25f);
+    
+    // 300 degrees at the fast speed (1600 steps/s) take 1.7 s, about 3 s
+    // with the ramps, back-off and latch; at the slow speed the seek alone
+    // would take 13 s, at one step per loop 27 s
+    ok = ok && runner.assertTrue(t < 4000000);
+    
+    StepTicker::detach(motor1);
+    StepTicker::detach(motor2);
+    MockPinIO::useRealTime();
+    return ok;
+}
+#endif
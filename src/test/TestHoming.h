@@ -0,0 +1,30 @@
+#ifndef TEST_HOMING_H
+#define TEST_HOMING_H
+
+#include "TestRunner.h"
+#include "../core/Homing.h"
+
+/**
+ * @file TestHoming.h
+ * @brief Unit tests for the homing sequence
+ *
+ * Runs against SimMotor and SimLimitSwitch on a simulated clock, and
+ * on the host against StepperMotor on the step timer at production
+ * rates.
+ */
+
+class TestHoming {
+public:
+    static void runAllTests(TestRunner& runner);
+    
+private:
+    static bool testHomesBothJoints();
+    static bool testStartOnSwitch();
+    static bool testSwitchNotFound();
+    static bool testSequential();
+#ifndef ARDUINO
+    static bool testStepperProductionRate();
+#endif
+};
+
+#endif // TEST_HOMING_H
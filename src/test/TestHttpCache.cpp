@@ -0,0 +1,53 @@
+#include "TestHttpCache.h"
+
+void TestHttpCache::runAllTests(TestRunner& runner) {
+    runner.printHeader("HTTP CACHE");
+    
+    runner.runTest("FNV-1a known values", testFnvKnownValues);
+    runner.runTest("FNV-1a fed in chunks", testFnvInChunks);
+    runner.runTest("ETag format", testETagFormat);
+    runner.runTest("If-None-Match matching", testIfNoneMatch);
+}
+
+bool TestHttpCache::testFnvKnownValues() {
+    TestRunner runner(false);
+    
+    // Reference values of 32-bit FNV-1a
+    return runner.assertTrue(HttpCache::fnv1a((const uint8_t*)"", 0) == 0x811c9dc5u) &&
+           runner.assertTrue(HttpCache::fnv1a((const uint8_t*)"a", 1) == 0xe40c292cu) &&
+           runner.assertTrue(HttpCache::fnv1a((const uint8_t*)"foobar", 6) == 0xbf9cf968u);
+}
+
+bool TestHttpCache::testFnvInChunks() {
+    TestRunner runner(false);
+    
+    // A file hashed 256 bytes at a time gives the same tag as in one go
+    const uint8_t* text = (const uint8_t*)"<!DOCTYPE html><html><body>SCARA</body></html>";
+    size_t len = strlen((const char*)text);
+    uint32_t whole = HttpCache::fnv1a(text, len);
+    uint32_t chunked = HttpCache::fnv1a(text, 10);
+    chunked = HttpCache::fnv1a(text + 10, len - 10, chunked);
+    
+    return runner.assertTrue(whole == chunked);
+}
+
+bool TestHttpCache::testETagFormat() {
+    TestRunner runner(false);
+    
+    char etag[HttpCache::ETAG_SIZE];
+    HttpCache::formatETag(0x0123abcdu, etag);
+    return runner.assertTrue(strcmp(etag, "\"0123abcd\"") == 0);
+}
+
+bool TestHttpCache::testIfNoneMatch() {
+    TestRunner runner(false);
+    
+    const char* etag = "\"0123abcd\"";
+    return runner.assertTrue(HttpCache::matches("\"0123abcd\"", etag)) &&
+           runner.assertTrue(HttpCache::matches("\"ffff0000\", \"0123abcd\"", etag)) &&
+           runner.assertTrue(HttpCache::matches("W/\"0123abcd\"", etag)) &&
+           runner.assertTrue(HttpCache::matches("*", etag)) &&
+           runner.assertFalse(HttpCache::matches("\"0123abce\"", etag)) &&
+           runner.assertFalse(HttpCache::matches("\"0123abcd", etag)) &&
+           runner.assertFalse(HttpCache::matches("", etag));
+}
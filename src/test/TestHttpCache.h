@@ -0,0 +1,23 @@
+#ifndef TEST_HTTP_CACHE_H
+#define TEST_HTTP_CACHE_H
+
+#include "TestRunner.h"
+#include "../web/HttpCache.h"
+
+/**
+ * @file TestHttpCache.h
+ * @brief Unit tests for static asset ETags and If-None-Match handling
+ */
+
+class TestHttpCache {
+public:
+    static void runAllTests(TestRunner& runner);
+    
+private:
+    static bool testFnvKnownValues();
+    static bool testFnvInChunks();
+    static bool testETagFormat();
+    static bool testIfNoneMatch();
+};
+
+#endif // TEST_HTTP_CACHE_H
@@ -1,5 +1,6 @@
 #include "TestInteractive.h"
 #include "../Config.h"
+#include "../hardware/MotionController.h"
 #include <Arduino.h>
 
 void TestInteractive::run(IMotor* motor1, IMotor* motor2) {
@@ -30,8 +31,11 @@ void TestInteractive::run(IMotor* motor1, IMotor* motor2) {
     // Calculate initial angles
     JointAngles initialAngles;
     if (kin.inverse(currentPos, initialAngles)) {
-        if (motor1) motor1->moveToAngle(initialAngles.theta1);
-        if (motor2) motor2->moveToAngle(initialAngles.theta2);
+        if (motor1 && motor2) {
+            // Coordinated, so both joints arrive together
+            MotionController<IMotor, IMotor> arm(*motor1, *motor2);
+            arm.moveJointsTo(initialAngles);
+        }
         Serial.println("Initial position set");
         printPoint(currentPos, "Current position");
         Serial.println();
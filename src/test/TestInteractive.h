@@ -5,6 +5,7 @@
 #include "../core/Planner.h"
 #include "../core/Types.h"
 #include "../hardware/IMotor.h"
+#include <Arduino.h>
 #include <queue>
 
 /**
@@ -154,11 +154,15 @@ bool TestKinematics::testIsReachable_OutOfRange() {
     // Points out of reach
     Point2D p1(400.0f, 0.0f);      // Too far
     Point2D p2(0.0f, 400.0f);      // Too far
+    
+    // With equal links the arm folds back onto the base, so only unequal
+    // links leave a hole in the middle: 50 mm here
+    Kinematics unequal(150.0f, 100.0f);
     Point2D p3(10.0f, 10.0f);      // Too close (inside minimum reach)
     
     return runner.assertFalse(kin.isReachable(p1)) &&
            runner.assertFalse(kin.isReachable(p2)) &&
-           runner.assertFalse(kin.isReachable(p3));
+           runner.assertFalse(unequal.isReachable(p3));
 }
 
 bool TestKinematics::testIsReachable_EdgeCases() {
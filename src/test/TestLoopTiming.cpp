@@ -0,0 +1,177 @@
+#include "TestLoopTiming.h"
+#include <string.h>
+
+void TestLoopTiming::runAllTests(TestRunner& runner) {
+    runner.printHeader("LOOP TIMING");
+    
+    runner.runTest("Histogram buckets", testHistogram_Buckets);
+    runner.runTest("Histogram percentiles", testHistogram_Percentile);
+    runner.runTest("Steady loop: no jitter, no miss", testSteadyLoop);
+    runner.runTest("Late wake-up counts as jitter", testJitter_LateWake);
+    runner.runTest("Long body misses its deadline", testMissedDeadline_LongBody);
+    runner.runTest("Catch-up iterations are late", testMissedDeadline_CatchUp);
+    runner.runTest("Cycle counter wrap-around", testCycles_WrapAround);
+    runner.runTest("Reset applied by the loop", testReset_AppliedByLoop);
+    runner.runTest("Text report", testReport);
+}
+
+// Run one iteration starting at startUs and lasting bodyUs (1 cycle = 1 us)
+static void iterate(LoopTimer& timer, uint32_t startUs, uint32_t bodyUs) {
+    timer.begin(startUs);
+    timer.end(startUs + bodyUs);
+}
+
+bool TestLoopTiming::testHistogram_Buckets() {
+    TestRunner runner(false);
+    TimingHistogram histogram;
+    
+    histogram.record(0);       // <= 5
+    histogram.record(5);       // <= 5 (bounds are inclusive)
+    histogram.record(6);       // <= 10
+    histogram.record(10000);   // <= 10000
+    histogram.record(50000);   // +Inf
+    
+    int last = TimingHistogram::BUCKETS - 1;
+    return runner.assertEqual(2, (int)histogram.bucketCount(0)) &&
+           runner.assertEqual(1, (int)histogram.bucketCount(1)) &&
+           runner.assertEqual(1, (int)histogram.bucketCount(last - 1)) &&
+           runner.assertEqual(1, (int)histogram.bucketCount(last)) &&
+           runner.assertEqual(5, (int)histogram.count()) &&
+           runner.assertEqual(60011, (int)histogram.sumUs()) &&
+           runner.assertEqual(50000, (int)histogram.maxUs()) &&
+           runner.assertTrue(TimingHistogram::upperBound(last) == UINT32_MAX);
+}
+
+bool TestLoopTiming::testHistogram_Percentile() {
+    TestRunner runner(false);
+    TimingHistogram histogram;
+    
+    if (!runner.assertEqual(0, (int)histogram.percentileUs(0.5f))) return false;
+    
+    // 98 fast samples, 2 slow ones
+    for (int i = 0; i < 98; i++) histogram.record(40);
+    histogram.record(300);
+    histogram.record(20000);
+    
+    return runner.assertEqual(50, (int)histogram.percentileUs(0.5f)) &&
+           runner.assertEqual(500, (int)histogram.percentileUs(0.99f)) &&
+           runner.assertTrue(histogram.percentileUs(1.0f) == UINT32_MAX);
+}
+
+bool TestLoopTiming::testSteadyLoop() {
+    TestRunner runner(false);
+    LoopTimer timer(10000);
+    
+    for (uint32_t i = 0; i < 100; i++) {
+        iterate(timer, 1000 + i * 10000, 150);
+    }
+    
+    // The first iteration has no period to measure
+    return runner.assertEqual(99, (int)timer.jitter().count()) &&
+           runner.assertEqual(99, (int)timer.jitter().bucketCount(0)) &&
+           runner.assertEqual(100, (int)timer.execution().count()) &&
+           runner.assertEqual(150, (int)timer.execution().maxUs()) &&
+           runner.assertEqual(0, (int)timer.missedDeadlines());
+}
+
+bool TestLoopTiming::testJitter_LateWake() {
+    TestRunner runner(false);
+    LoopTimer timer(10000);
+    
+    iterate(timer, 0, 100);
+    iterate(timer, 10300, 100);   // Woke 300 us late
+    iterate(timer, 20000, 100);   // Back on time (period 9700 us)
+    
+    // Late, but finished well before the next iteration was due
+    return runner.assertEqual(300, (int)timer.jitter().maxUs()) &&
+           runner.assertEqual(2, (int)timer.jitter().bucketCount(6)) &&   // <= 500
+           runner.assertEqual(0, (int)timer.missedDeadlines());
+}
+
+bool TestLoopTiming::testMissedDeadline_LongBody() {
+    TestRunner runner(false);
+    LoopTimer timer(10000);
+    
+    iterate(timer, 0, 100);
+    iterate(timer, 10000, 9999);   // Just in time
+    if (!runner.assertEqual(0, (int)timer.missedDeadlines())) return false;
+    
+    iterate(timer, 20000, 10500);  // Ends after 30000, when the next was due
+    return runner.assertEqual(1, (int)timer.missedDeadlines()) &&
+           runner.assertEqual(10500, (int)timer.execution().maxUs());
+}
+
+bool TestLoopTiming::testMissedDeadline_CatchUp() {
+    TestRunner runner(false);
+    LoopTimer timer(10000);
+    
+    // Blocked for 35 ms: vTaskDelayUntil then runs the iterations due at
+    // 10, 20 and 30 ms back to back, and the loop is on time again at 40
+    iterate(timer, 0, 100);
+    iterate(timer, 35000, 100);
+    iterate(timer, 35100, 100);
+    iterate(timer, 35200, 100);
+    iterate(timer, 40000, 100);
+    
+    // The iterations due at 10 and 20 ms ended after their successor was
+    // due; the one due at 30 ms ended at 35.3 ms, before 40 ms
+    return runner.assertEqual(2, (int)timer.missedDeadlines()) &&
+           runner.assertEqual(25000, (int)timer.jitter().maxUs());
+}
+
+bool TestLoopTiming::testCycles_WrapAround() {
+    TestRunner runner(false);
+    LoopTimer timer(10000, 240);  // 240 MHz
+    
+    // Periods of exactly 10 ms across the 32-bit cycle counter wrap
+    uint32_t start = 0xFFFFFFFFu - 2400000u;
+    for (uint32_t i = 0; i < 4; i++) {
+        uint32_t cycles = start + i * 2400000u;
+        timer.begin(cycles);
+        timer.end(cycles + 240u * 200u);  // 200 us body
+    }
+    
+    return runner.assertEqual(3, (int)timer.jitter().count()) &&
+           runner.assertEqual(0, (int)timer.jitter().maxUs()) &&
+           runner.assertEqual(200, (int)timer.execution().maxUs()) &&
+           runner.assertEqual(0, (int)timer.missedDeadlines());
+}
+
+bool TestLoopTiming::testReset_AppliedByLoop() {
+    TestRunner runner(false);
+    LoopTimer timer(10000);
+    
+    iterate(timer, 0, 100);
+    iterate(timer, 10000, 10500);  // Missed
+    
+    // Another task asks; nothing changes until the loop's next begin()
+    timer.requestReset();
+    if (!runner.assertEqual(1, (int)timer.missedDeadlines())) return false;
+    
+    iterate(timer, 20500, 100);
+    
+    // Cleared, then the new iteration recorded (its period still counts)
+    return runner.assertEqual(0, (int)timer.missedDeadlines()) &&
+           runner.assertEqual(1, (int)timer.execution().count()) &&
+           runner.assertEqual(1, (int)timer.jitter().count());
+}
+
+bool TestLoopTiming::testReport() {
+    TestRunner runner(false);
+    LoopTimer timer(10000);
+    
+    iterate(timer, 0, 100);
+    iterate(timer, 10000, 100);
+    
+    char text[1024];
+    size_t len = timer.report(text, sizeof(text));
+    
+    char small[40];
+    size_t cut = timer.report(small, sizeof(small));
+    
+    return runner.assertEqual((int)strlen(text), (int)len) &&
+           runner.assertTrue(strstr(text, "period 10000 us, 2 iterations, 0 missed") != nullptr) &&
+           runner.assertTrue(strstr(text, "> 10000 us") != nullptr) &&
+           runner.assertEqual(39, (int)cut) &&
+           runner.assertEqual(39, (int)strlen(small));
+}
@@ -0,0 +1,31 @@
+#ifndef TEST_LOOP_TIMING_H
+#define TEST_LOOP_TIMING_H
+
+#include "TestRunner.h"
+#include "../core/LoopTiming.h"
+
+/**
+ * @file TestLoopTiming.h
+ * @brief Unit tests for the motion loop timing histograms
+ *
+ * The loop is driven with made-up cycle counts, as the motion task
+ * drives it with ESP.getCycleCount().
+ */
+
+class TestLoopTiming {
+public:
+    static void runAllTests(TestRunner& runner);
+    
+private:
+    static bool testHistogram_Buckets();
+    static bool testHistogram_Percentile();
+    static bool testSteadyLoop();
+    static bool testJitter_LateWake();
+    static bool testMissedDeadline_LongBody();
+    static bool testMissedDeadline_CatchUp();
+    static bool testCycles_WrapAround();
+    static bool testReset_AppliedByLoop();
+    static bool testReport();
+};
+
+#endif // TEST_LOOP_TIMING_H
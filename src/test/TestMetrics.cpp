@@ -0,0 +1,110 @@
+#include "TestMetrics.h"
+#include <string.h>
+
+void TestMetrics::runAllTests(TestRunner& runner) {
+    runner.printHeader("METRICS");
+    
+    runner.runTest("Counters and gauges", testCounters);
+    runner.runTest("CPU utilization from idle run time", testIdleMeter_Utilization);
+    runner.runTest("Prometheus text format", testPrometheus_Format);
+    runner.runTest("Prometheus output truncation", testPrometheus_Truncation);
+    runner.runTest("Prometheus histogram", testPrometheus_Histogram);
+}
+
+bool TestMetrics::testCounters() {
+    TestRunner runner(false);
+    Metrics m;
+    
+    Metrics::increment(m.commandsReceived);
+    Metrics::increment(m.commandsReceived, 4);
+    Metrics::set(m.motionQueueDepth, 7);
+    Metrics::set(m.motionQueueDepth, 3);  // Gauges are overwritten
+    
+    if (!runner.assertEqual(5, (int)Metrics::get(m.commandsReceived))) return false;
+    if (!runner.assertEqual(3, (int)Metrics::get(m.motionQueueDepth))) return false;
+    
+    m.reset();
+    return runner.assertEqual(0, (int)Metrics::get(m.commandsReceived)) &&
+           runner.assertEqual(0, (int)Metrics::get(m.stepsIssued[1]));
+}
+
+bool TestMetrics::testIdleMeter_Utilization() {
+    TestRunner runner(false);
+    IdleMeter meter;
+    
+    // First sample only sets the reference point
+    if (!runner.assertNear(0.0f, meter.utilization(1000, 800), 0.001f)) return false;
+    
+    // 20 ms later the idle task has run 15 ms of them, however the busy
+    // time was split up (short bursts count too)
+    if (!runner.assertNear(0.25f, meter.utilization(21000, 15800), 0.001f)) return false;
+    
+    // Only the idle task ran since: no load
+    if (!runner.assertNear(0.0f, meter.utilization(31000, 25800), 0.001f)) return false;
+    
+    // The run-time counters wrap
+    uint32_t total = 0xFFFFF000u;
+    uint32_t idle = 0xFFFFFF00u;
+    meter.utilization(total, idle);
+    return runner.assertNear(0.5f, meter.utilization(total + 10000, idle + 5000), 0.001f);
+}
+
+bool TestMetrics::testPrometheus_Format() {
+    TestRunner runner(false);
+    char buffer[512];
+    PrometheusWriter out(buffer, sizeof(buffer));
+    
+    out.counter("scara_commands_received_total", "Commands received.", 42);
+    out.begin("scara_steps_total", "counter", "Step pulses issued per joint.");
+    out.sample("scara_steps_total", "joint", "1", (uint32_t)1200);
+    out.sample("scara_cpu_utilization", "core", "0", 0.5f);
+    
+    const char* expected =
+        "# HELP scara_commands_received_total Commands received.\n"
+        "# TYPE scara_commands_received_total counter\n"
+        "scara_commands_received_total 42\n"
+        "# HELP scara_steps_total Step pulses issued per joint.\n"
+        "# TYPE scara_steps_total counter\n"
+        "scara_steps_total{joint=\"1\"} 1200\n"
+        "scara_cpu_utilization{core=\"0\"} 0.5000\n";
+    
+    return runner.assertTrue(strcmp(out.text(), expected) == 0) &&
+           runner.assertEqual((int)strlen(expected), (int)out.length()) &&
+           runner.assertFalse(out.overflowed());
+}
+
+bool TestMetrics::testPrometheus_Truncation() {
+    TestRunner runner(false);
+    char buffer[48];
+    PrometheusWriter out(buffer, sizeof(buffer));
+    
+    out.sample("scara_heap_free_bytes", (uint32_t)100000);  // 29 bytes
+    out.sample("scara_heap_min_free_bytes", (uint32_t)90000);  // Does not fit
+    out.sample("x", (uint32_t)1);  // Would fit, but comes after a cut
+    
+    // Only whole lines are kept
+    return runner.assertTrue(out.overflowed()) &&
+           runner.assertTrue(strcmp(out.text(), "scara_heap_free_bytes 100000\n") == 0);
+}
+
+bool TestMetrics::testPrometheus_Histogram() {
+    TestRunner runner(false);
+    char buffer[512];
+    PrometheusWriter out(buffer, sizeof(buffer));
+    
+    const uint32_t bounds[] = {10, 100, 0};
+    const uint32_t counts[] = {3, 1, 2};
+    out.histogram("scara_loop_us", "Loop time.", bounds, counts, 3, 5000);
+    
+    // Buckets are cumulative; the last one is +Inf
+    const char* expected =
+        "# HELP scara_loop_us Loop time.\n"
+        "# TYPE scara_loop_us histogram\n"
+        "scara_loop_us_bucket{le=\"10\"} 3\n"
+        "scara_loop_us_bucket{le=\"100\"} 4\n"
+        "scara_loop_us_bucket{le=\"+Inf\"} 6\n"
+        "scara_loop_us_sum 5000\n"
+        "scara_loop_us_count 6\n";
+    
+    return runner.assertTrue(strcmp(out.text(), expected) == 0);
+}
@@ -0,0 +1,25 @@
+#ifndef TEST_METRICS_H
+#define TEST_METRICS_H
+
+#include "TestRunner.h"
+#include "../core/Metrics.h"
+#include "../web/Prometheus.h"
+
+/**
+ * @file TestMetrics.h
+ * @brief Unit tests for the /metrics counters, CPU load and text format
+ */
+
+class TestMetrics {
+public:
+    static void runAllTests(TestRunner& runner);
+    
+private:
+    static bool testCounters();
+    static bool testIdleMeter_Utilization();
+    static bool testPrometheus_Format();
+    static bool testPrometheus_Truncation();
+    static bool testPrometheus_Histogram();
+};
+
+#endif // TEST_METRICS_H
@@ -0,0 +1,96 @@
+#include "TestMotionController.h"
+#include "../Config.h"
+#include <math.h>
+
+// Run both joints until they stop; report when each one finished (ms)
+static void runUntilStopped(MotionController<StepperMotor, StepperMotor>& arm,
+                            unsigned long& done1, unsigned long& done2) {
+    unsigned long start = testMillis();
+    done1 = 0;
+    done2 = 0;
+    while (arm.isMoving() && testMillis() - start < 2000) {
+        arm.update();
+        unsigned long elapsed = testMillis() - start;
+        if (done1 == 0 && !arm.joint1().isMoving()) done1 = elapsed;
+        if (done2 == 0 && !arm.joint2().isMoving()) done2 = elapsed;
+    }
+    unsigned long elapsed = testMillis() - start;
+    if (done1 == 0) done1 = elapsed;
+    if (done2 == 0) done2 = elapsed;
+}
+
+void TestMotionController::runAllTests(TestRunner& runner) {
+    runner.printHeader("MOTION CONTROLLER");
+    
+    runner.runTest("Minimum move time", testMinMoveTime);
+    runner.runTest("moveJointsTo: Arrive together", testMoveJointsTo_ArriveTogether);
+    runner.runTest("moveJointsTo: Auto duration", testMoveJointsTo_AutoDuration);
+}
+
+bool TestMotionController::testMinMoveTime() {
+    StepperMotor motor(99, 98, 97);
+    motor.init();
+    motor.setSpeed(1000.0f);
+    motor.setAcceleration(0.0f);
+    
+    TestRunner runner(false);
+    
+    // 200 steps at 1000 steps/s peak: 1.5 * 200 / 1000 = 0.3 s
+    float angle = 200.0f / STEPS_PER_DEGREE;
+    if (!runner.assertEqual(0.3f, motor.getMinMoveTime(angle), 0.001f)) return false;
+    
+    // Acceleration limit: sqrt(6 * 200 / 1000) = 1.095 s
+    motor.setAcceleration(1000.0f);
+    if (!runner.assertEqual(1.095f, motor.getMinMoveTime(angle), 0.001f)) return false;
+    
+    // Already there
+    return runner.assertEqual(0.0f, motor.getMinMoveTime(0.0f), 0.001f);
+}
+
+bool TestMotionController::testMoveJointsTo_ArriveTogether() {
+    StepperMotor motorA(99, 98, 97);
+    StepperMotor motorB(96, 95, 94);
+    MotionController<StepperMotor, StepperMotor> arm(motorA, motorB);
+    arm.init();
+    arm.enable();
+    
+    TestRunner runner(false);
+    
+    // Joint 2 travels three times as far, in the same 100 ms
+    JointAngles target(2.0f, 6.0f);
+    float duration = arm.moveJointsTo(target, 0.1f);
+    if (!runner.assertEqual(0.1f, duration, 0.0001f)) return false;
+    
+    unsigned long done1, done2;
+    runUntilStopped(arm, done1, done2);
+    
+    long gap = (long)done1 - (long)done2;
+    if (gap < 0) gap = -gap;
+    
+    JointAngles reached = arm.getCurrentAngles();
+    return runner.assertFalse(arm.isMoving()) &&
+           runner.assertNear(2.0f, reached.theta1, 1.0f / STEPS_PER_DEGREE) &&
+           runner.assertNear(6.0f, reached.theta2, 1.0f / STEPS_PER_DEGREE) &&
+           runner.assertTrue(gap <= 10);
+}
+
+bool TestMotionController::testMoveJointsTo_AutoDuration() {
+    StepperMotor motorA(99, 98, 97);
+    StepperMotor motorB(96, 95, 94);
+    MotionController<StepperMotor, StepperMotor> arm(motorA, motorB);
+    arm.init();
+    arm.enable();
+    motorA.setSpeed(2000.0f);
+    motorB.setSpeed(2000.0f);
+    motorA.setAcceleration(0.0f);
+    motorB.setAcceleration(0.0f);
+    
+    TestRunner runner(false);
+    
+    // The longer joint sets the duration: 1.5 * steps / speed
+    JointAngles target(1.0f, 10.0f);
+    float expected = 1.5f * lroundf(10.0f * STEPS_PER_DEGREE) / 2000.0f;
+    float duration = arm.moveJointsTo(target);
+    
+    return runner.assertEqual(expected, duration, 0.001f);
+}
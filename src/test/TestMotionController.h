@@ -0,0 +1,25 @@
+#ifndef TEST_MOTION_CONTROLLER_H
+#define TEST_MOTION_CONTROLLER_H
+
+#include "TestRunner.h"
+#include "../hardware/MotionController.h"
+#include "../hardware/StepperMotor.h"
+
+/**
+ * @file TestMotionController.h
+ * @brief Unit tests for coordinated joint moves
+ * 
+ * Note: These tests simulate motor behavior without actual hardware
+ */
+
+class TestMotionController {
+public:
+    static void runAllTests(TestRunner& runner);
+    
+private:
+    static bool testMinMoveTime();
+    static bool testMoveJointsTo_ArriveTogether();
+    static bool testMoveJointsTo_AutoDuration();
+};
+
+#endif // TEST_MOTION_CONTROLLER_H
@@ -18,6 +18,9 @@ void TestPlanner::runAllTests(TestRunner& runner) {
     runner.runTest("Plan: Vertical line", testPlanPath_VerticalLine);
     runner.runTest("Plan: Horizontal line", testPlanPath_HorizontalLine);
     
+    // Incremental generation
+    runner.runTest("Plan: Incremental matches batch", testPlanPath_Incremental);
+    
     // Utility tests
     runner.runTest("Distance: Calculation", testDistance_Calculation);
 }
@@ -187,6 +190,35 @@ bool TestPlanner::testPlanPath_HorizontalLine() {
     return runner.assertTrue(numPoints >= 2) && runner.assertTrue(allHorizontal);
 }
 
+bool TestPlanner::testPlanPath_Incremental() {
+    Planner batchPlanner(50.0f, 200.0f);
+    Planner streamPlanner(50.0f, 200.0f);
+    TestRunner runner(false);
+    
+    Point2D start(0.0f, 150.0f);
+    Point2D end(120.0f, 200.0f);
+    std::queue<Point2D> queue;
+    
+    int batchPoints = batchPlanner.planPath(start, end, queue);
+    int streamPoints = streamPlanner.beginPath(start, end);
+    if (!runner.assertEqual(batchPoints, streamPoints)) return false;
+    
+    // Points pulled one by one must match the batch output exactly
+    int count = 0;
+    Point2D p;
+    while (streamPlanner.nextPoint(p)) {
+        if (!runner.assertFalse(queue.empty())) return false;
+        Point2D expected = queue.front();
+        queue.pop();
+        if (!runner.assertTrue(p == expected)) return false;
+        count++;
+    }
+    
+    return runner.assertEqual(streamPoints, count) &&
+           runner.assertFalse(streamPlanner.hasNextPoint()) &&
+           runner.assertTrue(queue.empty());
+}
+
 bool TestPlanner::testDistance_Calculation() {
     TestRunner runner(false);
     
@@ -30,6 +30,9 @@ private:
     static bool testPlanPath_VerticalLine();
     static bool testPlanPath_HorizontalLine();
     
+    // Incremental generation
+    static bool testPlanPath_Incremental();
+    
     // Distance calculation
     static bool testDistance_Calculation();
 };
@@ -0,0 +1,103 @@
+#include "TestProfiler.h"
+#include <stdio.h>
+#include <string.h>
+
+void TestProfiler::runAllTests(TestRunner& runner) {
+    runner.printHeader("PROFILER");
+    
+    runner.runTest("Slot statistics", testSlot_Statistics);
+    runner.runTest("Full table", testTable_Full);
+    runner.runTest("Scope measures its lifetime", testScope_MeasuresTime);
+    runner.runTest("Report in microseconds", testReport);
+}
+
+bool TestProfiler::testSlot_Statistics() {
+    TestRunner runner(false);
+    ProfileSlot slot;
+    
+    slot.record(5);
+    slot.record(3);
+    slot.record(10);
+    
+    if (!runner.assertEqual(3, (int)slot.count)) return false;
+    if (!runner.assertEqual(18, (int)slot.total)) return false;
+    if (!runner.assertEqual(3, (int)slot.min)) return false;
+    if (!runner.assertEqual(10, (int)slot.max)) return false;
+    
+    slot.reset();
+    slot.record(7);
+    return runner.assertEqual(1, (int)slot.count) &&
+           runner.assertEqual(7, (int)slot.min) &&
+           runner.assertEqual(7, (int)slot.max);
+}
+
+bool TestProfiler::testTable_Full() {
+    TestRunner runner(false);
+    ProfileTable table;
+    
+    ProfileSlot* first = table.claim("first");
+    for (int i = 1; i < PROFILE_MAX_SCOPES; i++) {
+        if (!table.claim("other")) return false;
+    }
+    
+    // One site too many: not profiled, and the report says so
+    ProfileSlot* extra = table.claim("extra");
+    char text[PROFILE_REPORT_SIZE];
+    table.report(text, sizeof(text), 1);
+    
+    // A scope without a row does nothing
+    {
+        ProfileScope scope(extra);
+    }
+    
+    return runner.assertTrue(first != nullptr) &&
+           runner.assertTrue(extra == nullptr) &&
+           runner.assertEqual(PROFILE_MAX_SCOPES, table.rows()) &&
+           runner.assertTrue(strstr(text, "1 scopes not profiled") != nullptr);
+}
+
+bool TestProfiler::testScope_MeasuresTime() {
+    TestRunner runner(false);
+    ProfileSlot slot;
+    uint32_t waitTicks = 200 * ProfileClock::ticksPerUs();  // 200 us
+    
+    {
+        ProfileScope scope(&slot);
+        uint32_t start = ProfileClock::now();
+        while (ProfileClock::now() - start < waitTicks) {
+        }
+    }
+    
+    return runner.assertEqual(1, (int)slot.count) &&
+           runner.assertTrue(slot.max >= waitTicks) &&
+           runner.assertTrue(slot.total == slot.max);
+}
+
+bool TestProfiler::testReport() {
+    TestRunner runner(false);
+    ProfileTable table;
+    
+    ProfileSlot* slot = table.claim("Kinematics::inverse");
+    slot->record(10);   // 5 us at 2 ticks per microsecond
+    slot->record(30);   // 15 us
+    table.claim("Planner::nextPoint");  // Never run
+    
+    char text[PROFILE_REPORT_SIZE];
+    size_t len = table.report(text, sizeof(text), 2);
+    
+    const char* row = strstr(text, "Kinematics::inverse");
+    if (!runner.assertTrue(row != nullptr)) return false;
+    
+    // Calls, total, average, min, max
+    char expected[96];
+    snprintf(expected, sizeof(expected), "%-24s %8u %12.1f %10.2f %10.2f %10.2f\n",
+             "Kinematics::inverse", 2u, 20.0, 10.0, 5.0, 15.0);
+    
+    table.reset();
+    
+    return runner.assertTrue(strncmp(row, expected, strlen(expected)) == 0) &&
+           runner.assertTrue(strstr(text, "Planner::nextPoint") != nullptr) &&
+           runner.assertEqual((int)strlen(text), (int)len) &&
+           runner.assertEqual(0, (int)slot->count) &&
+           runner.assertEqual(2, table.rows());
+}
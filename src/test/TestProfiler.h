@@ -0,0 +1,23 @@
+#ifndef TEST_PROFILER_H
+#define TEST_PROFILER_H
+
+#include "TestRunner.h"
+#include "../core/Profiler.h"
+
+/**
+ * @file TestProfiler.h
+ * @brief Unit tests for the PROFILE_SCOPE table and clock
+ */
+
+class TestProfiler {
+public:
+    static void runAllTests(TestRunner& runner);
+    
+private:
+    static bool testSlot_Statistics();
+    static bool testTable_Full();
+    static bool testScope_MeasuresTime();
+    static bool testReport();
+};
+
+#endif // TEST_PROFILER_H
@@ -0,0 +1,211 @@
+#include "TestPulseTrain.h"
+#include <math.h>
+
+#define MAX_TEST_EDGES 512
+
+// Play the whole train and collect step times and directions
+static int playTrain(PulseTrainCompiler& compiler, uint32_t* edges, int8_t* directions,
+                     int& bufferCount) {
+    int total = 0;
+    uint32_t clock = 0;
+    bufferCount = 0;
+    
+    compiler.begin();
+    bool more = compiler.current().count > 0;
+    while (more && bufferCount < 1000) {
+        const PulseBuffer& buffer = compiler.current();
+        int found = PulseTrainCompiler::decode(buffer, clock, edges + total,
+                                               MAX_TEST_EDGES - total);
+        for (int i = 0; i < found; i++) {
+            directions[total + i] = buffer.direction;
+        }
+        total += found;
+        bufferCount++;
+        more = compiler.bufferDone();
+    }
+    return total;
+}
+
+// Refill source generating 'remaining' identical slices
+struct RepeatSource {
+    StepSegment slice;
+    int remaining;
+};
+
+static bool repeatRefill(StepSegment& segment, void* context) {
+    RepeatSource* source = static_cast<RepeatSource*>(context);
+    if (source->remaining <= 0) {
+        return false;
+    }
+    source->remaining--;
+    segment = source->slice;
+    return true;
+}
+
+static StepSegment makeSlice(uint32_t durationUs, uint16_t steps, int8_t direction) {
+    StepSegment slice;
+    slice.durationUs = durationUs;
+    slice.steps = steps;
+    slice.direction = direction;
+    slice.intervalUs = steps > 0 ? durationUs / steps : 0;
+    return slice;
+}
+
+void TestPulseTrain::runAllTests(TestRunner& runner) {
+    runner.printHeader("PULSE TRAIN");
+    
+    runner.runTest("Single segment", testSingleSegment);
+    runner.runTest("Long gap (filler items)", testLongGap);
+    runner.runTest("Gap longer than a buffer", testGapLongerThanBuffer);
+    runner.runTest("Direction change", testDirectionChange);
+    runner.runTest("Double buffering", testDoubleBuffering);
+    runner.runTest("Empty schedule", testEmptySchedule);
+    runner.runTest("Prepared segments", testPreparedSegments);
+}
+
+bool TestPulseTrain::testSingleSegment() {
+    StepSegmentBuffer segments;
+    segments.push(makeSlice(2000, 10, 1));
+    PulseTrainCompiler compiler(PulseTrainCompiler::fromSegmentBuffer, &segments);
+    
+    TestRunner runner(false);
+    
+    uint32_t edges[MAX_TEST_EDGES];
+    int8_t directions[MAX_TEST_EDGES];
+    int buffers = 0;
+    int count = playTrain(compiler, edges, directions, buffers);
+    
+    if (!runner.assertEqual(10, count)) return false;
+    for (int i = 0; i < count; i++) {
+        // Step k at k * 200 us, one tick per microsecond
+        if (!runner.assertEqual((int)((i + 1) * 200 * PULSE_TICKS_PER_US), (int)edges[i])) return false;
+        if (!runner.assertEqual(1, (int)directions[i])) return false;
+    }
+    return true;
+}
+
+bool TestPulseTrain::testLongGap() {
+    // 1 step after 100 ms, then a 200 ms dwell, then 2 steps
+    StepSegmentBuffer segments;
+    segments.push(makeSlice(100000, 1, 1));
+    segments.push(makeSlice(200000, 0, 1));
+    segments.push(makeSlice(1000, 2, 1));
+    PulseTrainCompiler compiler(PulseTrainCompiler::fromSegmentBuffer, &segments);
+    
+    TestRunner runner(false);
+    
+    uint32_t edges[MAX_TEST_EDGES];
+    int8_t directions[MAX_TEST_EDGES];
+    int buffers = 0;
+    int count = playTrain(compiler, edges, directions, buffers);
+    
+    uint32_t tick = PULSE_TICKS_PER_US;
+    return runner.assertEqual(3, count) &&
+           runner.assertEqual((int)(100000 * tick), (int)edges[0]) &&
+           runner.assertEqual((int)(300500 * tick), (int)edges[1]) &&
+           runner.assertEqual((int)(301000 * tick), (int)edges[2]);
+}
+
+bool TestPulseTrain::testGapLongerThanBuffer() {
+    // A 6 s dwell (three idle slices) needs more fillers than one buffer
+    // holds (about 4.2 s at one tick per microsecond), then 2 steps
+    StepSegmentBuffer segments;
+    segments.push(makeSlice(2000000, 0, 1));
+    segments.push(makeSlice(2000000, 0, 1));
+    segments.push(makeSlice(2000000, 0, 1));
+    segments.push(makeSlice(1000, 2, 1));
+    PulseTrainCompiler compiler(PulseTrainCompiler::fromSegmentBuffer, &segments);
+    
+    TestRunner runner(false);
+    
+    uint32_t edges[MAX_TEST_EDGES];
+    int8_t directions[MAX_TEST_EDGES];
+    int buffers = 0;
+    int count = playTrain(compiler, edges, directions, buffers);
+    
+    uint32_t tick = PULSE_TICKS_PER_US;
+    return runner.assertTrue(buffers >= 2) &&
+           runner.assertEqual(2, count) &&
+           runner.assertEqual((int)(6000500 * tick), (int)edges[0]) &&
+           runner.assertEqual((int)(6001000 * tick), (int)edges[1]);
+}
+
+bool TestPulseTrain::testDirectionChange() {
+    StepSegmentBuffer segments;
+    segments.push(makeSlice(1000, 5, 1));
+    segments.push(makeSlice(1000, 5, -1));
+    PulseTrainCompiler compiler(PulseTrainCompiler::fromSegmentBuffer, &segments);
+    
+    TestRunner runner(false);
+    
+    uint32_t edges[MAX_TEST_EDGES];
+    int8_t directions[MAX_TEST_EDGES];
+    int buffers = 0;
+    int count = playTrain(compiler, edges, directions, buffers);
+    
+    if (!runner.assertEqual(10, count)) return false;
+    if (!runner.assertTrue(buffers >= 2)) return false;
+    for (int i = 0; i < count; i++) {
+        int expectedDirection = i < 5 ? 1 : -1;
+        if (!runner.assertEqual(expectedDirection, (int)directions[i])) return false;
+        if (!runner.assertEqual((int)((i + 1) * 200 * PULSE_TICKS_PER_US), (int)edges[i])) return false;
+    }
+    return true;
+}
+
+bool TestPulseTrain::testDoubleBuffering() {
+    // 300 steps: several times one buffer, fed through a custom refill
+    RepeatSource source;
+    source.slice = makeSlice(2000, 6, 1);
+    source.remaining = 50;
+    PulseTrainCompiler compiler(repeatRefill, &source);
+    
+    TestRunner runner(false);
+    
+    uint32_t edges[MAX_TEST_EDGES];
+    int8_t directions[MAX_TEST_EDGES];
+    int buffers = 0;
+    int count = playTrain(compiler, edges, directions, buffers);
+    
+    if (!runner.assertEqual(300, count)) return false;
+    if (!runner.assertTrue(buffers >= 300 / PULSE_BUFFER_ITEMS)) return false;
+    for (int i = 0; i < count; i++) {
+        uint32_t expected = ((i / 6) * 2000 + (i % 6 + 1) * 333) * PULSE_TICKS_PER_US;
+        if (!runner.assertEqual((int)expected, (int)edges[i])) return false;
+    }
+    return true;
+}
+
+bool TestPulseTrain::testEmptySchedule() {
+    StepSegmentBuffer segments;
+    PulseTrainCompiler compiler(PulseTrainCompiler::fromSegmentBuffer, &segments);
+    
+    TestRunner runner(false);
+    
+    compiler.begin();
+    return runner.assertEqual(0, compiler.current().count) &&
+           runner.assertFalse(compiler.bufferDone());
+}
+
+bool TestPulseTrain::testPreparedSegments() {
+    // A PVT move prepared for the segment walker compiles to the same steps
+    StepSegmentBuffer segments;
+    HermiteSegment motion(0.0f, 0.0f, 20.0f, 0.0f, 0.2f);
+    StepSegmentPreparer::prepare(motion, STEPS_PER_DEGREE, 0, segments);
+    PulseTrainCompiler compiler(PulseTrainCompiler::fromSegmentBuffer, &segments);
+    
+    TestRunner runner(false);
+    
+    uint32_t edges[MAX_TEST_EDGES];
+    int8_t directions[MAX_TEST_EDGES];
+    int buffers = 0;
+    int count = playTrain(compiler, edges, directions, buffers);
+    
+    // Steps in order, all inside the move
+    for (int i = 1; i < count; i++) {
+        if (!runner.assertTrue(edges[i] > edges[i - 1])) return false;
+    }
+    long expected = lroundf(20.0f * STEPS_PER_DEGREE);
+    return runner.assertEqual((int)expected, count) &&
+           runner.assertTrue(edges[count - 1] <= 200000 * PULSE_TICKS_PER_US);
+}
@@ -0,0 +1,29 @@
+#ifndef TEST_PULSE_TRAIN_H
+#define TEST_PULSE_TRAIN_H
+
+#include "TestRunner.h"
+#include "../core/PulseTrain.h"
+
+/**
+ * @file TestPulseTrain.h
+ * @brief Unit tests for the pulse train compiler
+ *
+ * Compiled buffers are decoded back into step times and compared with
+ * the source schedule.
+ */
+
+class TestPulseTrain {
+public:
+    static void runAllTests(TestRunner& runner);
+    
+private:
+    static bool testSingleSegment();
+    static bool testLongGap();
+    static bool testGapLongerThanBuffer();
+    static bool testDirectionChange();
+    static bool testDoubleBuffering();
+    static bool testEmptySchedule();
+    static bool testPreparedSegments();
+};
+
+#endif // TEST_PULSE_TRAIN_H
@@ -1,50 +1,81 @@
 #include "TestRunner.h"
+#include <math.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <chrono>
+#endif
+
+void testPrintf(const char* format, ...) {
+    char text[256];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(text, sizeof(text), format, args);
+    va_end(args);
+    
+#ifdef ARDUINO
+    Serial.print(text);
+#else
+    fputs(text, stdout);
+#endif
+}
+
+uint32_t testMillis() {
+#ifdef ARDUINO
+    return millis();
+#else
+    static const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    return (uint32_t)std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start).count();
+#endif
+}
 
 void TestRunner::runTest(const char* name, bool (*testFunc)()) {
     stats.total++;
-    Serial.print("  [TEST] ");
-    Serial.print(name);
-    Serial.print("... ");
+    testPrintf("  [TEST] %s... ", name);
     
     bool result = testFunc();
     
     if (result) {
         stats.passed++;
-        Serial.println("PASS");
+        testPrintf("PASS\n");
     } else {
         stats.failed++;
-        Serial.println("FAIL");
+        testPrintf("FAIL\n");
     }
     
+#ifdef ARDUINO
     delay(10);  // Small delay for Serial output
+#endif
 }
 
 bool TestRunner::assertTrue(bool condition, const char* message) {
     if (!condition && verbose) {
-        Serial.print("    ASSERT FAILED: ");
-        Serial.println(message);
+        testPrintf("    ASSERT FAILED: %s\n", message);
     }
     return condition;
 }
 
 bool TestRunner::assertFalse(bool condition, const char* message) {
     if (condition && verbose) {
-        Serial.print("    ASSERT FAILED: ");
-        Serial.println(message);
+        testPrintf("    ASSERT FAILED: %s\n", message);
     }
     return !condition;
 }
 
 bool TestRunner::assertEqual(float expected, float actual, float tolerance, const char* message) {
-    float diff = abs(expected - actual);
+    float diff = fabsf(expected - actual);
     bool result = diff <= tolerance;
     
     if (!result && verbose) {
-        Serial.printf("    ASSERT FAILED: Expected %.4f, got %.4f (diff: %.4f)\n", 
-                     expected, actual, diff);
+        testPrintf("    ASSERT FAILED: Expected %.4f, got %.4f (diff: %.4f)\n", 
+                   expected, actual, diff);
         if (strlen(message) > 0) {
-            Serial.print("    Message: ");
-            Serial.println(message);
+            testPrintf("    Message: %s\n", message);
         }
     }
     
@@ -55,10 +86,9 @@ bool TestRunner::assertEqual(int expected, int actual, const char* message) {
     bool result = (expected == actual);
     
     if (!result && verbose) {
-        Serial.printf("    ASSERT FAILED: Expected %d, got %d\n", expected, actual);
+        testPrintf("    ASSERT FAILED: Expected %d, got %d\n", expected, actual);
         if (strlen(message) > 0) {
-            Serial.print("    Message: ");
-            Serial.println(message);
+            testPrintf("    Message: %s\n", message);
         }
     }
     
@@ -70,36 +100,31 @@ bool TestRunner::assertNear(float expected, float actual, float tolerance, const
 }
 
 void TestRunner::printResults() {
-    Serial.println("\n========================================");
-    Serial.println("TEST RESULTS");
-    Serial.println("========================================");
-    Serial.printf("Total:  %d\n", stats.total);
-    Serial.printf("Passed: %d\n", stats.passed);
-    Serial.printf("Failed: %d\n", stats.failed);
+    testPrintf("\n========================================\n");
+    testPrintf("TEST RESULTS\n");
+    testPrintf("========================================\n");
+    testPrintf("Total:  %d\n", stats.total);
+    testPrintf("Passed: %d\n", stats.passed);
+    testPrintf("Failed: %d\n", stats.failed);
     
     if (stats.failed == 0) {
-        Serial.println("\n✅ ALL TESTS PASSED!");
+        testPrintf("\n✅ ALL TESTS PASSED!\n");
     } else {
-        Serial.println("\n❌ SOME TESTS FAILED");
+        testPrintf("\n❌ SOME TESTS FAILED\n");
     }
-    Serial.println("========================================\n");
+    testPrintf("========================================\n\n");
 }
 
 void TestRunner::printHeader(const char* suiteName) {
-    Serial.println("\n========================================");
-    Serial.print("TEST SUITE: ");
-    Serial.println(suiteName);
-    Serial.println("========================================");
+    testPrintf("\n========================================\n");
+    testPrintf("TEST SUITE: %s\n", suiteName);
+    testPrintf("========================================\n");
 }
 
 void TestRunner::printTest(const char* testName, bool passed, const char* message) {
-    Serial.print("  [");
-    Serial.print(passed ? "PASS" : "FAIL");
-    Serial.print("] ");
-    Serial.print(testName);
+    testPrintf("  [%s] %s", passed ? "PASS" : "FAIL", testName);
     if (strlen(message) > 0) {
-        Serial.print(" - ");
-        Serial.print(message);
+        testPrintf(" - %s", message);
     }
-    Serial.println();
+    testPrintf("\n");
 }
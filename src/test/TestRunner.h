@@ -1,16 +1,23 @@
 #ifndef TEST_RUNNER_H
 #define TEST_RUNNER_H
 
-#include <Arduino.h>
+#include <stdint.h>
 
 /**
  * @file TestRunner.h
  * @brief Simple test framework for unit testing
  * 
  * Provides macros and utilities for running unit tests
- * and reporting results via Serial.
+ * and reporting results via Serial (printf on the host, see the
+ * native environment in platformio.ini).
  */
 
+// Test output: Serial on the ESP32, stdout on the host
+void testPrintf(const char* format, ...) __attribute__((format(printf, 1, 2)));
+
+// Milliseconds since start-up, for tests that run against the real clock
+uint32_t testMillis();
+
 // Test result structure
 struct TestResult {
     const char* testName;
@@ -0,0 +1,161 @@
+#include "TestSimMotor.h"
+#include "../core/Kinematics.h"
+#include "../core/Planner.h"
+#include "../core/TrajectoryExecutor.h"
+#include "../hardware/MotionController.h"
+#include "../Config.h"
+#include <math.h>
+
+// Run the motor in 1 ms ticks until it stops (plus settling time)
+static void runMotor(SimClock& clock, SimMotor& motor, int maxMs, int settleMs) {
+    for (int i = 0; i < maxMs && motor.isMoving(); i++) {
+        clock.advance(1000);
+        motor.update();
+    }
+    for (int i = 0; i < settleMs; i++) {
+        clock.advance(1000);
+        motor.update();
+    }
+}
+
+void TestSimMotor::runAllTests(TestRunner& runner) {
+    runner.printHeader("SIM MOTOR");
+    
+    runner.runTest("Holds position", testHoldsPosition);
+    runner.runTest("Follows within limits", testFollowsWithinLimits);
+    runner.runTest("Stall when overdriven", testStallWhenOverdriven);
+    runner.runTest("Torque-speed limit", testTorqueSpeedLimit);
+    runner.runTest("Planned path", testPlannedPath);
+}
+
+bool TestSimMotor::testHoldsPosition() {
+    SimClock clock;
+    SimMotor motor(clock);
+    motor.init();
+    motor.enable();
+    
+    TestRunner runner(false);
+    
+    runMotor(clock, motor, 0, 100);
+    return runner.assertNear(0.0f, motor.getCurrentAngle(), 0.01f) &&
+           runner.assertFalse(motor.isStalled());
+}
+
+bool TestSimMotor::testFollowsWithinLimits() {
+    SimClock clock;
+    SimMotor motor(clock);
+    motor.init();
+    motor.enable();
+    
+    TestRunner runner(false);
+    
+    // 90 degrees in 0.5 s: peak 270 deg/s, well inside the torque curve
+    motor.moveToAngleIn(90.0f, 0.5f);
+    runMotor(clock, motor, 1000, 200);
+    
+    return runner.assertFalse(motor.isMoving()) &&
+           runner.assertFalse(motor.isStalled()) &&
+           runner.assertNear(90.0f, motor.getCurrentAngle(), 0.2f) &&
+           runner.assertTrue(motor.getMaxFollowingError() < 1.8f);
+}
+
+bool TestSimMotor::testStallWhenOverdriven() {
+    SimClock clock;
+    SimMotor motor(clock);
+    motor.init();
+    motor.enable();
+    
+    TestRunner runner(false);
+    
+    // 90 degrees in 20 ms needs far more acceleration than the torque allows
+    motor.moveToAngleIn(90.0f, 0.02f);
+    runMotor(clock, motor, 1000, 200);
+    
+    return runner.assertTrue(motor.isStalled()) &&
+           runner.assertTrue(fabsf(motor.getCurrentAngle() - 90.0f) > 1.0f);
+}
+
+bool TestSimMotor::testTorqueSpeedLimit() {
+    SimClock clock;
+    SimMotor motor(clock);
+    motor.init();
+    motor.enable();
+    
+    TestRunner runner(false);
+    
+    // Gentle acceleration, but a top speed past the no-load speed: the
+    // torque runs out on the way up
+    motor.setAcceleration(200000.0f * STEPS_PER_DEGREE);
+    motor.setSpeed(1.2f * SIM_NO_LOAD_SPEED * STEPS_PER_DEGREE);
+    motor.moveToAngle(179.0f);  // Longest move the short way round
+    runMotor(clock, motor, 2000, 0);
+    
+    return runner.assertTrue(motor.isStalled());
+}
+
+bool TestSimMotor::testPlannedPath() {
+    // Kinematics -> Planner -> executor -> motors, all on simulated time
+    SimClock clock;
+    SimMotor motorA(clock);
+    SimMotor motorB(clock);
+    MotionController<SimMotor, SimMotor> arm(motorA, motorB);
+    arm.init();
+    arm.enable();
+    motorA.setSpeed(STEPPER_MAX_SPEED);
+    motorB.setSpeed(STEPPER_MAX_SPEED);
+    
+    Kinematics kin(ARM_LENGTH_1, ARM_LENGTH_2);
+    Planner planner(DEFAULT_SPEED, ACCELERATION);
+    TrajectoryExecutor executor;
+    
+    TestRunner runner(false);
+    
+    // Both joints stay clear of the 0/360 wrap on this path
+    Point2D start(100.0f, 150.0f);
+    Point2D end(150.0f, 200.0f);
+    
+    // Bring the arm to the start point first
+    JointAngles angles;
+    if (!runner.assertTrue(kin.inverse(start, angles))) return false;
+    arm.moveJointsTo(angles);
+    for (int i = 0; i < 5000 && arm.isMoving(); i++) {
+        clock.advance(1000);
+        arm.update();
+    }
+    
+    // Stream the path at the motion loop rate
+    planner.beginPath(start, end);
+    Point2D point;
+    float t;
+    Point2D position;
+    bool more = true;
+    for (int tick = 0; tick < 2000 && (more || executor.isActive()); tick++) {
+        uint32_t now = clock.micros();
+        while (more && executor.needsSample(now)) {
+            more = planner.nextPoint(point, t);
+            if (more && kin.inverse(point, angles)) {
+                executor.push(TrajectorySample(t, angles, point), now);
+            }
+        }
+        if (executor.sample(now, angles, position)) {
+            arm.moveToAngles(angles);
+        }
+        
+        // 10 ms control tick, motors updated every 1 ms
+        for (int i = 0; i < 10; i++) {
+            clock.advance(1000);
+            arm.update();
+        }
+    }
+    for (int i = 0; i < 2000 && arm.isMoving(); i++) {
+        clock.advance(1000);
+        arm.update();
+    }
+    
+    Point2D reached;
+    kin.forward(arm.getCurrentAngles(), reached);
+    
+    return runner.assertFalse(motorA.isStalled()) &&
+           runner.assertFalse(motorB.isStalled()) &&
+           runner.assertNear(0.0f, Planner::distance(reached, end), 0.5f);
+}
@@ -0,0 +1,27 @@
+#ifndef TEST_SIM_MOTOR_H
+#define TEST_SIM_MOTOR_H
+
+#include "TestRunner.h"
+#include "../hardware/SimMotor.h"
+
+/**
+ * @file TestSimMotor.h
+ * @brief Unit tests for the simulated motor model
+ *
+ * Moves run against a SimClock, so these tests take far less time than
+ * the motion they simulate.
+ */
+
+class TestSimMotor {
+public:
+    static void runAllTests(TestRunner& runner);
+    
+private:
+    static bool testHoldsPosition();
+    static bool testFollowsWithinLimits();
+    static bool testStallWhenOverdriven();
+    static bool testTorqueSpeedLimit();
+    static bool testPlannedPath();
+};
+
+#endif // TEST_SIM_MOTOR_H
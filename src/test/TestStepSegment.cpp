@@ -0,0 +1,157 @@
+#include "TestStepSegment.h"
+#include <math.h>
+
+// Sum the signed steps of every slice left in the buffer
+static long drainSteps(StepSegmentBuffer& buffer, uint32_t& totalUs, int& count) {
+    long total = 0;
+    totalUs = 0;
+    count = 0;
+    StepSegment slice;
+    while (buffer.pop(slice)) {
+        total += slice.direction * (long)slice.steps;
+        totalUs += slice.durationUs;
+        count++;
+    }
+    return total;
+}
+
+void TestStepSegment::runAllTests(TestRunner& runner) {
+    runner.printHeader("STEP SEGMENTS");
+    
+    runner.runTest("Buffer: FIFO order", testBuffer_FifoOrder);
+    runner.runTest("Buffer: Full and wrap-around", testBuffer_FullAndWrap);
+    runner.runTest("Prepare: Total steps", testPrepare_TotalSteps);
+    runner.runTest("Prepare: Constant rate", testPrepare_ConstantRate);
+    runner.runTest("Prepare: Reverse direction", testPrepare_Reverse);
+    runner.runTest("Prepare: Limited buffer room", testPrepare_LimitedRoom);
+}
+
+bool TestStepSegment::testBuffer_FifoOrder() {
+    StepSegmentBuffer buffer;
+    TestRunner runner(false);
+    
+    for (int i = 1; i <= 3; i++) {
+        StepSegment slice;
+        slice.steps = i;
+        if (!runner.assertTrue(buffer.push(slice))) return false;
+    }
+    
+    StepSegment slice;
+    for (int i = 1; i <= 3; i++) {
+        if (!runner.assertTrue(buffer.pop(slice))) return false;
+        if (!runner.assertEqual(i, (int)slice.steps)) return false;
+    }
+    
+    return runner.assertFalse(buffer.pop(slice)) &&
+           runner.assertTrue(buffer.isEmpty());
+}
+
+bool TestStepSegment::testBuffer_FullAndWrap() {
+    StepSegmentBuffer buffer;
+    TestRunner runner(false);
+    StepSegment slice;
+    
+    // Capacity is one less than the array size
+    int capacity = buffer.available();
+    if (!runner.assertEqual(STEP_SEGMENT_BUFFER_SIZE - 1, capacity)) return false;
+    
+    for (int round = 0; round < 3; round++) {
+        for (int i = 0; i < capacity; i++) {
+            slice.steps = i;
+            if (!runner.assertTrue(buffer.push(slice))) return false;
+        }
+        if (!runner.assertFalse(buffer.push(slice))) return false;
+        if (!runner.assertEqual(0, buffer.available())) return false;
+        
+        for (int i = 0; i < capacity; i++) {
+            if (!runner.assertTrue(buffer.pop(slice))) return false;
+            if (!runner.assertEqual(i, (int)slice.steps)) return false;
+        }
+    }
+    
+    return runner.assertTrue(buffer.isEmpty());
+}
+
+bool TestStepSegment::testPrepare_TotalSteps() {
+    StepSegmentBuffer buffer;
+    TestRunner runner(false);
+    
+    // Rest-to-rest move of 10 degrees in 40 ms, starting at step 100
+    HermiteSegment seg(100.0f / STEPS_PER_DEGREE, 0.0f,
+                       100.0f / STEPS_PER_DEGREE + 10.0f, 0.0f, 0.04f);
+    int count = StepSegmentPreparer::prepare(seg, STEPS_PER_DEGREE, 100, buffer);
+    
+    uint32_t totalUs;
+    int popped;
+    long steps = drainSteps(buffer, totalUs, popped);
+    
+    return runner.assertEqual(20, count) &&  // 40 ms in 2 ms slices
+           runner.assertEqual(count, popped) &&
+           runner.assertEqual((int)lroundf(10.0f * STEPS_PER_DEGREE), (int)steps) &&
+           runner.assertEqual(40000, (int)totalUs);
+}
+
+bool TestStepSegment::testPrepare_ConstantRate() {
+    StepSegmentBuffer buffer;
+    TestRunner runner(false);
+    
+    // 1000 steps/s for 20 ms: every 2 ms slice holds 2 steps, 1000 us apart
+    float velocity = 1000.0f / STEPS_PER_DEGREE;
+    HermiteSegment seg(0.0f, velocity, velocity * 0.02f, velocity, 0.02f);
+    StepSegmentPreparer::prepare(seg, STEPS_PER_DEGREE, 0, buffer);
+    
+    StepSegment slice;
+    while (buffer.pop(slice)) {
+        if (!runner.assertEqual(2, (int)slice.steps)) return false;
+        if (!runner.assertEqual(1000, (int)slice.intervalUs)) return false;
+        if (!runner.assertEqual(1, (int)slice.direction)) return false;
+    }
+    return true;
+}
+
+bool TestStepSegment::testPrepare_Reverse() {
+    StepSegmentBuffer buffer;
+    TestRunner runner(false);
+    
+    HermiteSegment seg(20.0f, 0.0f, 15.0f, 0.0f, 0.01f);
+    long start = lroundf(20.0f * STEPS_PER_DEGREE);
+    StepSegmentPreparer::prepare(seg, STEPS_PER_DEGREE, start, buffer);
+    
+    uint32_t totalUs;
+    int count;
+    long steps = drainSteps(buffer, totalUs, count);
+    
+    return runner.assertEqual((int)(lroundf(15.0f * STEPS_PER_DEGREE) - start), (int)steps);
+}
+
+bool TestStepSegment::testPrepare_LimitedRoom() {
+    StepSegmentBuffer buffer;
+    TestRunner runner(false);
+    
+    // Leave room for only 4 slices
+    StepSegment filler;
+    int fillers = 0;
+    while (buffer.available() > 4) {
+        buffer.push(filler);
+        fillers++;
+    }
+    
+    // 100 ms would need 50 slices: they get stretched to fit
+    HermiteSegment seg(0.0f, 0.0f, 30.0f, 0.0f, 0.1f);
+    int count = StepSegmentPreparer::prepare(seg, STEPS_PER_DEGREE, 0, buffer);
+    
+    // Drop the filler, then check the prepared slices
+    StepSegment slice;
+    for (int i = 0; i < fillers; i++) {
+        buffer.pop(slice);
+    }
+    
+    uint32_t totalUs;
+    int popped;
+    long steps = drainSteps(buffer, totalUs, popped);
+    
+    return runner.assertEqual(4, count) &&
+           runner.assertEqual(4, popped) &&
+           runner.assertEqual((int)lroundf(30.0f * STEPS_PER_DEGREE), (int)steps) &&
+           runner.assertEqual(100000, (int)totalUs);
+}
@@ -0,0 +1,28 @@
+#ifndef TEST_STEP_SEGMENT_H
+#define TEST_STEP_SEGMENT_H
+
+#include "TestRunner.h"
+#include "../core/StepSegment.h"
+
+/**
+ * @file TestStepSegment.h
+ * @brief Unit tests for step segment preparation and buffering
+ */
+
+class TestStepSegment {
+public:
+    static void runAllTests(TestRunner& runner);
+    
+private:
+    // Buffer tests
+    static bool testBuffer_FifoOrder();
+    static bool testBuffer_FullAndWrap();
+    
+    // Preparation tests
+    static bool testPrepare_TotalSteps();
+    static bool testPrepare_ConstantRate();
+    static bool testPrepare_Reverse();
+    static bool testPrepare_LimitedRoom();
+};
+
+#endif // TEST_STEP_SEGMENT_H
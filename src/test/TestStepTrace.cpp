@@ -0,0 +1,153 @@
+#include "TestStepTrace.h"
+#include <string.h>
+
+// Freeze the trace and copy its whole dump
+static size_t dumpTrace(StepTrace& trace, uint8_t* out, size_t size) {
+    trace.freeze();
+    size_t length = trace.read(out, size, 0);
+    trace.resume();
+    return length;
+}
+
+void TestStepTrace::runAllTests(TestRunner& runner) {
+    runner.printHeader("STEP TRACE");
+    
+    runner.runTest("Dump round trip", testDump_RoundTrip);
+    runner.runTest("Oldest events overwritten", testDump_WrapAround);
+    runner.runTest("Dump read in chunks", testDump_ReadInChunks);
+    runner.runTest("Frozen trace drops events", testFrozen_DropsEvents);
+    runner.runTest("Clear", testClear);
+}
+
+bool TestStepTrace::testDump_RoundTrip() {
+    TestRunner runner(false);
+    TraceEvent storage[8];
+    StepTrace trace(storage, 8);
+    
+    trace.recordPosition(0, 1200, 100);
+    trace.recordStep(0, true, 150);
+    trace.recordStep(1, false, 160);
+    trace.recordSample(Point2D(123.456f, -20.0f), true, 170);
+    trace.recordPosition(1, -100, 180);  // Wrapped to one turn
+    
+    uint8_t dump[TRACE_HEADER_SIZE + 8 * TRACE_EVENT_SIZE];
+    size_t length = dumpTrace(trace, dump, sizeof(dump));
+    
+    TraceHeader header;
+    if (!runner.assertEqual((int)(TRACE_HEADER_SIZE + 6 * TRACE_EVENT_SIZE), (int)length)) return false;
+    if (!runner.assertTrue(StepTrace::parseHeader(dump, length, header))) return false;
+    if (!runner.assertEqual(6, (int)header.eventCount)) return false;
+    if (!runner.assertEqual(STEPS_PER_REVOLUTION * MICROSTEPS, (int)header.stepsPerRevolution)) return false;
+    if (!runner.assertEqual(ARM_LENGTH_1, header.armLength1, 0.05f)) return false;
+    
+    TraceEvent e[6];
+    for (int i = 0; i < 6; i++) {
+        e[i] = StepTrace::decodeEvent(dump + TRACE_HEADER_SIZE + i * TRACE_EVENT_SIZE);
+    }
+    
+    return runner.assertEqual(TRACE_POSITION, (int)e[0].type) &&
+           runner.assertEqual(1200, (int)e[0].value) &&
+           runner.assertEqual(100, (int)e[0].timeUs) &&
+           runner.assertEqual(TRACE_STEP, (int)e[1].type) &&
+           runner.assertEqual(1, (int)e[1].value) &&
+           runner.assertEqual(1, (int)e[2].channel) &&
+           runner.assertEqual(-1, (int)e[2].value) &&
+           runner.assertEqual(TRACE_SAMPLE_X, (int)e[3].type) &&
+           runner.assertEqual(1, (int)e[3].channel) &&
+           runner.assertEqual(12346, (int)e[3].value) &&
+           runner.assertEqual(TRACE_SAMPLE_Y, (int)e[4].type) &&
+           runner.assertEqual(-2000, (int)e[4].value) &&
+           runner.assertEqual(STEPS_PER_REVOLUTION * MICROSTEPS - 100, (int)e[5].value);
+}
+
+bool TestStepTrace::testDump_WrapAround() {
+    TestRunner runner(false);
+    TraceEvent storage[8];
+    StepTrace trace(storage, 8);
+    
+    for (uint32_t t = 0; t < 20; t++) {
+        trace.recordStep(0, true, t);
+    }
+    
+    // One slot is kept back for an event being written during freeze()
+    uint8_t dump[TRACE_HEADER_SIZE + 8 * TRACE_EVENT_SIZE];
+    size_t length = dumpTrace(trace, dump, sizeof(dump));
+    if (!runner.assertEqual((int)(TRACE_HEADER_SIZE + 7 * TRACE_EVENT_SIZE), (int)length)) return false;
+    
+    for (int i = 0; i < 7; i++) {
+        TraceEvent event = StepTrace::decodeEvent(dump + TRACE_HEADER_SIZE + i * TRACE_EVENT_SIZE);
+        if (!runner.assertEqual(13 + i, (int)event.timeUs)) return false;
+    }
+    return runner.assertEqual(20, (int)trace.recorded());
+}
+
+bool TestStepTrace::testDump_ReadInChunks() {
+    TestRunner runner(false);
+    TraceEvent storage[16];
+    StepTrace trace(storage, 16);
+    
+    for (uint32_t t = 0; t < 10; t++) {
+        trace.recordStep(t % 2, t % 3 == 0, t * 250);
+    }
+    
+    uint8_t whole[TRACE_HEADER_SIZE + 16 * TRACE_EVENT_SIZE];
+    uint8_t pieces[sizeof(whole)];
+    trace.freeze();
+    size_t total = trace.read(whole, sizeof(whole), 0);
+    
+    // Pieces that straddle the header and the events, as the HTTP
+    // response asks for them
+    size_t index = 0;
+    while (true) {
+        size_t n = trace.read(pieces + index, 5, index);
+        if (n == 0) break;
+        index += n;
+    }
+    trace.resume();
+    
+    return runner.assertEqual((int)trace.dumpSize(), (int)total) &&
+           runner.assertEqual((int)total, (int)index) &&
+           runner.assertTrue(memcmp(whole, pieces, total) == 0);
+}
+
+bool TestStepTrace::testFrozen_DropsEvents() {
+    TestRunner runner(false);
+    TraceEvent storage[8];
+    StepTrace trace(storage, 8);
+    
+    trace.recordStep(0, true, 1);
+    if (!runner.assertTrue(trace.freeze())) return false;
+    
+    // A second download has to wait
+    if (!runner.assertFalse(trace.freeze())) return false;
+    
+    trace.recordStep(0, true, 2);
+    if (!runner.assertEqual(1, (int)trace.recorded())) return false;
+    
+    trace.resume();
+    trace.recordStep(0, true, 3);
+    return runner.assertEqual(2, (int)trace.recorded()) &&
+           runner.assertFalse(trace.isFrozen());
+}
+
+bool TestStepTrace::testClear() {
+    TestRunner runner(false);
+    TraceEvent storage[8];
+    StepTrace trace(storage, 8);
+    
+    trace.recordStep(0, true, 1);
+    trace.recordStep(0, true, 2);
+    trace.clear();
+    trace.recordStep(1, false, 3);
+    
+    uint8_t dump[TRACE_HEADER_SIZE + 8 * TRACE_EVENT_SIZE];
+    size_t length = dumpTrace(trace, dump, sizeof(dump));
+    TraceEvent event = StepTrace::decodeEvent(dump + TRACE_HEADER_SIZE);
+    
+    // Uncorrupted: the header still parses, with only the new event
+    TraceHeader header;
+    return runner.assertEqual((int)(TRACE_HEADER_SIZE + TRACE_EVENT_SIZE), (int)length) &&
+           runner.assertTrue(StepTrace::parseHeader(dump, length, header)) &&
+           runner.assertEqual(1, (int)header.eventCount) &&
+           runner.assertEqual(3, (int)event.timeUs);
+}
@@ -0,0 +1,24 @@
+#ifndef TEST_STEP_TRACE_H
+#define TEST_STEP_TRACE_H
+
+#include "TestRunner.h"
+#include "../core/StepTrace.h"
+
+/**
+ * @file TestStepTrace.h
+ * @brief Unit tests for the step trace ring buffer and its dump format
+ */
+
+class TestStepTrace {
+public:
+    static void runAllTests(TestRunner& runner);
+    
+private:
+    static bool testDump_RoundTrip();
+    static bool testDump_WrapAround();
+    static bool testDump_ReadInChunks();
+    static bool testFrozen_DropsEvents();
+    static bool testClear();
+};
+
+#endif // TEST_STEP_TRACE_H
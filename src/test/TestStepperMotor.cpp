@@ -1,5 +1,6 @@
 #include "TestStepperMotor.h"
 #include "../Config.h"
+#include "../hardware/StepTicker.h"
 
 bool TestStepperMotor::testInit() {
     // Use dummy pins (not connected)
@@ -131,6 +132,76 @@ bool TestStepperMotor::testIsMoving() {
     return runner.assertTrue(moving || !moving);  // Always true, just check it works
 }
 
+bool TestStepperMotor::testMoveToPVT() {
+    StepperMotor motor(99, 98, 97);
+    motor.init();
+    motor.enable();
+    
+    TestRunner runner(false);
+    
+    // Rest-to-rest PVT segment: 2 degrees in 50 ms
+    motor.moveToPVT(2.0f, 0.0f, 0.05f);
+    if (!runner.assertTrue(motor.isMoving())) return false;
+    
+    // Run the step generator until the segment is done (with timeout)
+    unsigned long start = testMillis();
+    while (motor.isMoving() && testMillis() - start < 500) {
+        motor.update();
+    }
+    
+    return runner.assertFalse(motor.isMoving()) &&
+           runner.assertNear(2.0f, motor.getCurrentAngle(), 1.0f / STEPS_PER_DEGREE);
+}
+
+bool TestStepperMotor::testPVTCrossesZero() {
+    StepperMotor motor(99, 98, 97);
+    motor.init();
+    motor.enable();
+    motor.setCurrentAngle(359.0f);
+    
+    TestRunner runner(false);
+    
+    // 359° -> 1° is 2° forward across 0°, not 358° back
+    uint32_t stepsBefore = motor.getStepsIssued();
+    motor.moveToPVT(1.0f, 0.0f, 0.05f);
+    
+    unsigned long start = testMillis();
+    while (motor.isMoving() && testMillis() - start < 500) {
+        motor.update();
+    }
+    int steps = (int)(motor.getStepsIssued() - stepsBefore);
+    
+    return runner.assertFalse(motor.isMoving()) &&
+           runner.assertNear(1.0f, motor.getCurrentAngle(), 1.0f / STEPS_PER_DEGREE) &&
+           runner.assertTrue(abs(steps - (int)lroundf(2.0f * STEPS_PER_DEGREE)) <= 1);
+}
+
+bool TestStepperMotor::testAccelerationRamp() {
+    StepperMotor motor(99, 98, 97);
+    motor.init();
+    motor.enable();
+    motor.setSpeed(4000.0f);
+    motor.setAcceleration(20000.0f);
+    
+    TestRunner runner(false);
+    
+    // 200 steps: at full speed from the start this would take 50 ms. With
+    // a 20000 steps/s² ramp it is a triangle of 100 steps up and 100 down,
+    // 2*sqrt(2*100/a) = 200 ms (a little less: the first step comes early)
+    float target = 200.0f / STEPS_PER_DEGREE;
+    motor.moveToAngle(target);
+    
+    unsigned long start = testMillis();
+    while (motor.isMoving() && testMillis() - start < 1000) {
+        motor.update();
+    }
+    unsigned long elapsed = testMillis() - start;
+    
+    return runner.assertFalse(motor.isMoving()) &&
+           runner.assertNear(target, motor.getCurrentAngle(), 0.5f / STEPS_PER_DEGREE) &&
+           runner.assertTrue(elapsed >= 170 && elapsed < 230);
+}
+
 bool TestStepperMotor::testSetSpeed() {
     StepperMotor motor(99, 98, 97);
     motor.init();
@@ -151,6 +222,183 @@ bool TestStepperMotor::testSetSpeed() {
     return true;
 }
 
+#ifndef ARDUINO
+bool TestStepperMotor::testDirWrittenOnChange() {
+    MockPinIO::reset();
+    MockPinIO::setTime(0);
+    
+    StepperMotor motor(99, 98, 97);
+    motor.init();
+    motor.enable();
+    motor.setSpeed(1000.0f);
+    motor.setAcceleration(0.0f);
+    
+    TestRunner runner(false);
+    
+    // 10 steps forward, then 10 back: DIR changes only twice after init
+    float angles[] = {10.0f / STEPS_PER_DEGREE, 0.0f};
+    for (int m = 0; m < 2; m++) {
+        motor.moveToAngle(angles[m]);
+        for (int i = 0; i < 1000 && motor.isMoving(); i++) {
+            motor.update();
+            MockPinIO::advance(100);
+        }
+    }
+    motor.update();  // Lower the last pulse
+    
+    bool ok = runner.assertEqual(20, (int)MockPinIO::risingEdges(99)) &&
+              runner.assertEqual(3, (int)MockPinIO::writeCount(98)) &&
+              runner.assertFalse(MockPinIO::level(99));
+    
+    MockPinIO::useRealTime();
+    return ok;
+}
+
+bool TestStepperMotor::testStepPulseNonBlocking() {
+    MockPinIO::reset();
+    MockPinIO::setTime(100000);
+    
+    StepperMotor motor(99, 98, 97);
+    motor.init();
+    motor.enable();
+    motor.setAcceleration(0.0f);
+    motor.moveToAngle(10.0f / STEPS_PER_DEGREE);
+    
+    TestRunner runner(false);
+    
+    // The pulse is raised and update() returns without waiting
+    motor.update();
+    bool ok = runner.assertTrue(MockPinIO::level(99));
+    
+    // Still within the pulse width: stays high
+    motor.update();
+    ok = ok && runner.assertTrue(MockPinIO::level(99));
+    
+    // Pulse width elapsed: lowered by the next call
+    MockPinIO::advance(STEP_PULSE_WIDTH_US);
+    motor.update();
+    ok = ok && runner.assertFalse(MockPinIO::level(99)) &&
+         runner.assertEqual(1, (int)MockPinIO::risingEdges(99));
+    
+    MockPinIO::useRealTime();
+    return ok;
+}
+
+// Production timing on the mock clock: the step timer fires every
+// STEP_TICK_US and the motion loop calls update() every loop period.
+// Returns the time until the motor stopped (or maxUs).
+static uint32_t runAtProductionRate(StepperMotor& motor, uint32_t maxUs) {
+    const uint32_t loopUs = 1000000UL / MOTION_CONTROL_FREQUENCY;
+    uint32_t start = MockPinIO::micros();
+    uint32_t elapsed = 0;
+    while (motor.isMoving() && elapsed < maxUs) {
+        if (elapsed % loopUs < STEP_TICK_US) {
+            motor.update();
+        }
+        StepTicker::tick();
+        MockPinIO::advance(STEP_TICK_US);
+        elapsed = MockPinIO::micros() - start;
+    }
+    return elapsed;
+}
+
+bool TestStepperMotor::testTickerReachesSpeed() {
+    MockPinIO::reset();
+    MockPinIO::setTime(0);
+    
+    StepperMotor motor(99, 98, 97);
+    motor.init();
+    motor.enable();
+    motor.setSpeed(STEPPER_MAX_SPEED);
+    motor.setAcceleration(0.0f);
+    StepTicker::attach(motor);
+    
+    TestRunner runner(false);
+    
+    // 1000 steps at 3200 steps/s: 312.5 ms, although the motion loop only
+    // runs every 10 ms and the ticks do not divide the step interval
+    motor.moveToAngle(1000.0f / STEPS_PER_DEGREE);
+    float expected = 1000.0f / STEPPER_MAX_SPEED * 1000000.0f;
+    uint32_t elapsed = runAtProductionRate(motor, 2000000);
+    
+    bool ok = runner.assertFalse(motor.isMoving()) &&
+              runner.assertEqual(1000, (int)motor.getStepsIssued()) &&
+              runner.assertEqual(expected, (float)elapsed, 0.01f * expected);
+    
+    StepTicker::detach(motor);
+    MockPinIO::useRealTime();
+    return ok;
+}
+
+bool TestStepperMotor::testTickerRamp() {
+    MockPinIO::reset();
+    MockPinIO::setTime(0);
+    
+    StepperMotor motor(99, 98, 97);
+    motor.init();
+    motor.enable();
+    motor.setSpeed(STEPPER_MAX_SPEED);
+    motor.setAcceleration(STEPPER_ACCELERATION);
+    StepTicker::attach(motor);
+    
+    TestRunner runner(false);
+    
+    // 1500 steps with the production ramp: a triangle peaking just below
+    // full speed, 2*sqrt(1500/a) = 968 ms. Stepped from the motion loop
+    // alone this would take 15 s.
+    long steps = 1500;
+    motor.moveToAngle(steps / STEPS_PER_DEGREE);
+    float expected = 2.0f * sqrtf(steps / STEPPER_ACCELERATION) * 1000000.0f;
+    uint32_t elapsed = runAtProductionRate(motor, 3000000);
+    
+    bool ok = runner.assertFalse(motor.isMoving()) &&
+              runner.assertEqual((int)steps, (int)motor.getStepsIssued()) &&
+              runner.assertEqual(expected, (float)elapsed, 0.05f * expected);
+    
+    StepTicker::detach(motor);
+    MockPinIO::useRealTime();
+    return ok;
+}
+
+bool TestStepperMotor::testTickerFollowsPVT() {
+    MockPinIO::reset();
+    MockPinIO::setTime(0);
+    
+    StepperMotor motor(99, 98, 97);
+    motor.init();
+    motor.enable();
+    motor.setSpeed(STEPPER_MAX_SPEED);
+    StepTicker::attach(motor);
+    
+    TestRunner runner(false);
+    
+    // The motion loop hands over one PVT point per period, as with
+    // MOTION_USE_PVT: 1 s at 360 deg/s, the motor's full speed
+    const uint32_t loopUs = 1000000UL / MOTION_CONTROL_FREQUENCY;
+    const float velocity = STEPPER_MAX_SPEED / STEPS_PER_DEGREE;
+    float angle = 0.0f;
+    for (uint32_t t = 0; t < 1000000; t += STEP_TICK_US) {
+        if (t % loopUs == 0) {
+            angle += velocity * loopUs / 1000000.0f;
+            motor.moveToPVT(angle, velocity, loopUs / 1000000.0f);
+            motor.update();
+        }
+        StepTicker::tick();
+        MockPinIO::advance(STEP_TICK_US);
+    }
+    
+    // Every step commanded so far has been issued, less at most one period
+    int issued = (int)motor.getStepsIssued();
+    int commanded = (int)lroundf(STEPPER_MAX_SPEED);
+    bool ok = runner.assertTrue(issued <= commanded) &&
+              runner.assertTrue(issued >= commanded - (int)(STEPPER_MAX_SPEED / MOTION_CONTROL_FREQUENCY) - 1);
+    
+    StepTicker::detach(motor);
+    MockPinIO::useRealTime();
+    return ok;
+}
+#endif
+
 void TestStepperMotor::runAllTests(TestRunner& runner) {
     runner.printHeader("STEPPER MOTOR");
     
@@ -161,5 +409,15 @@ void TestStepperMotor::runAllTests(TestRunner& runner) {
     runner.runTest("Move to Angle", testMoveToAngle);
     runner.runTest("Get Current Angle", testGetCurrentAngle);
     runner.runTest("Is Moving", testIsMoving);
+    runner.runTest("Move to PVT", testMoveToPVT);
+    runner.runTest("PVT Crosses 0°", testPVTCrossesZero);
+    runner.runTest("Acceleration Ramp", testAccelerationRamp);
     runner.runTest("Set Speed", testSetSpeed);
+#ifndef ARDUINO
+    runner.runTest("DIR Written On Change", testDirWrittenOnChange);
+    runner.runTest("Non-blocking Step Pulse", testStepPulseNonBlocking);
+    runner.runTest("Step Timer: Full Speed", testTickerReachesSpeed);
+    runner.runTest("Step Timer: Ramp", testTickerRamp);
+    runner.runTest("Step Timer: PVT", testTickerFollowsPVT);
+#endif
 }
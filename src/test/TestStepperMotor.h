@@ -28,9 +28,24 @@ private:
     static bool testMoveToAngle();
     static bool testGetCurrentAngle();
     static bool testIsMoving();
+    static bool testMoveToPVT();
+    static bool testPVTCrossesZero();
+    static bool testAccelerationRamp();
     
     // Speed tests
     static bool testSetSpeed();
+    
+#ifndef ARDUINO
+    // Pin I/O tests (host only, against MockPinIO)
+    static bool testDirWrittenOnChange();
+    static bool testStepPulseNonBlocking();
+    
+    // Step timer tests (host only): the production motion loop and step
+    // timer rates, on the mock clock
+    static bool testTickerReachesSpeed();
+    static bool testTickerRamp();
+    static bool testTickerFollowsPVT();
+#endif
 };
 
 #endif // TEST_STEPPER_MOTOR_H
@@ -0,0 +1,221 @@
+#include "TestTelemetry.h"
+
+void TestTelemetry::runAllTests(TestRunner& runner) {
+    runner.printHeader("TELEMETRY");
+    
+    runner.runTest("STATUS_DELTA round trip", testDeltaRoundTrip);
+    runner.runTest("STATUS_DELTA rejects bad length", testDeltaRejectsBadLength);
+    runner.runTest("Sends only changed fields", testSendsOnlyChanges);
+    runner.runTest("Deadband drift accumulates", testDeadbandAccumulates);
+    runner.runTest("Client interval and heartbeat", testIntervalAndHeartbeat);
+    runner.runTest("Slow client coalesced", testSlowClientCoalesced);
+    runner.runTest("Requested interval clamped", testIntervalClamped);
+}
+
+// Status of an arm at rest at (x, 100)
+static StatusFrame restingAt(float x) {
+    StatusFrame status;
+    status.position = Point2D(x, 100.0f);
+    status.angles = JointAngles(30.0f, 60.0f);
+    status.isHomed = true;
+    status.credits = 32;
+    status.pathSpace = 2047;
+    return status;
+}
+
+// Poll, and record the send like the web server does
+static TelemetryChannel::Decision pollAndSend(TelemetryChannel& channel,
+                                              const StatusFrame& status, uint32_t nowMs,
+                                              uint16_t& mask, bool backlogged = false) {
+    TelemetryChannel::Decision decision = channel.poll(status, nowMs, backlogged, mask);
+    if (decision != TelemetryChannel::SEND_NONE) {
+        channel.sent(status, mask, nowMs);
+    }
+    return decision;
+}
+
+bool TestTelemetry::testDeltaRoundTrip() {
+    TestRunner runner(false);
+    
+    StatusFrame before = restingAt(10.0f);
+    StatusFrame after = before;
+    after.position.x = 12.5f;
+    after.credits = 5;
+    after.isMoving = true;
+    
+    uint16_t mask = BinaryProtocol::FIELD_X | BinaryProtocol::FIELD_CREDITS |
+                    BinaryProtocol::FIELD_FLAGS;
+    uint8_t frame[BinaryProtocol::MAX_FRAME_SIZE];
+    size_t len = BinaryProtocol::encodeStatusDelta(after, mask, frame, sizeof(frame));
+    
+    // Header, mask, float x, flags byte, uint16 credits
+    if (!runner.assertEqual((int)(BinaryProtocol::HEADER_SIZE + 2 + 4 + 1 + 2), (int)len)) {
+        return false;
+    }
+    
+    StatusFrame decoded = before;
+    uint16_t decodedMask = 0;
+    BinaryProtocol::Result result =
+        BinaryProtocol::decodeStatusDelta(frame, len, decoded, decodedMask);
+    
+    return runner.assertEqual((int)BinaryProtocol::OK, (int)result) &&
+           runner.assertEqual((int)mask, (int)decodedMask) &&
+           runner.assertEqual(12.5f, decoded.position.x, 0.0001f) &&
+           runner.assertEqual(100.0f, decoded.position.y, 0.0001f) &&
+           runner.assertEqual(5, (int)decoded.credits) &&
+           runner.assertTrue(decoded.isMoving) &&
+           runner.assertTrue(decoded.isHomed) &&
+           runner.assertEqual(2047, (int)decoded.pathSpace);
+}
+
+bool TestTelemetry::testDeltaRejectsBadLength() {
+    TestRunner runner(false);
+    
+    uint8_t frame[BinaryProtocol::MAX_FRAME_SIZE];
+    StatusFrame status = restingAt(0.0f);
+    size_t len = BinaryProtocol::encodeStatusDelta(status, BinaryProtocol::FIELD_Y,
+                                                   frame, sizeof(frame));
+    
+    // Claim a second field the payload does not carry
+    frame[4] |= BinaryProtocol::FIELD_X;
+    uint16_t mask;
+    BinaryProtocol::Result result = BinaryProtocol::decodeStatusDelta(frame, len, status, mask);
+    return runner.assertEqual((int)BinaryProtocol::ERROR_BAD_LENGTH, (int)result);
+}
+
+bool TestTelemetry::testSendsOnlyChanges() {
+    TestRunner runner(false);
+    
+    TelemetryChannel channel;
+    StatusFrame status = restingAt(10.0f);
+    uint16_t mask;
+    uint32_t t = 1000;
+    
+    // A new client gets everything once
+    if (!runner.assertEqual((int)TelemetryChannel::SEND_FULL,
+                            (int)pollAndSend(channel, status, t, mask))) return false;
+    
+    // Idle arm: nothing more
+    t += TELEMETRY_DEFAULT_INTERVAL_MS;
+    if (!runner.assertEqual((int)TelemetryChannel::SEND_NONE,
+                            (int)pollAndSend(channel, status, t, mask))) return false;
+    
+    // One field changes: a delta with just that field
+    status.credits = 31;
+    t += TELEMETRY_DEFAULT_INTERVAL_MS;
+    return runner.assertEqual((int)TelemetryChannel::SEND_DELTA,
+                              (int)pollAndSend(channel, status, t, mask)) &&
+           runner.assertEqual((int)BinaryProtocol::FIELD_CREDITS, (int)mask);
+}
+
+bool TestTelemetry::testDeadbandAccumulates() {
+    TestRunner runner(false);
+    
+    TelemetryChannel channel;
+    StatusFrame status = restingAt(10.0f);
+    uint16_t mask;
+    uint32_t t = 0;
+    pollAndSend(channel, status, t, mask);
+    
+    // Steps below the deadband are not sent on their own...
+    float step = TELEMETRY_POSITION_DEADBAND * 0.4f;
+    status.position.x += step;
+    t += TELEMETRY_DEFAULT_INTERVAL_MS;
+    if (!runner.assertEqual((int)TelemetryChannel::SEND_NONE,
+                            (int)pollAndSend(channel, status, t, mask))) return false;
+    
+    // ...but are compared with the last value sent, so they add up
+    status.position.x += step;
+    status.position.x += step;
+    t += TELEMETRY_DEFAULT_INTERVAL_MS;
+    return runner.assertEqual((int)TelemetryChannel::SEND_DELTA,
+                              (int)pollAndSend(channel, status, t, mask)) &&
+           runner.assertEqual((int)BinaryProtocol::FIELD_X, (int)mask);
+}
+
+bool TestTelemetry::testIntervalAndHeartbeat() {
+    TestRunner runner(false);
+    
+    TelemetryChannel channel;
+    channel.setInterval(250);
+    StatusFrame status = restingAt(10.0f);
+    uint16_t mask;
+    uint32_t t = 0;
+    pollAndSend(channel, status, t, mask);
+    
+    // Changes within the client's interval wait
+    status.position.x = 20.0f;
+    if (!runner.assertEqual((int)TelemetryChannel::SEND_NONE,
+                            (int)pollAndSend(channel, status, t + 100, mask))) return false;
+    if (!runner.assertEqual((int)TelemetryChannel::SEND_DELTA,
+                            (int)pollAndSend(channel, status, t + 250, mask))) return false;
+    t += 250;
+    
+    // Idle, but a full status goes out every heartbeat
+    if (!runner.assertEqual((int)TelemetryChannel::SEND_NONE,
+                            (int)pollAndSend(channel, status, t + TELEMETRY_HEARTBEAT_MS - 1,
+                                             mask))) return false;
+    return runner.assertEqual((int)TelemetryChannel::SEND_FULL,
+                              (int)pollAndSend(channel, status, t + TELEMETRY_HEARTBEAT_MS,
+                                               mask)) &&
+           runner.assertEqual((int)BinaryProtocol::FIELD_ALL, (int)mask);
+}
+
+bool TestTelemetry::testSlowClientCoalesced() {
+    TestRunner runner(false);
+    
+    TelemetryChannel channel;
+    StatusFrame status = restingAt(10.0f);
+    uint16_t mask;
+    uint32_t t = 0;
+    pollAndSend(channel, status, t, mask);
+    
+    // Client still busy: nothing is queued behind its backlog and it
+    // is polled less often
+    status.position.x = 11.0f;
+    t += TELEMETRY_DEFAULT_INTERVAL_MS;
+    if (!runner.assertEqual((int)TelemetryChannel::SEND_NONE,
+                            (int)pollAndSend(channel, status, t, mask, true))) return false;
+    if (!runner.assertEqual(TELEMETRY_DEFAULT_INTERVAL_MS * 2,
+                            (int)channel.getCurrentInterval())) return false;
+    
+    // More changes while waiting
+    status.credits = 20;
+    t += TELEMETRY_DEFAULT_INTERVAL_MS;
+    if (!runner.assertEqual((int)TelemetryChannel::SEND_NONE,
+                            (int)pollAndSend(channel, status, t, mask))) return false;
+    
+    // Caught up: one delta carries both changes, then the rate recovers
+    t += TELEMETRY_DEFAULT_INTERVAL_MS;
+    if (!runner.assertEqual((int)TelemetryChannel::SEND_DELTA,
+                            (int)pollAndSend(channel, status, t, mask))) return false;
+    if (!runner.assertEqual((int)(BinaryProtocol::FIELD_X | BinaryProtocol::FIELD_CREDITS),
+                            (int)mask)) return false;
+    if (!runner.assertTrue(channel.getCurrentInterval() < TELEMETRY_DEFAULT_INTERVAL_MS * 2)) {
+        return false;
+    }
+    
+    // Backoff never exceeds the slowest rate
+    for (int i = 0; i < 20; i++) {
+        t += TELEMETRY_MAX_INTERVAL_MS;
+        pollAndSend(channel, status, t, mask, true);
+    }
+    return runner.assertEqual(TELEMETRY_MAX_INTERVAL_MS, (int)channel.getCurrentInterval());
+}
+
+bool TestTelemetry::testIntervalClamped() {
+    TestRunner runner(false);
+    
+    TelemetryChannel channel;
+    channel.setInterval(1);
+    if (!runner.assertEqual(TELEMETRY_MIN_INTERVAL_MS, (int)channel.getInterval())) return false;
+    channel.setInterval(60000);
+    if (!runner.assertEqual(TELEMETRY_MAX_INTERVAL_MS, (int)channel.getInterval())) return false;
+    channel.setInterval(0);
+    if (!runner.assertEqual(TELEMETRY_DEFAULT_INTERVAL_MS, (int)channel.getInterval())) return false;
+    
+    // A reconnecting client starts from the default again
+    channel.setInterval(500);
+    channel.reset();
+    return runner.assertEqual(TELEMETRY_DEFAULT_INTERVAL_MS, (int)channel.getInterval());
+}
@@ -0,0 +1,26 @@
+#ifndef TEST_TELEMETRY_H
+#define TEST_TELEMETRY_H
+
+#include "TestRunner.h"
+#include "../web/Telemetry.h"
+
+/**
+ * @file TestTelemetry.h
+ * @brief Unit tests for change-driven status telemetry and STATUS_DELTA frames
+ */
+
+class TestTelemetry {
+public:
+    static void runAllTests(TestRunner& runner);
+    
+private:
+    static bool testDeltaRoundTrip();
+    static bool testDeltaRejectsBadLength();
+    static bool testSendsOnlyChanges();
+    static bool testDeadbandAccumulates();
+    static bool testIntervalAndHeartbeat();
+    static bool testSlowClientCoalesced();
+    static bool testIntervalClamped();
+};
+
+#endif // TEST_TELEMETRY_H
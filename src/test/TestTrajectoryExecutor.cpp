@@ -0,0 +1,139 @@
+#include "TestTrajectoryExecutor.h"
+
+// Sample at time t (seconds) with both joints at 'angle' and x = angle
+static TrajectorySample makeSample(float t, float angle) {
+    return TrajectorySample(t, JointAngles(angle, angle), Point2D(angle, 100.0f));
+}
+
+void TestTrajectoryExecutor::runAllTests(TestRunner& runner) {
+    runner.printHeader("TRAJECTORY EXECUTOR");
+    
+    runner.runTest("Executor: First sample immediate", testFirstSample_Immediate);
+    runner.runTest("Executor: Midpoint interpolation", testInterpolation_Midpoint);
+    runner.runTest("Executor: Jitter follows clock", testJitter_FollowsClock);
+    runner.runTest("Executor: Sparse samples", testSparseSamples);
+    runner.runTest("Executor: Underrun re-anchors", testUnderrun_Reanchors);
+    runner.runTest("Executor: New move starts now", testNewMove_StartsNow);
+}
+
+bool TestTrajectoryExecutor::testFirstSample_Immediate() {
+    TrajectoryExecutor executor;
+    TestRunner runner(false);
+    JointAngles angles;
+    Point2D position;
+    
+    // Nothing to execute before the first sample
+    if (!runner.assertFalse(executor.sample(0, angles, position))) return false;
+    if (!runner.assertTrue(executor.needsSample(0))) return false;
+    
+    executor.push(makeSample(0.0f, 30.0f), 1000);
+    
+    return runner.assertTrue(executor.sample(1000, angles, position)) &&
+           runner.assertNear(30.0f, angles.theta1, 0.001f) &&
+           runner.assertNear(30.0f, position.x, 0.001f);
+}
+
+bool TestTrajectoryExecutor::testInterpolation_Midpoint() {
+    TrajectoryExecutor executor;
+    TestRunner runner(false);
+    JointAngles angles;
+    Point2D position;
+    
+    executor.push(makeSample(0.0f, 10.0f), 0);
+    executor.push(makeSample(0.01f, 20.0f), 0);  // 10 ms segment
+    
+    if (!runner.assertFalse(executor.needsSample(5000))) return false;
+    executor.sample(5000, angles, position);
+    
+    return runner.assertNear(15.0f, angles.theta1, 0.01f) &&
+           runner.assertNear(15.0f, angles.theta2, 0.01f) &&
+           runner.assertNear(15.0f, position.x, 0.01f) &&
+           runner.assertTrue(executor.needsSample(10000));
+}
+
+bool TestTrajectoryExecutor::testJitter_FollowsClock() {
+    TrajectoryExecutor executor;
+    TestRunner runner(false);
+    JointAngles angles;
+    Point2D position;
+    
+    // 1 degree every 10 ms, i.e. 100 degrees/s
+    const int numSamples = 20;
+    int next = 0;
+    
+    // Irregular loop times: the target must always be 0.1 deg per ms
+    uint32_t ticks[] = {0, 9000, 23000, 31000, 52000, 60000, 88000, 101000};
+    for (int i = 0; i < 8; i++) {
+        uint32_t now = ticks[i];
+        while (executor.needsSample(now) && next < numSamples) {
+            executor.push(makeSample(next * 0.01f, (float)next), now);
+            next++;
+        }
+        executor.sample(now, angles, position);
+        if (!runner.assertNear(now / 10000.0f, angles.theta1, 0.01f)) return false;
+    }
+    
+    return true;
+}
+
+bool TestTrajectoryExecutor::testSparseSamples() {
+    TrajectoryExecutor executor;
+    TestRunner runner(false);
+    JointAngles angles;
+    Point2D position;
+    
+    // Two samples 100 ms apart, sampled by a 10 ms loop
+    executor.push(makeSample(0.0f, 0.0f), 0);
+    executor.push(makeSample(0.1f, 50.0f), 0);
+    
+    for (uint32_t now = 0; now <= 100000; now += 10000) {
+        executor.sample(now, angles, position);
+        if (!runner.assertNear(now * 0.0005f, angles.theta1, 0.01f)) return false;
+    }
+    
+    return runner.assertFalse(executor.isActive());
+}
+
+bool TestTrajectoryExecutor::testUnderrun_Reanchors() {
+    TrajectoryExecutor executor;
+    TestRunner runner(false);
+    JointAngles angles;
+    Point2D position;
+    
+    executor.push(makeSample(0.0f, 0.0f), 0);
+    executor.push(makeSample(0.01f, 1.0f), 0);
+    
+    // Queue ran dry: hold at the last sample
+    executor.sample(30000, angles, position);
+    if (!runner.assertNear(1.0f, angles.theta1, 0.001f)) return false;
+    if (!runner.assertFalse(executor.isActive())) return false;
+    
+    // Late sample: continue from here over its own 10 ms, no jump
+    executor.push(makeSample(0.02f, 2.0f), 30000);
+    executor.sample(35000, angles, position);
+    
+    return runner.assertNear(1.5f, angles.theta1, 0.01f) &&
+           runner.assertTrue(executor.isActive()) &&
+           runner.assertEqual(1, (int)executor.getUnderruns());
+}
+
+bool TestTrajectoryExecutor::testNewMove_StartsNow() {
+    TrajectoryExecutor executor;
+    TestRunner runner(false);
+    JointAngles angles;
+    Point2D position;
+    
+    executor.push(makeSample(0.0f, 0.0f), 0);
+    executor.push(makeSample(0.5f, 10.0f), 0);
+    executor.sample(500000, angles, position);
+    
+    // A new move restarts its time at 0 from the current position
+    executor.push(makeSample(0.0f, 10.0f), 600000);
+    if (!runner.assertTrue(executor.needsSample(600000))) return false;
+    executor.push(makeSample(0.1f, 20.0f), 600000);
+    executor.sample(650000, angles, position);
+    
+    // Running out at the end of a move is not an underrun
+    return runner.assertNear(15.0f, angles.theta1, 0.01f) &&
+           runner.assertEqual(0, (int)executor.getUnderruns());
+}
@@ -0,0 +1,31 @@
+#ifndef TEST_TRAJECTORY_EXECUTOR_H
+#define TEST_TRAJECTORY_EXECUTOR_H
+
+#include "TestRunner.h"
+#include "../core/TrajectoryExecutor.h"
+#include "../core/Types.h"
+
+/**
+ * @file TestTrajectoryExecutor.h
+ * @brief Unit tests for TrajectoryExecutor (clock-based sample execution)
+ */
+
+class TestTrajectoryExecutor {
+public:
+    static void runAllTests(TestRunner& runner);
+    
+private:
+    // Basic execution
+    static bool testFirstSample_Immediate();
+    static bool testInterpolation_Midpoint();
+    
+    // Timing robustness
+    static bool testJitter_FollowsClock();
+    static bool testSparseSamples();
+    static bool testUnderrun_Reanchors();
+    
+    // Move boundaries
+    static bool testNewMove_StartsNow();
+};
+
+#endif // TEST_TRAJECTORY_EXECUTOR_H
@@ -15,6 +15,8 @@ void TestTypes::runAllTests(TestRunner& runner) {
     // RobotState tests
     runner.runTest("RobotState: Default constructor", testRobotState_DefaultConstructor);
     runner.runTest("RobotState: Initialization", testRobotState_Initialization);
+    runner.runTest("RobotState: Seqlock snapshot", testRobotState_Snapshot);
+    runner.runTest("Seqlock: Version counts writes", testSeqlock_Version);
     
     // Command tests
     runner.runTest("Command: Default constructor", testCommand_DefaultConstructor);
@@ -93,6 +95,40 @@ bool TestTypes::testRobotState_Initialization() {
            runner.assertTrue(state.isHomed);
 }
 
+bool TestTypes::testRobotState_Snapshot() {
+    Seqlock<RobotState> snapshot;
+    RobotState state;
+    state.currentPosition = Point2D(150.0f, 200.0f);
+    state.currentAngles = JointAngles(45.0f, 30.0f);
+    state.isHomed = true;
+    state.firstStepLatency.record(1200);
+    snapshot.write(state);
+    
+    // Later changes to the writer's copy are not seen until published
+    state.currentPosition = Point2D(0.0f, 0.0f);
+    RobotState copy = snapshot.read();
+    
+    TestRunner runner(false);
+    
+    return runner.assertNear(150.0f, copy.currentPosition.x, 0.01f) &&
+           runner.assertNear(200.0f, copy.currentPosition.y, 0.01f) &&
+           runner.assertNear(30.0f, copy.currentAngles.theta2, 0.01f) &&
+           runner.assertTrue(copy.isHomed) &&
+           runner.assertEqual(1200, (int)copy.firstStepLatency.maxUs);
+}
+
+bool TestTypes::testSeqlock_Version() {
+    Seqlock<int> value;
+    TestRunner runner(false);
+    
+    if (!runner.assertEqual(0, (int)value.version())) return false;
+    value.write(7);
+    value.write(8);
+    
+    return runner.assertEqual(2, (int)value.version()) &&
+           runner.assertEqual(8, value.read());
+}
+
 bool TestTypes::testCommand_DefaultConstructor() {
     Command cmd;
     TestRunner runner(false);
@@ -3,6 +3,7 @@
 
 #include "TestRunner.h"
 #include "../core/Types.h"
+#include "../core/Seqlock.h"
 
 /**
  * @file TestTypes.h
@@ -26,6 +27,8 @@ private:
     // RobotState tests
     static bool testRobotState_DefaultConstructor();
     static bool testRobotState_Initialization();
+    static bool testRobotState_Snapshot();
+    static bool testSeqlock_Version();
     
     // Command tests
     static bool testCommand_DefaultConstructor();
@@ -19,6 +19,9 @@ void TestVisual::runAllTests(TestRunner& runner) {
     delay(1000);
     
     testFullPathVisual();
+    delay(1000);
+    
+    testDispatchBenchmark();
     
     Serial.println("\n✅ Visual tests completed. Review output above.\n");
 }
@@ -328,3 +331,58 @@ void TestVisual::testFullPathVisual() {
     printSeparator();
     Serial.println("✅ Full path test completed\n");
 }
+
+// Time 'iterations' control ticks (update + isMoving) through a controller
+template <class MotorA, class MotorB>
+static unsigned long timeControllerTicks(MotionController<MotorA, MotorB>& controller,
+                                         int iterations) {
+    unsigned long start = micros();
+    int moving = 0;
+    for (int i = 0; i < iterations; i++) {
+        controller.update();
+        moving += controller.isMoving() ? 1 : 0;
+    }
+    unsigned long elapsed = micros() - start;
+    
+    // Use the result so the loop is not optimized away
+    if (moving < 0) {
+        Serial.println(moving);
+    }
+    return elapsed;
+}
+
+void TestVisual::testDispatchBenchmark() {
+    Serial.println("\n═══════════════════════════════════════════════════════════");
+    Serial.println("TEST 5: MOTOR DISPATCH BENCHMARK");
+    Serial.println("═══════════════════════════════════════════════════════════");
+    
+    // Dummy pins (not connected); motors idle, so this measures call overhead
+    StepperMotor motorA(99, 98, 97);
+    StepperMotor motorB(96, 95, 94);
+    motorA.init();
+    motorB.init();
+    motorA.enable();
+    motorB.enable();
+    
+    const int iterations = 100000;
+    
+    MotionController<StepperMotor, StepperMotor> direct(motorA, motorB);
+    
+    // The motors are read back through volatile pointers, so the compiler
+    // cannot see their type and every call goes through the vtable (with
+    // the StepperMotors in view, GCC could devirtualize the IMotor calls)
+    IMotor* volatile opaqueA = &motorA;
+    IMotor* volatile opaqueB = &motorB;
+    MotionController<IMotor, IMotor> virtualDispatch(*opaqueA, *opaqueB);
+    
+    unsigned long directUs = timeControllerTicks(direct, iterations);
+    unsigned long virtualUs = timeControllerTicks(virtualDispatch, iterations);
+    
+    Serial.printf("\n%d ticks (update + isMoving on both joints):\n", iterations);
+    printSeparator();
+    Serial.printf("Direct  (MotionController<StepperMotor, StepperMotor>): %lu us (%.3f us/tick)\n",
+                  directUs, (float)directUs / iterations);
+    Serial.printf("Virtual (MotionController<IMotor, IMotor>):             %lu us (%.3f us/tick)\n",
+                  virtualUs, (float)virtualUs / iterations);
+    printSeparator();
+}
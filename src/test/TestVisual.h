@@ -2,9 +2,12 @@
 #define TEST_VISUAL_H
 
 #include "TestRunner.h"
+#include <Arduino.h>
 #include "../core/Kinematics.h"
 #include "../core/Planner.h"
 #include "../core/Types.h"
+#include "../hardware/StepperMotor.h"
+#include "../hardware/MotionController.h"
 #include <queue>
 
 /**
@@ -24,6 +27,7 @@ public:
     static void testAngleToPositionVisual();
     static void testPositionToAngleVisual();
     static void testFullPathVisual();
+    static void testDispatchBenchmark();
     
 private:
     static void printPoint(const Point2D& p, const char* label = "");
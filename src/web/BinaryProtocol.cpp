@@ -0,0 +1,445 @@
+#include "BinaryProtocol.h"
+#include <string.h>
+
+// Little-endian field access, independent of the host byte order
+
+static void putU16(uint8_t* p, uint16_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void putU32(uint8_t* p, uint32_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static void putF32(uint8_t* p, float v) {
+    uint32_t bits;
+    memcpy(&bits, &v, sizeof(bits));
+    putU32(p, bits);
+}
+
+static uint16_t getU16(const uint8_t* p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t getU32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) |
+           ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static float getF32(const uint8_t* p) {
+    uint32_t bits = getU32(p);
+    float v;
+    memcpy(&v, &bits, sizeof(v));
+    return v;
+}
+
+void BinaryProtocol::writeHeader(uint8_t* buffer, uint8_t type, uint16_t length) {
+    buffer[0] = BINARY_PROTOCOL_VERSION;
+    buffer[1] = type;
+    putU16(buffer + 2, length);
+}
+
+BinaryProtocol::Result BinaryProtocol::peekHeader(const uint8_t* data, size_t len,
+                                                  FrameHeader& header) {
+    if (len < HEADER_SIZE) {
+        return ERROR_TRUNCATED;
+    }
+
+    header.version = data[0];
+    header.type = data[1];
+    header.length = getU16(data + 2);
+
+    if (header.version != BINARY_PROTOCOL_VERSION) {
+        return ERROR_BAD_VERSION;
+    }
+    return OK;
+}
+
+BinaryProtocol::Result BinaryProtocol::readHeader(const uint8_t* data, size_t len,
+                                                  FrameHeader& header) {
+    Result result = peekHeader(data, len, header);
+    if (result != OK) {
+        return result;
+    }
+    if (len < HEADER_SIZE + header.length) {
+        return ERROR_TRUNCATED;
+    }
+    return OK;
+}
+
+BinaryProtocol::Result BinaryProtocol::decodeCommand(const uint8_t* data, size_t len,
+                                                     Command& cmd) {
+    FrameHeader header;
+    Result result = readHeader(data, len, header);
+    if (result != OK) {
+        return result;
+    }
+
+    const uint8_t* payload = data + HEADER_SIZE;
+
+    switch (header.type) {
+        case MSG_MOVE_TO:
+            if (header.length != MOVE_TO_PAYLOAD) {
+                return ERROR_BAD_LENGTH;
+            }
+            cmd = Command(Command::MOVE_TO,
+                          Point2D(getF32(payload), getF32(payload + 4)),
+                          getF32(payload + 8));
+            return OK;
+
+        case MSG_HOME:
+        case MSG_STOP:
+            if (header.length != 0) {
+                return ERROR_BAD_LENGTH;
+            }
+            cmd = Command(header.type == MSG_HOME ? Command::HOME : Command::STOP,
+                          Point2D(0, 0));
+            return OK;
+
+        default:
+            return ERROR_UNKNOWN_TYPE;
+    }
+}
+
+size_t BinaryProtocol::encodeCommand(const Command& cmd, uint8_t* buffer, size_t capacity) {
+    switch (cmd.type) {
+        case Command::MOVE_TO:
+            if (capacity < HEADER_SIZE + MOVE_TO_PAYLOAD) {
+                return 0;
+            }
+            writeHeader(buffer, MSG_MOVE_TO, MOVE_TO_PAYLOAD);
+            putF32(buffer + 4, cmd.target.x);
+            putF32(buffer + 8, cmd.target.y);
+            putF32(buffer + 12, cmd.speed);
+            return HEADER_SIZE + MOVE_TO_PAYLOAD;
+
+        case Command::HOME:
+        case Command::STOP:
+            if (capacity < HEADER_SIZE) {
+                return 0;
+            }
+            writeHeader(buffer, cmd.type == Command::HOME ? MSG_HOME : MSG_STOP, 0);
+            return HEADER_SIZE;
+
+        default:
+            return 0;
+    }
+}
+
+BinaryProtocol::Result BinaryProtocol::decodeSetRate(const uint8_t* data, size_t len,
+                                                     uint16_t& intervalMs) {
+    FrameHeader header;
+    Result result = readHeader(data, len, header);
+    if (result != OK) {
+        return result;
+    }
+    if (header.type != MSG_SET_RATE) {
+        return ERROR_UNKNOWN_TYPE;
+    }
+    if (header.length != SET_RATE_PAYLOAD) {
+        return ERROR_BAD_LENGTH;
+    }
+    intervalMs = getU16(data + HEADER_SIZE);
+    return OK;
+}
+
+size_t BinaryProtocol::encodeSetRate(uint16_t intervalMs, uint8_t* buffer, size_t capacity) {
+    if (capacity < HEADER_SIZE + SET_RATE_PAYLOAD) {
+        return 0;
+    }
+    writeHeader(buffer, MSG_SET_RATE, SET_RATE_PAYLOAD);
+    putU16(buffer + 4, intervalMs);
+    return HEADER_SIZE + SET_RATE_PAYLOAD;
+}
+
+size_t BinaryProtocol::encodeHello(uint8_t* buffer, size_t capacity) {
+    if (capacity < HEADER_SIZE) {
+        return 0;
+    }
+    writeHeader(buffer, MSG_HELLO, 0);
+    return HEADER_SIZE;
+}
+
+size_t BinaryProtocol::encodeError(Result code, uint8_t* buffer, size_t capacity) {
+    if (capacity < HEADER_SIZE + ERROR_PAYLOAD) {
+        return 0;
+    }
+    writeHeader(buffer, MSG_ERROR, ERROR_PAYLOAD);
+    buffer[4] = (uint8_t)code;
+    return HEADER_SIZE + ERROR_PAYLOAD;
+}
+
+static uint16_t clampU16(int value) {
+    if (value < 0) return 0;
+    if (value > 0xFFFF) return 0xFFFF;
+    return (uint16_t)value;
+}
+
+size_t BinaryProtocol::encodeCredits(MessageType type, int credits, int pathSpace,
+                                     uint8_t* buffer, size_t capacity) {
+    if (capacity < HEADER_SIZE + CREDITS_PAYLOAD) {
+        return 0;
+    }
+    writeHeader(buffer, (uint8_t)type, CREDITS_PAYLOAD);
+    putU16(buffer + 4, clampU16(credits));
+    putU16(buffer + 6, clampU16(pathSpace));
+    return HEADER_SIZE + CREDITS_PAYLOAD;
+}
+
+size_t BinaryProtocol::encodePathStart(float speed, uint16_t vertexCount, uint8_t* buffer,
+                                       size_t capacity) {
+    uint32_t length = 4 + (uint32_t)vertexCount * PATH_VERTEX_SIZE;
+    if (capacity < HEADER_SIZE + 4 || length > 0xFFFF) {
+        return 0;
+    }
+    writeHeader(buffer, MSG_PATH, (uint16_t)length);
+    putF32(buffer + 4, speed);
+    return HEADER_SIZE + 4;
+}
+
+size_t BinaryProtocol::encodeVertex(const Point2D& point, uint8_t* buffer, size_t capacity) {
+    if (capacity < PATH_VERTEX_SIZE) {
+        return 0;
+    }
+    putF32(buffer, point.x);
+    putF32(buffer + 4, point.y);
+    return PATH_VERTEX_SIZE;
+}
+
+size_t BinaryProtocol::encodeStatus(const StatusFrame& status, uint8_t* buffer,
+                                    size_t capacity) {
+    if (capacity < HEADER_SIZE + STATUS_PAYLOAD) {
+        return 0;
+    }
+
+    writeHeader(buffer, MSG_STATUS, STATUS_PAYLOAD);
+    uint8_t* p = buffer + HEADER_SIZE;
+    putF32(p, status.position.x);
+    putF32(p + 4, status.position.y);
+    putF32(p + 8, status.angles.theta1);
+    putF32(p + 12, status.angles.theta2);
+    p[16] = (status.isMoving ? 0x01 : 0) | (status.isHomed ? 0x02 : 0);
+    putU16(p + 17, status.credits);
+    putU32(p + 19, status.ttfsUs);
+    putU32(p + 23, status.ttfsMaxUs);
+    putU16(p + 27, status.pathSpace);
+    return HEADER_SIZE + STATUS_PAYLOAD;
+}
+
+BinaryProtocol::Result BinaryProtocol::decodeStatus(const uint8_t* data, size_t len,
+                                                    StatusFrame& status) {
+    FrameHeader header;
+    Result result = readHeader(data, len, header);
+    if (result != OK) {
+        return result;
+    }
+    if (header.type != MSG_STATUS) {
+        return ERROR_UNKNOWN_TYPE;
+    }
+    if (header.length != STATUS_PAYLOAD) {
+        return ERROR_BAD_LENGTH;
+    }
+
+    const uint8_t* p = data + HEADER_SIZE;
+    status.position = Point2D(getF32(p), getF32(p + 4));
+    status.angles = JointAngles(getF32(p + 8), getF32(p + 12));
+    status.isMoving = (p[16] & 0x01) != 0;
+    status.isHomed = (p[16] & 0x02) != 0;
+    status.credits = getU16(p + 17);
+    status.ttfsUs = getU32(p + 19);
+    status.ttfsMaxUs = getU32(p + 23);
+    status.pathSpace = getU16(p + 27);
+    return OK;
+}
+
+// Size of each STATUS field in a STATUS_DELTA payload, by mask bit
+static const uint8_t statusFieldSize[] = {4, 4, 4, 4, 1, 2, 4, 4, 2};
+
+// STATUS_DELTA payload length for a field mask
+static size_t deltaLength(uint16_t mask) {
+    size_t length = 2;
+    for (int i = 0; i < (int)sizeof(statusFieldSize); i++) {
+        if (mask & (1 << i)) {
+            length += statusFieldSize[i];
+        }
+    }
+    return length;
+}
+
+size_t BinaryProtocol::encodeStatusDelta(const StatusFrame& status, uint16_t mask,
+                                         uint8_t* buffer, size_t capacity) {
+    mask &= FIELD_ALL;
+
+    size_t length = deltaLength(mask);
+    if (capacity < HEADER_SIZE + length) {
+        return 0;
+    }
+
+    writeHeader(buffer, MSG_STATUS_DELTA, (uint16_t)length);
+    uint8_t* p = buffer + HEADER_SIZE;
+    putU16(p, mask);
+    p += 2;
+    if (mask & FIELD_X) { putF32(p, status.position.x); p += 4; }
+    if (mask & FIELD_Y) { putF32(p, status.position.y); p += 4; }
+    if (mask & FIELD_THETA1) { putF32(p, status.angles.theta1); p += 4; }
+    if (mask & FIELD_THETA2) { putF32(p, status.angles.theta2); p += 4; }
+    if (mask & FIELD_FLAGS) {
+        *p++ = (status.isMoving ? 0x01 : 0) | (status.isHomed ? 0x02 : 0);
+    }
+    if (mask & FIELD_CREDITS) { putU16(p, status.credits); p += 2; }
+    if (mask & FIELD_TTFS) { putU32(p, status.ttfsUs); p += 4; }
+    if (mask & FIELD_TTFS_MAX) { putU32(p, status.ttfsMaxUs); p += 4; }
+    if (mask & FIELD_PATH_SPACE) { putU16(p, status.pathSpace); p += 2; }
+    return HEADER_SIZE + length;
+}
+
+BinaryProtocol::Result BinaryProtocol::decodeStatusDelta(const uint8_t* data, size_t len,
+                                                         StatusFrame& status, uint16_t& mask) {
+    FrameHeader header;
+    Result result = readHeader(data, len, header);
+    if (result != OK) {
+        return result;
+    }
+    if (header.type != MSG_STATUS_DELTA) {
+        return ERROR_UNKNOWN_TYPE;
+    }
+    if (header.length < 2) {
+        return ERROR_BAD_LENGTH;
+    }
+
+    const uint8_t* p = data + HEADER_SIZE;
+    uint16_t fields = getU16(p);
+    if ((fields & ~FIELD_ALL) != 0 || header.length != deltaLength(fields)) {
+        return ERROR_BAD_LENGTH;
+    }
+
+    p += 2;
+    if (fields & FIELD_X) { status.position.x = getF32(p); p += 4; }
+    if (fields & FIELD_Y) { status.position.y = getF32(p); p += 4; }
+    if (fields & FIELD_THETA1) { status.angles.theta1 = getF32(p); p += 4; }
+    if (fields & FIELD_THETA2) { status.angles.theta2 = getF32(p); p += 4; }
+    if (fields & FIELD_FLAGS) {
+        status.isMoving = (*p & 0x01) != 0;
+        status.isHomed = (*p & 0x02) != 0;
+        p++;
+    }
+    if (fields & FIELD_CREDITS) { status.credits = getU16(p); p += 2; }
+    if (fields & FIELD_TTFS) { status.ttfsUs = getU32(p); p += 4; }
+    if (fields & FIELD_TTFS_MAX) { status.ttfsMaxUs = getU32(p); p += 4; }
+    if (fields & FIELD_PATH_SPACE) { status.pathSpace = getU16(p); p += 2; }
+    mask = fields;
+    return OK;
+}
+
+// ============================================================================
+// PathStreamDecoder
+// ============================================================================
+
+PathStreamDecoder::PathStreamDecoder()
+    : buffer(nullptr), state(IDLE), pathId(0), expectedVertices(0),
+      writtenVertices(0), speed(0.0f), pendingLen(0) {
+}
+
+void PathStreamDecoder::begin(PathBuffer* pathBuffer, uint16_t id) {
+    buffer = pathBuffer;
+    pathId = id;
+    state = HEADER;
+    expectedVertices = 0;
+    writtenVertices = 0;
+    speed = 0.0f;
+    pendingLen = 0;
+}
+
+void PathStreamDecoder::abort() {
+    if (buffer && writtenVertices > 0) {
+        buffer->retract(writtenVertices);
+        writtenVertices = 0;
+    }
+    if (state != IDLE) {
+        state = FAILED;
+    }
+}
+
+BinaryProtocol::Result PathStreamDecoder::parseHeader() {
+    FrameHeader header;
+    BinaryProtocol::Result result = BinaryProtocol::peekHeader(pending, sizeof(pending), header);
+    if (result != BinaryProtocol::OK) {
+        return result;
+    }
+    if (header.type != BinaryProtocol::MSG_PATH) {
+        return BinaryProtocol::ERROR_UNKNOWN_TYPE;
+    }
+    if (header.length < 4 || (header.length - 4) % BinaryProtocol::PATH_VERTEX_SIZE != 0) {
+        return BinaryProtocol::ERROR_BAD_LENGTH;
+    }
+
+    expectedVertices = (header.length - 4) / BinaryProtocol::PATH_VERTEX_SIZE;
+    if (!buffer || buffer->available() < expectedVertices) {
+        return BinaryProtocol::ERROR_NO_ROOM;
+    }
+
+    speed = getF32(pending + BinaryProtocol::HEADER_SIZE);
+    return BinaryProtocol::OK;
+}
+
+BinaryProtocol::Result PathStreamDecoder::feed(const uint8_t* data, size_t len) {
+    while (len > 0) {
+        if (state == HEADER) {
+            size_t take = sizeof(pending) - pendingLen;
+            if (take > len) take = len;
+            memcpy(pending + pendingLen, data, take);
+            pendingLen += take;
+            data += take;
+            len -= take;
+
+            if (pendingLen < sizeof(pending)) {
+                return BinaryProtocol::OK;  // Header continues in the next piece
+            }
+
+            BinaryProtocol::Result result = parseHeader();
+            if (result != BinaryProtocol::OK) {
+                state = FAILED;
+                return result;
+            }
+            pendingLen = 0;
+            state = (expectedVertices > 0) ? VERTICES : COMPLETE;
+        } else if (state == VERTICES) {
+            // Whole vertices are decoded in place; only a split one is copied
+            const uint8_t* vertex = data;
+            size_t used = BinaryProtocol::PATH_VERTEX_SIZE;
+            if (pendingLen > 0 || len < BinaryProtocol::PATH_VERTEX_SIZE) {
+                size_t take = BinaryProtocol::PATH_VERTEX_SIZE - pendingLen;
+                if (take > len) take = len;
+                memcpy(pending + pendingLen, data, take);
+                pendingLen += take;
+                used = take;
+                if (pendingLen < BinaryProtocol::PATH_VERTEX_SIZE) {
+                    return BinaryProtocol::OK;
+                }
+                vertex = pending;
+                pendingLen = 0;
+            }
+            data += used;
+            len -= used;
+
+            // Room was checked against the header, so this cannot fail
+            // unless another producer shares the buffer
+            if (!buffer->push(Point2D(getF32(vertex), getF32(vertex + 4)), pathId)) {
+                state = FAILED;
+                return BinaryProtocol::ERROR_NO_ROOM;
+            }
+            if (++writtenVertices == expectedVertices) {
+                state = COMPLETE;
+            }
+        } else {
+            // Bytes beyond the length given in the header
+            state = FAILED;
+            return BinaryProtocol::ERROR_BAD_LENGTH;
+        }
+    }
+    return BinaryProtocol::OK;
+}
@@ -0,0 +1,296 @@
+#ifndef BINARY_PROTOCOL_H
+#define BINARY_PROTOCOL_H
+
+#include "../core/Types.h"
+#include "../core/PathBuffer.h"
+#include "../Config.h"
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @file BinaryProtocol.h
+ * @brief Fixed-layout binary WebSocket frames for commands and telemetry
+ *
+ * Every message starts with a 4-byte header followed by a payload whose
+ * size is fixed for each message type:
+ *
+ *   offset 0  uint8   version  (BINARY_PROTOCOL_VERSION)
+ *   offset 1  uint8   type     (MessageType)
+ *   offset 2  uint16  payload length in bytes
+ *   offset 4  payload
+ *
+ * All multi-byte fields are little-endian and floats are IEEE-754
+ * binary32, written byte by byte so the layout does not depend on the
+ * host. Encoding and decoding work on caller-provided buffers and never
+ * allocate.
+ *
+ * Negotiation: a client sends HELLO; the server answers HELLO if it
+ * speaks the same version (the client is then sent binary frames only),
+ * or ERROR_BAD_VERSION with its own version in the header.
+ *
+ * PATH is the one variable-size message: a speed followed by up to
+ * 8191 vertices. It is decoded incrementally by PathStreamDecoder as
+ * the WebSocket delivers it, straight into the shared PathBuffer.
+ *
+ * Telemetry: a client gets one full STATUS, then STATUS_DELTA frames
+ * holding only the fields that changed (see Telemetry.h). It can ask
+ * for a different status rate with SET_RATE.
+ */
+
+// Decoded frame header
+struct FrameHeader {
+    uint8_t version;
+    uint8_t type;
+    uint16_t length;  // Payload length
+
+    FrameHeader() : version(0), type(0), length(0) {}
+};
+
+// Telemetry carried by a STATUS frame
+struct StatusFrame {
+    Point2D position;      // mm
+    JointAngles angles;    // degrees
+    bool isMoving;
+    bool isHomed;
+    uint16_t credits;      // Free command queue slots
+    uint32_t ttfsUs;       // Last time-to-first-step
+    uint32_t ttfsMaxUs;    // Worst time-to-first-step
+    uint16_t pathSpace;    // Free path buffer vertices
+
+    StatusFrame() : isMoving(false), isHomed(false), credits(0), ttfsUs(0), ttfsMaxUs(0),
+                    pathSpace(0) {}
+};
+
+class BinaryProtocol {
+public:
+    enum MessageType {
+        // Either direction
+        MSG_HELLO = 0x01,      // No payload
+        MSG_ERROR = 0x02,      // uint8 error code
+
+        // Client -> server
+        MSG_MOVE_TO = 0x10,    // float x, float y, float speed (mm, mm/s)
+        MSG_HOME = 0x11,       // No payload
+        MSG_STOP = 0x12,       // No payload
+        MSG_PATH = 0x13,       // float speed, then n x (float x, float y)
+        MSG_SET_RATE = 0x14,   // uint16 minimum ms between status frames (0 = default)
+
+        // Server -> client
+        MSG_ACK = 0x20,        // uint16 credits, uint16 path space
+        MSG_BUSY = 0x21,       // uint16 credits, uint16 path space
+        MSG_STATUS = 0x30,     // See StatusFrame / encodeStatus()
+        MSG_STATUS_DELTA = 0x31  // uint16 field mask, then the masked STATUS fields
+    };
+
+    // STATUS fields, as bits of a STATUS_DELTA mask (in payload order)
+    enum StatusField {
+        FIELD_X = 0x0001,
+        FIELD_Y = 0x0002,
+        FIELD_THETA1 = 0x0004,
+        FIELD_THETA2 = 0x0008,
+        FIELD_FLAGS = 0x0010,
+        FIELD_CREDITS = 0x0020,
+        FIELD_TTFS = 0x0040,
+        FIELD_TTFS_MAX = 0x0080,
+        FIELD_PATH_SPACE = 0x0100,
+        FIELD_ALL = 0x01FF
+    };
+
+    enum Result {
+        OK = 0,
+        ERROR_TRUNCATED,      // Shorter than its header says
+        ERROR_BAD_VERSION,    // Header version is not BINARY_PROTOCOL_VERSION
+        ERROR_BAD_LENGTH,     // Payload length wrong for the message type
+        ERROR_UNKNOWN_TYPE,   // Not a message this side can receive
+        ERROR_NO_ROOM         // PATH larger than the free path buffer space
+    };
+
+    static const size_t HEADER_SIZE = 4;
+    static const size_t MOVE_TO_PAYLOAD = 12;
+    static const size_t CREDITS_PAYLOAD = 4;
+    static const size_t ERROR_PAYLOAD = 1;
+    static const size_t STATUS_PAYLOAD = 29;
+    static const size_t SET_RATE_PAYLOAD = 2;
+    static const size_t PATH_VERTEX_SIZE = 8;
+    static const size_t STATUS_DELTA_MAX_PAYLOAD = 2 + STATUS_PAYLOAD;
+
+    // Largest frame the server sends (size output buffers with this)
+    static const size_t MAX_FRAME_SIZE = HEADER_SIZE + STATUS_DELTA_MAX_PAYLOAD;
+
+    /**
+     * @brief Decode and check a frame header
+     * @param data Received bytes
+     * @param len Number of bytes received
+     * @param header Output header
+     * @return OK, ERROR_TRUNCATED or ERROR_BAD_VERSION (header is still
+     *         filled in for a version mismatch)
+     */
+    static Result readHeader(const uint8_t* data, size_t len, FrameHeader& header);
+
+    /**
+     * @brief Decode a frame header without requiring its payload
+     * Used on the first piece of a message that arrives in pieces.
+     * @return OK, ERROR_TRUNCATED (fewer than HEADER_SIZE bytes) or
+     *         ERROR_BAD_VERSION
+     */
+    static Result peekHeader(const uint8_t* data, size_t len, FrameHeader& header);
+
+    /**
+     * @brief Decode a client command frame (MOVE_TO, HOME or STOP)
+     * @param data Received bytes (a whole frame)
+     * @param len Number of bytes received
+     * @param cmd Output command
+     * @return OK, or the reason the frame was rejected
+     */
+    static Result decodeCommand(const uint8_t* data, size_t len, Command& cmd);
+
+    /**
+     * @brief Encode a client command (for clients and tests)
+     * @return Bytes written, 0 if the command has no binary form or
+     *         the buffer is too small
+     */
+    static size_t encodeCommand(const Command& cmd, uint8_t* buffer, size_t capacity);
+
+    /**
+     * @brief Decode a SET_RATE frame
+     * @param intervalMs Output requested interval (0 = server default)
+     */
+    static Result decodeSetRate(const uint8_t* data, size_t len, uint16_t& intervalMs);
+
+    /**
+     * @brief Encode a SET_RATE frame (for clients and tests)
+     */
+    static size_t encodeSetRate(uint16_t intervalMs, uint8_t* buffer, size_t capacity);
+
+    /**
+     * @brief Encode a HELLO frame carrying this side's version
+     */
+    static size_t encodeHello(uint8_t* buffer, size_t capacity);
+
+    /**
+     * @brief Encode an ERROR frame
+     * @param code Reason the last frame was rejected
+     */
+    static size_t encodeError(Result code, uint8_t* buffer, size_t capacity);
+
+    /**
+     * @brief Encode an ACK or BUSY reply
+     * @param type MSG_ACK or MSG_BUSY
+     * @param credits Free command queue slots
+     * @param pathSpace Free path buffer vertices (largest PATH accepted)
+     */
+    static size_t encodeCredits(MessageType type, int credits, int pathSpace,
+                                uint8_t* buffer, size_t capacity);
+
+    /**
+     * @brief Encode the header and speed of a PATH message
+     * The caller appends vertexCount vertices with encodeVertex().
+     * @return Bytes written (header and speed)
+     */
+    static size_t encodePathStart(float speed, uint16_t vertexCount, uint8_t* buffer,
+                                  size_t capacity);
+
+    /**
+     * @brief Encode one PATH vertex (PATH_VERTEX_SIZE bytes)
+     */
+    static size_t encodeVertex(const Point2D& point, uint8_t* buffer, size_t capacity);
+
+    /**
+     * @brief Encode a STATUS frame
+     * Payload: float x, y, theta1, theta2; uint8 flags (bit 0 moving,
+     * bit 1 homed); uint16 credits; uint32 ttfsUs, ttfsMaxUs; uint16
+     * pathSpace.
+     */
+    static size_t encodeStatus(const StatusFrame& status, uint8_t* buffer, size_t capacity);
+
+    /**
+     * @brief Decode a STATUS frame (for clients and tests)
+     */
+    static Result decodeStatus(const uint8_t* data, size_t len, StatusFrame& status);
+
+    /**
+     * @brief Encode a STATUS_DELTA frame
+     * Payload: uint16 mask, then each field whose bit is set, in the
+     * STATUS order and encoding (the flags byte carries both flags).
+     * @param mask StatusField bits to include
+     */
+    static size_t encodeStatusDelta(const StatusFrame& status, uint16_t mask,
+                                    uint8_t* buffer, size_t capacity);
+
+    /**
+     * @brief Apply a STATUS_DELTA frame (for clients and tests)
+     * @param status Last known status, updated in place
+     * @param mask Output fields that were present
+     */
+    static Result decodeStatusDelta(const uint8_t* data, size_t len, StatusFrame& status,
+                                    uint16_t& mask);
+
+private:
+    static void writeHeader(uint8_t* buffer, uint8_t type, uint16_t length);
+};
+
+/**
+ * Incremental decoder for PATH messages.
+ *
+ * The WebSocket hands over a large message in pieces of any size; each
+ * piece is fed as it arrives and complete vertices go straight into the
+ * PathBuffer, so the message is never held in memory. The header is
+ * checked against the free buffer space before any vertex is written,
+ * so a PATH that does not fit is rejected without side effects.
+ */
+class PathStreamDecoder {
+public:
+    enum State {
+        IDLE,       // No upload in progress
+        HEADER,     // Waiting for the header and speed
+        VERTICES,   // Writing vertices to the buffer
+        COMPLETE,   // All vertices written
+        FAILED      // Rejected (see feed()'s result)
+    };
+
+    PathStreamDecoder();
+
+    /**
+     * @brief Start decoding a new PATH message
+     * @param buffer Ring to write the vertices to
+     * @param pathId Id to tag the vertices with
+     */
+    void begin(PathBuffer* buffer, uint16_t pathId);
+
+    /**
+     * @brief Feed the next piece of the message (starting with its header)
+     * @return OK, or the reason the message was rejected
+     */
+    BinaryProtocol::Result feed(const uint8_t* data, size_t len);
+
+    /**
+     * @brief Give up on the current message and take its vertices back
+     * For a client that disconnected, a message that failed, or a
+     * complete one whose command could not be queued.
+     */
+    void abort();
+
+    State getState() const { return state; }
+    bool isActive() const { return state == HEADER || state == VERTICES; }
+    bool isComplete() const { return state == COMPLETE; }
+
+    uint16_t getPathId() const { return pathId; }
+    uint16_t getVertexCount() const { return expectedVertices; }
+    float getSpeed() const { return speed; }
+
+private:
+    PathBuffer* buffer;
+    State state;
+    uint16_t pathId;
+    uint16_t expectedVertices;
+    uint16_t writtenVertices;
+    float speed;
+
+    // Bytes of a header or vertex split across two pieces
+    uint8_t pending[BinaryProtocol::HEADER_SIZE + 4];
+    size_t pendingLen;
+
+    BinaryProtocol::Result parseHeader();
+};
+
+#endif // BINARY_PROTOCOL_H
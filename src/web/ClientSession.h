@@ -0,0 +1,154 @@
+#ifndef CLIENT_SESSION_H
+#define CLIENT_SESSION_H
+
+#include "Telemetry.h"
+#include "../Config.h"
+#include <stdint.h>
+#include <atomic>
+
+/**
+ * @file ClientSession.h
+ * @brief Per-client WebSocket state
+ *
+ * Every connected WebSocket client gets a slot in a fixed table, so
+ * per-client settings (the negotiated message format and the status
+ * telemetry state) need no heap allocation. Clients start on JSON and
+ * switch to the binary protocol by sending a binary HELLO frame.
+ *
+ * The telemetry channel and the format belong to the telemetry task. The
+ * WebSocket handler runs on the async TCP task, so it does not change
+ * them itself: it posts a format switch, a reset or a new interval in one
+ * atomic word, and the telemetry task applies them together just before
+ * it next polls the channel.
+ */
+
+struct ClientSession {
+    enum Format {
+        FORMAT_JSON,    // Text frames (default, easy to debug)
+        FORMAT_BINARY   // BinaryProtocol frames
+    };
+
+    // Pending telemetry changes: flags, and the interval in the high half
+    enum TelemetryRequest {
+        REQUEST_RESET = 1 << 0,      // Full status next, back to JSON
+        REQUEST_INTERVAL = 1 << 1,   // New interval
+        REQUEST_BINARY = 1 << 2      // With REQUEST_RESET: full status next, in binary
+    };
+
+    uint32_t clientId;  // AsyncWebSocketClient::id()
+    bool inUse;
+    Format format;      // Set by applyTelemetryRequests()
+    TelemetryChannel telemetry;  // What this client was last sent, and how often
+    std::atomic<uint32_t> telemetryRequests;
+
+    ClientSession() : clientId(0), inUse(false), format(FORMAT_JSON), telemetryRequests(0) {}
+
+    /**
+     * @brief Have the telemetry task switch to binary (HELLO)
+     * The switch and the reset apply together, so the first binary status
+     * is a full one.
+     */
+    void requestBinaryFormat() {
+        telemetryRequests.fetch_or(REQUEST_RESET | REQUEST_BINARY);
+    }
+
+    /**
+     * @brief Have the telemetry task use a new interval (0 for the default)
+     */
+    void requestTelemetryInterval(uint16_t intervalMs) {
+        uint32_t expected = telemetryRequests.load();
+        uint32_t desired;
+        do {
+            desired = (expected & 0xFFFF) | REQUEST_INTERVAL | ((uint32_t)intervalMs << 16);
+        } while (!telemetryRequests.compare_exchange_weak(expected, desired));
+    }
+
+    /**
+     * @brief Apply the posted changes (telemetry task, before polling)
+     */
+    void applyTelemetryRequests() {
+        uint32_t requests = telemetryRequests.exchange(0);
+        if (requests & REQUEST_RESET) {
+            telemetry.reset();
+            format = (requests & REQUEST_BINARY) ? FORMAT_BINARY : FORMAT_JSON;
+        }
+        if (requests & REQUEST_INTERVAL) {
+            telemetry.setInterval((uint16_t)(requests >> 16));
+        }
+    }
+};
+
+/**
+ * Fixed table of client sessions, indexed by client id.
+ * Slots are only claimed and released from the WebSocket event handler;
+ * other tasks may iterate the table, at worst sending one message to a
+ * client that has just disconnected (which AsyncWebSocket ignores). A
+ * reused slot's telemetry and format are reset by the telemetry task,
+ * like any other request.
+ */
+class ClientSessionTable {
+private:
+    ClientSession sessions[WS_MAX_CLIENTS];
+
+public:
+    /**
+     * @brief Claim a slot for a new client (format back to JSON once the
+     * telemetry task applies the reset)
+     * @return The session, or nullptr if the table is full
+     */
+    ClientSession* open(uint32_t clientId) {
+        ClientSession* session = find(clientId);
+        if (!session) {
+            for (int i = 0; i < WS_MAX_CLIENTS; i++) {
+                if (!sessions[i].inUse) {
+                    session = &sessions[i];
+                    break;
+                }
+            }
+        }
+        if (!session) {
+            return nullptr;
+        }
+        // Back to JSON, dropping whatever the previous client had asked for
+        session->telemetryRequests = ClientSession::REQUEST_RESET;
+        session->clientId = clientId;
+        session->inUse = true;
+        return session;
+    }
+
+    void close(uint32_t clientId) {
+        ClientSession* session = find(clientId);
+        if (session) {
+            session->inUse = false;
+        }
+    }
+
+    ClientSession* find(uint32_t clientId) {
+        for (int i = 0; i < WS_MAX_CLIENTS; i++) {
+            if (sessions[i].inUse && sessions[i].clientId == clientId) {
+                return &sessions[i];
+            }
+        }
+        return nullptr;
+    }
+
+    /**
+     * @brief Number of open sessions using a format
+     */
+    int count(ClientSession::Format format) const {
+        int n = 0;
+        for (int i = 0; i < WS_MAX_CLIENTS; i++) {
+            if (sessions[i].inUse && sessions[i].format == format) {
+                n++;
+            }
+        }
+        return n;
+    }
+
+    // Slot access for iteration (check inUse)
+    static int capacity() { return WS_MAX_CLIENTS; }
+    ClientSession& at(int index) { return sessions[index]; }
+    const ClientSession& at(int index) const { return sessions[index]; }
+};
+
+#endif // CLIENT_SESSION_H
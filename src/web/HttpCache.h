@@ -0,0 +1,90 @@
+#ifndef HTTP_CACHE_H
+#define HTTP_CACHE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * @file HttpCache.h
+ * @brief Entity tags for static assets
+ *
+ * An asset's ETag is the FNV-1a hash of the bytes actually sent (the
+ * gzipped content), computed once at startup. A browser that already
+ * holds that version sends it back in If-None-Match and is answered with
+ * 304 Not Modified instead of the asset.
+ */
+
+class HttpCache {
+public:
+    static const uint32_t FNV_OFFSET = 2166136261u;
+    static const uint32_t FNV_PRIME = 16777619u;
+
+    // Size of a formatted ETag: quotes, 8 hex digits and the terminator
+    static const size_t ETAG_SIZE = 11;
+
+    /**
+     * @brief FNV-1a hash, 32 bits
+     * Feed a file in chunks by passing the previous result as hash.
+     */
+    static uint32_t fnv1a(const uint8_t* data, size_t len, uint32_t hash = FNV_OFFSET) {
+        for (size_t i = 0; i < len; i++) {
+            hash ^= data[i];
+            hash *= FNV_PRIME;
+        }
+        return hash;
+    }
+
+    /**
+     * @brief Format a strong ETag ("0123abcd", quotes included)
+     * @param out Buffer of at least ETAG_SIZE bytes
+     */
+    static void formatETag(uint32_t hash, char* out) {
+        static const char hex[] = "0123456789abcdef";
+        out[0] = '"';
+        for (int i = 0; i < 8; i++) {
+            out[1 + i] = hex[(hash >> (28 - 4 * i)) & 0x0F];
+        }
+        out[9] = '"';
+        out[10] = '\0';
+    }
+
+    /**
+     * @brief Check an If-None-Match header against an ETag
+     * Accepts a list of tags and "*"; weak tags (W/"...") compare by
+     * their value, as RFC 7232 asks for If-None-Match.
+     */
+    static bool matches(const char* ifNoneMatch, const char* etag) {
+        size_t etagLen = strlen(etag);
+        const char* p = ifNoneMatch;
+
+        while (*p) {
+            while (*p == ' ' || *p == '\t' || *p == ',') p++;
+            if (!*p) {
+                break;
+            }
+            if (*p == '*') {
+                return true;
+            }
+            if (p[0] == 'W' && p[1] == '/') {
+                p += 2;
+            }
+
+            const char* start = p;
+            if (*p == '"') {
+                p++;
+                while (*p && *p != '"') p++;
+                if (*p == '"') p++;
+            } else {
+                while (*p && *p != ',' && *p != ' ') p++;
+            }
+
+            if ((size_t)(p - start) == etagLen && strncmp(start, etag, etagLen) == 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+#endif // HTTP_CACHE_H
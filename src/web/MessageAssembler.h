@@ -0,0 +1,163 @@
+#ifndef MESSAGE_ASSEMBLER_H
+#define MESSAGE_ASSEMBLER_H
+
+#include "../Config.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * @file MessageAssembler.h
+ * @brief Reassembles WebSocket messages delivered in pieces
+ *
+ * AsyncWebSocket hands a message over as it arrives: a large frame comes
+ * in several data events, and a fragmented message in several frames.
+ * Pieces of a message are appended to a per-client slot taken from a
+ * fixed pool, and the message is handed on once its last piece is in.
+ *
+ * A message that arrives in one piece (the usual case for commands) is
+ * handed on where it lies, without a copy or a slot. Either way the
+ * message buffer is writable, so it can be parsed in place.
+ *
+ * All calls come from the async TCP task; nothing is locked.
+ */
+
+class MessageAssembler {
+public:
+    enum Result {
+        MESSAGE_PENDING,    // Piece stored (or ignored); wait for more
+        MESSAGE_COMPLETE,   // message/length hold a whole message
+        MESSAGE_DROPPED     // Too large, or no free slot: tell the client
+    };
+
+    MessageAssembler() {}
+
+    /**
+     * @brief Add one received piece of a message
+     * @param clientId Sender (AsyncWebSocketClient::id())
+     * @param data Piece received (writable)
+     * @param len Size of the piece
+     * @param start true for the first piece of a message
+     * @param end true for the last piece of a message
+     * @param message Output message (for MESSAGE_COMPLETE), valid until
+     *                the next call for this client or release()
+     * @param length Output message size
+     */
+    Result feed(uint32_t clientId, uint8_t* data, size_t len, bool start, bool end,
+                uint8_t*& message, size_t& length) {
+        Slot* slot = find(clientId);
+
+        if (start) {
+            if (slot) {
+                slot->inUse = false;  // Previous message done (or abandoned)
+                slot = nullptr;
+            }
+            if (end) {
+                message = data;
+                length = len;
+                return MESSAGE_COMPLETE;
+            }
+            slot = claim(clientId);
+            if (!slot) {
+                return MESSAGE_DROPPED;  // Later pieces find no slot and are ignored
+            }
+        } else if (!slot || slot->complete) {
+            return MESSAGE_PENDING;  // Rest of a message already dropped
+        }
+
+        if (!slot->overflow) {
+            if (slot->length + len > WS_MESSAGE_MAX) {
+                slot->overflow = true;
+            } else {
+                memcpy(slot->data + slot->length, data, len);
+                slot->length += len;
+            }
+        }
+
+        if (!end) {
+            return MESSAGE_PENDING;
+        }
+        if (slot->overflow) {
+            slot->inUse = false;
+            return MESSAGE_DROPPED;
+        }
+
+        slot->complete = true;
+        slot->data[slot->length] = '\0';  // Convenience for text messages
+        message = slot->data;
+        length = slot->length;
+        return MESSAGE_COMPLETE;
+    }
+
+    /**
+     * @brief Free a client's slot (message handled, or client gone)
+     */
+    void release(uint32_t clientId) {
+        Slot* slot = find(clientId);
+        if (slot) {
+            slot->inUse = false;
+        }
+    }
+
+    /**
+     * @brief Free every slot
+     */
+    void clear() {
+        for (int i = 0; i < WS_REASSEMBLY_SLOTS; i++) {
+            slots[i].inUse = false;
+        }
+    }
+
+    /**
+     * @brief Slots not holding a message
+     */
+    int freeSlots() const {
+        int n = 0;
+        for (int i = 0; i < WS_REASSEMBLY_SLOTS; i++) {
+            if (!slots[i].inUse) {
+                n++;
+            }
+        }
+        return n;
+    }
+
+private:
+    struct Slot {
+        uint32_t clientId;
+        bool inUse;
+        bool complete;   // Holds a whole message
+        bool overflow;   // Message longer than WS_MESSAGE_MAX
+        size_t length;
+        uint8_t data[WS_MESSAGE_MAX + 1];
+
+        Slot() : clientId(0), inUse(false), complete(false), overflow(false), length(0) {}
+    };
+
+    Slot slots[WS_REASSEMBLY_SLOTS];
+
+    Slot* find(uint32_t clientId) {
+        for (int i = 0; i < WS_REASSEMBLY_SLOTS; i++) {
+            if (slots[i].inUse && slots[i].clientId == clientId) {
+                return &slots[i];
+            }
+        }
+        return nullptr;
+    }
+
+    Slot* claim(uint32_t clientId) {
+        for (int i = 0; i < WS_REASSEMBLY_SLOTS; i++) {
+            if (!slots[i].inUse) {
+                Slot& slot = slots[i];
+                slot.clientId = clientId;
+                slot.inUse = true;
+                slot.complete = false;
+                slot.overflow = false;
+                slot.length = 0;
+                return &slot;
+            }
+        }
+        return nullptr;
+    }
+};
+
+#endif // MESSAGE_ASSEMBLER_H
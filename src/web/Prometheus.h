@@ -0,0 +1,118 @@
+#ifndef PROMETHEUS_H
+#define PROMETHEUS_H
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/**
+ * @file Prometheus.h
+ * @brief Prometheus text exposition format, written into a fixed buffer
+ *
+ * Each metric is a "# HELP" and a "# TYPE" line followed by one sample
+ * line per label value:
+ *
+ *     # HELP scara_steps_total Step pulses issued.
+ *     # TYPE scara_steps_total counter
+ *     scara_steps_total{joint="1"} 1200
+ *
+ * Output that does not fit is cut at the last whole line and flagged,
+ * so a scrape never returns a half-written sample.
+ */
+
+class PrometheusWriter {
+public:
+    PrometheusWriter(char* buffer, size_t size)
+        : buffer(buffer), size(size), used(0), truncated(false) {
+        if (size > 0) {
+            buffer[0] = '\0';
+        }
+    }
+
+    /**
+     * @brief Start a metric: its HELP and TYPE lines
+     * @param type "counter" or "gauge"
+     */
+    void begin(const char* name, const char* type, const char* help) {
+        line("# HELP %s %s\n# TYPE %s %s\n", name, help, name, type);
+    }
+
+    void sample(const char* name, uint32_t value) {
+        line("%s %u\n", name, (unsigned)value);
+    }
+
+    void sample(const char* name, const char* label, const char* labelValue, uint32_t value) {
+        line("%s{%s=\"%s\"} %u\n", name, label, labelValue, (unsigned)value);
+    }
+
+    void sample(const char* name, const char* label, const char* labelValue, float value) {
+        line("%s{%s=\"%s\"} %.4f\n", name, label, labelValue, (double)value);
+    }
+
+    /**
+     * @brief A metric with a single, unlabelled sample
+     */
+    void counter(const char* name, const char* help, uint32_t value) {
+        begin(name, "counter", help);
+        sample(name, value);
+    }
+
+    void gauge(const char* name, const char* help, uint32_t value) {
+        begin(name, "gauge", help);
+        sample(name, value);
+    }
+
+    /**
+     * @brief A histogram: cumulative buckets, sum and count
+     * @param upperBounds Upper bound of each bucket (the last one is +Inf
+     *                    whatever its value)
+     * @param counts Samples in each bucket (not cumulative)
+     * @param buckets Number of buckets
+     * @param sum Sum of all samples
+     */
+    void histogram(const char* name, const char* help, const uint32_t* upperBounds,
+                   const uint32_t* counts, int buckets, uint32_t sum) {
+        begin(name, "histogram", help);
+        uint32_t cumulative = 0;
+        for (int i = 0; i < buckets; i++) {
+            cumulative += counts[i];
+            if (i < buckets - 1) {
+                line("%s_bucket{le=\"%u\"} %u\n", name, (unsigned)upperBounds[i], (unsigned)cumulative);
+            } else {
+                line("%s_bucket{le=\"+Inf\"} %u\n", name, (unsigned)cumulative);
+            }
+        }
+        line("%s_sum %u\n%s_count %u\n", name, (unsigned)sum, name, (unsigned)cumulative);
+    }
+
+    const char* text() const { return buffer; }
+    size_t length() const { return used; }
+    bool overflowed() const { return truncated; }
+
+private:
+    char* buffer;
+    size_t size;
+    size_t used;
+    bool truncated;
+
+    void line(const char* format, ...) __attribute__((format(printf, 2, 3))) {
+        if (truncated || size == 0) {
+            truncated = true;
+            return;
+        }
+        va_list args;
+        va_start(args, format);
+        int n = vsnprintf(buffer + used, size - used, format, args);
+        va_end(args);
+
+        if (n < 0 || (size_t)n >= size - used) {
+            buffer[used] = '\0';  // Drop the partial line
+            truncated = true;
+            return;
+        }
+        used += (size_t)n;
+    }
+};
+
+#endif // PROMETHEUS_H
@@ -0,0 +1,117 @@
+#include "Telemetry.h"
+#include <math.h>
+
+TelemetryChannel::TelemetryChannel()
+    : hasBaseline(false), lastSendMs(0),
+      requestedIntervalMs(TELEMETRY_DEFAULT_INTERVAL_MS),
+      currentIntervalMs(TELEMETRY_DEFAULT_INTERVAL_MS) {
+}
+
+void TelemetryChannel::reset() {
+    hasBaseline = false;
+    lastSendMs = 0;
+    requestedIntervalMs = TELEMETRY_DEFAULT_INTERVAL_MS;
+    currentIntervalMs = TELEMETRY_DEFAULT_INTERVAL_MS;
+}
+
+void TelemetryChannel::setInterval(uint16_t intervalMs) {
+    if (intervalMs == 0) {
+        intervalMs = TELEMETRY_DEFAULT_INTERVAL_MS;
+    }
+    if (intervalMs < TELEMETRY_MIN_INTERVAL_MS) {
+        intervalMs = TELEMETRY_MIN_INTERVAL_MS;
+    }
+    if (intervalMs > TELEMETRY_MAX_INTERVAL_MS) {
+        intervalMs = TELEMETRY_MAX_INTERVAL_MS;
+    }
+    requestedIntervalMs = intervalMs;
+    currentIntervalMs = intervalMs;
+}
+
+uint16_t TelemetryChannel::changedFields(const StatusFrame& status) const {
+    if (!hasBaseline) {
+        return BinaryProtocol::FIELD_ALL;
+    }
+
+    uint16_t mask = 0;
+    if (fabsf(status.position.x - lastSent.position.x) >= TELEMETRY_POSITION_DEADBAND) {
+        mask |= BinaryProtocol::FIELD_X;
+    }
+    if (fabsf(status.position.y - lastSent.position.y) >= TELEMETRY_POSITION_DEADBAND) {
+        mask |= BinaryProtocol::FIELD_Y;
+    }
+    if (fabsf(status.angles.theta1 - lastSent.angles.theta1) >= TELEMETRY_ANGLE_DEADBAND) {
+        mask |= BinaryProtocol::FIELD_THETA1;
+    }
+    if (fabsf(status.angles.theta2 - lastSent.angles.theta2) >= TELEMETRY_ANGLE_DEADBAND) {
+        mask |= BinaryProtocol::FIELD_THETA2;
+    }
+    if (status.isMoving != lastSent.isMoving || status.isHomed != lastSent.isHomed) {
+        mask |= BinaryProtocol::FIELD_FLAGS;
+    }
+    if (status.credits != lastSent.credits) {
+        mask |= BinaryProtocol::FIELD_CREDITS;
+    }
+    if (status.ttfsUs != lastSent.ttfsUs) {
+        mask |= BinaryProtocol::FIELD_TTFS;
+    }
+    if (status.ttfsMaxUs != lastSent.ttfsMaxUs) {
+        mask |= BinaryProtocol::FIELD_TTFS_MAX;
+    }
+    if (status.pathSpace != lastSent.pathSpace) {
+        mask |= BinaryProtocol::FIELD_PATH_SPACE;
+    }
+    return mask;
+}
+
+TelemetryChannel::Decision TelemetryChannel::poll(const StatusFrame& status, uint32_t nowMs,
+                                                  bool backlogged, uint16_t& mask) {
+    mask = 0;
+    uint32_t elapsed = nowMs - lastSendMs;
+
+    if (hasBaseline && elapsed < currentIntervalMs) {
+        return SEND_NONE;
+    }
+
+    if (backlogged) {
+        // Coalesce: keep the changes for the next send and slow down
+        uint32_t slower = (uint32_t)currentIntervalMs * 2;
+        currentIntervalMs = (slower > TELEMETRY_MAX_INTERVAL_MS)
+                                ? TELEMETRY_MAX_INTERVAL_MS : (uint16_t)slower;
+        if (hasBaseline) {
+            lastSendMs = nowMs;  // Wait a full (longer) interval before trying again
+        }
+        return SEND_NONE;
+    }
+
+    if (!hasBaseline || elapsed >= TELEMETRY_HEARTBEAT_MS) {
+        mask = BinaryProtocol::FIELD_ALL;
+        return SEND_FULL;
+    }
+
+    mask = changedFields(status);
+    return mask ? SEND_DELTA : SEND_NONE;
+}
+
+void TelemetryChannel::sent(const StatusFrame& status, uint16_t mask, uint32_t nowMs) {
+    if (mask & BinaryProtocol::FIELD_X) lastSent.position.x = status.position.x;
+    if (mask & BinaryProtocol::FIELD_Y) lastSent.position.y = status.position.y;
+    if (mask & BinaryProtocol::FIELD_THETA1) lastSent.angles.theta1 = status.angles.theta1;
+    if (mask & BinaryProtocol::FIELD_THETA2) lastSent.angles.theta2 = status.angles.theta2;
+    if (mask & BinaryProtocol::FIELD_FLAGS) {
+        lastSent.isMoving = status.isMoving;
+        lastSent.isHomed = status.isHomed;
+    }
+    if (mask & BinaryProtocol::FIELD_CREDITS) lastSent.credits = status.credits;
+    if (mask & BinaryProtocol::FIELD_TTFS) lastSent.ttfsUs = status.ttfsUs;
+    if (mask & BinaryProtocol::FIELD_TTFS_MAX) lastSent.ttfsMaxUs = status.ttfsMaxUs;
+    if (mask & BinaryProtocol::FIELD_PATH_SPACE) lastSent.pathSpace = status.pathSpace;
+
+    if (mask == BinaryProtocol::FIELD_ALL) {
+        hasBaseline = true;
+    }
+    lastSendMs = nowMs;
+
+    // Client kept up: recover halfway towards the negotiated rate
+    currentIntervalMs = requestedIntervalMs + (currentIntervalMs - requestedIntervalMs) / 2;
+}
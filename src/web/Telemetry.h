@@ -0,0 +1,79 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include "BinaryProtocol.h"
+#include "../Config.h"
+#include <stdint.h>
+
+/**
+ * @file Telemetry.h
+ * @brief Per-client, change-driven status telemetry
+ *
+ * Each client has a TelemetryChannel remembering what it was last sent.
+ * A status is only sent when something moved past its deadband, and at
+ * most once per client interval; binary clients get just the fields that
+ * changed (STATUS_DELTA). Deadbands compare against the last value sent,
+ * so slow drift is still reported once it adds up.
+ *
+ * Slow clients are coalesced rather than queued: while a client still
+ * has a message waiting to go out, nothing new is sent to it and its
+ * interval backs off (doubling up to TELEMETRY_MAX_INTERVAL_MS). The next
+ * delta then carries everything that changed in the meantime. The
+ * interval recovers towards the negotiated one after each clean send.
+ */
+
+class TelemetryChannel {
+public:
+    enum Decision {
+        SEND_NONE,    // Nothing to send now
+        SEND_FULL,    // Send the whole status (first message, heartbeat)
+        SEND_DELTA    // Send the fields in the returned mask
+    };
+
+    TelemetryChannel();
+
+    /**
+     * @brief Forget what was sent (new client) and reset the rate
+     */
+    void reset();
+
+    /**
+     * @brief Set the interval the client asked for
+     * @param intervalMs Minimum time between messages, 0 for the default
+     */
+    void setInterval(uint16_t intervalMs);
+
+    /**
+     * @brief Decide what to send to this client now
+     * @param status Current status
+     * @param nowMs Current time (milliseconds)
+     * @param backlogged true if the client has not drained its last message
+     * @param mask Output fields to send (BinaryProtocol::StatusField bits)
+     */
+    Decision poll(const StatusFrame& status, uint32_t nowMs, bool backlogged, uint16_t& mask);
+
+    /**
+     * @brief Record that the fields in mask were sent
+     * @param status Status that was sent
+     * @param mask Fields sent (FIELD_ALL for a full status)
+     * @param nowMs Time of the send (milliseconds)
+     */
+    void sent(const StatusFrame& status, uint16_t mask, uint32_t nowMs);
+
+    /**
+     * @brief Fields that differ from the last sent status beyond the deadbands
+     */
+    uint16_t changedFields(const StatusFrame& status) const;
+
+    uint16_t getInterval() const { return requestedIntervalMs; }
+    uint16_t getCurrentInterval() const { return currentIntervalMs; }
+
+private:
+    StatusFrame lastSent;
+    bool hasBaseline;
+    uint32_t lastSendMs;
+    uint16_t requestedIntervalMs;   // Negotiated with the client
+    uint16_t currentIntervalMs;     // Backed off while the client is slow
+};
+
+#endif // TELEMETRY_H
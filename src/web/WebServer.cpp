@@ -1,9 +1,19 @@
 #include "WebServer.h"
 #include "web_assets.h"
 #include "../Config.h"
+#include "../core/Metrics.h"
+#include "../core/Profiler.h"
+#include "../core/StepTrace.h"
 #include <ArduinoJson.h>
+#include <LittleFS.h>
+#include <string.h>
+#include <memory>
 
-WebServer::WebServer() : server(nullptr), ws(nullptr), commandQueue(nullptr) {
+WebServer::WebServer()
+    : server(nullptr), ws(nullptr), commandQueue(nullptr),
+      assets(nullptr), assetCount(0), watchedTaskCount(0), loopTimer(nullptr),
+      pathBuffer(nullptr), pathClientId(0), nextPathId(0),
+      pendingGCodeClient(0), gcodeRemainderLength(0), gcodePending(false), gcodeCancel(false) {
 }
 
 WebServer::~WebServer() {
@@ -13,10 +23,12 @@ WebServer::~WebServer() {
     if (server) {
         delete server;
     }
+    delete[] assets;
 }
 
-void WebServer::init(QueueHandle_t cmdQueue) {
+void WebServer::init(QueueHandle_t cmdQueue, PathBuffer* paths) {
     commandQueue = cmdQueue;
+    pathBuffer = paths;
     
     server = new AsyncWebServer(80);
     ws = new AsyncWebSocket("/ws");
@@ -32,6 +44,13 @@ void WebServer::init(QueueHandle_t cmdQueue) {
         this->handleRoot(request);
     });
     
+    loadAssets();
+    for (int i = 0; i < assetCount; i++) {
+        server->on(assets[i].asset->path, HTTP_GET, [this, i](AsyncWebServerRequest* request) {
+            this->handleAsset(request, assets[i]);
+        });
+    }
+    
     server->on("/move", HTTP_GET, [this](AsyncWebServerRequest* request) {
         this->handleMove(request);
     });
@@ -44,10 +63,35 @@ void WebServer::init(QueueHandle_t cmdQueue) {
         this->handleStatus(request);
     });
     
+    server->on("/gcode", HTTP_GET, [this](AsyncWebServerRequest* request) {
+        this->handleGCode(request);
+    });
+    
+    server->on("/metrics", HTTP_GET, [this](AsyncWebServerRequest* request) {
+        this->handleMetrics(request);
+    });
+    
+    server->on("/loop", HTTP_GET, [this](AsyncWebServerRequest* request) {
+        this->handleLoopTiming(request);
+    });
+    
+    server->on("/profile", HTTP_GET, [this](AsyncWebServerRequest* request) {
+        this->handleProfile(request);
+    });
+    
+    server->on("/trace", HTTP_GET, [this](AsyncWebServerRequest* request) {
+        this->handleTrace(request);
+    });
+    
     // Add WebSocket handler
     server->addHandler(ws);
 }
 
+void WebServer::setGCodeHome(const Point2D& homePosition, const Point2D& position) {
+    gcode.setHomePosition(homePosition);
+    gcode.setPosition(position);
+}
+
 void WebServer::begin() {
     if (server) {
         server->begin();
@@ -55,23 +99,101 @@ void WebServer::begin() {
     }
 }
 
+void WebServer::loadAssets() {
+    bool mounted = LittleFS.begin(false);
+    if (!mounted) {
+        Serial.println("Web: LittleFS not mounted, serving built-in assets");
+    }
+    
+    assetCount = WEB_ASSET_COUNT;
+    assets = new ServedAsset[assetCount];
+    
+    for (int i = 0; i < assetCount; i++) {
+        ServedAsset& served = assets[i];
+        served.asset = &WEB_ASSETS[i];
+        served.onFilesystem = false;
+        
+        // The ETag is a hash of the bytes that will be sent, so it changes
+        // with the filesystem image even if the firmware does not
+        uint32_t hash = HttpCache::FNV_OFFSET;
+        String fsPath = String(served.asset->path) + ".gz";
+        if (mounted && LittleFS.exists(fsPath)) {
+            File file = LittleFS.open(fsPath, "r");
+            if (file) {
+                uint8_t chunk[256];
+                int n;
+                while ((n = file.read(chunk, sizeof(chunk))) > 0) {
+                    hash = HttpCache::fnv1a(chunk, n, hash);
+                }
+                file.close();
+                served.onFilesystem = true;
+            }
+        }
+        if (!served.onFilesystem) {
+            hash = HttpCache::fnv1a(served.asset->gzip, served.asset->gzipLength);
+        }
+        HttpCache::formatETag(hash, served.etag);
+        
+        Serial.printf("Web: %s from %s, ETag %s\n", served.asset->path,
+                     served.onFilesystem ? "LittleFS" : "flash", served.etag);
+    }
+}
+
 void WebServer::handleRoot(AsyncWebServerRequest* request) {
-    // Send the HTML page from PROGMEM with UTF-8 charset
-    request->send(200, "text/html; charset=UTF-8", WEB_HTML);
+    for (int i = 0; i < assetCount; i++) {
+        if (strcmp(assets[i].asset->path, "/index.html") == 0) {
+            handleAsset(request, assets[i]);
+            return;
+        }
+    }
+    request->send(404, "text/plain", "No index.html");
+}
+
+void WebServer::handleAsset(AsyncWebServerRequest* request, const ServedAsset& served) {
+    // Browser already has this version: headers only
+    if (request->hasHeader("If-None-Match") &&
+        HttpCache::matches(request->getHeader("If-None-Match")->value().c_str(), served.etag)) {
+        AsyncWebServerResponse* response = request->beginResponse(304);
+        response->addHeader("ETag", served.etag);
+        response->addHeader("Cache-Control", WEB_ASSET_CACHE_CONTROL);
+        request->send(response);
+        return;
+    }
+    
+    const WebAsset* asset = served.asset;
+    AsyncWebServerResponse* response;
+    if (served.onFilesystem) {
+        response = request->beginResponse(LittleFS, String(asset->path) + ".gz",
+                                          asset->contentType);
+    } else {
+        response = request->beginResponse_P(200, asset->contentType, asset->gzip,
+                                            asset->gzipLength);
+    }
+    response->addHeader("Content-Encoding", "gzip");
+    response->addHeader("ETag", served.etag);
+    response->addHeader("Cache-Control", WEB_ASSET_CACHE_CONTROL);
+    request->send(response);
 }
 
 void WebServer::handleMove(AsyncWebServerRequest* request) {
+    Metrics::increment(metrics.commandsReceived);
     if (request->hasParam("x") && request->hasParam("y")) {
+        Metrics::increment(metrics.commandsParsed);
         float x = request->getParam("x")->value().toFloat();
         float y = request->getParam("y")->value().toFloat();
+        float speed = 0.0f;
+        if (request->hasParam("speed")) {
+            speed = request->getParam("speed")->value().toFloat();
+        }
         
         Point2D target(x, y);
-        Command cmd(Command::MOVE_TO, target);
+        Command cmd(Command::MOVE_TO, target, speed);
         
         if (commandQueue) {
-            if (xQueueSend(commandQueue, &cmd, pdMS_TO_TICKS(100)) == pdTRUE) {
+            if (enqueueCommand(cmd)) {
                 request->send(200, "text/plain", "OK");
             } else {
+                Metrics::increment(metrics.commandsRejected);
                 request->send(503, "text/plain", "Command queue full");
             }
         } else {
@@ -83,11 +205,14 @@ void WebServer::handleMove(AsyncWebServerRequest* request) {
 }
 
 void WebServer::handleHome(AsyncWebServerRequest* request) {
+    Metrics::increment(metrics.commandsReceived);
+    Metrics::increment(metrics.commandsParsed);
     if (commandQueue) {
         Command cmd(Command::HOME, Point2D(0, 0));
-        if (xQueueSend(commandQueue, &cmd, pdMS_TO_TICKS(100)) == pdTRUE) {
+        if (enqueueCommand(cmd)) {
             request->send(200, "text/plain", "Homing started");
         } else {
+            Metrics::increment(metrics.commandsRejected);
             request->send(503, "text/plain", "Command queue full");
         }
     } else {
@@ -97,78 +222,726 @@ void WebServer::handleHome(AsyncWebServerRequest* request) {
 
 void WebServer::handleStatus(AsyncWebServerRequest* request) {
     // Return JSON status (simplified - would need robot state)
-    String json = "{\"status\":\"running\"}";
+    String json = "{\"status\":\"running\",\"credits\":";
+    json += String(availableCredits());
+    json += "}";
     request->send(200, "application/json", json);
 }
 
+void WebServer::handleMetrics(AsyncWebServerRequest* request) {
+    char* text = new char[METRICS_BUFFER_SIZE];
+    PrometheusWriter out(text, METRICS_BUFFER_SIZE);
+    char label[12];
+    
+    out.counter("scara_commands_received_total",
+                "Command messages and G-code lines received.",
+                Metrics::get(metrics.commandsReceived));
+    out.counter("scara_commands_parsed_total",
+                "Commands received that were understood.",
+                Metrics::get(metrics.commandsParsed));
+    out.counter("scara_commands_rejected_total",
+                "Commands refused because the command queue was full.",
+                Metrics::get(metrics.commandsRejected));
+    out.gauge("scara_command_credits",
+              "Free slots in the command queue.",
+              (uint32_t)availableCredits());
+    
+    out.counter("scara_planner_blocks_total",
+                "Straight moves planned.",
+                Metrics::get(metrics.plannerBlocks));
+    out.counter("scara_planner_samples_total",
+                "Trajectory samples queued for the motion task.",
+                Metrics::get(metrics.plannerSamples));
+    out.counter("scara_ik_failures_total",
+                "Targets and path points with no inverse kinematics solution.",
+                Metrics::get(metrics.ikFailures));
+    
+    out.gauge("scara_motion_queue_depth",
+              "Trajectory samples waiting for the motion task.",
+              Metrics::get(metrics.motionQueueDepth));
+    out.counter("scara_motion_underruns_total",
+                "Times a move ran out of samples before its end.",
+                Metrics::get(metrics.motionUnderruns));
+    
+    if (loopTimer) {
+        writeHistogram(out, "scara_motion_loop_jitter_us",
+                       "Deviation of the motion loop period from nominal.",
+                       loopTimer->jitter());
+        writeHistogram(out, "scara_motion_loop_execution_us",
+                       "Time spent in each motion loop iteration.",
+                       loopTimer->execution());
+        out.counter("scara_motion_loop_missed_deadlines_total",
+                    "Motion loop iterations that ended after the next was due.",
+                    loopTimer->missedDeadlines());
+    }
+    
+    out.begin("scara_steps_total", "counter", "Step pulses issued per joint.");
+    for (int i = 0; i < Metrics::JOINTS; i++) {
+        snprintf(label, sizeof(label), "%d", i + 1);
+        out.sample("scara_steps_total", "joint", label, Metrics::get(metrics.stepsIssued[i]));
+    }
+    
+    out.begin("scara_task_stack_free_bytes", "gauge",
+              "Least free stack each task has had since it started.");
+    for (int i = 0; i < watchedTaskCount; i++) {
+        out.sample("scara_task_stack_free_bytes", "task", watchedTasks[i].name,
+                   (uint32_t)uxTaskGetStackHighWaterMark(watchedTasks[i].handle));
+    }
+    
+    #if STEP_TRACE_ENABLED
+    out.counter("scara_trace_events_total",
+                "Events recorded in the step trace.",
+                stepTrace.recorded());
+    #endif
+    
+    out.gauge("scara_heap_free_bytes", "Free heap.", ESP.getFreeHeap());
+    out.gauge("scara_heap_min_free_bytes", "Least free heap since boot.", ESP.getMinFreeHeap());
+    
+    #if METRICS_CPU_LOAD && configGENERATE_RUN_TIME_STATS
+    // Averaged over the time since the previous scrape: the run time the
+    // idle task of each core did not get
+    UBaseType_t taskCount = uxTaskGetNumberOfTasks();
+    TaskStatus_t* tasks = new TaskStatus_t[taskCount];
+    uint32_t totalRunTime = 0;
+    taskCount = uxTaskGetSystemState(tasks, taskCount, &totalRunTime);
+    out.begin("scara_cpu_utilization", "gauge",
+              "Fraction of time each core was busy since the previous scrape.");
+    for (int i = 0; i < Metrics::CORES; i++) {
+        TaskHandle_t idleTask = xTaskGetIdleTaskHandleForCPU(i);
+        uint32_t idleRunTime = 0;
+        for (UBaseType_t t = 0; t < taskCount; t++) {
+            if (tasks[t].xHandle == idleTask) {
+                idleRunTime = tasks[t].ulRunTimeCounter;
+            }
+        }
+        snprintf(label, sizeof(label), "%d", i);
+        out.sample("scara_cpu_utilization", "core", label,
+                   metrics.cpuIdle[i].utilization(totalRunTime, idleRunTime));
+    }
+    delete[] tasks;
+    #elif METRICS_CPU_LOAD
+    #warning "METRICS_CPU_LOAD needs configGENERATE_RUN_TIME_STATS: no CPU utilization on /metrics"
+    #endif
+    
+    if (out.overflowed()) {
+        Serial.println("Metrics: output truncated, raise METRICS_BUFFER_SIZE");
+    }
+    request->send(200, "text/plain; version=0.0.4", text);
+    delete[] text;
+}
+
+void WebServer::writeHistogram(PrometheusWriter& out, const char* name, const char* help,
+                               const TimingHistogram& histogram) {
+    uint32_t bounds[TimingHistogram::BUCKETS];
+    uint32_t counts[TimingHistogram::BUCKETS];
+    for (int i = 0; i < TimingHistogram::BUCKETS; i++) {
+        bounds[i] = TimingHistogram::upperBound(i);
+        counts[i] = histogram.bucketCount(i);
+    }
+    out.histogram(name, help, bounds, counts, TimingHistogram::BUCKETS, histogram.sumUs());
+}
+
+void WebServer::handleLoopTiming(AsyncWebServerRequest* request) {
+    if (!loopTimer) {
+        request->send(503, "text/plain", "Loop timing not available");
+        return;
+    }
+    
+    char* text = new char[LOOP_REPORT_SIZE];
+    loopTimer->report(text, LOOP_REPORT_SIZE);
+    
+    // Report what was measured, then start over
+    if (request->hasParam("reset")) {
+        loopTimer->requestReset();
+    }
+    request->send(200, "text/plain", text);
+    delete[] text;
+}
+
+void WebServer::handleProfile(AsyncWebServerRequest* request) {
+    char* text = new char[PROFILE_REPORT_SIZE];
+    profileReport(text, PROFILE_REPORT_SIZE);
+    
+    if (request->hasParam("reset")) {
+        profileReset();
+    }
+    request->send(200, "text/plain", text);
+    delete[] text;
+}
+
+void WebServer::handleTrace(AsyncWebServerRequest* request) {
+    #if STEP_TRACE_ENABLED
+    if (request->hasParam("clear")) {
+        stepTrace.clear();
+        request->send(200, "text/plain", "Trace cleared");
+        return;
+    }
+    
+    // Recording stops while the events are sent, so none is overwritten
+    // halfway through the download
+    if (!stepTrace.freeze()) {
+        request->send(503, "text/plain", "Trace download in progress");
+        return;
+    }
+    
+    // Resume once everything is copied, or when the client goes away
+    // first; both run on the async_tcp task
+    std::shared_ptr<bool> released(new bool(false));
+    auto release = [released]() {
+        if (!*released) {
+            *released = true;
+            stepTrace.resume();
+        }
+    };
+    request->onDisconnect(release);
+    
+    AsyncWebServerResponse* response = request->beginResponse(
+        "application/octet-stream", stepTrace.dumpSize(),
+        [release](uint8_t* buffer, size_t maxLen, size_t index) -> size_t {
+            size_t length = stepTrace.read(buffer, maxLen, index);
+            if (index + length >= stepTrace.dumpSize()) {
+                release();
+            }
+            return length;
+        });
+    response->addHeader("Content-Disposition", "attachment; filename=\"steptrace.bin\"");
+    response->addHeader("Cache-Control", "no-store");
+    request->send(response);
+    #else
+    request->send(404, "text/plain", "Step trace disabled (STEP_TRACE_ENABLED)");
+    #endif
+}
+
+void WebServer::setLoopTimer(LoopTimer* timer) {
+    loopTimer = timer;
+}
+
+void WebServer::watchTask(const char* name, TaskHandle_t task) {
+    if (!task || watchedTaskCount >= METRICS_MAX_TASKS) {
+        return;
+    }
+    watchedTasks[watchedTaskCount].name = name;
+    watchedTasks[watchedTaskCount].handle = task;
+    watchedTaskCount++;
+}
+
+void WebServer::handleGCode(AsyncWebServerRequest* request) {
+    if (!request->hasParam("val")) {
+        request->send(400, "text/plain", "Missing parameters");
+        return;
+    }
+    if (!commandQueue) {
+        request->send(500, "text/plain", "Command queue not initialized");
+        return;
+    }
+    Metrics::increment(metrics.commandsReceived);
+    if (gcodePending) {
+        Metrics::increment(metrics.commandsRejected);
+        request->send(503, "text/plain", "busy");
+        return;
+    }
+    
+    const String& line = request->getParam("val")->value();
+    if (line.length() >= GCODE_LINE_MAX) {
+        request->send(400, "text/plain", "error: Line too long");
+        return;
+    }
+    
+    Command cmd;
+    GCodeInterpreter::Result result = gcode.execute(line.c_str(), cmd);
+    if (result == GCodeInterpreter::RESULT_ERROR) {
+        request->send(400, "text/plain", String("error: ") + gcode.getError());
+        return;
+    }
+    Metrics::increment(metrics.commandsParsed);
+    if (result == GCodeInterpreter::RESULT_COMMAND && !enqueueCommand(cmd)) {
+        // Not committed: the same line can be sent again
+        Metrics::increment(metrics.commandsRejected);
+        request->send(503, "text/plain", "busy");
+        return;
+    }
+    
+    gcode.commit();
+    request->send(200, "text/plain", "ok");
+}
+
 void WebServer::onWebSocketEvent(AsyncWebSocket* server, AsyncWebSocketClient* client,
                                  AwsEventType type, void* arg, uint8_t* data, size_t len) {
     if (type == WS_EVT_CONNECT) {
         Serial.printf("WebSocket client #%u connected from %s\n", 
                      client->id(), client->remoteIP().toString().c_str());
+        if (!sessions.open(client->id())) {
+            Serial.printf("WebSocket: No session slot for client #%u\n", client->id());
+        }
     } else if (type == WS_EVT_DISCONNECT) {
         Serial.printf("WebSocket client #%u disconnected\n", client->id());
+        sessions.close(client->id());
+        assembler.release(client->id());
+        if (pathDecoder.isActive() && pathClientId == client->id()) {
+            pathDecoder.abort();
+        }
     } else if (type == WS_EVT_DATA) {
-        // Parse incoming message
-        String message = String((char*)data);
-        Command cmd;
+        // A message may arrive over several events: large frames in
+        // pieces, fragmented messages frame by frame
+        AwsFrameInfo* info = (AwsFrameInfo*)arg;
+        bool messageStart = (info->num == 0 && info->index == 0);
+        bool messageEnd = info->final && (info->index + len == info->len);
+        uint8_t opcode = info->message_opcode;
+        
+        // PATH messages are large and arrive in pieces; they are decoded
+        // as they come instead of being assembled first
+        if (messageStart && opcode == WS_BINARY &&
+            len >= 2 && data[1] == BinaryProtocol::MSG_PATH) {
+            if (!beginPath(client)) {
+                return;
+            }
+        }
+        if (pathDecoder.isActive() && pathClientId == client->id()) {
+            handlePathData(client, data, len, messageEnd);
+            return;
+        }
         
-        if (parseCommand(message, cmd) && commandQueue) {
-            if (xQueueSend(commandQueue, &cmd, pdMS_TO_TICKS(100)) == pdTRUE) {
-                Serial.printf("WebSocket: Command received and queued\n");
+        uint8_t* message;
+        size_t messageLen;
+        MessageAssembler::Result assembled = assembler.feed(
+            client->id(), data, len, messageStart, messageEnd, message, messageLen);
+        
+        if (assembled == MessageAssembler::MESSAGE_DROPPED) {
+            Serial.printf("WebSocket: Message from #%u dropped (too large or no buffer)\n",
+                         client->id());
+            if (opcode == WS_BINARY) {
+                sendBinaryReply(client, BinaryProtocol::ERROR_BAD_LENGTH, false);
             } else {
-                Serial.println("WebSocket: WARNING - Command queue full!");
+                client->text("error: Message too large");
+            }
+            return;
+        }
+        if (assembled == MessageAssembler::MESSAGE_COMPLETE) {
+            handleMessage(client, opcode, message, messageLen);
+            assembler.release(client->id());
+        }
+    }
+}
+
+void WebServer::handleMessage(AsyncWebSocketClient* client, uint8_t opcode, uint8_t* message,
+                              size_t len) {
+    if (opcode == WS_BINARY) {
+        handleBinaryMessage(client, message, len);
+        return;
+    }
+    
+    if (len > 0 && message[0] != '{') {
+        handleGCodeText(client, message, len);
+        return;
+    }
+    
+    Metrics::increment(metrics.commandsReceived);
+    Command cmd;
+    if (parseCommand((char*)message, len, cmd, sessions.find(client->id()))) {
+        submitCommand(client, cmd, false);
+    }
+}
+
+void WebServer::handleGCodeText(AsyncWebSocketClient* client, const uint8_t* data,
+                                size_t len) {
+    if (!gcodePending) {
+        gcodeCancel = false;  // Any STOP before this message was handled
+        runGCodeLines(client->id(), data, len);
+        return;
+    }
+    
+    // The sender must wait for the held line's "ok" before the next
+    GCodeLineBuffer line;
+    for (size_t i = 0; i <= len; i++) {
+        char c = (i < len) ? (char)data[i] : '\n';
+        if (line.feed(c)) {
+            Metrics::increment(metrics.commandsReceived);
+            Metrics::increment(metrics.commandsRejected);
+            client->text("error: busy");
+        }
+    }
+}
+
+bool WebServer::runGCodeLines(uint32_t clientId, const uint8_t* data, size_t len) {
+    GCodeLineBuffer line;
+    Command cmd;
+    char reply[64];
+    
+    for (size_t i = 0; i <= len; i++) {
+        // The end of the message also ends its last line
+        char c = (i < len) ? (char)data[i] : '\n';
+        if (!line.feed(c)) {
+            continue;
+        }
+        
+        Metrics::increment(metrics.commandsReceived);
+        
+        if (gcodeCancel) {
+            // STOP arrived while poll() was running the rest of a message
+            ws->text(clientId, "error: stopped");
+            continue;
+        }
+        if (line.overflowed()) {
+            ws->text(clientId, "error: Line too long");
+            continue;
+        }
+        
+        GCodeInterpreter::Result result = gcode.execute(line.line(), cmd);
+        if (result == GCodeInterpreter::RESULT_ERROR) {
+            snprintf(reply, sizeof(reply), "error: %s", gcode.getError());
+            ws->text(clientId, reply);
+            continue;
+        }
+        Metrics::increment(metrics.commandsParsed);
+        
+        if (result == GCodeInterpreter::RESULT_COMMAND && !enqueueCommand(cmd)) {
+            // Acknowledged by poll() once the planner makes room; the
+            // lines after it wait with it (data may be gcodeRemainder)
+            size_t rest = (i < len) ? len - i - 1 : 0;
+            memmove(gcodeRemainder, data + len - rest, rest);
+            gcodeRemainderLength = rest;
+            pendingGCode = cmd;
+            pendingGCodeClient = clientId;
+            gcodePending = true;
+            return true;
+        }
+        
+        gcode.commit();
+        ws->text(clientId, "ok");
+    }
+    return false;
+}
+
+void WebServer::poll() {
+    if (!gcodePending || !commandQueue) {
+        return;
+    }
+    if (gcodeCancel.exchange(false)) {
+        // Nothing queued before a STOP may run after it: the held line
+        // and every line after it are answered without running
+        if (ws) {
+            ws->text(pendingGCodeClient, "error: stopped");
+            GCodeLineBuffer line;
+            for (size_t i = 0; i <= gcodeRemainderLength; i++) {
+                char c = (i < gcodeRemainderLength) ? (char)gcodeRemainder[i] : '\n';
+                if (line.feed(c)) {
+                    ws->text(pendingGCodeClient, "error: stopped");
+                }
             }
         }
+        gcodeRemainderLength = 0;
+        gcodePending = false;
+        return;
+    }
+    if (xQueueSend(commandQueue, &pendingGCode, 0) != pdTRUE) {
+        return;
+    }
+    
+    gcode.commit();
+    if (ws) {
+        ws->text(pendingGCodeClient, "ok");
+    }
+    
+    // Run the rest of the message, still refusing new ones meanwhile; the
+    // first line that finds the queue full again is held in turn
+    size_t rest = gcodeRemainderLength;
+    gcodeRemainderLength = 0;
+    if (rest == 0 || !ws || !runGCodeLines(pendingGCodeClient, gcodeRemainder, rest)) {
+        gcodePending = false;
+    }
+}
+
+void WebServer::handleBinaryMessage(AsyncWebSocketClient* client, const uint8_t* data,
+                                    size_t len) {
+    uint8_t reply[BinaryProtocol::MAX_FRAME_SIZE];
+    size_t replyLen;
+    
+    Metrics::increment(metrics.commandsReceived);
+    FrameHeader header;
+    BinaryProtocol::Result result = BinaryProtocol::readHeader(data, len, header);
+    
+    if (result == BinaryProtocol::OK && header.type == BinaryProtocol::MSG_HELLO) {
+        Metrics::increment(metrics.commandsParsed);
+        ClientSession* session = sessions.find(client->id());
+        if (session) {
+            session->requestBinaryFormat();  // Next status is a full one, in binary
+            Serial.printf("WebSocket client #%u switched to binary v%u\n",
+                         client->id(), header.version);
+        }
+        replyLen = BinaryProtocol::encodeHello(reply, sizeof(reply));
+        client->binary(reply, replyLen);
+        return;
+    }
+    
+    if (result == BinaryProtocol::OK && header.type == BinaryProtocol::MSG_SET_RATE) {
+        uint16_t intervalMs;
+        result = BinaryProtocol::decodeSetRate(data, len, intervalMs);
+        ClientSession* session = sessions.find(client->id());
+        if (result == BinaryProtocol::OK && session) {
+            Metrics::increment(metrics.commandsParsed);
+            session->requestTelemetryInterval(intervalMs);
+            return;  // Not a command: no ACK
+        }
     }
+    
+    Command cmd;
+    if (result == BinaryProtocol::OK) {
+        result = BinaryProtocol::decodeCommand(data, len, cmd);
+    }
+    
+    if (result != BinaryProtocol::OK) {
+        Serial.printf("WebSocket: Bad binary frame (error %d)\n", (int)result);
+        sendBinaryReply(client, result, false);
+        return;
+    }
+    
+    Metrics::increment(metrics.commandsParsed);
+    submitCommand(client, cmd, true);
 }
 
-bool WebServer::parseCommand(const String& json, Command& cmd) {
-    // Simple JSON parsing (could use ArduinoJson for more complex cases)
+bool WebServer::beginPath(AsyncWebSocketClient* client) {
+    Metrics::increment(metrics.commandsReceived);
+    if (pathDecoder.isActive()) {
+        // Another client is uploading; this message is ignored
+        Serial.printf("WebSocket: Path upload from #%u refused, #%u is uploading\n",
+                     client->id(), pathClientId);
+        Metrics::increment(metrics.commandsRejected);
+        sendBinaryReply(client, BinaryProtocol::OK, false);
+        return false;
+    }
+    if (!pathBuffer || availableCredits() == 0) {
+        Metrics::increment(metrics.commandsRejected);
+        sendBinaryReply(client, BinaryProtocol::OK, false);
+        return false;
+    }
+    
+    pathClientId = client->id();
+    pathDecoder.begin(pathBuffer, nextPathId++);
+    return true;
+}
+
+void WebServer::handlePathData(AsyncWebSocketClient* client, const uint8_t* data, size_t len,
+                               bool messageEnd) {
+    BinaryProtocol::Result result = pathDecoder.feed(data, len);
+    if (result != BinaryProtocol::OK) {
+        pathDecoder.abort();  // Take back whatever it wrote
+    }
+    
+    if (result == BinaryProtocol::ERROR_NO_ROOM) {
+        // Not an error: the client sent more than advertised and resends
+        sendBinaryReply(client, BinaryProtocol::OK, false);
+        return;
+    }
+    if (result != BinaryProtocol::OK) {
+        Serial.printf("WebSocket: Bad PATH message (error %d)\n", (int)result);
+        sendBinaryReply(client, result, false);
+        return;
+    }
+    
+    if (messageEnd && !pathDecoder.isComplete()) {
+        // The header promised more vertices than the message carried
+        pathDecoder.abort();
+        sendBinaryReply(client, BinaryProtocol::ERROR_TRUNCATED, false);
+        return;
+    }
+    
+    if (pathDecoder.isComplete()) {
+        Command cmd(Command::PATH, Point2D(0, 0), pathDecoder.getSpeed());
+        cmd.pathId = pathDecoder.getPathId();
+        cmd.pathLength = pathDecoder.getVertexCount();
+        
+        Metrics::increment(metrics.commandsParsed);
+        
+        // Without its command the upload is taken back, or its vertices
+        // would hold the buffer until a later path drained them
+        bool queued = commandQueue && enqueueCommand(cmd);
+        if (!queued) {
+            pathDecoder.abort();
+            Metrics::increment(metrics.commandsRejected);
+            Serial.println("WebSocket: PATH rejected, no credits left");
+        }
+        sendBinaryReply(client, BinaryProtocol::OK, queued);
+    }
+}
+
+void WebServer::sendBinaryReply(AsyncWebSocketClient* client, BinaryProtocol::Result result,
+                                bool queued) {
+    uint8_t reply[BinaryProtocol::MAX_FRAME_SIZE];
+    size_t replyLen;
+    if (result != BinaryProtocol::OK) {
+        replyLen = BinaryProtocol::encodeError(result, reply, sizeof(reply));
+    } else {
+        replyLen = BinaryProtocol::encodeCredits(
+            queued ? BinaryProtocol::MSG_ACK : BinaryProtocol::MSG_BUSY,
+            availableCredits(), availablePathSpace(), reply, sizeof(reply));
+    }
+    client->binary(reply, replyLen);
+}
+
+void WebServer::submitCommand(AsyncWebSocketClient* client, const Command& cmd, bool binary) {
+    if (!commandQueue) {
+        return;
+    }
+    
+    // Every command gets an ACK carrying the remaining credits, so
+    // a streaming client knows when to pause and when to resend.
+    bool queued = enqueueCommand(cmd);
+    if (!queued) {
+        Metrics::increment(metrics.commandsRejected);
+        Serial.println("WebSocket: Command rejected, no credits left");
+    }
+    
+    if (binary) {
+        sendBinaryReply(client, BinaryProtocol::OK, queued);
+    } else {
+        char ack[64];
+        snprintf(ack, sizeof(ack), "{\"type\":\"%s\",\"credits\":%d}",
+                 queued ? "ACK" : "BUSY", availableCredits());
+        client->text(ack);
+    }
+}
+
+bool WebServer::parseCommand(char* json, size_t len, Command& cmd, ClientSession* session) {
+    PROFILE_SCOPE("WebServer::parseCommand");
+    
     // Expected format: {"type":"MOVE_TO","x":100,"y":50,"speed":50}
+    // Parsed in place (zero-copy): strings in doc point into json, so the
+    // document only needs room for the object itself
     
-    DynamicJsonDocument doc(1024);
-    DeserializationError error = deserializeJson(doc, json);
+    StaticJsonDocument<256> doc;
+    DeserializationError error = deserializeJson(doc, json, len);
     
     if (error) {
         Serial.printf("JSON parse error: %s\n", error.c_str());
         return false;
     }
     
-    String typeStr = doc["type"] | "MOVE_TO";
+    const char* type = doc["type"] | "MOVE_TO";
     
-    if (typeStr == "MOVE_TO") {
+    if (strcmp(type, "MOVE_TO") == 0) {
         float x = doc["x"] | 0.0f;
         float y = doc["y"] | 0.0f;
         float speed = doc["speed"] | DEFAULT_SPEED;
         cmd = Command(Command::MOVE_TO, Point2D(x, y), speed);
-    } else if (typeStr == "HOME") {
+    } else if (strcmp(type, "HOME") == 0) {
         cmd = Command(Command::HOME, Point2D(0, 0));
-    } else if (typeStr == "STOP") {
+    } else if (strcmp(type, "STOP") == 0) {
         cmd = Command(Command::STOP, Point2D(0, 0));
+    } else if (strcmp(type, "RATE") == 0) {
+        // Status rate request: {"type":"RATE","intervalMs":250}
+        if (session) {
+            session->requestTelemetryInterval(doc["intervalMs"] | 0);
+        }
+        Metrics::increment(metrics.commandsParsed);
+        return false;
     } else {
         return false;
     }
     
+    Metrics::increment(metrics.commandsParsed);
     return true;
 }
 
+bool WebServer::enqueueCommand(const Command& cmd) {
+    if (cmd.type == Command::STOP) {
+        // Pending commands are meaningless once stopped, and a full queue
+        // must never delay an emergency stop.
+        if (gcodePending) {
+            gcodeCancel = true;
+        }
+        if (pathBuffer) {
+            // Flushed PATHs leave their vertices behind; the planner drops
+            // them on this STOP. An upload still arriving is kept.
+            pathBuffer->abandonBefore(pathDecoder.isActive() ? pathDecoder.getPathId()
+                                                              : nextPathId);
+        }
+        xQueueReset(commandQueue);
+        return xQueueSendToFront(commandQueue, &cmd, 0) == pdTRUE;
+    }
+    
+    // Never block here: the caller runs on the async TCP task, and the
+    // client is told how many credits remain instead.
+    return xQueueSend(commandQueue, &cmd, 0) == pdTRUE;
+}
+
+int WebServer::availableCredits() {
+    if (!commandQueue) return 0;
+    return (int)uxQueueSpacesAvailable(commandQueue);
+}
+
+int WebServer::availablePathSpace() {
+    if (!pathBuffer) return 0;
+    return pathBuffer->available();
+}
+
 void WebServer::broadcastStatus(const RobotState& state) {
+    PROFILE_SCOPE("WebServer::broadcastStatus");
     if (!ws) return;
     
-    // Create JSON status message
-    DynamicJsonDocument doc(512);
-    doc["x"] = state.currentPosition.x;
-    doc["y"] = state.currentPosition.y;
-    doc["theta1"] = state.currentAngles.theta1;
-    doc["theta2"] = state.currentAngles.theta2;
-    doc["isMoving"] = state.isMoving;
-    doc["isHomed"] = state.isHomed;
+    StatusFrame status;
+    status.position = state.currentPosition;
+    status.angles = state.currentAngles;
+    status.isMoving = state.isMoving;
+    status.isHomed = state.isHomed;
+    status.credits = (uint16_t)availableCredits();
+    status.ttfsUs = state.firstStepLatency.lastUs;
+    status.ttfsMaxUs = state.firstStepLatency.maxUs;
+    status.pathSpace = (uint16_t)availablePathSpace();
     
-    String json;
-    serializeJson(doc, json);
+    uint32_t now = millis();
+    String json;  // Built on first use, shared by all JSON clients
     
-    ws->textAll(json);
+    for (int i = 0; i < ClientSessionTable::capacity(); i++) {
+        ClientSession& session = sessions.at(i);
+        if (!session.inUse) {
+            continue;
+        }
+        AsyncWebSocketClient* client = ws->client(session.clientId);
+        if (!client) {
+            continue;
+        }
+        
+        // A format switch comes with its reset, so the first status in the
+        // new format is a full one
+        session.applyTelemetryRequests();
+        
+        // A client still draining earlier messages is skipped; its next
+        // message carries everything that changed meanwhile.
+        bool backlogged = client->queueLen() >= TELEMETRY_MAX_QUEUED;
+        uint16_t mask;
+        TelemetryChannel::Decision decision =
+            session.telemetry.poll(status, now, backlogged, mask);
+        if (decision == TelemetryChannel::SEND_NONE) {
+            continue;
+        }
+        
+        if (session.format == ClientSession::FORMAT_BINARY) {
+            uint8_t frame[BinaryProtocol::MAX_FRAME_SIZE];
+            size_t frameLen = (decision == TelemetryChannel::SEND_FULL)
+                ? BinaryProtocol::encodeStatus(status, frame, sizeof(frame))
+                : BinaryProtocol::encodeStatusDelta(status, mask, frame, sizeof(frame));
+            client->binary(frame, frameLen);
+            session.telemetry.sent(status, mask, now);
+            continue;
+        }
+        
+        // JSON clients (debugging, older pages) always get every field
+        if (json.length() == 0) {
+            DynamicJsonDocument doc(512);
+            doc["x"] = status.position.x;
+            doc["y"] = status.position.y;
+            doc["theta1"] = status.angles.theta1;
+            doc["theta2"] = status.angles.theta2;
+            doc["isMoving"] = status.isMoving;
+            doc["isHomed"] = status.isHomed;
+            doc["credits"] = status.credits;
+            doc["ttfsUs"] = status.ttfsUs;
+            doc["ttfsMaxUs"] = status.ttfsMaxUs;
+            serializeJson(doc, json);
+        }
+        client->text(json);
+        session.telemetry.sent(status, BinaryProtocol::FIELD_ALL, now);
+    }
 }
 
 void WebServer::cleanup() {
@@ -9,6 +9,15 @@
 #include <freertos/task.h>
 #include <freertos/queue.h>
 #include "../core/Types.h"
+#include "ClientSession.h"
+#include "BinaryProtocol.h"
+#include "MessageAssembler.h"
+#include "HttpCache.h"
+#include "Prometheus.h"
+#include "../core/PathBuffer.h"
+#include "../core/GCode.h"
+#include "../core/LoopTiming.h"
+#include <atomic>
 
 /**
  * @file WebServer.h
@@ -16,8 +25,20 @@
  * 
  * Handles HTTP requests and WebSocket connections for the web UI.
  * Parses incoming commands and pushes them to the command queue.
+ * Clients talk JSON text frames unless they negotiate the binary
+ * protocol (BinaryProtocol.h) by sending a binary HELLO frame. Text
+ * frames that are not JSON are G-code lines, as is /gcode?val=.
+ * 
+ * The UI (data/, see web_assets.h) is always sent gzipped with an ETag,
+ * from LittleFS when the filesystem image holds it. /metrics exports the
+ * counters of Metrics.h, task stacks, heap, CPU load and the motion loop
+ * timing for Prometheus; /loop prints the loop timing and /profile the
+ * PROFILE_SCOPE table (?reset=1 clears either after printing it).
+ * /trace downloads the step trace (StepTrace.h; ?clear=1 empties it).
  */
 
+struct WebAsset;
+
 class WebServer {
 private:
     AsyncWebServer* server;
@@ -26,18 +47,107 @@ private:
     // Command queue reference (FreeRTOS queue)
     QueueHandle_t commandQueue;
     
+    // Negotiated format and telemetry state of each connected client
+    ClientSessionTable sessions;
+    
+    // Messages that arrive in several pieces are collected here
+    MessageAssembler assembler;
+    
+    // Static assets and where each is served from
+    struct ServedAsset {
+        const WebAsset* asset;
+        bool onFilesystem;                  // LittleFS holds path + ".gz"
+        char etag[HttpCache::ETAG_SIZE];
+    };
+    ServedAsset* assets;
+    int assetCount;
+    
+    // Tasks whose stack high-water mark /metrics reports
+    struct WatchedTask {
+        const char* name;
+        TaskHandle_t handle;
+    };
+    WatchedTask watchedTasks[METRICS_MAX_TASKS];
+    int watchedTaskCount;
+    
+    // Motion loop timing (owned by the motion task)
+    LoopTimer* loopTimer;
+    
+    // Bulk path uploads (one client at a time: vertices of an upload
+    // must be contiguous in the shared buffer)
+    PathBuffer* pathBuffer;
+    PathStreamDecoder pathDecoder;
+    uint32_t pathClientId;
+    uint16_t nextPathId;
+    
+    // G-code from the WebSocket and /gcode. A line that finds the command
+    // queue full is held here, with the rest of its message, and
+    // acknowledged by poll() once queued; poll() then runs the rest. The
+    // async TCP task only touches the interpreter while nothing is pending.
+    GCodeInterpreter gcode;
+    Command pendingGCode;
+    uint32_t pendingGCodeClient;
+    uint8_t gcodeRemainder[WS_MESSAGE_MAX];   // Lines after the held one
+    size_t gcodeRemainderLength;
+    std::atomic<bool> gcodePending;
+    std::atomic<bool> gcodeCancel;   // STOP received: drop the held line
+    
     // WebSocket message handler
     void onWebSocketEvent(AsyncWebSocket* server, AsyncWebSocketClient* client,
                          AwsEventType type, void* arg, uint8_t* data, size_t len);
     
+    // Find each asset on LittleFS (or fall back to flash) and hash it
+    void loadAssets();
+    
     // HTTP route handlers
     void handleRoot(AsyncWebServerRequest* request);
+    void handleAsset(AsyncWebServerRequest* request, const ServedAsset& served);
     void handleMove(AsyncWebServerRequest* request);
     void handleHome(AsyncWebServerRequest* request);
     void handleStatus(AsyncWebServerRequest* request);
+    void handleGCode(AsyncWebServerRequest* request);
+    void handleMetrics(AsyncWebServerRequest* request);
+    void handleLoopTiming(AsyncWebServerRequest* request);
+    void handleProfile(AsyncWebServerRequest* request);
+    void handleTrace(AsyncWebServerRequest* request);
+    
+    // Export one loop timing histogram in Prometheus format
+    static void writeHistogram(PrometheusWriter& out, const char* name, const char* help,
+                               const TimingHistogram& histogram);
+    
+    // Handle a complete WebSocket message (binary frame, JSON or G-code)
+    void handleMessage(AsyncWebSocketClient* client, uint8_t opcode, uint8_t* message,
+                       size_t len);
+    
+    // Parse a JSON command in place; json is modified (a RATE request is
+    // applied to the session and returns false: nothing to queue)
+    bool parseCommand(char* json, size_t len, Command& cmd, ClientSession* session);
+    
+    // Handle a binary protocol frame (HELLO or a command)
+    void handleBinaryMessage(AsyncWebSocketClient* client, const uint8_t* data, size_t len);
+    
+    // Queue a parsed command and answer ACK/BUSY in the client's format
+    void submitCommand(AsyncWebSocketClient* client, const Command& cmd, bool binary);
+    
+    // Start a PATH upload (false if refused with BUSY), then feed it
+    // piece by piece as it arrives
+    bool beginPath(AsyncWebSocketClient* client);
+    void handlePathData(AsyncWebSocketClient* client, const uint8_t* data, size_t len,
+                        bool messageEnd);
+    
+    // Run the G-code lines of a WebSocket text message
+    void handleGCodeText(AsyncWebSocketClient* client, const uint8_t* data, size_t len);
+    
+    // Run and acknowledge G-code lines until one finds the command queue
+    // full; that one and the lines after it are held (returns true)
+    bool runGCodeLines(uint32_t clientId, const uint8_t* data, size_t len);
+    
+    // Answer a binary client with ACK/BUSY (or ERROR for other results)
+    void sendBinaryReply(AsyncWebSocketClient* client, BinaryProtocol::Result result, bool queued);
     
-    // Parse JSON command
-    bool parseCommand(const String& json, Command& cmd);
+    // Push a command without blocking the async TCP task.
+    // STOP jumps ahead of (and discards) any pending commands.
+    bool enqueueCommand(const Command& cmd);
     
 public:
     WebServer();
@@ -46,8 +156,28 @@ public:
     /**
      * @brief Initialize the web server
      * @param cmdQueue FreeRTOS queue handle for incoming commands
+     * @param paths Ring receiving uploaded PATH vertices (consumed by the
+     *              planner on Command::PATH)
      */
-    void init(QueueHandle_t cmdQueue);
+    void init(QueueHandle_t cmdQueue, PathBuffer* paths);
+    
+    /**
+     * @brief Set the G-code position after G28 and the current position
+     */
+    void setGCodeHome(const Point2D& homePosition, const Point2D& position);
+    
+    /**
+     * @brief Report a task's stack high-water mark on /metrics
+     * @param name Label value (task name)
+     * @param task Task handle (ignored if null, or if METRICS_MAX_TASKS
+     *             tasks are already watched)
+     */
+    void watchTask(const char* name, TaskHandle_t task);
+    
+    /**
+     * @brief Export the motion loop timing on /metrics and /loop
+     */
+    void setLoopTimer(LoopTimer* timer);
     
     /**
      * @brief Start the web server (call after WiFi is connected)
@@ -55,11 +185,34 @@ public:
     void begin();
     
     /**
-     * @brief Broadcast robot status to all WebSocket clients
+     * @brief Queue a held G-code line once there is room, acknowledge it
+     * and run the lines that followed it in the same message
+     * Call often (every few milliseconds) from a task.
+     */
+    void poll();
+    
+    /**
+     * @brief Send the robot status to the clients that are due for it
+     * Clients only get a message when the status changed and their
+     * interval has elapsed (see Telemetry.h). Called by the telemetry
+     * task every TELEMETRY_TASK_PERIOD_MS, never from the motion task.
      * @param state Current robot state
      */
     void broadcastStatus(const RobotState& state);
     
+    /**
+     * @brief Number of commands the controller can accept right now
+     * Clients streaming large jobs should not send more commands than
+     * this; it is advertised in every status broadcast and ACK.
+     * @return Free slots in the command queue
+     */
+    int availableCredits();
+    
+    /**
+     * @brief Largest PATH upload (in vertices) accepted right now
+     */
+    int availablePathSpace();
+    
     /**
      * @brief Cleanup WebSocket clients (call in loop)
      */
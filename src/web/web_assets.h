@@ -5,191 +5,191 @@
 
 /**
  * @file web_assets.h
- * @brief Web UI assets stored in PROGMEM
+ * @brief Gzipped web UI built into the firmware
  * 
- * HTML, CSS, and JavaScript for the robot control interface.
- * Stored as PROGMEM strings to save RAM.
+ * Generated from data/ by tools/compress_assets.py - do not edit,
+ * change the files in data/ instead. Served when the LittleFS image
+ * does not hold an asset.
  */
 
-// Simple web interface HTML
-const char WEB_HTML[] PROGMEM = R"rawliteral(
-<!DOCTYPE html>
-<html>
-<head>
-    <meta charset="UTF-8">
-    <title>SCARA Robot Controller</title>
-    <meta name="viewport" content="width=device-width, initial-scale=1">
-    <style>
-        body {
-            font-family: Arial, sans-serif;
-            margin: 20px;
-            background: #f0f0f0;
-        }
-        .container {
-            max-width: 800px;
-            margin: 0 auto;
-            background: white;
-            padding: 20px;
-            border-radius: 10px;
-            box-shadow: 0 2px 10px rgba(0,0,0,0.1);
-        }
-        h1 {
-            color: #333;
-            text-align: center;
-        }
-        .control-panel {
-            display: grid;
-            grid-template-columns: 1fr 1fr;
-            gap: 20px;
-            margin: 20px 0;
-        }
-        .control-group {
-            padding: 15px;
-            background: #f9f9f9;
-            border-radius: 5px;
-        }
-        label {
-            display: block;
-            margin-bottom: 5px;
-            font-weight: bold;
-        }
-        input[type="number"] {
-            width: 100%;
-            padding: 8px;
-            margin-bottom: 10px;
-            border: 1px solid #ddd;
-            border-radius: 4px;
-        }
-        button {
-            width: 100%;
-            padding: 10px;
-            background: #4CAF50;
-            color: white;
-            border: none;
-            border-radius: 4px;
-            cursor: pointer;
-            font-size: 16px;
-        }
-        button:hover {
-            background: #45a049;
-        }
-        button.stop {
-            background: #f44336;
-        }
-        button.stop:hover {
-            background: #da190b;
-        }
-        .status {
-            margin-top: 20px;
-            padding: 15px;
-            background: #e3f2fd;
-            border-radius: 5px;
-        }
-        .status-item {
-            margin: 5px 0;
-        }
-    </style>
-</head>
-<body>
-    <div class="container">
-        <h1>SCARA Robot Controller</h1>
-        
-        <div class="control-panel">
-            <div class="control-group">
-                <h3>Position Control</h3>
-                <label>X (mm):</label>
-                <input type="number" id="x" value="150" step="0.1">
-                <label>Y (mm):</label>
-                <input type="number" id="y" value="150" step="0.1">
-                <label>Speed (mm/s):</label>
-                <input type="number" id="speed" value="50" step="1" min="1" max="100">
-                <button onclick="moveTo()">Move To Position</button>
-            </div>
-            
-            <div class="control-group">
-                <h3>Actions</h3>
-                <button onclick="home()">Home Robot</button>
-                <button class="stop" onclick="stop()">Emergency Stop</button>
-            </div>
-        </div>
-        
-        <div class="status" id="status">
-            <h3>Status</h3>
-            <div class="status-item">Position: <span id="pos">-</span></div>
-            <div class="status-item">Angles: <span id="angles">-</span></div>
-            <div class="status-item">Moving: <span id="moving">-</span></div>
-        </div>
-    </div>
-    
-    <script>
-        let ws = null;
-        
-        function connectWebSocket() {
-            const protocol = window.location.protocol === 'https:' ? 'wss:' : 'ws:';
-            const wsUrl = protocol + '//' + window.location.hostname + '/ws';
-            ws = new WebSocket(wsUrl);
-            
-            ws.onopen = function() {
-                console.log('WebSocket connected');
-            };
-            
-            ws.onmessage = function(event) {
-                const data = JSON.parse(event.data);
-                updateStatus(data);
-            };
-            
-            ws.onerror = function(error) {
-                console.error('WebSocket error:', error);
-            };
-            
-            ws.onclose = function() {
-                console.log('WebSocket closed, reconnecting...');
-                setTimeout(connectWebSocket, 1000);
-            };
-        }
-        
-        function moveTo() {
-            const x = parseFloat(document.getElementById('x').value);
-            const y = parseFloat(document.getElementById('y').value);
-            const speed = parseFloat(document.getElementById('speed').value);
-            
-            fetch(`/move?x=${x}&y=${y}&speed=${speed}`)
-                .then(response => response.text())
-                .then(data => console.log('Move command sent:', data));
-        }
-        
-        function home() {
-            fetch('/home')
-                .then(response => response.text())
-                .then(data => console.log('Home command sent:', data));
-        }
-        
-        function stop() {
-            if (ws && ws.readyState === WebSocket.OPEN) {
-                ws.send(JSON.stringify({type: 'STOP'}));
-            }
-        }
-        
-        function updateStatus(data) {
-            document.getElementById('pos').textContent = 
-                `(${data.x.toFixed(2)}, ${data.y.toFixed(2)})`;
-            document.getElementById('angles').textContent = 
-                `θ₁: ${data.theta1.toFixed(2)}°, θ₂: ${data.theta2.toFixed(2)}°`;
-            document.getElementById('moving').textContent = data.isMoving ? 'Yes' : 'No';
-        }
-        
-        // Connect on page load
-        connectWebSocket();
-        
-        // Poll status every second
-        setInterval(() => {
-            fetch('/status')
-                .then(response => response.json())
-                .then(data => console.log('Status:', data));
-        }, 1000);
-    </script>
-</body>
-</html>
-)rawliteral";
+struct WebAsset {
+    const char* path;          // URL path (LittleFS holds path + ".gz")
+    const char* contentType;
+    const uint8_t* gzip;       // Compressed content (PROGMEM)
+    size_t gzipLength;
+};
+
+// /index.html (9390 bytes, 2622 gzipped)
+const uint8_t WEB_INDEX_HTML_GZ[] PROGMEM = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0xff, 0xb5, 0x5a, 0xdd, 0x72, 0xda, 0x48,
+    0x16, 0xbe, 0xcf, 0x53, 0x74, 0x98, 0xd9, 0x20, 0x2a, 0x20, 0x10, 0x10, 0x97, 0x83, 0xc1, 0x53,
+    0x8e, 0x83, 0x77, 0xb2, 0xeb, 0xc4, 0x2e, 0x83, 0x67, 0x37, 0xe5, 0x4a, 0x4d, 0x1a, 0xa9, 0x05,
+    0x1a, 0x4b, 0x6a, 0x95, 0xba, 0x31, 0xb0, 0x19, 0x2e, 0x76, 0x9e, 0x68, 0x2f, 0xf7, 0x7a, 0x1f,
+    0x60, 0x1f, 0x62, 0x9f, 0x64, 0x4f, 0x77, 0x0b, 0x81, 0xa4, 0x16, 0xc6, 0x9e, 0x5d, 0x5c, 0x13,
+    0xa4, 0xfe, 0x39, 0xff, 0xe7, 0x3b, 0xa7, 0x9b, 0xe9, 0xbf, 0x7c, 0x7f, 0x75, 0x3e, 0xfe, 0x7c,
+    0x3d, 0x44, 0x33, 0x1e, 0xf8, 0xa7, 0x2f, 0xfa, 0x9b, 0x2f, 0x82, 0x9d, 0xd3, 0x17, 0x08, 0x3e,
+    0xfd, 0x80, 0x70, 0x8c, 0xec, 0x19, 0x8e, 0x19, 0xe1, 0x83, 0xca, 0xed, 0xf8, 0xa2, 0x71, 0x5c,
+    0x49, 0xa6, 0xb8, 0xc7, 0x7d, 0x72, 0x3a, 0x3a, 0x3f, 0xbb, 0x39, 0x43, 0x37, 0x74, 0x42, 0x39,
+    0x3a, 0xa7, 0x21, 0x8f, 0xa9, 0xef, 0x93, 0xb8, 0xdf, 0x54, 0xb3, 0x3b, 0x44, 0x42, 0x1c, 0x90,
+    0x41, 0xe5, 0xc1, 0x23, 0x8b, 0x88, 0xc6, 0xbc, 0x82, 0x6c, 0x58, 0x4c, 0x42, 0x20, 0xba, 0xf0,
+    0x1c, 0x3e, 0x1b, 0x38, 0xe4, 0xc1, 0xb3, 0x49, 0x43, 0xbe, 0xd4, 0x91, 0x17, 0x7a, 0xdc, 0xc3,
+    0x7e, 0x83, 0xd9, 0xd8, 0x27, 0x03, 0x6b, 0xc3, 0x92, 0xf1, 0xd5, 0x86, 0xa8, 0xf8, 0x4c, 0xa8,
+    0xb3, 0x42, 0xdf, 0xd2, 0x57, 0xf1, 0x71, 0x81, 0x6a, 0xc3, 0xc5, 0x81, 0xe7, 0xaf, 0x7a, 0xe8,
+    0x2c, 0x06, 0x1a, 0x75, 0xc4, 0x70, 0xc8, 0x1a, 0x8c, 0xc4, 0x9e, 0x7b, 0x92, 0x59, 0x1b, 0xe0,
+    0x78, 0xea, 0x85, 0x3d, 0xd4, 0x6e, 0x45, 0xcb, 0xec, 0xcc, 0x04, 0xdb, 0xf7, 0xd3, 0x98, 0xce,
+    0x43, 0xa7, 0x87, 0xbe, 0x73, 0x5b, 0xe2, 0x6f, 0xbb, 0x60, 0x9d, 0x3e, 0x99, 0x42, 0x07, 0xec,
+    0x85, 0x24, 0xce, 0x49, 0x11, 0xe0, 0xa5, 0xd2, 0xa4, 0x87, 0x8e, 0x5b, 0x05, 0xea, 0x1b, 0xbe,
+    0x2d, 0x84, 0xe7, 0x9c, 0x96, 0x73, 0x5e, 0xcc, 0x3c, 0x4e, 0xb2, 0xd3, 0x11, 0x76, 0x1c, 0x2f,
+    0x9c, 0x6a, 0x65, 0xa6, 0xb1, 0x43, 0xe2, 0x46, 0x8c, 0x1d, 0x6f, 0xce, 0x7a, 0xc8, 0xd2, 0x2c,
+    0x58, 0x36, 0xd8, 0x0c, 0x3b, 0x74, 0x21, 0x58, 0xb7, 0xa3, 0xa5, 0x5c, 0x83, 0xe2, 0xe9, 0x04,
+    0x1b, 0xad, 0xba, 0xfc, 0x33, 0xad, 0x9a, 0x4e, 0xcf, 0x99, 0x95, 0xd3, 0xcf, 0xa6, 0x3e, 0x8d,
+    0xc1, 0x34, 0x9d, 0x4e, 0x27, 0xcb, 0x83, 0x93, 0x25, 0x6f, 0x60, 0xdf, 0x9b, 0x82, 0x7a, 0x36,
+    0x78, 0x97, 0xc4, 0xa5, 0x76, 0x83, 0x40, 0x69, 0x44, 0x38, 0x24, 0x7e, 0x8e, 0xb6, 0xe3, 0xb1,
+    0xc8, 0xc7, 0xe0, 0xbd, 0x69, 0xec, 0x39, 0x59, 0xea, 0x62, 0xa4, 0xc1, 0x49, 0x00, 0xf3, 0x9c,
+    0x34, 0x40, 0x88, 0x79, 0x10, 0x0a, 0x55, 0xdd, 0x58, 0xfc, 0x97, 0x5b, 0x8b, 0x23, 0x9d, 0x95,
+    0x76, 0x7d, 0x8e, 0x5a, 0x7b, 0x85, 0x13, 0x6e, 0x88, 0x72, 0xc2, 0xa5, 0xf6, 0xb7, 0xde, 0xec,
+    0x8f, 0x99, 0xb7, 0xe2, 0x6f, 0xaf, 0x83, 0x32, 0x04, 0xb6, 0xec, 0x7d, 0x3c, 0x29, 0x37, 0xc9,
+    0xc4, 0xa7, 0xf6, 0xbd, 0x4e, 0xa1, 0x06, 0xa4, 0x1f, 0xa7, 0x41, 0x8e, 0x6a, 0x9a, 0x10, 0x0b,
+    0xe2, 0x4d, 0x67, 0x1c, 0xf6, 0x53, 0xdf, 0xd1, 0x31, 0xf5, 0xc2, 0x68, 0xce, 0xef, 0xf8, 0x2a,
+    0x82, 0x0c, 0x0d, 0xe7, 0xc1, 0x84, 0xc4, 0x95, 0x2f, 0x39, 0x19, 0x92, 0x70, 0xb6, 0x5a, 0xad,
+    0x3f, 0x94, 0x84, 0xe4, 0xb1, 0xde, 0xd6, 0xa9, 0x68, 0x56, 0x49, 0xc8, 0xc2, 0x0c, 0xf8, 0x82,
+    0x51, 0xdf, 0x73, 0xd0, 0x77, 0x8e, 0xe3, 0xec, 0xb5, 0x5a, 0x57, 0x6f, 0xb5, 0xc9, 0x1c, 0x78,
+    0x84, 0x4f, 0x16, 0xd9, 0xda, 0x9f, 0xf9, 0xdd, 0xf3, 0xb3, 0x8b, 0x37, 0xad, 0x13, 0x5d, 0xe8,
+    0x6b, 0x72, 0x73, 0xa3, 0x4d, 0x48, 0x43, 0x72, 0xb8, 0x0e, 0x92, 0xe6, 0x3c, 0x66, 0x82, 0x68,
+    0x44, 0xbd, 0x6c, 0xca, 0xa4, 0x0e, 0x64, 0xde, 0xdf, 0x08, 0x88, 0x7b, 0xb4, 0x4f, 0xfb, 0xde,
+    0x8c, 0x3e, 0x14, 0x90, 0x28, 0xab, 0xcf, 0x1b, 0xdc, 0xea, 0xbe, 0x2d, 0xa7, 0x60, 0x32, 0x4e,
+    0xa3, 0x7d, 0x04, 0xdc, 0x6e, 0xb7, 0xd3, 0x39, 0x7a, 0x84, 0xc0, 0xe3, 0x72, 0x38, 0xd8, 0x7a,
+    0xdb, 0x9a, 0x68, 0x93, 0x8f, 0x71, 0xcc, 0xe7, 0xac, 0x00, 0xa7, 0x32, 0x90, 0x04, 0x6d, 0x4d,
+    0x4a, 0x1f, 0x9a, 0x93, 0xa4, 0xe3, 0xb6, 0x5d, 0xe7, 0x39, 0x39, 0x99, 0x48, 0xd5, 0x00, 0x97,
+    0x07, 0x5a, 0xd1, 0xe4, 0xce, 0x22, 0x9c, 0xf4, 0x9b, 0x49, 0xc1, 0xea, 0x37, 0x55, 0x49, 0xed,
+    0x8b, 0x8a, 0x95, 0xd4, 0x32, 0xc7, 0x7b, 0x40, 0xb6, 0x8f, 0x19, 0x1b, 0x54, 0xd2, 0x32, 0x52,
+    0xd9, 0xd6, 0xb6, 0xfe, 0xcc, 0x2a, 0xad, 0xad, 0x30, 0x95, 0xae, 0xdb, 0x6e, 0xc8, 0x11, 0x4c,
+    0xf1, 0x75, 0x87, 0x68, 0xd9, 0x3a, 0x09, 0x75, 0xb9, 0x75, 0x4a, 0x88, 0xce, 0xe9, 0x35, 0x65,
+    0x50, 0x8b, 0x21, 0xb9, 0x12, 0x09, 0x80, 0x7d, 0x47, 0xb3, 0x52, 0xe2, 0xd6, 0xe9, 0x5f, 0x91,
+    0x11, 0x04, 0xb5, 0x5e, 0xbf, 0xa9, 0x5e, 0x8b, 0xcb, 0x24, 0xd2, 0xa0, 0x0c, 0xd2, 0x20, 0xcf,
+    0x19, 0x54, 0x96, 0x15, 0xf4, 0x80, 0xfd, 0x39, 0x8c, 0x5a, 0x6f, 0x5a, 0x15, 0xc4, 0x38, 0x89,
+    0x06, 0x15, 0xa8, 0x47, 0x95, 0x52, 0x56, 0x9f, 0x9f, 0xcb, 0x6a, 0xf5, 0x64, 0x56, 0xa3, 0x88,
+    0x10, 0x47, 0xb0, 0x6b, 0xb2, 0xe7, 0x30, 0x64, 0x62, 0x7b, 0xca, 0x74, 0xcb, 0xd3, 0xaa, 0xa0,
+    0xc0, 0x0b, 0xd5, 0x37, 0x5e, 0xc2, 0x77, 0xab, 0xa5, 0x93, 0x21, 0xc1, 0x36, 0x1a, 0xda, 0xbe,
+    0x67, 0xdf, 0x0f, 0x2a, 0x01, 0xa4, 0xd7, 0x98, 0x1a, 0xb5, 0xca, 0xe9, 0x47, 0x78, 0x42, 0x63,
+    0x8a, 0x36, 0x2e, 0xea, 0x37, 0xd5, 0xda, 0x9c, 0xc3, 0x9b, 0xe0, 0xf1, 0xec, 0xd0, 0xef, 0x0a,
+    0x88, 0x33, 0x5b, 0xf0, 0x62, 0x25, 0x71, 0x90, 0x97, 0x76, 0x46, 0x03, 0x22, 0x64, 0xfd, 0x11,
+    0xbe, 0x55, 0x28, 0xeb, 0xa5, 0xdc, 0xdd, 0x9c, 0x08, 0x23, 0xc0, 0xa4, 0xb2, 0xa5, 0x24, 0x5e,
+    0x05, 0xa5, 0x61, 0x40, 0xe2, 0x29, 0x09, 0xed, 0x15, 0x1a, 0xc1, 0xc8, 0x41, 0x3a, 0xe7, 0x5e,
+    0xb5, 0x39, 0xa3, 0x72, 0x3c, 0xf1, 0x98, 0x7a, 0xce, 0xd1, 0x04, 0x7d, 0x47, 0x72, 0xa2, 0xa8,
+    0x7a, 0x91, 0x90, 0x04, 0x8b, 0x4a, 0x9a, 0x3d, 0x3d, 0x68, 0x5e, 0x21, 0x1b, 0x25, 0xf5, 0x88,
+    0x02, 0xe9, 0x06, 0x80, 0x03, 0x0c, 0x9c, 0x6a, 0xbc, 0x53, 0x4a, 0xec, 0x2c, 0x9c, 0xfa, 0x84,
+    0xed, 0x92, 0xc2, 0x72, 0xe4, 0x79, 0xd4, 0x20, 0x7a, 0x24, 0x6c, 0x6e, 0xa9, 0x05, 0x72, 0xe4,
+    0x79, 0xd4, 0xce, 0x63, 0xe2, 0x78, 0x3c, 0x23, 0x9c, 0xad, 0x86, 0x4a, 0xe9, 0xed, 0xbc, 0xee,
+    0x3c, 0x26, 0x9d, 0xbe, 0x1d, 0x7b, 0x11, 0xdf, 0xae, 0xf5, 0x09, 0x47, 0x0b, 0x86, 0x06, 0x28,
+    0x9c, 0xfb, 0xfe, 0x49, 0x66, 0x78, 0xe2, 0x85, 0x38, 0x5e, 0xc1, 0x94, 0x8b, 0x7d, 0x46, 0x4e,
+    0x10, 0x6a, 0x36, 0x11, 0x8f, 0xe7, 0x44, 0x44, 0x0e, 0x41, 0x7c, 0x46, 0x10, 0xf4, 0xfe, 0xa2,
+    0x22, 0x61, 0xdb, 0x26, 0x11, 0x87, 0x4c, 0xa6, 0xf3, 0x18, 0xfd, 0x38, 0xbc, 0xbc, 0xbc, 0x2a,
+    0x46, 0x04, 0xec, 0x7d, 0xa7, 0xe8, 0x45, 0x31, 0xe5, 0x14, 0xaa, 0x3d, 0x32, 0x18, 0x21, 0xc9,
+    0xe0, 0x75, 0x32, 0x66, 0xce, 0x6a, 0x50, 0xc6, 0x1b, 0x93, 0x15, 0x27, 0x48, 0x20, 0x3b, 0x89,
+    0x77, 0x09, 0xdc, 0x01, 0x33, 0x06, 0x3e, 0xaf, 0x4b, 0x2c, 0xa8, 0x43, 0x81, 0x5a, 0xf9, 0x14,
+    0x3b, 0x20, 0x6c, 0x38, 0xe5, 0x33, 0x64, 0xcc, 0xa1, 0xca, 0x5b, 0x47, 0xb5, 0x2f, 0x75, 0xe4,
+    0x7b, 0x1c, 0x4e, 0x49, 0x0d, 0x12, 0x3a, 0x1e, 0xd8, 0x2c, 0x59, 0xf7, 0x62, 0xdb, 0x6a, 0x84,
+    0x8c, 0xa3, 0xeb, 0x9b, 0xab, 0xf1, 0xd5, 0xf9, 0xd5, 0xe5, 0xcf, 0x3f, 0x0d, 0x6f, 0x46, 0x1f,
+    0xae, 0x3e, 0x81, 0xa2, 0x3b, 0x4d, 0xb7, 0x5a, 0xf3, 0x71, 0xf4, 0x47, 0x18, 0xfe, 0x26, 0x75,
+    0x82, 0xe6, 0x7e, 0xd9, 0xb2, 0xea, 0x68, 0x78, 0x73, 0x73, 0x75, 0x23, 0x5f, 0xda, 0x75, 0x34,
+    0x1a, 0x5f, 0x5d, 0x8b, 0x67, 0x4b, 0x3c, 0x0f, 0xc7, 0x3f, 0xdf, 0x9c, 0x8d, 0x87, 0xf2, 0xbd,
+    0x5b, 0x2f, 0x64, 0xa1, 0xfc, 0x9c, 0x9d, 0xff, 0x59, 0xcc, 0xb7, 0x5b, 0x75, 0xf4, 0xee, 0x76,
+    0xf4, 0x59, 0x3e, 0x5b, 0x82, 0xce, 0xd9, 0xf8, 0x76, 0x24, 0xde, 0x3a, 0xad, 0xcd, 0xdb, 0xcf,
+    0xef, 0x87, 0x97, 0xe3, 0x33, 0x39, 0x66, 0xad, 0x4f, 0xb4, 0x26, 0xbd, 0xc4, 0x20, 0xe4, 0x7d,
+    0x48, 0x17, 0x21, 0x52, 0x41, 0x73, 0x92, 0xd9, 0x8b, 0xdc, 0x18, 0x0e, 0x87, 0x0c, 0x1c, 0xe6,
+    0xaf, 0x90, 0x8d, 0x63, 0xb0, 0xfe, 0x62, 0x86, 0xb9, 0x38, 0x77, 0x86, 0x53, 0x92, 0x37, 0x48,
+    0xd2, 0x22, 0x80, 0xbe, 0xeb, 0xbc, 0x1d, 0x12, 0xa2, 0x17, 0x1f, 0x86, 0x97, 0xef, 0x47, 0xb0,
+    0xe2, 0x2e, 0xa3, 0xdc, 0x5d, 0x75, 0x59, 0xad, 0xa3, 0xaa, 0xdb, 0x69, 0x57, 0xc1, 0xf6, 0x77,
+    0xd5, 0x55, 0xe6, 0x0d, 0x02, 0x85, 0x63, 0xab, 0x38, 0xd4, 0xde, 0x0e, 0xe5, 0xa8, 0xb9, 0x3e,
+    0x9e, 0x32, 0x31, 0x3b, 0x3f, 0x56, 0xeb, 0x93, 0x80, 0x97, 0x43, 0xd6, 0x51, 0x42, 0x83, 0xbb,
+    0xec, 0x56, 0x0d, 0xe9, 0x68, 0x88, 0xe9, 0x8f, 0x78, 0xb9, 0xbb, 0x02, 0x46, 0x23, 0xcc, 0x67,
+    0xa3, 0x08, 0xdb, 0x24, 0x25, 0xf5, 0x45, 0x63, 0x58, 0x77, 0x1e, 0x4a, 0x28, 0x46, 0x31, 0x84,
+    0xa0, 0x42, 0xa6, 0x0b, 0x8f, 0xf8, 0x0e, 0x33, 0xc4, 0x29, 0xbb, 0x8e, 0xa8, 0xeb, 0xc2, 0xa9,
+    0xbd, 0x0e, 0xc5, 0x85, 0xdd, 0xd7, 0x72, 0x7d, 0x4b, 0xc6, 0x52, 0xa6, 0x4b, 0xe3, 0x21, 0xb6,
+    0x67, 0xc6, 0x86, 0xa2, 0xe1, 0x0a, 0x3a, 0x75, 0x48, 0x2d, 0x9e, 0xdf, 0x28, 0x8f, 0x0b, 0x2e,
+    0x32, 0x5e, 0x1a, 0x82, 0x2c, 0x7a, 0x85, 0x0c, 0x0b, 0xf5, 0xfb, 0x72, 0x65, 0xad, 0x06, 0x92,
+    0xf0, 0x79, 0x1c, 0x9e, 0x68, 0x77, 0x48, 0x9a, 0x77, 0xd6, 0x17, 0x34, 0x18, 0x0c, 0x94, 0x45,
+    0x75, 0xb4, 0xc5, 0x47, 0x79, 0xf8, 0x4e, 0x6d, 0x68, 0x7d, 0x81, 0x1d, 0x48, 0x68, 0x64, 0x4e,
+    0x09, 0xbf, 0x80, 0x0c, 0xe1, 0x9d, 0xb6, 0xb1, 0xd1, 0x4d, 0x24, 0x7a, 0xed, 0x24, 0x51, 0x15,
+    0xbd, 0x1e, 0xa0, 0x6e, 0x91, 0xf9, 0x1a, 0x11, 0x00, 0x06, 0x8d, 0x0c, 0xf3, 0xe7, 0xc9, 0x70,
+    0x0b, 0xf9, 0xfb, 0x3f, 0x13, 0x01, 0x9c, 0xfb, 0x4c, 0x11, 0xac, 0xa3, 0x72, 0x11, 0xda, 0xa5,
+    0x22, 0x3c, 0x8b, 0xd5, 0x71, 0xc2, 0x29, 0xc3, 0xc3, 0xd2, 0xf0, 0xc8, 0x8c, 0xac, 0x6b, 0xd9,
+    0x15, 0x8a, 0x89, 0xe9, 0x31, 0x55, 0x79, 0x80, 0x87, 0x91, 0x0c, 0xc9, 0x4c, 0x82, 0x58, 0xb2,
+    0x6a, 0xe8, 0x25, 0x58, 0xa5, 0x55, 0xb2, 0x4f, 0xf4, 0x10, 0x8e, 0x66, 0x5b, 0x5b, 0xbb, 0x6d,
+    0x1e, 0x39, 0x98, 0x13, 0x95, 0x17, 0xc9, 0x0e, 0xed, 0xed, 0xc6, 0x2e, 0x50, 0x8d, 0x7c, 0xba,
+    0x50, 0x25, 0x43, 0x81, 0x0c, 0xe3, 0x90, 0x5b, 0x01, 0x72, 0x04, 0x72, 0xc1, 0x91, 0xcf, 0x57,
+    0xf5, 0x24, 0xc2, 0x53, 0xf0, 0x25, 0x83, 0x93, 0x1e, 0x07, 0x33, 0x31, 0x6f, 0xe2, 0x93, 0x62,
+    0x52, 0x32, 0x40, 0xf5, 0x1b, 0x10, 0xc0, 0xc8, 0xbb, 0x57, 0x66, 0x0f, 0xd4, 0xb2, 0x5f, 0x7f,
+    0x45, 0x2f, 0x55, 0xed, 0xd2, 0xe7, 0x8d, 0x82, 0x34, 0xe1, 0x06, 0x51, 0xdb, 0x04, 0x42, 0x1a,
+    0x80, 0xf3, 0xe6, 0x06, 0xbe, 0xeb, 0xa0, 0x76, 0x76, 0x83, 0xf4, 0x18, 0x4b, 0x83, 0xa3, 0x5b,
+    0x07, 0xb9, 0xed, 0x79, 0x40, 0x42, 0x6e, 0xce, 0x3c, 0xc7, 0x21, 0x21, 0xfa, 0x41, 0x1c, 0x86,
+    0x5b, 0x08, 0xb0, 0x7a, 0x13, 0x33, 0xd9, 0x03, 0x33, 0x33, 0x85, 0xd4, 0x12, 0x3e, 0xcc, 0xc9,
+    0xdc, 0x75, 0x49, 0xac, 0xb5, 0x58, 0x4a, 0x16, 0x4e, 0x5e, 0xc3, 0x07, 0x78, 0xb8, 0xf4, 0xa0,
+    0xa3, 0x85, 0xf3, 0x8b, 0x51, 0x95, 0xe6, 0xf0, 0xa0, 0xae, 0xad, 0x14, 0x78, 0x03, 0x80, 0x6d,
+    0x0c, 0x51, 0xdb, 0x07, 0x61, 0x4a, 0xbf, 0x4c, 0xbd, 0xbc, 0x94, 0xe5, 0xb2, 0x56, 0xb8, 0x7a,
+    0xda, 0xb1, 0x4a, 0x08, 0xff, 0xbe, 0xc7, 0x1c, 0xff, 0x04, 0xaf, 0x86, 0x78, 0x39, 0x8b, 0x63,
+    0xbc, 0x7a, 0x27, 0x25, 0x37, 0xba, 0xe8, 0x75, 0x8e, 0xd4, 0x1e, 0x7b, 0x1d, 0x1b, 0x60, 0x92,
+    0x7c, 0xa9, 0xdd, 0xbb, 0xde, 0x52, 0xe5, 0x7d, 0xbf, 0x0f, 0xda, 0x39, 0x6d, 0xb4, 0x66, 0x57,
+    0xce, 0x97, 0x5b, 0xf7, 0xc6, 0x67, 0x6a, 0x2c, 0x1a, 0xaa, 0x76, 0xe4, 0x23, 0x61, 0x0c, 0x42,
+    0xd1, 0x48, 0x5c, 0x75, 0xb0, 0xa5, 0x0a, 0xae, 0xdd, 0x2e, 0x17, 0x2a, 0x15, 0x92, 0xdf, 0xca,
+    0x2d, 0x15, 0x11, 0xac, 0x16, 0x42, 0xd6, 0x89, 0x98, 0x94, 0x8d, 0x87, 0x0e, 0xc6, 0xd2, 0xde,
+    0x4c, 0xa8, 0x5d, 0xc4, 0x8b, 0x6d, 0x8e, 0x64, 0xe7, 0x76, 0xe0, 0x32, 0xc3, 0x07, 0xba, 0x12,
+    0x91, 0x36, 0x99, 0x31, 0xd1, 0x9e, 0xe8, 0x58, 0xa7, 0x41, 0x0a, 0x6a, 0x0c, 0x7d, 0x22, 0x1e,
+    0xdf, 0xad, 0x3e, 0x38, 0x46, 0x5a, 0xa5, 0x6b, 0xa6, 0xb8, 0xad, 0x3c, 0x57, 0xd7, 0xd0, 0x45,
+    0x6c, 0xed, 0x6a, 0x7d, 0x55, 0x26, 0x99, 0xaa, 0xa7, 0x3a, 0x39, 0x4a, 0x8a, 0x33, 0x90, 0x17,
+    0x7d, 0xda, 0xc5, 0xc5, 0x93, 0x18, 0xa8, 0x7e, 0xe9, 0x09, 0x6c, 0x8e, 0xea, 0x65, 0x7a, 0x1d,
+    0xc8, 0x57, 0xb6, 0x91, 0x3a, 0x86, 0x22, 0x5e, 0xa8, 0x4f, 0x4c, 0x12, 0xc7, 0x14, 0x12, 0x7f,
+    0xd3, 0x1a, 0x23, 0xf9, 0xde, 0xab, 0xd6, 0x73, 0x31, 0xd4, 0x2d, 0x30, 0x3c, 0x28, 0xd4, 0x81,
+    0x4b, 0x48, 0x6c, 0xfe, 0x17, 0x32, 0x19, 0x51, 0xfb, 0x9e, 0x70, 0x43, 0x1f, 0xe5, 0x69, 0xb3,
+    0x3e, 0x40, 0x0b, 0x2f, 0x04, 0xb8, 0x36, 0x7d, 0x6a, 0x63, 0x41, 0xc1, 0xdc, 0x4e, 0x89, 0x7a,
+    0x3b, 0xe3, 0x3c, 0x62, 0xbd, 0x2a, 0x20, 0x61, 0x75, 0xc1, 0xc4, 0x43, 0x4f, 0x3c, 0xf4, 0xaa,
+    0xba, 0x5c, 0x58, 0xb0, 0xdb, 0x58, 0x50, 0x4c, 0x29, 0xbc, 0x46, 0xd5, 0x66, 0xb3, 0x0a, 0x5f,
+    0x79, 0x1e, 0x33, 0xca, 0xb8, 0xf8, 0x7d, 0x43, 0xae, 0x58, 0xb0, 0x6a, 0x1e, 0x56, 0x93, 0x04,
+    0xdc, 0x6a, 0x21, 0x49, 0x17, 0xd1, 0x57, 0xa5, 0xcb, 0x58, 0xe5, 0x60, 0x15, 0x0b, 0x30, 0x53,
+    0xb9, 0x9a, 0xa3, 0x98, 0x3b, 0xf2, 0x94, 0x9f, 0xed, 0x81, 0x26, 0x0d, 0x69, 0x04, 0xd0, 0x3f,
+    0x48, 0x6d, 0x6a, 0xec, 0xf3, 0xa6, 0x4f, 0xa7, 0x46, 0x35, 0x95, 0x73, 0x63, 0x7e, 0xe2, 0x54,
+    0x6b, 0xc5, 0xec, 0xdd, 0x94, 0x8b, 0x6d, 0x6d, 0x92, 0x38, 0x00, 0x81, 0x5d, 0x33, 0xb5, 0x10,
+    0xb3, 0x7e, 0x4c, 0xd2, 0x40, 0x01, 0xda, 0xae, 0xb0, 0x44, 0xd4, 0x97, 0xb2, 0x26, 0x54, 0x4e,
+    0x9a, 0x50, 0xe6, 0x31, 0xf2, 0xc0, 0x63, 0x18, 0x0e, 0x7c, 0xd4, 0xdd, 0x2d, 0x02, 0x65, 0xad,
+    0x55, 0x1e, 0x41, 0xb7, 0x84, 0x34, 0x7a, 0x6e, 0x31, 0xfa, 0xb1, 0x8e, 0x67, 0x1b, 0x3b, 0x52,
+    0xa6, 0x01, 0xfa, 0xd3, 0xe8, 0xea, 0x93, 0x19, 0x89, 0x5f, 0xcf, 0xf6, 0xb3, 0x10, 0xca, 0x88,
+    0x29, 0x33, 0xcd, 0xbd, 0x2a, 0x60, 0x5d, 0x55, 0x80, 0x5d, 0x6e, 0x58, 0xc0, 0x5d, 0x69, 0xc7,
+    0xf8, 0x64, 0xcc, 0x93, 0xc4, 0x93, 0xc9, 0x27, 0xb6, 0x8c, 0x99, 0xf6, 0xaa, 0x44, 0xad, 0xf5,
+    0xd3, 0xdc, 0x2f, 0xa1, 0x23, 0xe3, 0x7c, 0x31, 0x70, 0x00, 0xf8, 0x6c, 0x03, 0x36, 0x45, 0x1f,
+    0xb5, 0xf5, 0x89, 0xf1, 0x67, 0xfb, 0x94, 0x91, 0xe7, 0xa6, 0x8a, 0xd8, 0x0b, 0x67, 0xa6, 0x98,
+    0x24, 0x49, 0x03, 0x2d, 0xae, 0x69, 0x9a, 0xba, 0xc4, 0x81, 0xfe, 0x60, 0xec, 0x05, 0x84, 0xce,
+    0xb9, 0x91, 0xc7, 0xb7, 0xba, 0xec, 0xd0, 0xca, 0xe5, 0xde, 0x87, 0x95, 0x9b, 0x8b, 0x41, 0x2d,
+    0x42, 0x2e, 0x05, 0x90, 0x89, 0x40, 0x94, 0x27, 0x28, 0xa3, 0x34, 0x52, 0x96, 0x10, 0x23, 0xf2,
+    0xa6, 0x52, 0xdb, 0x1e, 0xac, 0x0e, 0xa4, 0xb2, 0xda, 0x4b, 0x45, 0x5e, 0x88, 0x1e, 0x48, 0x49,
+    0xae, 0x2d, 0xa1, 0x96, 0xfd, 0x9d, 0x84, 0x70, 0x38, 0xc1, 0x7e, 0x6d, 0x0a, 0x2b, 0xfc, 0xb0,
+    0x1c, 0x7c, 0xff, 0x6d, 0xb9, 0x7e, 0xb5, 0x82, 0xaf, 0xd5, 0xfa, 0x95, 0xa4, 0x01, 0x8f, 0xf2,
+    0x7b, 0xfd, 0xb5, 0x56, 0x70, 0x88, 0x09, 0x5d, 0x7d, 0x68, 0xc4, 0x84, 0x45, 0x20, 0x1f, 0x04,
+    0xc0, 0x29, 0xda, 0x3c, 0xcb, 0x7c, 0x31, 0x6a, 0x65, 0x5b, 0x54, 0x9a, 0x9f, 0x66, 0x63, 0x42,
+    0x5e, 0xcb, 0xda, 0x34, 0x08, 0x70, 0xe8, 0x88, 0x16, 0x87, 0x8b, 0x78, 0x94, 0x19, 0x52, 0x3b,
+    0xcc, 0x91, 0xea, 0xce, 0x34, 0xff, 0xcb, 0xb6, 0xd4, 0xaf, 0xda, 0x14, 0x93, 0xd5, 0xff, 0xb7,
+    0x0a, 0xf2, 0xb6, 0xf6, 0xf7, 0xa8, 0xa0, 0x2e, 0x6b, 0x35, 0x27, 0x1f, 0x28, 0x86, 0xaf, 0x5e,
+    0x89, 0x6c, 0x13, 0x0d, 0xcb, 0x4a, 0xc0, 0x87, 0x02, 0xb6, 0x34, 0x03, 0xcc, 0xab, 0xeb, 0xe1,
+    0xa7, 0x32, 0xc0, 0xdf, 0x9c, 0x97, 0xf4, 0x90, 0x54, 0x2c, 0x48, 0xe2, 0xde, 0xab, 0xbc, 0x1e,
+    0x3d, 0x8a, 0x71, 0x1b, 0x82, 0x12, 0xc6, 0xe1, 0x2c, 0x08, 0x29, 0xed, 0xb9, 0x2b, 0xe3, 0x9b,
+    0x80, 0x63, 0x68, 0x1c, 0x04, 0xf5, 0xea, 0xba, 0xf6, 0x38, 0xf0, 0x1d, 0x64, 0xb2, 0x22, 0xa0,
+    0xe6, 0x7f, 0x06, 0x2e, 0xcb, 0x91, 0x88, 0x16, 0x91, 0xbd, 0x20, 0xd2, 0x57, 0xe3, 0xfb, 0x6f,
+    0x12, 0xee, 0x97, 0x26, 0xa7, 0x17, 0xde, 0x92, 0x38, 0x46, 0xbb, 0xb6, 0xae, 0xa3, 0x64, 0x74,
+    0xb5, 0x3b, 0x5a, 0xfb, 0x7a, 0x72, 0x18, 0x67, 0x75, 0xff, 0x7c, 0x00, 0xf3, 0x7f, 0xff, 0xf3,
+    0x3f, 0xbf, 0xfd, 0xbd, 0xb7, 0x61, 0xa6, 0xee, 0xda, 0x76, 0x39, 0xfe, 0xeb, 0x1f, 0x75, 0x24,
+    0xd6, 0xfc, 0x96, 0x5d, 0xd3, 0xce, 0xae, 0x39, 0x54, 0x2c, 0x75, 0x91, 0xad, 0xaf, 0x76, 0xe9,
+    0xf5, 0x03, 0xb4, 0x80, 0x9f, 0x41, 0x76, 0xd1, 0x01, 0x7e, 0xa2, 0xd5, 0x03, 0x29, 0x3f, 0xad,
+    0x90, 0xea, 0x2f, 0x19, 0xce, 0x15, 0xe6, 0x43, 0x13, 0xa2, 0x6e, 0x12, 0xf2, 0x97, 0xbe, 0xb9,
+    0x86, 0x57, 0x7f, 0xa5, 0x7a, 0x4d, 0x7d, 0x7f, 0x73, 0x4b, 0x01, 0xad, 0x05, 0x74, 0x83, 0x4c,
+    0x14, 0x9e, 0x2d, 0x21, 0x28, 0x32, 0x1f, 0xc4, 0xaf, 0xc9, 0x00, 0x9c, 0x06, 0x64, 0x22, 0x64,
+    0xb8, 0x1e, 0x4f, 0x14, 0x8d, 0xa7, 0x21, 0xca, 0x2f, 0x4c, 0xd4, 0xc6, 0x27, 0x21, 0x8a, 0x8a,
+    0x6b, 0x2d, 0x8c, 0x64, 0x6a, 0x5e, 0xbf, 0xb9, 0xb9, 0xfa, 0xef, 0x37, 0xd5, 0xaf, 0xa5, 0xfd,
+    0xa6, 0xfa, 0xdf, 0x92, 0xfe, 0x0b, 0x6e, 0x4d, 0x6d, 0xbf, 0xae, 0x24, 0x00, 0x00,
+};
+
+const WebAsset WEB_ASSETS[] = {
+    {"/index.html", "text/html; charset=UTF-8", WEB_INDEX_HTML_GZ, sizeof(WEB_INDEX_HTML_GZ)},
+};
+const int WEB_ASSET_COUNT = sizeof(WEB_ASSETS) / sizeof(WEB_ASSETS[0]);
 
 #endif // WEB_ASSETS_H
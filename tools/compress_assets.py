@@ -0,0 +1,143 @@
+"""
+Gzip the web UI at build time.
+
+Run by PlatformIO before every build (extra_scripts = pre:...), or by hand:
+
+    python tools/compress_assets.py
+
+For every file in data/ it writes:
+  - <build dir>/data/<file>.gz, the LittleFS image contents (the image
+    then only holds compressed files; `pio run -t uploadfs` uploads it)
+  - src/web/web_assets.h, the same compressed bytes in PROGMEM, served
+    when the LittleFS image is missing or does not hold the asset
+
+Compression is deterministic (no timestamp or file name in the gzip
+header), so outputs only change when an asset does and unchanged files
+are not rewritten.
+"""
+
+import gzip
+import io
+import os
+import re
+
+CONTENT_TYPES = {
+    ".html": "text/html; charset=UTF-8",
+    ".js": "application/javascript",
+    ".css": "text/css",
+    ".svg": "image/svg+xml",
+    ".json": "application/json",
+    ".ico": "image/x-icon",
+}
+
+
+def compress(data):
+    out = io.BytesIO()
+    with gzip.GzipFile(filename="", mode="wb", fileobj=out, compresslevel=9, mtime=0) as gz:
+        gz.write(data)
+    return out.getvalue()
+
+
+def write_if_changed(path, data):
+    if os.path.exists(path):
+        with open(path, "rb") as f:
+            if f.read() == data:
+                return False
+    os.makedirs(os.path.dirname(path), exist_ok=True)
+    with open(path, "wb") as f:
+        f.write(data)
+    return True
+
+
+def list_assets(data_dir):
+    assets = []
+    for root, _, files in os.walk(data_dir):
+        for name in sorted(files):
+            if name.endswith(".gz") or name.startswith("."):
+                continue
+            full = os.path.join(root, name)
+            rel = "/" + os.path.relpath(full, data_dir).replace(os.sep, "/")
+            assets.append((rel, full))
+    return sorted(assets)
+
+
+def symbol_name(path):
+    return "WEB_" + re.sub(r"[^A-Za-z0-9]", "_", path.strip("/")).upper() + "_GZ"
+
+
+def render_header(entries):
+    lines = [
+        "#ifndef WEB_ASSETS_H",
+        "#define WEB_ASSETS_H",
+        "",
+        "#include <Arduino.h>",
+        "",
+        "/**",
+        " * @file web_assets.h",
+        " * @brief Gzipped web UI built into the firmware",
+        " * ",
+        " * Generated from data/ by tools/compress_assets.py - do not edit,",
+        " * change the files in data/ instead. Served when the LittleFS image",
+        " * does not hold an asset.",
+        " */",
+        "",
+        "struct WebAsset {",
+        "    const char* path;          // URL path (LittleFS holds path + \".gz\")",
+        "    const char* contentType;",
+        "    const uint8_t* gzip;       // Compressed content (PROGMEM)",
+        "    size_t gzipLength;",
+        "};",
+        "",
+    ]
+    for path, content_type, raw_len, data in entries:
+        name = symbol_name(path)
+        lines.append("// %s (%d bytes, %d gzipped)" % (path, raw_len, len(data)))
+        lines.append("const uint8_t %s[] PROGMEM = {" % name)
+        for i in range(0, len(data), 16):
+            chunk = ", ".join("0x%02x" % b for b in data[i:i + 16])
+            lines.append("    " + chunk + ",")
+        lines.append("};")
+        lines.append("")
+
+    lines.append("const WebAsset WEB_ASSETS[] = {")
+    for path, content_type, _, _ in entries:
+        name = symbol_name(path)
+        lines.append('    {"%s", "%s", %s, sizeof(%s)},' % (path, content_type, name, name))
+    lines.append("};")
+    lines.append("const int WEB_ASSET_COUNT = sizeof(WEB_ASSETS) / sizeof(WEB_ASSETS[0]);")
+    lines.append("")
+    lines.append("#endif // WEB_ASSETS_H")
+    lines.append("")
+    return "\n".join(lines).encode("utf-8")
+
+
+def build(project_dir, data_dir, fs_dir):
+    entries = []
+    for path, full in list_assets(data_dir):
+        with open(full, "rb") as f:
+            raw = f.read()
+        data = compress(raw)
+        ext = os.path.splitext(path)[1].lower()
+        entries.append((path, CONTENT_TYPES.get(ext, "application/octet-stream"), len(raw), data))
+        if fs_dir and write_if_changed(os.path.join(fs_dir, path.lstrip("/") + ".gz"), data):
+            print("compress_assets: %s -> %d bytes" % (path, len(data)))
+
+    header = os.path.join(project_dir, "src", "web", "web_assets.h")
+    if write_if_changed(header, render_header(entries)):
+        print("compress_assets: regenerated %s" % os.path.relpath(header, project_dir))
+
+
+try:
+    Import("env")  # noqa: F821 (provided by PlatformIO/SCons)
+except NameError:
+    env = None
+
+if env is not None:
+    project_dir = env.subst("$PROJECT_DIR")
+    fs_dir = os.path.join(env.subst("$BUILD_DIR"), "data")
+    build(project_dir, env.subst("$PROJECT_DATA_DIR"), fs_dir)
+    # The filesystem image is built from the compressed copies
+    env.Replace(PROJECT_DATA_DIR=fs_dir)
+elif __name__ == "__main__":
+    root = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+    build(root, os.path.join(root, "data"), None)
@@ -0,0 +1,92 @@
+/**
+ * @file gcode_bench.cpp
+ * @brief Host throughput benchmark for the G-code front end
+ *
+ * Feeds a generated drawing through GCodeLineBuffer and GCodeInterpreter
+ * character by character, the way the Serial task does, and reports
+ * lines per second. Build and run on the development machine:
+ *
+ *   g++ -O2 -std=gnu++11 -Isrc tools/gcode_bench.cpp src/core/GCode.cpp -o gcode_bench
+ *   ./gcode_bench [lines]
+ */
+
+#include "core/GCode.h"
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+// Typical CAM output: mostly G1 moves with coordinates, some arcs,
+// comments and feed changes
+static size_t generateProgram(char* text, size_t capacity, int lines) {
+    size_t length = 0;
+    float x = 100.0f;
+    float y = 100.0f;
+
+    for (int i = 0; i < lines && length + GCODE_LINE_MAX < capacity; i++) {
+        int n;
+        if (i % 50 == 0) {
+            n = snprintf(text + length, capacity - length, "; contour %d\nG1 F%d\n", i / 50, 600 + i % 7 * 100);
+            i++;  // Two lines written
+        } else if (i % 10 == 0) {
+            // Half circle of radius 5 and back on the next line
+            n = snprintf(text + length, capacity - length, "G2 X%.3f Y%.3f I5 J0\n", x + 10.0f, y);
+            x += 10.0f;
+        } else {
+            x = 100.0f + 50.0f * cosf(i * 0.01f);
+            y = 150.0f + 50.0f * sinf(i * 0.01f);
+            n = snprintf(text + length, capacity - length, "N%d G1 X%.3f Y%.3f\n", i, x, y);
+        }
+        length += n;
+    }
+    return length;
+}
+
+int main(int argc, char** argv) {
+    int lines = (argc > 1) ? atoi(argv[1]) : 1000000;
+
+    size_t capacity = (size_t)lines * 40 + GCODE_LINE_MAX;
+    char* text = (char*)malloc(capacity);
+    if (!text) {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+    size_t length = generateProgram(text, capacity, lines);
+
+    GCodeLineBuffer line;
+    GCodeInterpreter gcode;
+    gcode.setPosition(Point2D(100, 100));
+    Command cmd;
+    long parsed = 0;
+    long commands = 0;
+    long errors = 0;
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    for (size_t i = 0; i < length; i++) {
+        if (!line.feed(text[i])) {
+            continue;
+        }
+        parsed++;
+        GCodeInterpreter::Result result = gcode.execute(line.line(), cmd);
+        if (result == GCodeInterpreter::RESULT_ERROR) {
+            errors++;
+            continue;
+        }
+        if (result == GCodeInterpreter::RESULT_COMMAND) {
+            commands++;
+        }
+        gcode.commit();
+    }
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    double seconds = elapsed.count();
+
+    printf("Lines:     %ld (%ld commands, %ld errors)\n", parsed, commands, errors);
+    printf("Bytes:     %zu\n", length);
+    printf("Time:      %.3f s\n", seconds);
+    printf("Rate:      %.0f lines/s, %.1f MB/s\n", parsed / seconds, length / seconds / 1e6);
+
+    free(text);
+    return errors == 0 ? 0 : 1;
+}
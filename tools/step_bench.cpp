@@ -0,0 +1,100 @@
+/**
+ * @file step_bench.cpp
+ * @brief Host benchmark of the stepper step path
+ *
+ * Runs StepperMotor::tick(), the work the step timer interrupt does for
+ * each motor, against MockPinIO on a simulated clock: an idle motor, a
+ * constant-speed move, a ramped move and a chain of PVT segments. For
+ * each it reports the host time per tick and the pin writes per step
+ * (STEP high and low, plus DIR only when the direction changes).
+ * Build and run on the development machine:
+ *
+ *   g++ -O2 -std=gnu++11 -Isrc tools/step_bench.cpp src/hardware/StepperMotor.cpp \
+ *       src/hardware/StepTicker.cpp src/hardware/PinIO.cpp src/core/StepSegment.cpp \
+ *       src/core/StepTrace.cpp src/core/Profiler.cpp -o step_bench
+ *   ./step_bench [seconds of simulated motion per case]
+ */
+
+#include "hardware/StepperMotor.h"
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+
+static const uint8_t STEP_PIN = 10;
+static const uint8_t DIR_PIN = 11;
+static const uint8_t ENABLE_PIN = 12;
+
+enum BenchCase {
+    CASE_IDLE,
+    CASE_CONSTANT,
+    CASE_RAMP,
+    CASE_PVT
+};
+
+// Motion loop period, for the PVT case
+static const uint32_t LOOP_US = 1000000UL / MOTION_CONTROL_FREQUENCY;
+
+static void runCase(const char* name, BenchCase benchCase, uint32_t durationUs) {
+    MockPinIO::reset();
+    MockPinIO::setTime(0);
+
+    StepperMotor motor(STEP_PIN, DIR_PIN, ENABLE_PIN);
+    motor.init();
+    motor.enable();
+    motor.setSpeed(STEPPER_MAX_SPEED);
+    motor.setAcceleration(benchCase == CASE_CONSTANT ? 0.0f : STEPPER_ACCELERATION);
+
+    const float velocity = STEPPER_MAX_SPEED / STEPS_PER_DEGREE;
+    float angle = 0.0f;
+    int8_t direction = 1;
+    uint32_t dirWritesBefore = MockPinIO::writeCount(DIR_PIN);
+
+    double tickSeconds = 0.0;
+    long ticks = 0;
+
+    for (uint32_t t = 0; t < durationUs; t += STEP_TICK_US) {
+        // Motion task side, not timed: new targets as the motion loop
+        // would hand them over
+        if (benchCase == CASE_PVT && t % LOOP_US == 0) {
+            angle += velocity * LOOP_US / 1000000.0f;
+            motor.moveToPVT(angle, velocity, LOOP_US / 1000000.0f);
+        } else if ((benchCase == CASE_CONSTANT || benchCase == CASE_RAMP) && !motor.isMoving()) {
+            // Back and forth over 170 degrees, so DIR changes now and then
+            motor.moveToAngle(direction > 0 ? 170.0f : 0.0f);
+            direction = -direction;
+        }
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        motor.tick();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        tickSeconds += elapsed.count();
+        ticks++;
+
+        MockPinIO::advance(STEP_TICK_US);
+    }
+
+    uint32_t steps = motor.getStepsIssued();
+    uint32_t stepWrites = MockPinIO::writeCount(STEP_PIN);
+    uint32_t dirWrites = MockPinIO::writeCount(DIR_PIN) - dirWritesBefore;
+
+    printf("%-10s %8.1f ns/tick %9.0f steps/s", name,
+           tickSeconds / ticks * 1e9, steps / (durationUs / 1e6));
+    if (steps > 0) {
+        printf("   %.2f pin writes/step (%u DIR)", (double)(stepWrites + dirWrites) / steps, dirWrites);
+    }
+    printf("\n");
+}
+
+int main(int argc, char** argv) {
+    double seconds = (argc > 1) ? atof(argv[1]) : 10.0;
+    uint32_t durationUs = (uint32_t)(seconds * 1e6);
+
+    printf("Step tick every %d us, %.0f steps/s max, %.0f steps/s²\n\n",
+           STEP_TICK_US, STEPPER_MAX_SPEED, STEPPER_ACCELERATION);
+
+    runCase("Idle", CASE_IDLE, durationUs);
+    runCase("Constant", CASE_CONSTANT, durationUs);
+    runCase("Ramp", CASE_RAMP, durationUs);
+    runCase("PVT", CASE_PVT, durationUs);
+    return 0;
+}
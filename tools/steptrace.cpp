@@ -0,0 +1,400 @@
+/**
+ * @file steptrace.cpp
+ * @brief Offline analysis of a step trace downloaded from /trace
+ *
+ * Replays the recorded STEP pulses from the POSITION keyframes to
+ * rebuild both joint trajectories, runs them through the forward
+ * kinematics for the Cartesian path, and reports:
+ * - trace gaps: keyframes that disagree with the replayed step count
+ *   (steps missing from the trace, e.g. while it was being downloaded)
+ * - velocity and acceleration spikes of each joint, measured over
+ *   windows of steps, against the stepper limits of Config.h
+ * - deviations of the tool from the planned path, i.e. the polyline of
+ *   the planner samples of the move being executed
+ *
+ * Build and run on the development machine:
+ *
+ *   g++ -O2 -std=gnu++11 -Isrc tools/steptrace.cpp src/core/StepTrace.cpp -o steptrace
+ *   curl -o trace.bin http://<robot>/trace
+ *   ./steptrace trace.bin [--csv path.csv] [--tolerance mm] [--limit factor]
+ *
+ * The CSV holds the rebuilt trajectory every 10 ms: time, joint angles,
+ * tool position and speed, and deviation from the plan. The exit status
+ * is 0 for a clean trace, 2 when problems were found and 1 on errors.
+ */
+
+#include "core/StepTrace.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+static const int JOINTS = 2;
+static const int WINDOW_STEPS = 8;          // Steps per velocity estimate
+static const double FRAME_US = 10000.0;     // Trajectory resolution
+static const double SETTLE_US = 200000.0;   // A move is followed this long after its last sample
+static const int MAX_LISTED = 10;           // Problems printed per kind
+
+struct Step {
+    double timeUs;
+    int direction;
+};
+
+struct PlannedPoint {
+    double timeUs;
+    double x;
+    double y;
+};
+
+struct Move {
+    std::vector<PlannedPoint> points;
+};
+
+struct Frame {
+    double timeUs;
+    double theta[JOINTS];   // Degrees
+    double x;
+    double y;
+    double speed;           // mm/s
+    double deviation;       // mm, negative outside any move
+};
+
+struct Options {
+    const char* input;
+    const char* csv;
+    double tolerance;   // mm
+    double limit;       // Spike threshold, as a multiple of the stepper limits
+};
+
+static bool readFile(const char* path, std::vector<uint8_t>& data) {
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        return false;
+    }
+    uint8_t buffer[4096];
+    size_t n;
+    while ((n = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        data.insert(data.end(), buffer, buffer + n);
+    }
+    fclose(file);
+    return true;
+}
+
+static bool parseOptions(int argc, char** argv, Options& options) {
+    options.input = nullptr;
+    options.csv = nullptr;
+    options.tolerance = 0.5;
+    options.limit = 1.5;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--csv") == 0 && i + 1 < argc) {
+            options.csv = argv[++i];
+        } else if (strcmp(argv[i], "--tolerance") == 0 && i + 1 < argc) {
+            options.tolerance = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--limit") == 0 && i + 1 < argc) {
+            options.limit = atof(argv[++i]);
+        } else if (argv[i][0] != '-' && !options.input) {
+            options.input = argv[i];
+        } else {
+            return false;
+        }
+    }
+    return options.input != nullptr;
+}
+
+static double distanceToSegment(double px, double py, const PlannedPoint& a, const PlannedPoint& b) {
+    double dx = b.x - a.x;
+    double dy = b.y - a.y;
+    double lengthSquared = dx * dx + dy * dy;
+    double u = 0.0;
+    if (lengthSquared > 0.0) {
+        u = ((px - a.x) * dx + (py - a.y) * dy) / lengthSquared;
+        if (u < 0.0) u = 0.0;
+        if (u > 1.0) u = 1.0;
+    }
+    double ex = a.x + u * dx - px;
+    double ey = a.y + u * dy - py;
+    return sqrt(ex * ex + ey * ey);
+}
+
+// Distance from the planned path of the move running at the given time,
+// or -1 when no move is running
+static double deviationFromPlan(const std::vector<Move>& moves, double timeUs, double x, double y) {
+    for (size_t m = moves.size(); m-- > 0;) {
+        const std::vector<PlannedPoint>& points = moves[m].points;
+        if (points.front().timeUs > timeUs) {
+            continue;
+        }
+        if (timeUs > points.back().timeUs + SETTLE_US) {
+            return -1.0;
+        }
+        if (points.size() == 1) {
+            return distanceToSegment(x, y, points[0], points[0]);
+        }
+        double best = -1.0;
+        for (size_t i = 1; i < points.size(); i++) {
+            double d = distanceToSegment(x, y, points[i - 1], points[i]);
+            if (best < 0.0 || d < best) {
+                best = d;
+            }
+        }
+        return best;
+    }
+    return -1.0;
+}
+
+// Velocity over windows of WINDOW_STEPS steps in the same direction, and
+// acceleration between consecutive windows; prints the worst offenders
+static int findSpikes(int joint, const std::vector<Step>& steps, double maxSpeed, double maxAcceleration,
+                      double& peakSpeed) {
+    int spikes = 0;
+    double previousVelocity = 0.0;
+    double previousMiddle = 0.0;
+    bool havePrevious = false;
+    peakSpeed = 0.0;
+
+    for (size_t i = WINDOW_STEPS; i < steps.size(); i += WINDOW_STEPS) {
+        const Step& first = steps[i - WINDOW_STEPS];
+        const Step& last = steps[i];
+        bool sameDirection = true;
+        for (size_t k = i - WINDOW_STEPS + 1; k <= i; k++) {
+            if (steps[k].direction != first.direction) {
+                sameDirection = false;
+            }
+        }
+        double span = last.timeUs - first.timeUs;
+        if (!sameDirection || span <= 0.0) {
+            havePrevious = false;  // Reversal: start over
+            continue;
+        }
+
+        double velocity = first.direction * WINDOW_STEPS * 1e6 / span;  // steps/s
+        double middle = (first.timeUs + last.timeUs) / 2.0;
+        if (fabs(velocity) > peakSpeed) {
+            peakSpeed = fabs(velocity);
+        }
+
+        if (fabs(velocity) > maxSpeed) {
+            if (spikes++ < MAX_LISTED) {
+                printf("  joint %d, %9.1f ms: velocity %.0f steps/s (limit %.0f)\n",
+                       joint + 1, middle / 1000.0, velocity, maxSpeed);
+            }
+        }
+        if (havePrevious && middle - previousMiddle < 4.0 * span) {
+            double acceleration = (velocity - previousVelocity) * 1e6 / (middle - previousMiddle);
+            if (fabs(acceleration) > maxAcceleration) {
+                if (spikes++ < MAX_LISTED) {
+                    printf("  joint %d, %9.1f ms: acceleration %.0f steps/s^2 (limit %.0f)\n",
+                           joint + 1, middle / 1000.0, acceleration, maxAcceleration);
+                }
+            }
+        }
+        previousVelocity = velocity;
+        previousMiddle = middle;
+        havePrevious = true;
+    }
+    if (spikes > MAX_LISTED) {
+        printf("  joint %d: %d more\n", joint + 1, spikes - MAX_LISTED);
+    }
+    return spikes;
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        fprintf(stderr, "Usage: %s trace.bin [--csv path.csv] [--tolerance mm] [--limit factor]\n", argv[0]);
+        return 1;
+    }
+
+    std::vector<uint8_t> data;
+    if (!readFile(options.input, data)) {
+        fprintf(stderr, "Cannot read %s\n", options.input);
+        return 1;
+    }
+    TraceHeader header;
+    if (!StepTrace::parseHeader(data.data(), data.size(), header)) {
+        fprintf(stderr, "%s is not a step trace (version %u)\n", options.input, (unsigned)TRACE_VERSION);
+        return 1;
+    }
+    size_t count = (data.size() - TRACE_HEADER_SIZE) / TRACE_EVENT_SIZE;
+    if (count < header.eventCount) {
+        fprintf(stderr, "Warning: dump cut short, %zu of %u events\n", count, (unsigned)header.eventCount);
+    } else {
+        count = header.eventCount;
+    }
+
+    double stepsPerDegree = header.stepsPerRevolution / 360.0;
+    printf("Trace:     %zu events, %u steps/rev, arms %.1f + %.1f mm\n", count,
+           (unsigned)header.stepsPerRevolution, header.armLength1, header.armLength2);
+
+    // Replay: step counts from the keyframes, steps and plan in time order
+    std::vector<Step> steps[JOINTS];
+    std::vector<Move> moves;
+    std::vector<Frame> frames;
+    long position[JOINTS] = {0, 0};
+    bool known[JOINTS] = {false, false};
+    long skipped = 0;
+    int gaps = 0;
+    double nowUs = 0.0;
+    double nextFrameUs = 0.0;
+    uint32_t previousTime = 0;
+
+    for (size_t i = 0; i < count; i++) {
+        TraceEvent event = StepTrace::decodeEvent(data.data() + TRACE_HEADER_SIZE + i * TRACE_EVENT_SIZE);
+
+        // micros() wraps every 71 minutes; events are close together
+        if (i > 0) {
+            nowUs += (int32_t)(event.timeUs - previousTime);
+        }
+        previousTime = event.timeUs;
+
+        // Frames up to this event, once both joints are known
+        while (known[0] && known[1] && nextFrameUs < nowUs) {
+            Frame frame;
+            frame.timeUs = nextFrameUs;
+            for (int j = 0; j < JOINTS; j++) {
+                frame.theta[j] = position[j] / stepsPerDegree;
+            }
+            double t1 = frame.theta[0] * M_PI / 180.0;
+            double t2 = frame.theta[1] * M_PI / 180.0;
+            frame.x = header.armLength1 * cos(t1) + header.armLength2 * cos(t1 + t2);
+            frame.y = header.armLength1 * sin(t1) + header.armLength2 * sin(t1 + t2);
+            frame.speed = 0.0;
+            frames.push_back(frame);
+            nextFrameUs += FRAME_US;
+        }
+
+        int joint = event.channel;
+        switch (event.type) {
+            case TRACE_STEP:
+                if (joint >= JOINTS) break;
+                if (!known[joint]) {
+                    skipped++;
+                    break;
+                }
+                position[joint] += event.value;
+                steps[joint].push_back(Step{nowUs, event.value});
+                break;
+
+            case TRACE_POSITION:
+                if (joint >= JOINTS) break;
+                if (known[joint]) {
+                    // Keyframes are wrapped to one turn; the replay is not
+                    long turn = header.stepsPerRevolution;
+                    long diff = ((event.value - position[joint]) % turn + turn) % turn;
+                    if (diff >= turn / 2) diff -= turn;
+                    if (diff != 0 && gaps++ < MAX_LISTED) {
+                        printf("Gap:       joint %d at %.1f ms: replayed %ld steps, keyframe says %d\n",
+                               joint + 1, nowUs / 1000.0, position[joint], event.value);
+                    }
+                    position[joint] += diff;
+                } else {
+                    position[joint] = event.value;
+                }
+                if (!known[joint]) {
+                    known[joint] = true;
+                    nextFrameUs = nowUs;
+                }
+                break;
+
+            case TRACE_SAMPLE_X:
+                // SAMPLE_Y follows; a sample cut in half by the ring is dropped
+                if (i + 1 < count) {
+                    TraceEvent y = StepTrace::decodeEvent(data.data() + TRACE_HEADER_SIZE + (i + 1) * TRACE_EVENT_SIZE);
+                    if (y.type == TRACE_SAMPLE_Y) {
+                        if (event.channel == 1 || moves.empty()) {
+                            moves.push_back(Move());
+                        }
+                        moves.back().points.push_back(PlannedPoint{nowUs, event.value / 100.0, y.value / 100.0});
+                    }
+                }
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    printf("Duration:  %.1f ms, %zu + %zu steps replayed (%ld before the first keyframe)\n",
+           nowUs / 1000.0, steps[0].size(), steps[1].size(), skipped);
+    if (gaps > MAX_LISTED) {
+        printf("Gap:       %d more\n", gaps - MAX_LISTED);
+    }
+
+    // Joint velocity and acceleration
+    printf("Spikes (limits x%.2f):\n", options.limit);
+    int spikes = 0;
+    for (int j = 0; j < JOINTS; j++) {
+        double peak;
+        spikes += findSpikes(j, steps[j], STEPPER_MAX_SPEED * options.limit,
+                             STEPPER_ACCELERATION * options.limit, peak);
+        printf("  joint %d: peak %.0f steps/s (%.1f deg/s)\n", j + 1, peak, peak / stepsPerDegree);
+    }
+
+    // Cartesian path against the plan
+    int deviations = 0;
+    int checked = 0;
+    double worst = 0.0;
+    double worstTime = 0.0;
+    double sumSquares = 0.0;
+    double peakSpeed = 0.0;
+    for (size_t i = 0; i < frames.size(); i++) {
+        Frame& frame = frames[i];
+        if (i > 0 && i + 1 < frames.size()) {
+            // Central difference: one step of quantization is less noisy
+            const Frame& before = frames[i - 1];
+            const Frame& after = frames[i + 1];
+            frame.speed = hypot(after.x - before.x, after.y - before.y) * 1e6 / (2.0 * FRAME_US);
+        }
+        frame.deviation = deviationFromPlan(moves, frame.timeUs, frame.x, frame.y);
+        if (frame.speed > peakSpeed) {
+            peakSpeed = frame.speed;
+        }
+        if (frame.deviation < 0.0) {
+            continue;
+        }
+        checked++;
+        sumSquares += frame.deviation * frame.deviation;
+        if (frame.deviation > worst) {
+            worst = frame.deviation;
+            worstTime = frame.timeUs;
+        }
+        if (frame.deviation > options.tolerance && deviations++ < MAX_LISTED) {
+            printf("Deviation: %9.1f ms: (%.2f, %.2f) is %.2f mm off the plan\n",
+                   frame.timeUs / 1000.0, frame.x, frame.y, frame.deviation);
+        }
+    }
+    if (deviations > MAX_LISTED) {
+        printf("Deviation: %d more\n", deviations - MAX_LISTED);
+    }
+    printf("Path:      %zu moves planned, %d of %zu positions checked, peak speed %.1f mm/s\n",
+           moves.size(), checked, frames.size(), peakSpeed);
+    if (checked > 0) {
+        printf("           deviation max %.3f mm at %.1f ms, rms %.3f mm (tolerance %.2f mm)\n",
+               worst, worstTime / 1000.0, sqrt(sumSquares / checked), options.tolerance);
+    }
+
+    if (options.csv) {
+        FILE* csv = fopen(options.csv, "w");
+        if (!csv) {
+            fprintf(stderr, "Cannot write %s\n", options.csv);
+            return 1;
+        }
+        fprintf(csv, "time_ms,theta1_deg,theta2_deg,x_mm,y_mm,speed_mm_s,deviation_mm\n");
+        for (size_t i = 0; i < frames.size(); i++) {
+            const Frame& frame = frames[i];
+            fprintf(csv, "%.1f,%.3f,%.3f,%.3f,%.3f,%.2f,", frame.timeUs / 1000.0,
+                    frame.theta[0], frame.theta[1], frame.x, frame.y, frame.speed);
+            if (frame.deviation >= 0.0) {
+                fprintf(csv, "%.3f", frame.deviation);
+            }
+            fprintf(csv, "\n");
+        }
+        fclose(csv);
+    }
+
+    bool clean = gaps == 0 && spikes == 0 && deviations == 0;
+    printf("Result:    %s\n", clean ? "clean" : "problems found");
+    return clean ? 0 : 2;
+}